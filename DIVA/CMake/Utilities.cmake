@@ -32,6 +32,7 @@ endmacro()
 #               [SOURCE [<source1> ...]]
 #               [HEADERS [<header1> ...]]
 #               [INCLUDE [<include1> ...]]
+#               [SYSTEM_INCLUDE [<include1> ...]]
 #               [DEFINE [<definition1> ...]]
 #               [LINK [<library1> ...]]
 #               [DEPENDS [<dependency1> ...]]
@@ -39,7 +40,8 @@ endmacro()
 function(create_target project_type project_name)
     # Parse Args
     set(one_val_args "OUTPUT_NAME")
-    set(multi_val_args "SOURCE" "HEADERS" "INCLUDE" "DEFINE" "LINK" "DEPENDS")
+    set(multi_val_args "SOURCE" "HEADERS" "INCLUDE" "SYSTEM_INCLUDE" "DEFINE"
+        "LINK" "DEPENDS")
     parse_all_arguments("ARG" "" "${one_val_args}" "${multi_val_args}" ${ARGN})
 
     # Create target
@@ -55,6 +57,11 @@ function(create_target project_type project_name)
                               ${ARG_OUTPUT_NAME})
     endif()
     target_include_directories(${project_name} PRIVATE ${ARG_INCLUDE})
+    # Third party headers, whose warnings are not ours to fix.
+    if(ARG_SYSTEM_INCLUDE)
+        target_include_directories(${project_name} SYSTEM PRIVATE
+                                   ${ARG_SYSTEM_INCLUDE})
+    endif()
     target_compile_definitions(${project_name} PRIVATE ${ARG_DEFINE})
     target_link_libraries(${project_name} ${ARG_LINK})
     foreach(dep ${ARG_DEPENDS})
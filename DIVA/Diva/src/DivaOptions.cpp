@@ -31,6 +31,14 @@
 #include "ArgumentParser.h"
 #include "Error.h"
 #include "Platform.h"
+#include "ScopeHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <regex>
+#include <thread>
+#include <utility>
 
 namespace {
 
@@ -38,8 +46,8 @@ const static std::string DIVA_VERSION_NUMBER(RC_VERSION_STR);
 const static std::string COPYRIGHT_YEAR(RC_COPYYEAR_STR);
 const static std::string COMPANY_NAME(RC_COMPANYNAME_STR);
 
-[[noreturn]] void earlyExitSuccess() { std::exit(0); }
-[[noreturn]] void earlyExitFailure() { std::exit(1); }
+[[noreturn]] void earlyExitSuccess() { LibScopeError::exitProgram(0); }
+[[noreturn]] void earlyExitFailure() { LibScopeError::exitProgram(1); }
 
 void printVersionDetails(std::ostream &VersionOut) {
 #ifndef NDEBUG
@@ -72,22 +80,37 @@ void printVersionDetails(std::ostream &VersionOut) {
              << "\n";
 }
 
-void compileRegexs(std::vector<std::string> &Patterns,
-                   std::vector<std::regex> &RegexsOut) {
+// Check the patterns are valid regexs. They are compiled together by the
+// printers.
+void checkRegexs(const std::vector<std::string> &Patterns,
+                 std::vector<std::string> &PatternsOut) {
   for (const std::string &Pattern : Patterns) {
     try {
-      RegexsOut.emplace_back(Pattern);
+      std::regex Regex(Pattern);
     } catch (std::regex_error &) {
       fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_REGEX, Pattern);
     }
+    PatternsOut.push_back(Pattern);
   }
 }
 
+// Report the first of the other arguments that is given, and that Arg can not
+// be used with.
+void checkIncompatible(
+    const char *Arg,
+    std::initializer_list<std::pair<bool, const char *>> Others) {
+  for (const auto &Other : Others)
+    if (Other.first)
+      LibScopeError::fatalError(
+          LibScopeError::ErrorCode::ERR_CMD_INCOMPATIBLE_ARGS, Arg,
+          Other.second);
+}
+
 } // end anonymous namespace.
 
 DivaOptions::DivaOptions(const std::vector<std::string> &CMDArgs,
                          std::ostream &HelpOut, std::ostream &VersionOut,
-                         std::ostream &) {
+                         std::ostream &, bool Serving) {
 
   // Parsing.
   try {
@@ -118,6 +141,115 @@ DivaOptions::DivaOptions(const std::vector<std::string> &CMDArgs,
     OutputFormats.emplace(OutputFormat::TEXT);
   if (OutputFormatStrings.count("yaml"))
     OutputFormats.emplace(OutputFormat::YAML);
+  if (OutputFormatStrings.count("json"))
+    OutputFormats.emplace(OutputFormat::JSON);
+
+  // Pipelining only supports the text output.
+  if (Pipeline)
+    checkIncompatible("--pipeline", {
+        {OutputFormats.count(OutputFormat::YAML) != 0, "--output=yaml"},
+        {OutputFormats.count(OutputFormat::JSON) != 0, "--output=json"},
+        {ShowScopeAllocation, "--scope-allocation"},
+        {Serve, "--serve"},
+    });
+  if (Serve) {
+    checkIncompatible("--batch", {{!BatchFile.empty(), "--serve"}});
+    checkIncompatible("--output-if-changed",
+                      {{!ChangedFilesList.empty(), "--serve"}});
+  }
+
+  // A pack holds the files of the split output.
+  if (!OutputPackFile.empty()) {
+    checkIncompatible("--output-pack", {
+        {PrintingSettings.SplitOutput, "--output-dir"},
+        {Serve, "--serve"},
+        {Compare, "--compare"},
+        {CUHashes, "--cu-hashes"},
+    });
+  }
+
+  // Unpacking reads packs rather than programs.
+  if (Unpack) {
+    checkIncompatible("--unpack", {
+        {Serve, "--serve"},
+        {!BatchFile.empty(), "--batch"},
+        {Compare, "--compare"},
+        {!OutputPackFile.empty(), "--output-pack"},
+    });
+  }
+
+  // The index gives the positions of the objects in the text output printed.
+  if (!OutputIndexFile.empty()) {
+    checkIncompatible("--output-index", {
+        {PrintingSettings.SplitOutput, "--output-dir"},
+        {!OutputPackFile.empty(), "--output-pack"},
+        {Serve, "--serve"},
+        {!BatchFile.empty(), "--batch"},
+        {Compare, "--compare"},
+        {Unpack, "--unpack"},
+        {CUHashes, "--cu-hashes"},
+        {!OutputFormats.count(OutputFormat::TEXT), "--output"},
+    });
+  }
+
+  // Comparing prints a report of the differences rather than the objects.
+  if (Compare) {
+    if (InputFiles.size() != 2)
+      LibScopeError::fatalError(
+          LibScopeError::ErrorCode::ERR_CMD_COMPARE_INPUTS,
+          std::to_string(InputFiles.size()));
+    checkIncompatible("--compare", {
+        {Pipeline, "--pipeline"},
+        {Serve, "--serve"},
+        {!BatchFile.empty(), "--batch"},
+        {PrintingSettings.SplitOutput, "--output-dir"},
+        {OutputFormats.count(OutputFormat::JSON) != 0, "--output=json"},
+        {ShowSummary, "--show-summary"},
+        {CUHashes, "--cu-hashes"},
+        {!RawFilters.empty(), "--filter"},
+        {!PrintingSettings.FilterAnys.empty(), "--filter-any"},
+        {!RawTreeFilters.empty(), "--tree"},
+        {!PrintingSettings.TreeFilterAnys.empty(), "--tree-any"},
+    });
+  }
+
+  // The other outputs and views would miss the members freed from shared
+  // types.
+  if (PrintingSettings.ShareTypes) {
+    checkIncompatible("--share-types", {
+        {OutputFormats.count(OutputFormat::YAML) != 0, "--output=yaml"},
+        {OutputFormats.count(OutputFormat::JSON) != 0, "--output=json"},
+        {Compare, "--compare"},
+        {CUHashes, "--cu-hashes"},
+    });
+  }
+
+  // The hashes replace the text output.
+  if (CUHashes) {
+    checkIncompatible("--cu-hashes", {
+        {PrintingSettings.SplitOutput, "--output-dir"},
+        {OutputFormats.count(OutputFormat::YAML) != 0, "--output=yaml"},
+        {OutputFormats.count(OutputFormat::JSON) != 0, "--output=json"},
+        {!RawFilters.empty(), "--filter"},
+        {!PrintingSettings.FilterAnys.empty(), "--filter-any"},
+        {!RawTreeFilters.empty(), "--tree"},
+        {!PrintingSettings.TreeFilterAnys.empty(), "--tree-any"},
+    });
+  }
+
+  // A snapshot holds the tree of a single input file.
+  if (!SnapshotFile.empty()) {
+    if (InputFiles.size() != 1)
+      LibScopeError::fatalError(
+          LibScopeError::ErrorCode::ERR_CMD_SNAPSHOT_INPUTS,
+          std::to_string(InputFiles.size()));
+    checkIncompatible("--save-snapshot", {
+        {Pipeline, "--pipeline"},
+        {Serve, "--serve"},
+        {!BatchFile.empty(), "--batch"},
+        {Compare, "--compare"},
+    });
+  }
 
   // Set sort key.
   if (SortKeyString == "line")
@@ -127,9 +259,190 @@ DivaOptions::DivaOptions(const std::vector<std::string> &CMDArgs,
   if (SortKeyString == "name")
     PrintingSettings.SortKey = LibScopeView::SortingKey::NAME;
 
-  // Compile filter regexs.
-  compileRegexs(RawFilters, PrintingSettings.Filters);
-  compileRegexs(RawTreeFilters, PrintingSettings.TreeFilters);
+  // Set the number of compression threads.
+  if (!CompressThreadsString.empty()) {
+    if (CompressThreadsString.find_first_not_of("0123456789") !=
+            std::string::npos ||
+        CompressThreadsString.size() > 4)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--compress-threads",
+                                CompressThreadsString.c_str());
+    PrintingSettings.CompressionThreads =
+        static_cast<unsigned>(std::stoul(CompressThreadsString));
+  }
+
+  // Set the number of input files processed at once.
+  if (!JobsString.empty()) {
+    if (JobsString.find_first_not_of("0123456789") != std::string::npos ||
+        JobsString.size() > 4)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--jobs", JobsString.c_str());
+    Jobs = static_cast<unsigned>(std::stoul(JobsString));
+  }
+
+  // Set the number of processes reading and printing a pipeline.
+  if (!ProcessesString.empty()) {
+    if (ProcessesString.find_first_not_of("0123456789") != std::string::npos ||
+        ProcessesString.size() > 4)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--processes", ProcessesString.c_str());
+    Processes = static_cast<unsigned>(std::stoul(ProcessesString));
+    if (!Processes)
+      Processes = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  // Only the summary table is printed, counted as the groups of compile
+  // units of --pipeline are read.
+  if (SummaryOnly) {
+    checkIncompatible("--summary-only", {
+        {PrintingSettings.SplitOutput, "--output-dir"},
+        {!OutputPackFile.empty(), "--output-pack"},
+        {!OutputIndexFile.empty(), "--output-index"},
+        {!OutputFormats.count(OutputFormat::TEXT) ||
+             OutputFormats.size() != 1,
+         "--output"},
+        {Serve, "--serve"},
+        {Compare, "--compare"},
+        {CUHashes, "--cu-hashes"},
+        {!SnapshotFile.empty(), "--save-snapshot"},
+        {PrintingSettings.ShareTypes, "--share-types"},
+    });
+  }
+
+  // Set the groups of compile units drawn to estimate the summary table.
+  if (!SummarySampleString.empty()) {
+    if (SummarySampleString.find_first_not_of("0123456789") !=
+            std::string::npos ||
+        SummarySampleString.size() > 6 || std::stoul(SummarySampleString) < 2)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--summary-sample",
+                                SummarySampleString.c_str());
+    SummarySample = static_cast<unsigned>(std::stoul(SummarySampleString));
+    if (!SummaryOnly)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_REQUIRES_ARG,
+                                "--summary-sample", "--summary-only");
+    checkIncompatible("--summary-sample", {{!BatchFile.empty(), "--batch"}});
+  }
+  if (!SampleSeedString.empty()) {
+    if (SampleSeedString.find_first_not_of("0123456789") !=
+            std::string::npos ||
+        SampleSeedString.size() > 19)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--sample-seed", SampleSeedString.c_str());
+    SampleSeed = std::stoull(SampleSeedString);
+    if (!SummarySample)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_REQUIRES_ARG,
+                                "--sample-seed", "--summary-sample");
+  }
+
+  // The worker processes only send back the output of each part, or the
+  // counts of its objects.
+  if (Processes != 1) {
+    if (!Pipeline && !SummaryOnly)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_REQUIRES_ARG,
+                                "--processes", "--pipeline");
+    checkIncompatible("--processes", {
+        {Jobs != 1, "--jobs"},
+        {ShowSummary && !SummaryOnly, "--show-summary"},
+        {!OutputPackFile.empty(), "--output-pack"},
+        {!OutputIndexFile.empty(), "--output-index"},
+        {!ChangedFilesList.empty(), "--output-if-changed"},
+    });
+  }
+
+  // Set the shard printed, given as "<index>/<count>".
+  if (!ShardString.empty()) {
+    size_t Slash = ShardString.find('/');
+    std::string IndexString = ShardString.substr(0, Slash);
+    std::string CountString =
+        Slash == std::string::npos ? "" : ShardString.substr(Slash + 1);
+    auto isNumber = [](const std::string &Text) {
+      return !Text.empty() && Text.size() <= 4 &&
+             Text.find_first_not_of("0123456789") == std::string::npos;
+    };
+    if (!isNumber(IndexString) || !isNumber(CountString))
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--cu-shard", ShardString.c_str());
+    ShardIndex = static_cast<unsigned>(std::stoul(IndexString));
+    ShardCount = static_cast<unsigned>(std::stoul(CountString));
+    if (ShardIndex >= ShardCount)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_INVALID_VALUE,
+                                "--cu-shard", ShardString.c_str());
+  }
+
+  // A shard holds the text output of some of the parts of one input file,
+  // printed as --pipeline does.
+  if (ShardCount) {
+    if (!Pipeline)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_REQUIRES_ARG,
+                                "--cu-shard", "--pipeline");
+    if (ShardFile.empty())
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_REQUIRES_ARG,
+                                "--cu-shard", "--save-shard");
+    if (InputFiles.size() != 1)
+      LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_SHARD_INPUTS,
+                                std::to_string(InputFiles.size()));
+    checkIncompatible("--cu-shard", {
+        {Serve, "--serve"},
+        {!BatchFile.empty(), "--batch"},
+        {PrintingSettings.SplitOutput, "--output-dir"},
+        {!OutputPackFile.empty(), "--output-pack"},
+        {!OutputIndexFile.empty(), "--output-index"},
+        {ShowSummary, "--show-summary"},
+        {SummaryOnly, "--summary-only"},
+    });
+
+    // The input file, the shard and how it is read do not change the output.
+    const char *const Ignored[] = {"--cu-shard=", "--save-shard=",
+                                   "--processes=", "--cu-cache="};
+    LibScopeView::HashBuilder Hash;
+    for (const std::string &Arg : CMDArgs)
+      if (Arg.size() > 1 && Arg[0] == '-' &&
+          std::none_of(std::begin(Ignored), std::end(Ignored),
+                       [&](const char *Prefix) {
+                         return Arg.compare(0, strlen(Prefix), Prefix) == 0;
+                       }))
+        Hash.add(Arg);
+    ShardSettingsHash = Hash.get();
+  } else if (!ShardFile.empty()) {
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_CMD_REQUIRES_ARG,
+                              "--save-shard", "--cu-shard");
+  }
+
+  // Merging reads shards rather than programs.
+  if (MergeShards) {
+    checkIncompatible("--merge-shards", {
+        {ShardCount != 0, "--cu-shard"},
+        {Serve, "--serve"},
+        {!BatchFile.empty(), "--batch"},
+        {Compare, "--compare"},
+        {Unpack, "--unpack"},
+        {!OutputPackFile.empty(), "--output-pack"},
+        {!OutputIndexFile.empty(), "--output-index"},
+    });
+  }
+
+  // Check filter regexs.
+  checkRegexs(RawFilters, PrintingSettings.Filters);
+  checkRegexs(RawTreeFilters, PrintingSettings.TreeFilters);
+
+  // A command line sent to a server prints the trees the server holds to the
+  // output of the server, and nothing else.
+  if (Serving) {
+    for (const auto &Arg : std::initializer_list<std::pair<bool, const char *>>{
+             {Pipeline, "--pipeline"},
+             {!SnapshotFile.empty(), "--save-snapshot"},
+             {!CUCacheDirectory.empty(), "--cu-cache"},
+             {!ChangedFilesList.empty(), "--output-if-changed"},
+             {!OutputPackFile.empty(), "--output-pack"},
+             {Unpack, "--unpack"},
+             {!OutputIndexFile.empty(), "--output-index"},
+             {ShardCount != 0, "--cu-shard"},
+             {SummaryOnly, "--summary-only"},
+             {MergeShards, "--merge-shards"},
+         })
+      checkIncompatible(Arg.second, {{Arg.first, "--serve"}});
+  }
 }
 
 void DivaOptions::parseArgs(const std::vector<std::string> &CMDArgs,
@@ -183,6 +496,23 @@ void DivaOptions::parseArgs(const std::vector<std::string> &CMDArgs,
                [&](const Parser &) { PrintingSettings.showBrief(); }),
       Argument::switchArg('t', "show-summary", "Print the summary table",
                           BasicHelp, ShowSummary),
+      Argument::switchArg(
+          NSC, "summary-only",
+          "Print only the summary table, counting the objects of one group "
+          "of compile units at a time without sorting or printing them. "
+          "--processes counts the groups in several processes.",
+          BasicHelp, SummaryOnly),
+      Argument::stringArg(
+          NSC, "summary-sample", "n",
+          "Estimate the summary table of --summary-only from <n> groups of "
+          "compile units drawn at random, each with a chance in proportion "
+          "to its size, printing the 95% confidence interval of each count.",
+          BasicHelp, SummarySampleString),
+      Argument::stringArg(
+          NSC, "sample-seed", "seed",
+          "Seed of the random draws of --summary-sample, drawing the same "
+          "groups for the same seed and input file. By default 0.",
+          BasicHelp, SampleSeedString),
       Argument('d', "output-dir", "[=<dir>]",
                "Print the output into a directory with each compile unit's "
                "output in a separate file. If no dir is given, then diva will "
@@ -195,10 +525,149 @@ void DivaOptions::parseArgs(const std::vector<std::string> &CMDArgs,
                  PrintingSettings.OutputDirectory = Opt;
                },
                [&](const Parser &) { PrintingSettings.SplitOutput = false; }),
+      Argument::switchArg(
+          NSC, "output-compress",
+          "Gzip compress each file written by --output-dir, adding a \".gz\" "
+          "extension.",
+          BasicHelp, PrintingSettings.CompressOutput),
+      Argument(NSC, "output-if-changed", "[=<file>]",
+               "Only replace the files written by --output-dir whose contents "
+               "changed, leaving the others untouched. If a file is given, "
+               "the files replaced are listed in it, one per line.",
+               BasicHelp,
+               [&](const Parser &) {
+                 PrintingSettings.WriteOnlyChangedOutput = true;
+               },
+               [&](const Parser &, const std::string &Opt) {
+                 PrintingSettings.WriteOnlyChangedOutput = true;
+                 ChangedFilesList = Opt;
+               },
+               [&](const Parser &) {
+                 PrintingSettings.WriteOnlyChangedOutput = false;
+                 ChangedFilesList.clear();
+               }),
+      Argument::stringArg(
+          NSC, "output-pack", "file",
+          "Print the output into <file>, packing together the files that "
+          "--output-dir would write, with an index to find each one. "
+          "--output-compress compresses each of them.",
+          BasicHelp, OutputPackFile),
+      Argument(NSC, "unpack", "[=<name>]",
+               "Print the file <name> from the packs written by --output-pack "
+               "that are given as input files, or list the files they hold if "
+               "no name is given.",
+               BasicHelp,
+               [&](const Parser &) { Unpack = true; },
+               [&](const Parser &, const std::string &Opt) {
+                 Unpack = true;
+                 UnpackName = Opt;
+               },
+               [&](const Parser &) {
+                 Unpack = false;
+                 UnpackName.clear();
+               }),
+      Argument::stringArg(
+          NSC, "output-index", "file",
+          "Write an index of the text output into <file>, giving the byte "
+          "offset and line where each compile unit and each scope directly "
+          "in one starts, so that a viewer can go straight to them.",
+          BasicHelp, OutputIndexFile),
+      Argument::stringArg(
+          NSC, "compress-threads", "n",
+          "Number of threads used to compress the output of "
+          "--output-compress. 0, or more than the number of cores, uses one "
+          "thread per core. By default 1.",
+          BasicHelp, CompressThreadsString),
       Argument::multiChoiceArg(
           NSC, "output",
           "A comma separated list of output formats.", BasicHelp,
-          {"text", "yaml"}, OutputFormatStrings)
+          {"text", "yaml", "json"}, OutputFormatStrings),
+      Argument::switchArg(
+          NSC, "pipeline",
+          "Read and print the compile units in groups, freeing each group "
+          "once printed, to limit memory use. Only the text output is "
+          "supported. The groups are printed in the order they are read, "
+          "each with its own column widths.",
+          BasicHelp, Pipeline),
+      Argument::stringArg(
+          NSC, "processes", "n",
+          "Number of processes reading and printing the groups of compile "
+          "units of --pipeline at once, each reading the input file on its "
+          "own. The groups are printed in the order they are read. 0 uses "
+          "one process per core. By default 1. Only Linux runs several "
+          "processes.",
+          BasicHelp, ProcessesString),
+      Argument::stringArg(
+          NSC, "cu-shard", "i/n",
+          "Print only the shard <i> out of <n> of the groups of compile units "
+          "of --pipeline, counting from 0, into the file given to "
+          "--save-shard. The shards hold about as many bytes of the input "
+          "file each.",
+          BasicHelp, ShardString),
+      Argument::stringArg(
+          NSC, "save-shard", "file",
+          "Save the output of the shard printed by --cu-shard into <file>.",
+          BasicHelp, ShardFile),
+      Argument::switchArg(
+          NSC, "merge-shards",
+          "Print the output of the shards saved by --save-shard that are "
+          "given as input files, one after another, after checking that "
+          "they are all the shards of the same input file and options.",
+          BasicHelp, MergeShards),
+      Argument::stringArg(
+          NSC, "jobs", "n",
+          "Number of input files read and printed at once. Each file's "
+          "output is printed in the order the files are given. 0 uses one "
+          "job per core. By default 1.",
+          BasicHelp, JobsString),
+      Argument::switchArg(
+          NSC, "serve",
+          "Read diva command lines from stdin and print the output of "
+          "each, keeping the input files read in memory for later command "
+          "lines. Any input_file given is read before the first command line.",
+          BasicHelp, Serve),
+      Argument::stringArg(
+          NSC, "batch", "file",
+          "Read more input files from <file>, one per line, each optionally "
+          "followed by a file to print its output into. A <file> of - reads "
+          "them from stdin. The summary table is printed once for all the "
+          "input files.",
+          BasicHelp, BatchFile),
+      Argument::switchArg(
+          NSC, "compare",
+          "Compare the two input files, printing the objects added, removed "
+          "and changed in the second. Only the text and yaml outputs are "
+          "supported.",
+          BasicHelp, Compare),
+      Argument::switchArg(
+          NSC, "cu-hashes",
+          "Print a hash of the logical view of each compile unit, followed "
+          "by its name, rather than the view. The hash does not depend on "
+          "the DWARF offsets or the order of the objects.",
+          BasicHelp, CUHashes),
+      Argument::switchArg(
+          NSC, "share-types",
+          "Keep one copy of the members of each class, structure and union "
+          "that is the same in several compile units, to save memory. The "
+          "later copies are printed, and counted in the summary table, "
+          "without their members. Only the text output is supported.",
+          BasicHelp, PrintingSettings.ShareTypes),
+      Argument::stringArg(
+          NSC, "save-snapshot", "file",
+          "Save the tree read from the input file into <file>, which can be "
+          "given as an input file to print it again without reading the "
+          "DWARF. It must be printed with the same --show-void and "
+          "--share-types settings.",
+          BasicHelp, SnapshotFile),
+      Argument::stringArg(
+          NSC, "cu-cache", "dir",
+          "Keep the compile units read from the input files in <dir>, and "
+          "load those whose DWARF did not change from there rather than "
+          "reading them again. Object files are not cached. The text and "
+          "YAML output of each compile unit split into its own file is kept "
+          "there too, and copied from there when it is printed again with the "
+          "same options.",
+          BasicHelp, CUCacheDirectory)
     }),
 
     ArgumentGroup("Sort options", {
@@ -32,12 +32,13 @@
 
 #include "PrintSettings.h"
 
+#include <cstdint>
 #include <iostream>
 #include <set>
 #include <string>
 #include <vector>
 
-enum class OutputFormat { TEXT, YAML };
+enum class OutputFormat { TEXT, YAML, JSON };
 
 /// \brief Class that parses command line arguments into DIVA's options (using
 /// ArgumentParser).
@@ -48,8 +49,11 @@ public:
   /// \brief Creates the options from a set of command line arguments.
   ///
   /// Note the first argument should not be the executable name (argv[0]).
+  /// Serving is set for a command line sent to a running --serve, which
+  /// rejects the arguments that write anything but the printed output.
   DivaOptions(const std::vector<std::string> &CMDArgs, std::ostream &HelpOut,
-              std::ostream &VersionOut, std::ostream &ErrOut);
+              std::ostream &VersionOut, std::ostream &ErrOut,
+              bool Serving = false);
 
   std::vector<std::string> InputFiles;
 
@@ -59,6 +63,72 @@ public:
 
   bool ShowSummary = false;
 
+  // Print only the summary table, counted one group of compile units at a
+  // time.
+  bool SummaryOnly = false;
+
+  // Groups of compile units drawn to estimate the summary table of
+  // --summary-only from, or 0 to count them all, and the seed of the draws.
+  unsigned SummarySample = 0;
+  uint64_t SampleSeed = 0;
+
+  // File to pack the split output files into, or empty for none.
+  std::string OutputPackFile;
+
+  // Print the file UnpackName from the packs given as input files, or list
+  // their files if it is empty.
+  bool Unpack = false;
+  std::string UnpackName;
+
+  // File to write the index of the text output into, or empty for none.
+  std::string OutputIndexFile;
+
+  // File listing the split output files replaced by --output-if-changed, or
+  // empty for none.
+  std::string ChangedFilesList;
+
+  bool Pipeline = false;
+
+  // Processes reading and printing the parts of a --pipeline at once, 0 for
+  // one per core.
+  unsigned Processes = 1;
+
+  // The shard of the parts of a --pipeline saved into ShardFile, out of
+  // ShardCount, or 0 shards for none.
+  unsigned ShardIndex = 0;
+  unsigned ShardCount = 0;
+  std::string ShardFile;
+
+  // A hash of the arguments the output of a shard depends on, so that only
+  // shards printed alike are merged.
+  uint64_t ShardSettingsHash = 0;
+
+  // Print the output of the shards given as input files, merged.
+  bool MergeShards = false;
+
+  // Input files processed at once, 0 for one per core.
+  unsigned Jobs = 1;
+
+  // Answer command lines read from stdin, keeping the input files read.
+  bool Serve = false;
+
+  // File listing more input files, and the files to print them into, or "-"
+  // for stdin.
+  std::string BatchFile;
+
+  // Compare the two input files rather than print them.
+  bool Compare = false;
+
+  // Print a hash of each compile unit's logical view rather than the view.
+  bool CUHashes = false;
+
+  // File to save the tree of the input file into, once read.
+  std::string SnapshotFile;
+
+  // Directory keeping the compile units read from the input files, so that
+  // those that did not change are loaded rather than read. Empty for none.
+  std::string CUCacheDirectory;
+
   bool ShowPerformanceTime = false;
   bool ShowPerformanceMemory = false;
   bool ShowScopeAllocation = false;
@@ -70,6 +140,13 @@ private:
   // Some options need to be translated from input strings to enum values.
   std::set<std::string> OutputFormatStrings;
   std::string SortKeyString;
+  // Or from strings to numbers.
+  std::string CompressThreadsString;
+  std::string JobsString;
+  std::string ProcessesString;
+  std::string ShardString;
+  std::string SummarySampleString;
+  std::string SampleSeedString;
   // Or from strings to regular expressions.
   std::vector<std::string> RawFilters;
   std::vector<std::string> RawTreeFilters;
@@ -31,22 +31,91 @@
 #include "ElfDwarfReader.h"
 #include "Error.h"
 #include "FileUtilities.h"
+#include "FilterMatcher.h"
+#include "OutputIndex.h"
+#include "OutputPack.h"
+#include "OutputShard.h"
 #include "PrintSettings.h"
+#include "ScopeCompare.h"
+#include "ScopeHash.h"
+#include "ScopeJSONPrinter.h"
 #include "ScopeTextPrinter.h"
 #include "ScopeYAMLPrinter.h"
+#include "Snapshot.h"
 #include "StringPool.h"
+#include "SummaryEstimate.h"
 #include "SummaryTable.h"
 #include "Utilities.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cctype>
+#include <cstdio>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 namespace {
 
-/// \brief Read an input file, creating a Scope tree.
-std::unique_ptr<LibScopeView::ScopeRoot>
-readInputFile(const std::string &InputFilePath,
-              const LibScopeView::PrintSettings &Settings) {
+/// \brief An input file, and the file to print its output into.
+struct InputFile {
+  std::string Path;
+  // Empty to print the output to stdout.
+  std::string OutputPath;
+};
+
+/// \brief The split output files written for all the input files, listed in
+/// the file given to --output-if-changed once they are all printed.
+class WrittenFileList {
+public:
+  void add(const LibScopeView::ScopePrinter &Printer) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Files.insert(Files.end(), Printer.getWrittenFiles().begin(),
+                 Printer.getWrittenFiles().end());
+  }
+
+  /// \brief Write the files, one per line, into the file at Path.
+  void write(const std::string &Path) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    // The input files may be printed in any order by several jobs.
+    std::sort(Files.begin(), Files.end());
+    std::string Contents;
+    for (const std::string &File : Files)
+      Contents.append(File).append("\n");
+    std::string UnifiedPath = LibScopeView::unifyFilePath(Path);
+    LibScopeView::recursiveMakeDir(LibScopeView::getDirectoryName(UnifiedPath));
+    if (!LibScopeView::replaceFileContents(UnifiedPath, Contents))
+      fatalError(LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+  }
+
+private:
+  std::mutex Mutex;
+  std::vector<std::string> Files;
+};
+
+WrittenFileList ChangedFiles;
+
+// The pack given to --output-pack, written into by all the input files.
+std::unique_ptr<LibScopeView::OutputPackWriter> OutputPack;
+
+// The index given to --output-index, of the text output printed to stdout.
+std::unique_ptr<LibScopeView::OutputIndex> TextOutputIndex;
+
+// The shard given to --save-shard, and the parts of the input file printed
+// into it.
+std::unique_ptr<LibScopeView::ShardWriter> OutputShard;
+LibScopeView::ShardInfo OutputShardInfo;
+
+/// \brief Create the reader for an input file, keeping the compile units it
+/// reads in CUCacheDirectory if not empty.
+std::unique_ptr<LibScopeView::Reader>
+createReader(const std::string &InputFilePath,
+             const std::string &CUCacheDirectory) {
   // Check that the file exists.
   if (!LibScopeView::doesFileExist(InputFilePath))
     fatalError(LibScopeError::ErrorCode::ERR_FILE_NOT_FOUND, InputFilePath);
@@ -54,14 +123,25 @@ readInputFile(const std::string &InputFilePath,
   // Create an appropriate reader.
   std::unique_ptr<LibScopeView::Reader> Reader;
   if (LibScopeView::isFileFormatElf(InputFilePath))
-    Reader = std::make_unique<ElfDwarfReader::DwarfReader>();
+    Reader = std::make_unique<ElfDwarfReader::DwarfReader>(CUCacheDirectory);
+  else if (LibScopeView::isFileFormatSnapshot(InputFilePath))
+    Reader = std::make_unique<LibScopeView::SnapshotReader>();
 
   if (!Reader)
     fatalError(LibScopeError::ErrorCode::ERR_INVALID_FILE, InputFilePath);
 
+  return Reader;
+}
+
+/// \brief Read an input file, creating a Scope tree.
+std::unique_ptr<LibScopeView::ScopeRoot>
+readInputFile(const std::string &InputFilePath,
+              const LibScopeView::PrintSettings &Settings,
+              const std::string &CUCacheDirectory) {
   // Load the file.
   std::unique_ptr<LibScopeView::ScopeRoot> Root =
-      Reader->loadFile(InputFilePath, Settings);
+      createReader(InputFilePath, CUCacheDirectory)
+          ->loadFile(InputFilePath, Settings);
   if (!Root)
     // Currently the ElfDwarfReader will always call fatalError itself so we
     // should never reach this code.
@@ -70,44 +150,565 @@ readInputFile(const std::string &InputFilePath,
   return Root;
 }
 
+/// \brief Get the settings deciding which objects the summary table counts as
+/// printed, or null for all of them.
+const LibScopeView::PrintSettings *
+getSummarySettings(const DivaOptions &Options) {
+  // Print settings were ignored for YAML and JSON.
+  if (Options.OutputFormats.count(OutputFormat::YAML) ||
+      Options.OutputFormats.count(OutputFormat::JSON))
+    return nullptr;
+  return &Options.PrintingSettings;
+}
+
+/// \brief Print a tree. The summary of the tree is added to \p BatchSummary
+/// if it is given, rather than printed.
 void printScopeView(const LibScopeView::ScopeRoot &Root,
                     const std::string &InputFilePath,
-                    const DivaOptions &Options) {
+                    const DivaOptions &Options, std::ostream &OutputStream,
+                    LibScopeView::SummaryTable *BatchSummary = nullptr) {
   if (Options.ShowScopeAllocation)
-    LibScopeView::printAllocationInfo(Root, std::cout);
+    LibScopeView::printAllocationInfo(Root, OutputStream);
+
+  if (Options.CUHashes && !Options.PrintingSettings.QuietMode)
+    LibScopeView::printCompileUnitHashes(Root, Options.PrintingSettings,
+                                         OutputStream);
 
   std::vector<std::unique_ptr<LibScopeView::ScopePrinter>> Printers;
 
   // Create text printer.
-  if (Options.OutputFormats.count(OutputFormat::TEXT))
-    Printers.emplace_back(std::make_unique<LibScopeView::ScopeTextPrinter>(
-        Options.PrintingSettings, InputFilePath));
+  if (Options.OutputFormats.count(OutputFormat::TEXT) && !Options.CUHashes) {
+    auto TextPrinter = std::make_unique<LibScopeView::ScopeTextPrinter>(
+        Options.PrintingSettings, InputFilePath);
+    TextPrinter->setOutputIndex(TextOutputIndex.get());
+    Printers.emplace_back(std::move(TextPrinter));
+  }
   // Create YAML printer.
   if (Options.OutputFormats.count(OutputFormat::YAML))
     Printers.emplace_back(std::make_unique<LibScopeView::ScopeYAMLPrinter>(
         Options.PrintingSettings, InputFilePath, YAML_OUTPUT_VERSION_STR));
+  // Create JSON printer.
+  if (Options.OutputFormats.count(OutputFormat::JSON))
+    Printers.emplace_back(std::make_unique<LibScopeView::ScopeJSONPrinter>(
+        Options.PrintingSettings, InputFilePath, JSON_OUTPUT_VERSION_STR));
 
   // Print the Logical Views.
   for (auto &Printer : Printers) {
-    if (Options.PrintingSettings.SplitOutput) {
+    if (OutputPack) {
+      Printer->setOutputCache(Options.CUCacheDirectory);
+      Printer->print(&Root, *OutputPack);
+    } else if (Options.PrintingSettings.SplitOutput) {
+      Printer->setOutputCache(Options.CUCacheDirectory);
       Printer->print(&Root, Options.PrintingSettings.OutputDirectory);
+      if (!Options.ChangedFilesList.empty())
+        ChangedFiles.add(*Printer);
     } else if (!Options.PrintingSettings.QuietMode) {
-      Printer->print(&Root, std::cout);
+      Printer->print(&Root, OutputStream);
     }
   }
 
   // Print summary.
-  if (Options.ShowSummary) {
-    const auto *Settings = &Options.PrintingSettings;
-    // Print settings were ignored for YAML.
-    if (Options.OutputFormats.count(OutputFormat::YAML))
-      Settings = nullptr;
-    LibScopeView::SummaryTable Table(Root, Settings);
-    std::cout << '\n';
-    Table.printSummaryTable(std::cout);
+  if (BatchSummary) {
+    BatchSummary->addObjects(Root);
+  } else if (Options.ShowSummary) {
+    LibScopeView::SummaryTable Table(Root, getSummarySettings(Options));
+    OutputStream << '\n';
+    Table.printSummaryTable(OutputStream);
+  }
+}
+
+/// \brief Print the objects added, removed and changed in the tree of the
+/// second input file from the tree of the first.
+void printComparison(const LibScopeView::ScopeRoot &Old,
+                     const LibScopeView::ScopeRoot &New,
+                     const DivaOptions &Options, std::ostream &OutputStream) {
+  if (Options.PrintingSettings.QuietMode)
+    return;
+  LibScopeView::ScopeCompare Comparison(Old, New, Options.PrintingSettings);
+  const std::string &OldPath = Options.InputFiles[0];
+  const std::string &NewPath = Options.InputFiles[1];
+  if (Options.OutputFormats.count(OutputFormat::TEXT))
+    Comparison.printText(OutputStream, OldPath, NewPath);
+  if (Options.OutputFormats.count(OutputFormat::YAML))
+    Comparison.printYAML(OutputStream, OldPath, NewPath);
+}
+
+/// \brief Read and print an input file one group of compile units at a
+/// time, so that only the groups being read and printed are in memory.
+void readAndPrintInParts(const std::string &InputFilePath,
+                         const DivaOptions &Options, std::ostream &OutputStream,
+                         LibScopeView::SummaryTable *BatchSummary) {
+  const LibScopeView::PrintSettings &Settings = Options.PrintingSettings;
+  LibScopeView::ScopeTextPrinter Printer(Settings, InputFilePath);
+  Printer.setOutputCache(Options.CUCacheDirectory);
+  Printer.setOutputIndex(TextOutputIndex.get());
+  LibScopeView::SummaryTable Table(&Settings);
+
+  std::unique_ptr<LibScopeView::Reader> Reader =
+      createReader(InputFilePath, Options.CUCacheDirectory);
+  // With --processes or --cu-shard, each part is printed on its own, in a
+  // worker process which only sends its output back, or in a shard holding
+  // some of the parts. The header is printed with the first part, and the
+  // text output has no footer.
+  auto PrintIndependentPart = [&](const LibScopeView::ScopeRoot &Part,
+                                  size_t Index, std::ostream &PartOutput) {
+    if (Settings.SplitOutput)
+      Printer.print(&Part, Settings.OutputDirectory);
+    else if (!Settings.QuietMode && Options.CUHashes)
+      LibScopeView::printCompileUnitHashes(Part, Settings, PartOutput);
+    else if (!Settings.QuietMode)
+      Printer.printIndependentPart(&Part, PartOutput, Index == 0);
+  };
+  bool PrintedHeader = false;
+  if (OutputShard) {
+    size_t PartsPrinted = Reader->loadFileShard(
+        InputFilePath, Settings, Options.ShardIndex, Options.ShardCount,
+        Options.Processes, PrintIndependentPart, OutputStream,
+        OutputShardInfo);
+    OutputShardInfo.SettingsHash = Options.ShardSettingsHash;
+    // Only the first shard prints the header of a file without parts.
+    PrintedHeader = PartsPrinted != 0 || Options.ShardIndex != 0 ||
+                    OutputShardInfo.PartCount != 0;
+  } else if (Options.Processes > 1) {
+    PrintedHeader = Reader->loadFileInProcesses(
+                        InputFilePath, Settings, Options.Processes,
+                        PrintIndependentPart, OutputStream) != 0;
+  } else {
+    Reader->loadFileInParts(InputFilePath, Settings,
+                            [&](const LibScopeView::ScopeRoot &Part) {
+                              if (OutputPack)
+                                Printer.print(&Part, *OutputPack);
+                              else if (Settings.SplitOutput)
+                                Printer.print(&Part, Settings.OutputDirectory);
+                              else if (!Settings.QuietMode && Options.CUHashes)
+                                LibScopeView::printCompileUnitHashes(
+                                    Part, Settings, OutputStream);
+                              else if (!Settings.QuietMode)
+                                Printer.printPart(&Part, OutputStream);
+                              if (BatchSummary)
+                                BatchSummary->addObjects(Part);
+                              else if (Options.ShowSummary)
+                                Table.addObjects(Part);
+                            });
+  }
+
+  if (!Settings.SplitOutput && !OutputPack && !Settings.QuietMode &&
+      !Options.CUHashes && !PrintedHeader)
+    Printer.printEnd(OutputStream);
+  if (Settings.SplitOutput && !Options.ChangedFilesList.empty())
+    ChangedFiles.add(Printer);
+
+  // Print summary.
+  if (!BatchSummary && Options.ShowSummary) {
+    OutputStream << '\n';
+    Table.printSummaryTable(OutputStream);
+  }
+}
+
+/// \brief Count the objects of an input file one group of compile units at a
+/// time, and print only the summary table. The counts are added to
+/// \p BatchSummary if it is given, rather than printed. With --summary-sample
+/// the table is estimated from the groups drawn.
+void printSummaryOnly(const std::string &InputFilePath,
+                      const DivaOptions &Options, std::ostream &OutputStream,
+                      LibScopeView::SummaryTable *BatchSummary) {
+  LibScopeView::SummaryTable Table(&Options.PrintingSettings);
+  std::unique_ptr<LibScopeView::Reader> Reader =
+      createReader(InputFilePath, Options.CUCacheDirectory);
+  if (Options.SummarySample) {
+    std::unique_ptr<LibScopeView::SummaryEstimate> Estimate =
+        Reader->estimateObjectsInParts(
+            InputFilePath, Options.PrintingSettings, Options.Processes,
+            Options.SummarySample, Options.SampleSeed, Table);
+    if (Estimate) {
+      Estimate->printSummaryEstimate(OutputStream);
+      return;
+    }
+  } else {
+    Reader->countObjectsInParts(InputFilePath, Options.PrintingSettings,
+                                Options.Processes, Table);
+  }
+  if (BatchSummary)
+    BatchSummary->addTable(Table);
+  else
+    Table.printSummaryTable(OutputStream);
+}
+
+/// \brief Read and print an input file, into its output file if it has one.
+///
+/// Returns false if the output file can not be opened.
+bool processInputFile(const InputFile &Input, const DivaOptions &Options,
+                      std::ostream &OutputStream,
+                      LibScopeView::SummaryTable *BatchSummary) {
+  std::ofstream OutputFile;
+  if (!Input.OutputPath.empty() && !Options.PrintingSettings.SplitOutput &&
+      !OutputPack) {
+    std::string OutputPath = LibScopeView::unifyFilePath(Input.OutputPath);
+    LibScopeView::recursiveMakeDir(LibScopeView::getDirectoryName(OutputPath));
+    OutputFile.open(LibScopeView::nativeFilePath(OutputPath));
+    if (!OutputFile)
+      return false;
+  }
+  std::ostream &Output = OutputFile.is_open() ? OutputFile : OutputStream;
+
+  if (Options.SummaryOnly) {
+    printSummaryOnly(Input.Path, Options, Output, BatchSummary);
+    return true;
+  }
+  if (Options.Pipeline) {
+    readAndPrintInParts(Input.Path, Options, Output, BatchSummary);
+    return true;
+  }
+  auto Root = readInputFile(Input.Path, Options.PrintingSettings,
+                            Options.CUCacheDirectory);
+  if (!Options.SnapshotFile.empty())
+    LibScopeView::saveSnapshot(*Root, Options.PrintingSettings,
+                               Options.SnapshotFile);
+  printScopeView(*Root, Input.Path, Options, Output, BatchSummary);
+  return true;
+}
+
+/// \brief Split a line into arguments separated by white space. Double quotes
+/// group text that has white space into an argument, and a backslash before a
+/// double quote or backslash includes it as is.
+std::vector<std::string> splitCommandLine(const std::string &Line) {
+  std::vector<std::string> Args;
+  std::string Arg;
+  bool InArg = false;
+  bool InQuotes = false;
+  for (size_t Pos = 0; Pos < Line.size(); ++Pos) {
+    char C = Line[Pos];
+    if (C == '\\' && Pos + 1 < Line.size() &&
+        (Line[Pos + 1] == '"' || Line[Pos + 1] == '\\')) {
+      Arg.push_back(Line[++Pos]);
+      InArg = true;
+    } else if (C == '"') {
+      InQuotes = !InQuotes;
+      InArg = true;
+    } else if (!InQuotes && std::isspace(static_cast<unsigned char>(C))) {
+      if (InArg)
+        Args.push_back(Arg);
+      Arg.clear();
+      InArg = false;
+    } else {
+      Arg.push_back(C);
+      InArg = true;
+    }
+  }
+  if (InArg)
+    Args.push_back(Arg);
+  return Args;
+}
+
+/// \brief Read the input files listed in a --batch file, one per line, each
+/// optionally followed by the file to print its output into.
+void readBatchFile(const std::string &BatchFile,
+                   std::vector<InputFile> &Inputs) {
+  std::ifstream File;
+  if (BatchFile != "-") {
+    File.open(LibScopeView::nativeFilePath(BatchFile));
+    if (!File)
+      fatalError(LibScopeError::ErrorCode::ERR_FILE_NOT_FOUND, BatchFile);
+  }
+  std::istream &Input = File.is_open() ? File : std::cin;
+
+  std::string Line;
+  while (std::getline(Input, Line)) {
+    std::vector<std::string> Paths = splitCommandLine(Line);
+    if (Paths.empty())
+      continue;
+    if (Paths.size() > 2)
+      fatalError(LibScopeError::ErrorCode::ERR_INVALID_BATCH_LINE, Line,
+                 BatchFile);
+    Inputs.push_back({Paths[0], Paths.size() > 1 ? Paths[1] : ""});
   }
 }
 
+/// \brief Read and print the input files on several threads, each with its own
+/// string pool. The output of each file is buffered and printed in command
+/// line order, and at most Jobs files are being read or waiting to be printed.
+void processInputFilesConcurrently(const std::vector<InputFile> &Inputs,
+                                   const DivaOptions &Options, unsigned Jobs,
+                                   LibScopeView::SummaryTable *BatchSummary) {
+  struct BufferedOutput {
+    std::string Text;
+    bool IsReady = false;
+    bool IsValidFile = true;
+    bool IsOutputOpen = true;
+    // The error that ended the reading of the file, if any.
+    std::unique_ptr<LibScopeError::ExitException> Exit;
+  };
+  std::vector<BufferedOutput> Outputs(Inputs.size());
+  std::mutex Mutex;
+  std::condition_variable Changed;
+  size_t NextInput = 0;
+  size_t NextToPrint = 0;
+
+  auto processInputFiles = [&]() {
+    // An error is kept with the output of its file, and reported when that
+    // file's output is printed.
+    LibScopeError::ScopedExitAsException ExitAsException;
+
+    // The many small inputs of a batch share most of their strings, so each
+    // thread keeps its pool for them. Otherwise a pool is freed with its file.
+    LibScopeView::StringPool BatchPool;
+    std::unique_ptr<LibScopeView::SummaryTable> Summary;
+    if (BatchSummary)
+      Summary = std::make_unique<LibScopeView::SummaryTable>(
+          getSummarySettings(Options));
+
+    while (true) {
+      size_t Index;
+      {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        Changed.wait(Lock, [&]() {
+          return NextInput == Inputs.size() || NextInput < NextToPrint + Jobs;
+        });
+        if (NextInput == Inputs.size())
+          break;
+        Index = NextInput++;
+      }
+
+      // Invalid files are reported when their output would be printed.
+      const std::string &InputFilePath = Inputs[Index].Path;
+      bool IsValidFile = LibScopeView::doesFileExist(InputFilePath) &&
+                         (LibScopeView::isFileFormatElf(InputFilePath) ||
+                          LibScopeView::isFileFormatSnapshot(InputFilePath));
+      bool IsOutputOpen = true;
+      std::unique_ptr<LibScopeError::ExitException> Exit;
+      std::stringstream Output;
+      if (IsValidFile) {
+        LibScopeView::StringPool FilePool;
+        LibScopeView::ScopedStringPool UsePool(
+            Options.BatchFile.empty() ? FilePool : BatchPool);
+        try {
+          IsOutputOpen =
+              processInputFile(Inputs[Index], Options, Output, Summary.get());
+        } catch (const LibScopeError::ExitException &Error) {
+          Exit = std::make_unique<LibScopeError::ExitException>(Error);
+        }
+      }
+
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Outputs[Index].Text = Output.str();
+      Outputs[Index].IsValidFile = IsValidFile;
+      Outputs[Index].IsOutputOpen = IsOutputOpen;
+      Outputs[Index].Exit = std::move(Exit);
+      Outputs[Index].IsReady = true;
+      Changed.notify_all();
+    }
+
+    if (Summary) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      BatchSummary->addTable(*Summary);
+    }
+  };
+
+  std::vector<std::thread> Workers;
+  for (unsigned Job = 0; Job < Jobs; ++Job)
+    Workers.emplace_back(processInputFiles);
+
+  for (size_t Index = 0; Index < Inputs.size(); ++Index) {
+    BufferedOutput Output;
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Changed.wait(Lock, [&]() { return Outputs[Index].IsReady; });
+      Output = std::move(Outputs[Index]);
+    }
+    std::cout << Output.Text << std::flush;
+    if (!Output.IsValidFile) // Creating the reader reports the error.
+      createReader(Inputs[Index].Path, Options.CUCacheDirectory);
+    if (Output.Exit) {
+      fputs(Output.Exit->what(), stderr);
+      LibScopeError::exitProgram(Output.Exit->getExitCode());
+    }
+    if (!Output.IsOutputOpen)
+      fatalError(LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE,
+                 Inputs[Index].OutputPath);
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ++NextToPrint;
+    Changed.notify_all();
+  }
+
+  for (std::thread &Worker : Workers)
+    Worker.join();
+}
+
+/// \brief The trees of the input files read by the server. A tree is read
+/// again once its file changes, or for settings that change how it is read.
+class ScopeRootCache {
+public:
+  /// \brief Create the cache, keeping the compile units read in
+  /// CUCacheDirectory if not empty.
+  explicit ScopeRootCache(const std::string &CUCacheDirectory)
+      : CUCacheDirectory(CUCacheDirectory) {}
+
+  /// \brief Get the tree of an input file, reading it if needed.
+  LibScopeView::ScopeRoot &get(const std::string &InputFilePath,
+                               const LibScopeView::PrintSettings &Settings);
+
+private:
+  struct Entry {
+    uint64_t Size;
+    int64_t ModifiedTime;
+    bool ShowVoid;
+    LibScopeView::SortingKey SortKey;
+    bool ShareTypes;
+    // Each tree interns its strings in its own pool, freed with the tree.
+    std::unique_ptr<LibScopeView::StringPool> Pool;
+    std::unique_ptr<LibScopeView::ScopeRoot> Root;
+  };
+  // The trees of each file, by absolute path.
+  std::map<std::string, std::vector<Entry>> Entries;
+  std::string CUCacheDirectory;
+};
+
+LibScopeView::ScopeRoot &
+ScopeRootCache::get(const std::string &InputFilePath,
+                    const LibScopeView::PrintSettings &Settings) {
+  uint64_t Size;
+  int64_t ModifiedTime;
+  if (!LibScopeView::getFileStatus(InputFilePath, Size, ModifiedTime))
+    fatalError(LibScopeError::ErrorCode::ERR_FILE_NOT_FOUND, InputFilePath);
+
+  // Drop the trees read before the file changed.
+  std::vector<Entry> &FileEntries = Entries[LibScopeView::getAbsolutePath(
+      LibScopeView::unifyFilePath(InputFilePath))];
+  FileEntries.erase(std::remove_if(FileEntries.begin(), FileEntries.end(),
+                                   [&](const Entry &E) {
+                                     return E.Size != Size ||
+                                            E.ModifiedTime != ModifiedTime;
+                                   }),
+                    FileEntries.end());
+
+  auto Found = std::find_if(
+      FileEntries.begin(), FileEntries.end(), [&](const Entry &E) {
+        return E.ShowVoid == Settings.ShowVoid &&
+               E.SortKey == Settings.SortKey &&
+               E.ShareTypes == Settings.ShareTypes;
+      });
+  if (Found == FileEntries.end()) {
+    auto Pool = std::make_unique<LibScopeView::StringPool>();
+    LibScopeView::ScopedStringPool UsePool(*Pool);
+    auto Root = readInputFile(InputFilePath, Settings, CUCacheDirectory);
+    FileEntries.push_back({Size, ModifiedTime, Settings.ShowVoid,
+                           Settings.SortKey, Settings.ShareTypes,
+                           std::move(Pool), std::move(Root)});
+    Found = std::prev(FileEntries.end());
+  }
+
+  if (Settings.hasOnlyExactNameFilters() && !Found->Root->getNameIndex())
+    Found->Root->buildNameIndex();
+  return *Found->Root;
+}
+
+/// \brief Read diva command lines from stdin, one per line, and print the
+/// output of each after a "Result: <exit code> <size>" line giving the exit
+/// code diva would have returned and the size of the output in bytes.
+void serve(const DivaOptions &Options) {
+  ScopeRootCache Cache(Options.CUCacheDirectory);
+  for (const std::string &InputFilePath : Options.InputFiles)
+    Cache.get(InputFilePath, Options.PrintingSettings);
+
+  // Errors end the command line rather than the server.
+  LibScopeError::ScopedExitAsException ExitAsException;
+  std::string Line;
+  while (std::getline(std::cin, Line)) {
+    std::vector<std::string> Args = splitCommandLine(Line);
+    if (Args.empty())
+      continue;
+
+    std::stringstream Output;
+    int ExitCode = 0;
+    try {
+      const DivaOptions Request(Args, /*HelpOut*/ Output, /*VersionOut*/ Output,
+                                /*ErrOut*/ Output, /*Serving*/ true);
+      if (Request.Compare) {
+        const LibScopeView::ScopeRoot &Old =
+            Cache.get(Request.InputFiles[0], Request.PrintingSettings);
+        const LibScopeView::ScopeRoot &New =
+            Cache.get(Request.InputFiles[1], Request.PrintingSettings);
+        printComparison(Old, New, Request, Output);
+      } else {
+        for (const std::string &InputFilePath : Request.InputFiles) {
+          LibScopeView::ScopeRoot &Root =
+              Cache.get(InputFilePath, Request.PrintingSettings);
+          printScopeView(Root, InputFilePath, Request, Output);
+        }
+      }
+    } catch (const LibScopeError::ExitException &Exit) {
+      Output << Exit.what();
+      ExitCode = Exit.getExitCode();
+    }
+
+    const std::string Text = Output.str();
+    std::cout << "Result: " << ExitCode << ' ' << Text.size() << '\n'
+              << Text << std::flush;
+  }
+}
+
+/// \brief Print the file given to --unpack from each pack given as an input
+/// file, or list the files of each pack with the hashes of their contents.
+void unpack(const DivaOptions &Options) {
+  for (const std::string &PackPath : Options.InputFiles) {
+    LibScopeView::OutputPackReader Pack(PackPath);
+    if (Options.UnpackName.empty()) {
+      for (const LibScopeView::OutputPackEntry &Entry : Pack.getEntries())
+        std::cout << std::hex << std::setw(16) << std::setfill('0')
+                  << Entry.Hash << std::dec << std::setfill(' ') << "  "
+                  << Entry.Name << '\n';
+      continue;
+    }
+    LibScopeView::OutputPackEntry Entry;
+    if (!Pack.find(Options.UnpackName, Entry))
+      fatalError(LibScopeError::ErrorCode::ERR_PACK_ENTRY_NOT_FOUND,
+                 Options.UnpackName, PackPath);
+    const std::string Contents = Pack.read(Entry);
+    std::cout.write(Contents.data(),
+                    static_cast<std::streamsize>(Contents.size()));
+  }
+}
+
+/// \brief Print the output of the shards given as input files one after
+/// another, in the order of their indexes, after checking that they are all
+/// the shards printed from the same input file with the same options.
+void mergeShards(const DivaOptions &Options) {
+  std::vector<std::unique_ptr<LibScopeView::ShardReader>> Shards;
+  for (const std::string &ShardPath : Options.InputFiles)
+    Shards.push_back(std::make_unique<LibScopeView::ShardReader>(ShardPath));
+  std::stable_sort(Shards.begin(), Shards.end(),
+                   [](const std::unique_ptr<LibScopeView::ShardReader> &A,
+                      const std::unique_ptr<LibScopeView::ShardReader> &B) {
+                     return A->getInfo().Index < B->getInfo().Index;
+                   });
+  if (Shards.empty())
+    return;
+
+  const LibScopeView::ShardInfo &First = Shards.front()->getInfo();
+  for (size_t I = 1; I < Shards.size(); ++I) {
+    const LibScopeView::ShardInfo &Info = Shards[I]->getInfo();
+    const LibScopeView::ShardInfo &Previous = Shards[I - 1]->getInfo();
+    if (Info.Count != First.Count || Info.PartCount != First.PartCount ||
+        Info.PartsHash != First.PartsHash ||
+        Info.SettingsHash != First.SettingsHash)
+      fatalError(LibScopeError::ErrorCode::ERR_SHARD_MISMATCH,
+                 Shards[I]->getPath(), Shards.front()->getPath());
+    if (Info.Index == Previous.Index ||
+        (Info.Index == Previous.Index + 1 &&
+         Info.FirstPart != Previous.EndPart))
+      fatalError(LibScopeError::ErrorCode::ERR_SHARD_MISMATCH,
+                 Shards[I]->getPath(), Shards[I - 1]->getPath());
+  }
+  for (uint32_t Index = 0; Index < First.Count; ++Index)
+    if (Index >= Shards.size() || Shards[Index]->getInfo().Index != Index)
+      fatalError(LibScopeError::ErrorCode::ERR_SHARD_MISSING,
+                 std::to_string(Index) + '/' + std::to_string(First.Count));
+
+  for (const std::unique_ptr<LibScopeView::ShardReader> &Shard : Shards)
+    Shard->copyOutput(std::cout);
+}
+
 } // namespace
 
 int main(int argc, char *argv[]) {
@@ -122,12 +723,75 @@ int main(int argc, char *argv[]) {
                             /*VersionOut*/ std::cerr,
                             /*ErrOut*/ std::cerr);
 
+  // Gather the input files.
+  std::vector<InputFile> Inputs;
+  for (const std::string &InputFilePath : Options.InputFiles)
+    Inputs.push_back({InputFilePath, ""});
+  if (!Options.BatchFile.empty())
+    readBatchFile(Options.BatchFile, Inputs);
+
+  // A batch prints one summary table for all its input files.
+  std::unique_ptr<LibScopeView::SummaryTable> BatchSummary;
+  if (!Options.BatchFile.empty() &&
+      (Options.ShowSummary || Options.SummaryOnly))
+    BatchSummary = std::make_unique<LibScopeView::SummaryTable>(
+        getSummarySettings(Options));
+
   // Load and print each input file.
-  for (const std::string &InputFilePath : Options.InputFiles) {
-    auto Root = readInputFile(InputFilePath, Options.PrintingSettings);
-    printScopeView(*Root, InputFilePath, Options);
+  unsigned Jobs =
+      Options.Jobs ? Options.Jobs : std::thread::hardware_concurrency();
+  Jobs = std::min<size_t>(std::max(Jobs, 1U), Inputs.size());
+  if (!Options.OutputPackFile.empty())
+    OutputPack = std::make_unique<LibScopeView::OutputPackWriter>(
+        Options.OutputPackFile);
+  // The positions in the index are those of the text printed to its stream,
+  // so the input files are printed to it one at a time.
+  if (!Options.OutputIndexFile.empty()) {
+    TextOutputIndex = std::make_unique<LibScopeView::OutputIndex>(
+        std::cout, Options.OutputIndexFile);
+    Jobs = 1;
+  }
+  if (Options.ShardCount)
+    OutputShard =
+        std::make_unique<LibScopeView::ShardWriter>(Options.ShardFile);
+  std::ostream &Output = TextOutputIndex ? TextOutputIndex->getStream()
+                         : OutputShard   ? OutputShard->getStream()
+                                         : std::cout;
+  if (Options.Serve) {
+    serve(Options);
+  } else if (Options.Unpack) {
+    unpack(Options);
+  } else if (Options.MergeShards) {
+    mergeShards(Options);
+  } else if (Options.Compare) {
+    auto Old = readInputFile(Options.InputFiles[0], Options.PrintingSettings,
+                             Options.CUCacheDirectory);
+    auto New = readInputFile(Options.InputFiles[1], Options.PrintingSettings,
+                             Options.CUCacheDirectory);
+    printComparison(*Old, *New, Options, std::cout);
+  } else if (Jobs > 1) {
+    processInputFilesConcurrently(Inputs, Options, Jobs, BatchSummary.get());
+  } else {
+    for (const InputFile &Input : Inputs)
+      if (!processInputFile(Input, Options, Output, BatchSummary.get()))
+        fatalError(LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE,
+                   Input.OutputPath);
+  }
+
+  if (BatchSummary) {
+    std::cout << '\n';
+    BatchSummary->printSummaryTable(std::cout);
   }
 
+  if (!Options.ChangedFilesList.empty())
+    ChangedFiles.write(Options.ChangedFilesList);
+  if (OutputPack)
+    OutputPack->finish();
+  if (TextOutputIndex)
+    TextOutputIndex->finish();
+  if (OutputShard)
+    OutputShard->finish(OutputShardInfo);
+
   // Library termination.
   LibScopeView::terminate();
 
@@ -135,6 +799,10 @@ int main(int argc, char *argv[]) {
   if (Options.ShowPerformanceTime) {
     auto EndTime = LibScopeView::getCurrentTime();
     LibScopeView::printTimeTaken(StartTime, EndTime);
+    const auto &CacheStatistics = LibScopeView::getFilterCacheStatistics();
+    if (CacheStatistics.Lookups)
+      LibScopeView::printFilterCacheHitRate(CacheStatistics.Hits,
+                                            CacheStatistics.Lookups);
   }
   if (Options.ShowPerformanceMemory) {
     LibScopeView::printMemoryUsage(LibScopeView::getPeakMemoryUsage());
@@ -0,0 +1,575 @@
+//===-- ElfDwarfReader/CompileUnitCache.cpp ---------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements the cache of the compile units read by the
+/// DwarfReader.
+///
+//===----------------------------------------------------------------------===//
+
+#include "CompileUnitCache.h"
+#include "FileUtilities.h"
+#include "Scope.h"
+#include "ScopeHash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace ElfDwarfReader;
+
+namespace {
+
+// Changed whenever the DwarfReader creates different objects from the same
+// DWARF, or the layout of an entry changes.
+const char CacheVersion[] = "diva-cu-cache-1";
+
+// The DWARF sections a compile unit is read from.
+const char *const DwarfSections[] = {".debug_info", ".debug_abbrev",
+                                     ".debug_str", ".debug_line",
+                                     ".debug_line_str"};
+
+// ELF values used to find the sections.
+const uint16_t ElfTypeExecutable = 2;
+const uint16_t ElfTypeShared = 3;
+const uint32_t ElfSectionNoBits = 8;
+const uint64_t ElfSectionCompressed = 0x800;
+
+// DWARF 5 forms not in dwarf.h.
+const uint64_t FormAddrx1 = 0x29;
+const uint64_t FormAddrx4 = 0x2c;
+
+/// \brief Thrown when a file or compile unit cannot be cached.
+struct Uncacheable {};
+
+/// \brief Reads the values in the contents of a section, in the byte order
+/// of the file.
+class DataCursor {
+public:
+  DataCursor(const std::string &Data, bool IsBigEndian, uint64_t Pos = 0)
+      : Data(Data), IsBigEndian(IsBigEndian), Pos(Pos), End(Data.size()) {
+    if (Pos > End)
+      throw Uncacheable();
+  }
+
+  size_t getPos() const { return Pos; }
+  bool atEnd() const { return Pos == End; }
+
+  /// \brief Stop reading at NewEnd, which must not be past the current end.
+  void setEnd(uint64_t NewEnd) {
+    if (NewEnd < Pos || NewEnd > End)
+      throw Uncacheable();
+    End = NewEnd;
+  }
+
+  void skip(uint64_t Size) {
+    if (End - Pos < Size)
+      throw Uncacheable();
+    Pos += Size;
+  }
+
+  uint64_t readUnsigned(size_t Size) {
+    if (End - Pos < Size)
+      throw Uncacheable();
+    uint64_t Value = 0;
+    for (size_t I = 0; I < Size; ++I) {
+      size_t Byte = IsBigEndian ? I : Size - 1 - I;
+      Value = (Value << 8) | static_cast<unsigned char>(Data[Pos + Byte]);
+    }
+    Pos += Size;
+    return Value;
+  }
+
+  uint64_t readULEB128() {
+    uint64_t Value = 0;
+    for (unsigned Shift = 0;; Shift += 7) {
+      uint64_t Byte = readUnsigned(1);
+      if (Shift < 64)
+        Value |= (Byte & 0x7f) << Shift;
+      if (!(Byte & 0x80))
+        return Value;
+    }
+  }
+
+  void skipLEB128() {
+    while (readUnsigned(1) & 0x80)
+      ;
+  }
+
+  void skipString() {
+    const char *Begin = Data.data() + Pos;
+    const void *Nul = std::memchr(Begin, 0, End - Pos);
+    if (!Nul)
+      throw Uncacheable();
+    Pos += static_cast<const char *>(Nul) - Begin + 1;
+  }
+
+  /// \brief Read the length of a unit, and whether it is in the 64-bit DWARF
+  /// format.
+  uint64_t readUnitLength(bool &IsDwarf64) {
+    uint64_t Length = readUnsigned(4);
+    IsDwarf64 = Length == 0xffffffff;
+    if (IsDwarf64)
+      return readUnsigned(8);
+    if (Length >= 0xfffffff0)
+      throw Uncacheable();
+    return Length;
+  }
+
+private:
+  const std::string &Data;
+  bool IsBigEndian;
+  size_t Pos;
+  size_t End;
+};
+
+/// \brief The sizes of the values in a unit.
+struct UnitFormat {
+  uint64_t Version;
+  uint64_t AddressSize;
+  bool IsDwarf64;
+
+  size_t getOffsetSize() const { return IsDwarf64 ? 8 : 4; }
+};
+
+/// \brief Hashes the DWARF a compile unit is read from.
+class CompileUnitHasher {
+public:
+  CompileUnitHasher(
+      const std::unordered_map<std::string, std::string> &Sections,
+      bool IsBigEndian, LibScopeView::HashBuilder &Hash)
+      : Sections(Sections), IsBigEndian(IsBigEndian), Hash(Hash) {}
+
+  /// \brief Hash the compile unit whose header is at HeaderOffset.
+  void hashCompileUnit(uint64_t HeaderOffset, uint64_t EndOffset);
+
+private:
+  const std::string &getSection(const char *Name) const;
+  void hashString(const char *SectionName, uint64_t Offset);
+  void readAbbreviations(uint64_t Offset);
+  uint64_t readForm(DataCursor &Cursor, uint64_t Form,
+                    const UnitFormat &Format);
+  void hashLineProgram(uint64_t Offset);
+
+  const std::unordered_map<std::string, std::string> &Sections;
+  bool IsBigEndian;
+  LibScopeView::HashBuilder &Hash;
+
+  // The attributes and forms of each abbreviation, by code.
+  std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, uint64_t>>>
+      Abbreviations;
+};
+
+const std::string &CompileUnitHasher::getSection(const char *Name) const {
+  static const std::string Missing;
+  auto Found = Sections.find(Name);
+  return Found == Sections.end() ? Missing : Found->second;
+}
+
+void CompileUnitHasher::hashString(const char *SectionName, uint64_t Offset) {
+  const std::string &Section = getSection(SectionName);
+  DataCursor Cursor(Section, IsBigEndian, Offset);
+  Cursor.skipString();
+  Hash.add(Section.data() + Offset, Cursor.getPos() - Offset - 1);
+}
+
+void CompileUnitHasher::readAbbreviations(uint64_t Offset) {
+  const std::string &Section = getSection(".debug_abbrev");
+  DataCursor Cursor(Section, IsBigEndian, Offset);
+  while (uint64_t Code = Cursor.readULEB128()) {
+    auto &Attributes = Abbreviations[Code];
+    Cursor.readULEB128(); // Tag.
+    Cursor.skip(1);       // Children.
+    for (;;) {
+      uint64_t Attribute = Cursor.readULEB128();
+      uint64_t Form = Cursor.readULEB128();
+      if (!Attribute && !Form)
+        break;
+      // The value is in the abbreviation, which is hashed.
+      if (Form == DW_FORM_implicit_const)
+        Cursor.skipLEB128();
+      Attributes.emplace_back(Attribute, Form);
+    }
+  }
+  Hash.add(Section.data() + Offset, Cursor.getPos() - Offset);
+}
+
+uint64_t CompileUnitHasher::readForm(DataCursor &Cursor, uint64_t Form,
+                                     const UnitFormat &Format) {
+  switch (Form) {
+  case DW_FORM_addr:
+    return Cursor.readUnsigned(Format.AddressSize);
+  case DW_FORM_data1:
+  case DW_FORM_ref1:
+  case DW_FORM_flag:
+    return Cursor.readUnsigned(1);
+  case DW_FORM_data2:
+  case DW_FORM_ref2:
+    return Cursor.readUnsigned(2);
+  case DW_FORM_data4:
+  case DW_FORM_ref4:
+    return Cursor.readUnsigned(4);
+  case DW_FORM_data8:
+  case DW_FORM_ref8:
+    return Cursor.readUnsigned(8);
+  case DW_FORM_udata:
+  case DW_FORM_ref_udata:
+    return Cursor.readULEB128();
+  case DW_FORM_ref_addr:
+    return Cursor.readUnsigned(Format.Version <= 2 ? Format.AddressSize
+                                                   : Format.getOffsetSize());
+  case DW_FORM_sec_offset:
+    return Cursor.readUnsigned(Format.getOffsetSize());
+  case DW_FORM_strp: {
+    uint64_t Offset = Cursor.readUnsigned(Format.getOffsetSize());
+    hashString(".debug_str", Offset);
+    return Offset;
+  }
+  case DW_FORM_line_strp: {
+    uint64_t Offset = Cursor.readUnsigned(Format.getOffsetSize());
+    hashString(".debug_line_str", Offset);
+    return Offset;
+  }
+  case DW_FORM_sdata:
+    Cursor.skipLEB128();
+    return 0;
+  case DW_FORM_data16:
+    Cursor.skip(16);
+    return 0;
+  case DW_FORM_string:
+    Cursor.skipString();
+    return 0;
+  case DW_FORM_block1:
+    Cursor.skip(Cursor.readUnsigned(1));
+    return 0;
+  case DW_FORM_block2:
+    Cursor.skip(Cursor.readUnsigned(2));
+    return 0;
+  case DW_FORM_block4:
+    Cursor.skip(Cursor.readUnsigned(4));
+    return 0;
+  case DW_FORM_block:
+  case DW_FORM_exprloc:
+    Cursor.skip(Cursor.readULEB128());
+    return 0;
+  case DW_FORM_flag_present:
+  case DW_FORM_implicit_const:
+    return 0;
+  // The addresses and lists are not read by the DwarfReader.
+  case DW_FORM_addrx:
+  case DW_FORM_loclistx:
+  case DW_FORM_rnglistx:
+  case DW_FORM_GNU_addr_index:
+    Cursor.readULEB128();
+    return 0;
+  case DW_FORM_indirect:
+    return readForm(Cursor, Cursor.readULEB128(), Format);
+  default:
+    if (Form >= FormAddrx1 && Form <= FormAddrx4) {
+      Cursor.skip(Form - FormAddrx1 + 1);
+      return 0;
+    }
+    // String offsets tables, type signatures, supplementary files and unknown
+    // forms are not hashed.
+    throw Uncacheable();
+  }
+}
+
+void CompileUnitHasher::hashLineProgram(uint64_t Offset) {
+  const std::string &Section = getSection(".debug_line");
+  DataCursor Cursor(Section, IsBigEndian, Offset);
+  UnitFormat Format;
+  uint64_t Length = Cursor.readUnitLength(Format.IsDwarf64);
+  Cursor.setEnd(Cursor.getPos() + Length);
+  Hash.add(Section.data() + Offset, Cursor.getPos() + Length - Offset);
+
+  // Before DWARF 5, the directories and files are in the line program.
+  Format.Version = Cursor.readUnsigned(2);
+  if (Format.Version < 5)
+    return;
+  if (Format.Version > 5)
+    throw Uncacheable();
+  Format.AddressSize = Cursor.readUnsigned(1);
+  Cursor.skip(1);                         // Segment selector size.
+  Cursor.skip(Format.getOffsetSize() + 5); // Header length to line range.
+  Cursor.skip(Cursor.readUnsigned(1) - 1); // Standard opcode lengths.
+
+  // The directories, then the files.
+  for (int Table = 0; Table < 2; ++Table) {
+    std::vector<uint64_t> Forms(Cursor.readUnsigned(1));
+    for (uint64_t &Form : Forms) {
+      Cursor.readULEB128(); // Content type.
+      Form = Cursor.readULEB128();
+    }
+    for (uint64_t Count = Cursor.readULEB128(); Count; --Count)
+      for (uint64_t Form : Forms)
+        readForm(Cursor, Form, Format);
+  }
+}
+
+void CompileUnitHasher::hashCompileUnit(uint64_t HeaderOffset,
+                                        uint64_t EndOffset) {
+  Hash.add(CacheVersion);
+  Hash.add(static_cast<uint64_t>(IsBigEndian));
+
+  const std::string &Section = getSection(".debug_info");
+  DataCursor Cursor(Section, IsBigEndian, HeaderOffset);
+  UnitFormat Format;
+  uint64_t Length = Cursor.readUnitLength(Format.IsDwarf64);
+  if (Cursor.getPos() + Length != EndOffset)
+    throw Uncacheable();
+  Cursor.setEnd(EndOffset);
+  Hash.add(Section.data() + HeaderOffset, EndOffset - HeaderOffset);
+
+  Format.Version = Cursor.readUnsigned(2);
+  if (Format.Version < 2 || Format.Version > 5)
+    throw Uncacheable();
+  uint64_t AbbreviationOffset;
+  if (Format.Version == 5) {
+    uint64_t UnitType = Cursor.readUnsigned(1);
+    if (UnitType != DW_UT_compile && UnitType != DW_UT_partial)
+      throw Uncacheable();
+    Format.AddressSize = Cursor.readUnsigned(1);
+    AbbreviationOffset = Cursor.readUnsigned(Format.getOffsetSize());
+  } else {
+    AbbreviationOffset = Cursor.readUnsigned(Format.getOffsetSize());
+    Format.AddressSize = Cursor.readUnsigned(1);
+  }
+  readAbbreviations(AbbreviationOffset);
+
+  // Hash the strings used by the DIEs, and find the line program of the
+  // compile unit, which is the first DIE.
+  bool IsUnitDie = true;
+  bool HasLineProgram = false;
+  uint64_t LineProgramOffset = 0;
+  while (!Cursor.atEnd()) {
+    uint64_t Code = Cursor.readULEB128();
+    if (!Code)
+      continue;
+    auto Found = Abbreviations.find(Code);
+    if (Found == Abbreviations.end())
+      throw Uncacheable();
+    for (const auto &Attribute : Found->second) {
+      uint64_t Value = readForm(Cursor, Attribute.second, Format);
+      if (IsUnitDie && Attribute.first == DW_AT_stmt_list) {
+        HasLineProgram = true;
+        LineProgramOffset = Value;
+      }
+    }
+    IsUnitDie = false;
+  }
+
+  if (HasLineProgram)
+    hashLineProgram(LineProgramOffset);
+}
+
+/// \brief Read Size bytes at Offset in File, whose size is FileSize.
+std::string readFileBytes(std::ifstream &File, uint64_t FileSize,
+                          uint64_t Offset, uint64_t Size) {
+  if (Offset > FileSize || FileSize - Offset < Size)
+    throw Uncacheable();
+  std::string Bytes(static_cast<size_t>(Size), '\0');
+  File.seekg(static_cast<std::streamoff>(Offset));
+  File.read(&Bytes[0], static_cast<std::streamsize>(Size));
+  if (!File)
+    throw Uncacheable();
+  return Bytes;
+}
+
+/// \brief Read the DWARF sections of an ELF executable or shared library.
+void readDwarfSections(const std::string &FileName,
+                       std::unordered_map<std::string, std::string> &Sections,
+                       bool &IsBigEndian) {
+  std::ifstream File(
+      LibScopeView::nativeFilePath(LibScopeView::unifyFilePath(FileName)),
+      std::ios::binary | std::ios::ate);
+  std::streamoff FileSize = File.tellg();
+  if (FileSize < 0)
+    throw Uncacheable();
+
+  std::string Identification = readFileBytes(File, FileSize, 0, 16);
+  if (Identification.compare(0, 4, "\x7f" "ELF") != 0)
+    throw Uncacheable();
+  bool Is64 = Identification[4] == 2;
+  IsBigEndian = Identification[5] == 2;
+  size_t AddressSize = Is64 ? 8 : 4;
+
+  std::string Header = readFileBytes(File, FileSize, 0, Is64 ? 64 : 52);
+  DataCursor HeaderCursor(Header, IsBigEndian, 16);
+  uint64_t Type = HeaderCursor.readUnsigned(2);
+  if (Type != ElfTypeExecutable && Type != ElfTypeShared)
+    throw Uncacheable();
+  HeaderCursor.skip(6 + 2 * AddressSize); // Machine to program headers.
+  uint64_t SectionHeadersOffset = HeaderCursor.readUnsigned(AddressSize);
+  HeaderCursor.skip(10); // Flags to program header count.
+  uint64_t SectionHeaderSize = HeaderCursor.readUnsigned(2);
+  uint64_t SectionCount = HeaderCursor.readUnsigned(2);
+  uint64_t NamesIndex = HeaderCursor.readUnsigned(2);
+  if (SectionHeaderSize < (Is64 ? 64 : 40) || NamesIndex >= SectionCount)
+    throw Uncacheable();
+
+  struct SectionHeader {
+    uint64_t Name;
+    uint64_t Type;
+    uint64_t Flags;
+    uint64_t Offset;
+    uint64_t Size;
+  };
+  std::string HeaderBytes =
+      readFileBytes(File, FileSize, SectionHeadersOffset,
+                    SectionCount * SectionHeaderSize);
+  std::vector<SectionHeader> Headers;
+  for (uint64_t Index = 0; Index < SectionCount; ++Index) {
+    DataCursor Cursor(HeaderBytes, IsBigEndian, Index * SectionHeaderSize);
+    SectionHeader Section;
+    Section.Name = Cursor.readUnsigned(4);
+    Section.Type = Cursor.readUnsigned(4);
+    Section.Flags = Cursor.readUnsigned(AddressSize);
+    Cursor.skip(AddressSize); // Address.
+    Section.Offset = Cursor.readUnsigned(AddressSize);
+    Section.Size = Cursor.readUnsigned(AddressSize);
+    Headers.push_back(Section);
+  }
+
+  const SectionHeader &NamesHeader = Headers[NamesIndex];
+  std::string Names = readFileBytes(File, FileSize, NamesHeader.Offset,
+                                    NamesHeader.Size);
+  for (const SectionHeader &Section : Headers) {
+    if (Section.Name >= Names.size())
+      continue;
+    const char *Name = Names.c_str() + Section.Name;
+    if (std::find_if(std::begin(DwarfSections), std::end(DwarfSections),
+                     [&](const char *DwarfSection) {
+                       return std::strcmp(Name, DwarfSection) == 0;
+                     }) == std::end(DwarfSections))
+      continue;
+    if (Section.Flags & ElfSectionCompressed)
+      throw Uncacheable();
+    Sections[Name] = Section.Type == ElfSectionNoBits
+                         ? std::string()
+                         : readFileBytes(File, FileSize, Section.Offset,
+                                         Section.Size);
+  }
+}
+
+} // end anonymous namespace
+
+CompileUnitCache::CompileUnitCache(const std::string &Directory,
+                                   const std::string &FileName)
+    : Directory(LibScopeView::unifyFilePath(Directory)) {
+  try {
+    readDwarfSections(FileName, Sections, IsBigEndian);
+  } catch (const Uncacheable &) {
+    Sections.clear();
+  }
+}
+
+std::string CompileUnitCache::getEntryPath(Dwarf_Off HeaderOffset,
+                                           Dwarf_Off EndOffset) {
+  if (Sections.empty())
+    return std::string();
+
+  LibScopeView::HashBuilder Hash;
+  try {
+    CompileUnitHasher(Sections, IsBigEndian, Hash)
+        .hashCompileUnit(HeaderOffset, EndOffset);
+  } catch (const Uncacheable &) {
+    return std::string();
+  }
+
+  std::ostringstream Path;
+  Path << Directory << '/' << std::hex << std::setw(16) << std::setfill('0')
+       << Hash.get() << '-' << std::dec << (EndOffset - HeaderOffset)
+       << ".cu";
+  return Path.str();
+}
+
+std::unique_ptr<LibScopeView::ScopeCompileUnit> CompileUnitCache::load(
+    Dwarf_Off HeaderOffset, Dwarf_Off EndOffset,
+    std::vector<CompileUnitWarning> &Warnings,
+    const LibScopeView::ExternalReferenceCallback &AddReference) {
+  const std::string &Path = EntryPaths[HeaderOffset] =
+      getEntryPath(HeaderOffset, EndOffset);
+  if (Path.empty())
+    return nullptr;
+
+  std::string Entry;
+  if (!LibScopeView::readFileContents(Path, Entry))
+    return nullptr;
+
+  // The warnings, followed by the compile unit.
+  uint32_t WarningCount;
+  const size_t WarningSize = 1 + 2 * sizeof(Dwarf_Half);
+  if (Entry.size() < sizeof(WarningCount))
+    return nullptr;
+  std::memcpy(&WarningCount, Entry.data(), sizeof(WarningCount));
+  size_t Pos = sizeof(WarningCount);
+  if ((Entry.size() - Pos) / WarningSize < WarningCount)
+    return nullptr;
+  std::vector<CompileUnitWarning> EntryWarnings(WarningCount);
+  for (CompileUnitWarning &Warning : EntryWarnings) {
+    Warning.IsUnknownTag = Entry[Pos] != 0;
+    std::memcpy(&Warning.Code, Entry.data() + Pos + 1, sizeof(Dwarf_Half));
+    std::memcpy(&Warning.Form, Entry.data() + Pos + 1 + sizeof(Dwarf_Half),
+                sizeof(Dwarf_Half));
+    Pos += WarningSize;
+  }
+
+  std::unique_ptr<LibScopeView::ScopeCompileUnit> CU =
+      LibScopeView::loadCompileUnit(Entry.data() + Pos, Entry.size() - Pos,
+                                    HeaderOffset, AddReference);
+  if (CU)
+    Warnings = std::move(EntryWarnings);
+  return CU;
+}
+
+void CompileUnitCache::save(Dwarf_Off HeaderOffset,
+                            const LibScopeView::ScopeCompileUnit &CU,
+                            const std::vector<CompileUnitWarning> &Warnings) {
+  auto Found = EntryPaths.find(HeaderOffset);
+  if (Found == EntryPaths.end() || Found->second.empty())
+    return;
+  const std::string &Path = Found->second;
+
+  std::string Entry;
+  auto WarningCount = static_cast<uint32_t>(Warnings.size());
+  Entry.append(reinterpret_cast<const char *>(&WarningCount),
+               sizeof(WarningCount));
+  for (const CompileUnitWarning &Warning : Warnings) {
+    Entry.push_back(Warning.IsUnknownTag ? 1 : 0);
+    Entry.append(reinterpret_cast<const char *>(&Warning.Code),
+                 sizeof(Dwarf_Half));
+    Entry.append(reinterpret_cast<const char *>(&Warning.Form),
+                 sizeof(Dwarf_Half));
+  }
+  Entry += LibScopeView::saveCompileUnit(CU, HeaderOffset);
+
+  // The entry is moved into place once written, so that no run sharing the
+  // cache loads a partly written entry. The cache is only an aid, so an entry
+  // that cannot be written is left out.
+  LibScopeView::recursiveMakeDir(Directory);
+  LibScopeView::replaceFileContents(Path, Entry);
+}
@@ -0,0 +1,108 @@
+//===-- ElfDwarfReader/CompileUnitCache.h -----------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the cache of the compile units read by the
+/// DwarfReader, kept in a directory between runs.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef ELF_DWARF_READER_COMPILE_UNIT_CACHE_H
+#define ELF_DWARF_READER_COMPILE_UNIT_CACHE_H
+
+#include "Snapshot.h"
+
+#include "dwarf.h"
+#include "libdwarf.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ElfDwarfReader {
+
+/// \brief A warning given once per file while reading a compile unit, given
+/// again when the compile unit is loaded from the cache.
+struct CompileUnitWarning {
+  // An unknown tag Code, or an unrecognised attribute Code with form Form.
+  bool IsUnknownTag;
+  Dwarf_Half Code;
+  Dwarf_Half Form;
+
+  bool operator==(const CompileUnitWarning &Other) const {
+    return IsUnknownTag == Other.IsUnknownTag && Code == Other.Code &&
+           Form == Other.Form;
+  }
+};
+
+/// \brief The compile units read from the DWARF of a file, kept in a
+/// directory so that those whose DWARF did not change since an earlier run
+/// are loaded rather than read again.
+///
+/// Each entry is named after a hash of the DWARF a compile unit was read
+/// from: its DIEs, its abbreviations, the strings they use and its line
+/// program. Compile units that use data the hash does not cover, such as
+/// string offsets tables, type units or supplementary files, are not cached,
+/// nor are relocatable objects, whose DWARF is completed by relocations.
+class CompileUnitCache {
+public:
+  /// \brief Open the cache in Directory for the DWARF of the ELF file
+  /// FileName. Nothing is cached if FileName cannot be cached.
+  CompileUnitCache(const std::string &Directory, const std::string &FileName);
+
+  /// \brief Load the compile unit whose header is at HeaderOffset and whose
+  /// DWARF ends at EndOffset, or return null if it is not in the cache.
+  ///
+  /// Warnings is set to the warnings given while reading it, and AddReference
+  /// is given its references to objects in other compile units.
+  std::unique_ptr<LibScopeView::ScopeCompileUnit>
+  load(Dwarf_Off HeaderOffset, Dwarf_Off EndOffset,
+       std::vector<CompileUnitWarning> &Warnings,
+       const LibScopeView::ExternalReferenceCallback &AddReference);
+
+  /// \brief Save a compile unit read from the DWARF whose header is at
+  /// HeaderOffset, along with the warnings given while reading it.
+  void save(Dwarf_Off HeaderOffset, const LibScopeView::ScopeCompileUnit &CU,
+            const std::vector<CompileUnitWarning> &Warnings);
+
+private:
+  /// \brief Get the path of the entry of a compile unit, or an empty string
+  /// if it cannot be cached.
+  std::string getEntryPath(Dwarf_Off HeaderOffset, Dwarf_Off EndOffset);
+
+  std::string Directory;
+
+  // The contents of the DWARF sections of the file, by name. Empty if the
+  // file cannot be cached.
+  std::unordered_map<std::string, std::string> Sections;
+  bool IsBigEndian = false;
+
+  // The path of the entry of each compile unit loaded, by header offset.
+  std::unordered_map<Dwarf_Off, std::string> EntryPaths;
+};
+
+} // end namespace ElfDwarfReader
+
+#endif // ELF_DWARF_READER_COMPILE_UNIT_CACHE_H
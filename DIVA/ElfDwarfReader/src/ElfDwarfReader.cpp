@@ -36,6 +36,7 @@
 #include "Symbol.h"
 #include "Type.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -114,17 +115,92 @@ void writeStringOrHex(std::ostream &Out, const std::string Str,
     Out << Str;
 }
 
+// The attributes that make one object reference another.
+const Dwarf_Half ReferenceAttrs[] = {DW_AT_type, DW_AT_import,
+                                     DW_AT_specification, DW_AT_abstract_origin,
+                                     DW_AT_extension};
+
+// Record the references from Die and its children to other compile units,
+// where CUIndex is the index of the compile unit holding Die and CUOffsets
+// holds the offset of each compile unit. LinkEnds[I] is raised to the index
+// of the last compile unit linked to the compile unit I by a reference.
+void findCrossCULinks(const DwarfDie &Die, size_t CUIndex,
+                      const std::vector<Dwarf_Off> &CUOffsets,
+                      std::vector<size_t> &LinkEnds) {
+  for (Dwarf_Half Attr : ReferenceAttrs) {
+    DwarfAttrValue Value(Die.getAttr(Attr));
+    // Only DW_FORM_ref_addr can reference another compile unit.
+    if (Value.getKind() != DwarfAttrValueKind::Reference ||
+        Value.getForm() != DW_FORM_ref_addr)
+      continue;
+
+    auto Next = std::upper_bound(CUOffsets.begin(), CUOffsets.end(),
+                                 Value.getReference());
+    if (Next == CUOffsets.begin())
+      continue;
+    size_t TargetIndex = static_cast<size_t>(Next - CUOffsets.begin()) - 1;
+    size_t First = std::min(CUIndex, TargetIndex);
+    LinkEnds[First] = std::max(LinkEnds[First], std::max(CUIndex, TargetIndex));
+  }
+
+  for (auto IT = Die.childrenBegin(), End = Die.childrenEnd(); IT != End; ++IT)
+    findCrossCULinks(*IT, CUIndex, CUOffsets, LinkEnds);
+}
+
+// Split the compile units into consecutive groups that don't reference each
+// other, returning the index one past the end of each group.
+std::vector<size_t>
+findIndependentCUGroups(const std::vector<DwarfCompileUnit> &CUs) {
+  std::vector<Dwarf_Off> CUOffsets;
+  std::vector<size_t> LinkEnds;
+  for (size_t Index = 0; Index < CUs.size(); ++Index) {
+    CUOffsets.push_back(CUs[Index].HeaderOffset);
+    LinkEnds.push_back(Index);
+  }
+  for (size_t Index = 0; Index < CUs.size(); ++Index)
+    findCrossCULinks(CUs[Index].CUDie, Index, CUOffsets, LinkEnds);
+
+  std::vector<size_t> GroupEnds;
+  size_t GroupLast = 0;
+  for (size_t Index = 0; Index < CUs.size(); ++Index) {
+    GroupLast = std::max(GroupLast, LinkEnds[Index]);
+    if (GroupLast == Index)
+      GroupEnds.push_back(Index + 1);
+  }
+  return GroupEnds;
+}
+
 } // end anonymous namespace
 
+struct DwarfReader::PartFile {
+  explicit PartFile(const std::string &FileName)
+      : FD(FileName), DebugData(FD.get()),
+        CUs(DebugData.getCompileUnits()) {}
+
+  LibScopeView::FileDescriptor FD;
+  DwarfDebugData DebugData;
+  std::vector<DwarfCompileUnit> CUs;
+};
+
+DwarfReader::DwarfReader() = default;
+
+DwarfReader::DwarfReader(const std::string &CacheDirectory)
+    : CacheDirectory(CacheDirectory) {}
+
+DwarfReader::~DwarfReader() = default;
+
 std::unique_ptr<LibScopeView::ScopeRoot>
 DwarfReader::createScopes(const std::string &FileName) {
   auto Root = std::make_unique<LibScopeView::ScopeRoot>();
   Root->setName(FileName.c_str());
 
   LibScopeView::FileDescriptor FD(FileName);
+  if (!CacheDirectory.empty())
+    Cache = std::make_unique<CompileUnitCache>(CacheDirectory, FileName);
   try {
     const DwarfDebugData DebugData(FD.get());
-    createCompileUnits(DebugData, *Root);
+    const auto CUs = DebugData.getCompileUnits();
+    createCompileUnits(DebugData, CUs.data(), CUs.data() + CUs.size(), *Root);
   } catch (LibDwarfError &Err) {
 #ifndef NDEBUG
     std::cerr << Err.getErrorMessage();
@@ -141,15 +217,147 @@ DwarfReader::createScopes(const std::string &FileName) {
   return Root;
 }
 
+void DwarfReader::createScopesInParts(const std::string &FileName,
+                                      const CreatedPartCallback &AddPart) {
+  LibScopeView::FileDescriptor FD(FileName);
+  if (!CacheDirectory.empty())
+    Cache = std::make_unique<CompileUnitCache>(CacheDirectory, FileName);
+  bool FoundCompileUnits = false;
+  try {
+    const DwarfDebugData DebugData(FD.get());
+    const auto CUs = DebugData.getCompileUnits();
+    FoundCompileUnits = !CUs.empty();
+
+    size_t GroupBegin = 0;
+    for (size_t GroupEnd : findIndependentCUGroups(CUs)) {
+      auto Root = std::make_unique<LibScopeView::ScopeRoot>();
+      Root->setName(FileName.c_str());
+      createCompileUnits(DebugData, CUs.data() + GroupBegin,
+                         CUs.data() + GroupEnd, *Root);
+      GroupBegin = GroupEnd;
+
+      // The objects of the group are freed once used, and no other group
+      // references them.
+      CreatedObjects.clear();
+      TypesToBeSet.clear();
+      ReferencesToBeSet.clear();
+
+      AddPart(std::move(Root));
+    }
+  } catch (LibDwarfError &Err) {
+#ifndef NDEBUG
+    std::cerr << Err.getErrorMessage();
+#else
+    static_cast<void>(Err);
+#endif
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_DWARF,
+                              FileName);
+  }
+
+  if (!FoundCompileUnits)
+    LibScopeError::warning("No DWARF debug data found.");
+}
+
+std::vector<uint64_t>
+DwarfReader::findIndependentParts(const std::string &FileName) {
+  LibScopeView::FileDescriptor FD(FileName);
+  // The cache is opened before the worker processes are started, so that
+  // they share its copy of the file's sections.
+  if (!CacheDirectory.empty())
+    Cache = std::make_unique<CompileUnitCache>(CacheDirectory, FileName);
+  std::vector<uint64_t> PartSizes;
+  try {
+    const DwarfDebugData DebugData(FD.get());
+    const std::vector<DwarfCompileUnit> CUs = DebugData.getCompileUnits();
+    PartEnds = findIndependentCUGroups(CUs);
+    size_t Begin = 0;
+    for (size_t End : PartEnds) {
+      PartSizes.push_back(CUs[End - 1].NextHeaderOffset -
+                          CUs[Begin].HeaderOffset);
+      Begin = End;
+    }
+  } catch (LibDwarfError &Err) {
+#ifndef NDEBUG
+    std::cerr << Err.getErrorMessage();
+#else
+    static_cast<void>(Err);
+#endif
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_DWARF,
+                              FileName);
+  }
+  return PartSizes;
+}
+
+std::unique_ptr<LibScopeView::ScopeRoot>
+DwarfReader::createIndependentPart(const std::string &FileName, size_t Index) {
+  assert(Index < PartEnds.size());
+  auto Root = std::make_unique<LibScopeView::ScopeRoot>();
+  Root->setName(FileName.c_str());
+  try {
+    // libdwarf's state can not be shared with the other processes, so the
+    // file is opened again by each.
+    if (!OpenPartFile)
+      OpenPartFile = std::make_unique<PartFile>(FileName);
+    const DwarfCompileUnit *CUs = OpenPartFile->CUs.data();
+    createCompileUnits(OpenPartFile->DebugData,
+                       CUs + (Index ? PartEnds[Index - 1] : 0),
+                       CUs + PartEnds[Index], *Root);
+  } catch (LibDwarfError &Err) {
+#ifndef NDEBUG
+    std::cerr << Err.getErrorMessage();
+#else
+    static_cast<void>(Err);
+#endif
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_DWARF,
+                              FileName);
+  }
+
+  // No other part references the objects of this one.
+  CreatedObjects.clear();
+  TypesToBeSet.clear();
+  ReferencesToBeSet.clear();
+  return Root;
+}
+
 void DwarfReader::createCompileUnits(const DwarfDebugData &DebugData,
+                                     const DwarfCompileUnit *Begin,
+                                     const DwarfCompileUnit *End,
                                      LibScopeView::ScopeRoot &Root) {
-  for (const auto &CU : DebugData.getCompileUnits()) {
+  // The CUs created rather than loaded from the cache, saved once their
+  // references to the other CUs are set.
+  struct CreatedCompileUnit {
+    Dwarf_Off HeaderOffset;
+    LibScopeView::ScopeCompileUnit *CU;
+    std::vector<CompileUnitWarning> Warnings;
+  };
+  std::vector<CreatedCompileUnit> CreatedCUs;
+
+  for (const DwarfCompileUnit *IT = Begin; IT != End; ++IT) {
+    const DwarfCompileUnit &CU = *IT;
     CurrentCURange = std::make_pair(CU.HeaderOffset, CU.NextHeaderOffset);
+    CurrentCU = nullptr;
+    CurrentLevel = 0;
+    CurrentWarnings.clear();
+    if (Cache && loadCachedCompileUnit(CU, Root))
+      continue;
     SourceFileMapping = getSourceFileMapping(DebugData, CU.CUDie);
 
     // Recursively create the tree of Objects from the CU and down.
     createObject(DebugData, CU.CUDie, Root);
+
+    if (CurrentCU) {
+      CurrentCU->getExtents().setIsRecorded();
+      Root.getExtents().merge(CurrentCU->getExtents());
+      if (Cache)
+        CreatedCUs.push_back(
+            {CU.HeaderOffset, CurrentCU, std::move(CurrentWarnings)});
+    }
   }
+  CurrentCU = nullptr;
+  Root.getExtents().setIsRecorded();
+
+  for (const CreatedCompileUnit &Created : CreatedCUs)
+    Cache->save(Created.HeaderOffset, *Created.CU, Created.Warnings);
 
   // If we didn't skip any Dies (because of unknown tags) then we should have
   // resolved all the types and references.
@@ -159,6 +367,46 @@ void DwarfReader::createCompileUnits(const DwarfDebugData &DebugData,
          "Some objects had a reference that was not created");
 }
 
+bool DwarfReader::loadCachedCompileUnit(const DwarfCompileUnit &CU,
+                                        LibScopeView::ScopeRoot &Root) {
+  std::vector<CompileUnitWarning> Warnings;
+  std::unique_ptr<LibScopeView::ScopeCompileUnit> Loaded = Cache->load(
+      CU.HeaderOffset, CU.NextHeaderOffset, Warnings,
+      [this](LibScopeView::Object &Obj, bool IsType, Dwarf_Off Offset) {
+        if (IsType)
+          setTypeByOffset(Obj, Offset);
+        else
+          setReferenceByOffset(Obj, Offset);
+      });
+  if (!Loaded)
+    return false;
+
+  Root.addChild(Loaded.get());
+  LibScopeView::ScopeCompileUnit &CUObj = *Loaded.release();
+  addLoadedObjects(CUObj);
+
+  for (const CompileUnitWarning &Warning : Warnings) {
+    if (Warning.IsUnknownTag)
+      warnUnknownTag(Warning.Code);
+    else
+      warnUnknownAttrForm(Warning.Code, Warning.Form);
+  }
+
+  Root.getExtents().merge(CUObj.getExtents());
+  return true;
+}
+
+void DwarfReader::addLoadedObjects(LibScopeView::Object &Obj) {
+  assert(CreatedObjects.count(Obj.getDieOffset()) == 0U &&
+         "DWARF offset seen twice");
+  CreatedObjects[Obj.getDieOffset()] = &Obj;
+  updateReferencesToObject(Obj, Obj.getDieOffset());
+
+  if (auto *Scp = dyn_cast<LibScopeView::Scope>(&Obj))
+    for (LibScopeView::Object *Child : Scp->getChildren())
+      addLoadedObjects(*Child);
+}
+
 void DwarfReader::createObject(const DwarfDebugData &DebugData,
                                const DwarfDie &Die,
                                LibScopeView::Object &ParentObj) {
@@ -181,9 +429,17 @@ void DwarfReader::createObject(const DwarfDebugData &DebugData,
   // Record the Object by offset for lookup when creating other objects.
   CreatedObjects[ObjOffset] = Obj;
 
+  // The CU must be current before its attributes create the lines.
+  if (auto *CU = dyn_cast<LibScopeView::ScopeCompileUnit>(Obj))
+    CurrentCU = CU;
+
   // Set attributes.
   initObjectFromAttrs(*Obj, Die, ObjOffset, ObjTag);
 
+  // Record the extents used to lay out the printed columns.
+  if (CurrentCU)
+    CurrentCU->getExtents().addObject(*Obj, CurrentLevel);
+
   // Set any references.
   initObjectReferences(*Obj, Die);
 
@@ -191,8 +447,10 @@ void DwarfReader::createObject(const DwarfDebugData &DebugData,
   updateReferencesToObject(*Obj, ObjOffset);
 
   // Recurse on the DIE children.
+  ++CurrentLevel;
   for (auto IT = Die.childrenBegin(), End = Die.childrenEnd(); IT != End; ++IT)
     createObject(DebugData, *IT, *Obj);
+  --CurrentLevel;
 }
 
 LibScopeView::Object *
@@ -367,14 +625,7 @@ DwarfReader::createObjectByTag(Dwarf_Half Tag) {
   case DW_TAG_GNU_template_parameter_pack:
     return new LibScopeView::ScopeTemplatePack;
   default:
-    if (!UnknownDWTags.count(Tag)) {
-      UnknownDWTags.insert(Tag);
-      std::stringstream Msg;
-      Msg << "Ignoring unknown/unsupported DWARF tag '";
-      writeStringOrHex(Msg, getDwarfTagAsString(Tag), Tag);
-      Msg << "'.";
-      LibScopeError::warning(Msg.str());
-    }
+    warnUnknownTag(Tag);
     return nullptr;
   }
 }
@@ -557,6 +808,8 @@ void DwarfReader::createLines(const DwarfDie &CUDie,
       Ln->setIsEpilogueBegin();
     if (DwarfLine.IsPrologEnd)
       Ln->setIsPrologueEnd();
+
+    CUObj.getExtents().addObject(*Ln, 1);
   }
 }
 
@@ -571,19 +824,8 @@ void DwarfReader::initObjectReferences(LibScopeView::Object &Obj,
     TypeRef =
         getAttrExpectingKind(Die, DW_AT_import, DwarfAttrValueKind::Reference);
 
-  if (!TypeRef.empty()) {
-    auto TypeOffset = TypeRef.getReference();
-    auto IT = CreatedObjects.find(TypeOffset);
-    if (IT != CreatedObjects.end()) {
-      Obj.setType(IT->second);
-      // If the type is in another CU mark it as global.
-      if (TypeOffset < CurrentCURange.first ||
-          TypeOffset > CurrentCURange.second)
-        IT->second->setIsGlobalReference();
-    } else
-      // Set the type for this Object when we encounter TypeOffset.
-      TypesToBeSet.emplace(TypeOffset, &Obj);
-  }
+  if (!TypeRef.empty())
+    setTypeByOffset(Obj, TypeRef.getReference());
 
   // Set reference from a DW_AT_specification / DW_AT_abstract_origin /
   // DW_AT_extension or add to list to be resolved later.
@@ -596,19 +838,35 @@ void DwarfReader::initObjectReferences(LibScopeView::Object &Obj,
     ReferenceOffset = getAttrExpectingKind(Die, DW_AT_extension,
                                            DwarfAttrValueKind::Reference);
 
-  if (!ReferenceOffset.empty()) {
-    auto RefOffset = ReferenceOffset.getReference();
-    auto IT = CreatedObjects.find(RefOffset);
-    // If the referenced function hasn't been created yet, add to
-    // ReferencesToBeSet for later.
-    if (IT == CreatedObjects.end())
-      ReferencesToBeSet.emplace(RefOffset, &Obj);
-    else {
-      addObjectReference(&Obj, IT->second);
-      // If the reference is in another CU mark it as global.
-      if (RefOffset < CurrentCURange.first || RefOffset > CurrentCURange.second)
-        IT->second->setIsGlobalReference();
-    }
+  if (!ReferenceOffset.empty())
+    setReferenceByOffset(Obj, ReferenceOffset.getReference());
+}
+
+void DwarfReader::setTypeByOffset(LibScopeView::Object &Obj,
+                                  Dwarf_Off TypeOffset) {
+  auto IT = CreatedObjects.find(TypeOffset);
+  if (IT != CreatedObjects.end()) {
+    Obj.setType(IT->second);
+    // If the type is in another CU mark it as global.
+    if (TypeOffset < CurrentCURange.first || TypeOffset > CurrentCURange.second)
+      IT->second->setIsGlobalReference();
+  } else
+    // Set the type for this Object when we encounter TypeOffset.
+    TypesToBeSet.emplace(TypeOffset, &Obj);
+}
+
+void DwarfReader::setReferenceByOffset(LibScopeView::Object &Obj,
+                                       Dwarf_Off RefOffset) {
+  auto IT = CreatedObjects.find(RefOffset);
+  // If the referenced function hasn't been created yet, add to
+  // ReferencesToBeSet for later.
+  if (IT == CreatedObjects.end())
+    ReferencesToBeSet.emplace(RefOffset, &Obj);
+  else {
+    addObjectReference(&Obj, IT->second);
+    // If the reference is in another CU mark it as global.
+    if (RefOffset < CurrentCURange.first || RefOffset > CurrentCURange.second)
+      IT->second->setIsGlobalReference();
   }
 }
 
@@ -652,18 +910,7 @@ DwarfAttrValue DwarfReader::getAttrExpectingKinds(
   if (AttrVal.empty() || ExpectedKinds.count(AttrVal.getKind()))
     return AttrVal;
 
-  auto Form = AttrVal.getForm();
-  auto AttrFormPair = std::make_pair(Attr, Form);
-  if (!UnknownAttrFormPairs.count(AttrFormPair)) {
-    UnknownAttrFormPairs.insert(AttrFormPair);
-    std::stringstream Msg;
-    Msg << "Ignoring unrecognised DW_AT, DW_FORM combination '";
-    writeStringOrHex(Msg, getDwarfAttrAsString(Attr), Attr);
-    Msg << "', '";
-    writeStringOrHex(Msg, getDwarfFormAsString(Form), Form);
-    Msg << "'.";
-    LibScopeError::warning(Msg.str());
-  }
+  warnUnknownAttrForm(Attr, AttrVal.getForm());
   return DwarfAttrValue();
 }
 
@@ -689,3 +936,40 @@ DwarfReader::getAccessSpecifier(const DwarfDie &Die) {
   }
   return LibScopeView::AccessSpecifier::Unspecified;
 }
+
+void DwarfReader::warnUnknownTag(Dwarf_Half Tag) {
+  if (Cache)
+    recordWarning({/*IsUnknownTag*/ true, Tag, 0});
+  if (UnknownDWTags.count(Tag))
+    return;
+
+  UnknownDWTags.insert(Tag);
+  std::stringstream Msg;
+  Msg << "Ignoring unknown/unsupported DWARF tag '";
+  writeStringOrHex(Msg, getDwarfTagAsString(Tag), Tag);
+  Msg << "'.";
+  LibScopeError::warning(Msg.str());
+}
+
+void DwarfReader::warnUnknownAttrForm(Dwarf_Half Attr, Dwarf_Half Form) {
+  if (Cache)
+    recordWarning({/*IsUnknownTag*/ false, Attr, Form});
+  auto AttrFormPair = std::make_pair(Attr, Form);
+  if (UnknownAttrFormPairs.count(AttrFormPair))
+    return;
+
+  UnknownAttrFormPairs.insert(AttrFormPair);
+  std::stringstream Msg;
+  Msg << "Ignoring unrecognised DW_AT, DW_FORM combination '";
+  writeStringOrHex(Msg, getDwarfAttrAsString(Attr), Attr);
+  Msg << "', '";
+  writeStringOrHex(Msg, getDwarfFormAsString(Form), Form);
+  Msg << "'.";
+  LibScopeError::warning(Msg.str());
+}
+
+void DwarfReader::recordWarning(const CompileUnitWarning &Warning) {
+  if (std::find(CurrentWarnings.begin(), CurrentWarnings.end(), Warning) ==
+      CurrentWarnings.end())
+    CurrentWarnings.push_back(Warning);
+}
@@ -32,6 +32,7 @@
 #ifndef ELF_DWARF_READER_H
 #define ELF_DWARF_READER_H
 
+#include "CompileUnitCache.h"
 #include "Reader.h"
 
 #include <set>
@@ -42,13 +43,17 @@ namespace ElfDwarfReader {
 
 class DwarfDebugData;
 class DwarfDie;
+struct DwarfCompileUnit;
 class DwarfAttrValue;
 enum class DwarfAttrValueKind;
 
 class DwarfReader : public LibScopeView::Reader {
 public:
-  DwarfReader() = default;
-  ~DwarfReader() override = default;
+  DwarfReader();
+  /// Create a reader that keeps the compile units it reads in a cache in
+  /// CacheDirectory, and loads those that did not change from there.
+  explicit DwarfReader(const std::string &CacheDirectory);
+  ~DwarfReader() override;
 
   DwarfReader(const DwarfReader &) = delete;
   DwarfReader &operator=(const DwarfReader &) = delete;
@@ -58,10 +63,36 @@ private:
   std::unique_ptr<LibScopeView::ScopeRoot>
   createScopes(const std::string &FileName) override;
 
-  /// Create each compile unit.
+  /// Create the scope tree in parts, each holding a group of compile units
+  /// that do not reference objects in the other groups.
+  void createScopesInParts(const std::string &FileName,
+                           const CreatedPartCallback &AddPart) override;
+
+  /// Find the groups of compile units that do not reference each other, to be
+  /// created as independent parts.
+  std::vector<uint64_t>
+  findIndependentParts(const std::string &FileName) override;
+
+  /// Create a group of compile units found by findIndependentParts, opening
+  /// the file again in this process.
+  std::unique_ptr<LibScopeView::ScopeRoot>
+  createIndependentPart(const std::string &FileName, size_t Index) override;
+
+  /// Create each compile unit in the range [Begin, End).
   void createCompileUnits(const DwarfDebugData &DebugData,
+                          const DwarfCompileUnit *Begin,
+                          const DwarfCompileUnit *End,
                           LibScopeView::ScopeRoot &Root);
 
+  /// Load a compile unit from the cache into Root, returning false if it is
+  /// not in the cache.
+  bool loadCachedCompileUnit(const DwarfCompileUnit &CU,
+                             LibScopeView::ScopeRoot &Root);
+
+  /// Record each object of a compile unit loaded from the cache by offset,
+  /// and set the references to it from the other compile units.
+  void addLoadedObjects(LibScopeView::Object &Obj);
+
   /// Create a LibScopeView::Object from a Die and then recursivly create its
   /// children.
   void createObject(const DwarfDebugData &DebugData, const DwarfDie &Die,
@@ -89,6 +120,14 @@ private:
   /// needs to be updated when the other object is created.
   void initObjectReferences(LibScopeView::Object &Obj, const DwarfDie &Die);
 
+  /// Set the type of this object to the object at TypeOffset, or record that
+  /// it needs to be set when that object is created.
+  void setTypeByOffset(LibScopeView::Object &Obj, Dwarf_Off TypeOffset);
+
+  /// Set the reference of this object to the object at RefOffset, or record
+  /// that it needs to be set when that object is created.
+  void setReferenceByOffset(LibScopeView::Object &Obj, Dwarf_Off RefOffset);
+
   /// Set any references from other objects to this object now that it exists.
   void updateReferencesToObject(LibScopeView::Object &Obj, Dwarf_Off ObjOffset);
 
@@ -110,12 +149,46 @@ private:
   /// Get the access specifier (Public, Private, etc.) of a Die.
   LibScopeView::AccessSpecifier getAccessSpecifier(const DwarfDie &Die);
 
+  /// Produce a warning for an unknown DWARF tag, unless already seen.
+  void warnUnknownTag(Dwarf_Half Tag);
+
+  /// Produce a warning for an unrecognised Attr-Form combination, unless
+  /// already seen.
+  void warnUnknownAttrForm(Dwarf_Half Attr, Dwarf_Half Form);
+
+  /// Record a warning given while creating the current CU, to be given again
+  /// when it is loaded from the cache.
+  void recordWarning(const CompileUnitWarning &Warning);
+
+  // Directory of the compile unit cache, or empty for none.
+  std::string CacheDirectory;
+
+  // The cache of the file being read, if any.
+  std::unique_ptr<CompileUnitCache> Cache;
+
+  // The index one past the last compile unit of each independent part.
+  std::vector<size_t> PartEnds;
+
+  // The file opened to create the independent parts, with its own libdwarf
+  // state.
+  struct PartFile;
+  std::unique_ptr<PartFile> OpenPartFile;
+
+  // The warnings given while creating the current CU.
+  std::vector<CompileUnitWarning> CurrentWarnings;
+
   // Offset range of the current CU.
   std::pair<Dwarf_Off, Dwarf_Off> CurrentCURange;
 
   // Mapping from DWARF file IDs to the file paths in the current CU.
   std::vector<std::string> SourceFileMapping;
 
+  // The CU being created, whose extents record each object created in it.
+  LibScopeView::ScopeCompileUnit *CurrentCU = nullptr;
+
+  // Depth of the object being created below the current CU.
+  size_t CurrentLevel = 0;
+
   // Mapping from DWARF offsets to already created Objects.
   std::unordered_map<Dwarf_Off, LibScopeView::Object *> CreatedObjects;
 
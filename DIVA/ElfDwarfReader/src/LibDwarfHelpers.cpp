@@ -29,6 +29,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "LibDwarfHelpers.h"
+#include "DwarfNames.h"
 
 #include <cstdlib>
 
@@ -67,24 +68,18 @@ const char *LibDwarfError::what() const noexcept {
 }
 
 std::string ElfDwarfReader::getDwarfTagAsString(Dwarf_Half Tag) {
-  const char *Result;
-  if (dwarf_get_TAG_name(Tag, &Result) == DW_DLV_OK)
-    return std::string(Result);
-  return std::string();
+  const LibScopeView::DwarfName &Result = LibScopeView::getDwarfTagName(Tag);
+  return std::string(Result.Name, Result.Length);
 }
 
 std::string ElfDwarfReader::getDwarfAttrAsString(Dwarf_Half Attr) {
-  const char *Result;
-  if (dwarf_get_AT_name(Attr, &Result) == DW_DLV_OK)
-    return std::string(Result);
-  return std::string();
+  const LibScopeView::DwarfName &Result = LibScopeView::getDwarfAttrName(Attr);
+  return std::string(Result.Name, Result.Length);
 }
 
 std::string ElfDwarfReader::getDwarfFormAsString(Dwarf_Half Form) {
-  const char *Result;
-  if (dwarf_get_FORM_name(Form, &Result) == DW_DLV_OK)
-    return std::string(Result);
-  return std::string();
+  const LibScopeView::DwarfName &Result = LibScopeView::getDwarfFormName(Form);
+  return std::string(Result.Name, Result.Length);
 }
 
 // DwarfDebugData methods.
@@ -209,9 +204,7 @@ Dwarf_Half DwarfDie::getTag() const {
 }
 
 std::string DwarfDie::getTagName() const {
-  const char *TagName;
-  int ret = dwarf_get_TAG_name(getTag(), &TagName);
-  return (ret == DW_DLV_OK) ? TagName : "";
+  return getDwarfTagAsString(getTag());
 }
 
 DwarfLineTable DwarfDie::getLineTable() const { return DwarfLineTable(*this); }
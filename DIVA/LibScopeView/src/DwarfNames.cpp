@@ -0,0 +1,129 @@
+//===-- LibScopeView/DwarfNames.cpp -----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the tables of the names of DWARF tags, attributes and
+/// forms, built at compile time from DwarfNames.def.
+///
+//===----------------------------------------------------------------------===//
+
+#include "DwarfNames.h"
+
+#include <algorithm>
+
+using namespace LibScopeView;
+
+namespace {
+
+// An entry of DwarfNames.def.
+struct DwarfNameEntry {
+  Dwarf_Half Value;
+  DwarfName Name;
+};
+
+// Values below this are looked up directly in a table. This covers all the
+// standard values; the sparse vendor values are found by a binary search.
+const size_t DirectTableSize = 0x100;
+
+// The names of the values below DirectTableSize, indexed by value.
+struct DirectTable {
+  template <size_t Size>
+  constexpr DirectTable(const DwarfNameEntry (&Entries)[Size]) : Names() {
+    for (size_t Index = 0; Index < Size; ++Index) {
+      if (Entries[Index].Value < DirectTableSize) {
+        Names[Entries[Index].Value].Name = Entries[Index].Name.Name;
+        Names[Entries[Index].Value].Length = Entries[Index].Name.Length;
+      }
+    }
+  }
+
+  DwarfName Names[DirectTableSize];
+};
+
+template <size_t Size>
+constexpr bool isSorted(const DwarfNameEntry (&Entries)[Size]) {
+  for (size_t Index = 1; Index < Size; ++Index)
+    if (Entries[Index - 1].Value >= Entries[Index].Value)
+      return false;
+  return true;
+}
+
+template <size_t Size>
+const DwarfName &lookup(const DirectTable &Table,
+                        const DwarfNameEntry (&Entries)[Size],
+                        Dwarf_Half Value) {
+  if (Value < DirectTableSize)
+    return Table.Names[Value];
+
+  static const DwarfName Unknown;
+  const DwarfNameEntry *End = Entries + Size;
+  auto IT = std::lower_bound(Entries, End, Value,
+                             [](const DwarfNameEntry &Entry, Dwarf_Half V) {
+                               return Entry.Value < V;
+                             });
+  if (IT == End || IT->Value != Value)
+    return Unknown;
+  return IT->Name;
+}
+
+#define DWARF_NAME_ENTRY(Value, Name) {Value, {#Name, sizeof(#Name) - 1}},
+
+constexpr DwarfNameEntry TagEntries[] = {
+#define DWARF_TAG DWARF_NAME_ENTRY
+#include "DwarfNames.def"
+};
+
+constexpr DwarfNameEntry AttrEntries[] = {
+#define DWARF_AT DWARF_NAME_ENTRY
+#include "DwarfNames.def"
+};
+
+constexpr DwarfNameEntry FormEntries[] = {
+#define DWARF_FORM DWARF_NAME_ENTRY
+#include "DwarfNames.def"
+};
+
+#undef DWARF_NAME_ENTRY
+
+static_assert(isSorted(TagEntries), "DWARF tags must be in value order");
+static_assert(isSorted(AttrEntries), "DWARF attributes must be in value order");
+static_assert(isSorted(FormEntries), "DWARF forms must be in value order");
+
+constexpr DirectTable TagTable(TagEntries);
+constexpr DirectTable AttrTable(AttrEntries);
+constexpr DirectTable FormTable(FormEntries);
+
+} // end anonymous namespace.
+
+const DwarfName &LibScopeView::getDwarfTagName(Dwarf_Half Tag) {
+  return lookup(TagTable, TagEntries, Tag);
+}
+
+const DwarfName &LibScopeView::getDwarfAttrName(Dwarf_Half Attr) {
+  return lookup(AttrTable, AttrEntries, Attr);
+}
+
+const DwarfName &LibScopeView::getDwarfFormName(Dwarf_Half Form) {
+  return lookup(FormTable, FormEntries, Form);
+}
@@ -0,0 +1,54 @@
+//===-- LibScopeView/DwarfNames.h -------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the lookups of the names of DWARF tags, attributes and
+/// forms.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_DWARFNAMES_H
+#define SCOPEVIEW_DWARFNAMES_H
+
+#include "libdwarf.h"
+
+#include <cstddef>
+
+namespace LibScopeView {
+
+/// \brief The name of a DWARF value, and the length of that name.
+struct DwarfName {
+  const char *Name = "";
+  size_t Length = 0;
+};
+
+/// \brief Get the name of a DWARF tag, attribute or form. The name is empty
+/// for values that are not known.
+const DwarfName &getDwarfTagName(Dwarf_Half Tag);
+const DwarfName &getDwarfAttrName(Dwarf_Half Attr);
+const DwarfName &getDwarfFormName(Dwarf_Half Form);
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_DWARFNAMES_H
@@ -30,6 +30,7 @@
 #include "Error.h"
 
 #include <assert.h>
+#include <iostream>
 #include <sstream>
 
 using namespace LibScopeError;
@@ -53,13 +54,38 @@ const ErrorEntry ErrorTable[] = {
     {"ERR_CMD_SHORTCUT_WITH_VALUE",
      "Shortcut arguments can not be given values '%s'."},
     {"ERR_CMD_INVALID_REGEX", "Invalid Regular Expression '%s'."},
+    {"ERR_CMD_INCOMPATIBLE_ARGS", "Argument '%s' can not be used with '%s'."},
+    {"ERR_CMD_COMPARE_INPUTS",
+     "Argument '--compare' requires two input files, got %s."},
+    {"ERR_CMD_SNAPSHOT_INPUTS",
+     "Argument '--save-snapshot' requires one input file, got %s."},
+    {"ERR_CMD_REQUIRES_ARG", "Argument '%s' can only be used with '%s'."},
+    {"ERR_CMD_SHARD_INPUTS",
+     "Argument '--cu-shard' requires one input file, got %s."},
 
     // Reading.
     {"ERR_READ_FAILED", "Failed to read '%s'."},
+    {"ERR_WORKER_FAILED", "A worker process was killed by signal %s."},
 
     // ElfDwarfReader.
     {"ERR_INVALID_DWARF", "Failed to read DWARF from '%s'."},
 
+    // SnapshotReader.
+    {"ERR_INVALID_SNAPSHOT",
+     "Failed to read snapshot '%s', it is damaged or from another version."},
+    {"ERR_SNAPSHOT_SETTINGS", "Snapshot '%s' can only be read with '%s'."},
+
+    // Output packs.
+    {"ERR_INVALID_PACK",
+     "Failed to read output pack '%s', it is damaged or from another version."},
+    {"ERR_PACK_ENTRY_NOT_FOUND", "No file '%s' in output pack '%s'."},
+
+    // Shards.
+    {"ERR_INVALID_SHARD",
+     "Failed to read shard '%s', it is damaged or from another version."},
+    {"ERR_SHARD_MISMATCH", "Shard '%s' can not be merged with '%s'."},
+    {"ERR_SHARD_MISSING", "Shard %s is missing."},
+
     // FileIO Error.
     {"ERR_FILEIO_GET_CWD", "Unable to get current working directory."},
     {"ERR_FILEIO_ABS_PATH", "Unable to find file or directory '%s'."},
@@ -69,11 +95,14 @@ const ErrorEntry ErrorTable[] = {
     // Internal Error.
     {"ERR_SPLIT_UNABLE_TO_OPEN_FILE",
      "Unable to open file '%s' for Logical View Split."},
+    {"ERR_SPLIT_UNABLE_TO_COMPRESS",
+     "Unable to write compressed file '%s' for Logical View Split."},
 
     // Start up Error.
     {"ERR_FILE_NOT_FOUND", "Unable to open file '%s'."},
     {"ERR_INVALID_FILE",
      "Invalid input file '%s', please provide a file in a supported format."},
+    {"ERR_INVALID_BATCH_LINE", "Invalid line '%s' in batch file '%s'."},
 };
 static_assert(sizeof(ErrorTable) / sizeof(ErrorEntry) ==
                   static_cast<size_t>(ErrorCode::ERR_LAST_CODE),
@@ -84,6 +113,8 @@ const ErrorEntry &getEntry(const ErrorCode Code) {
   return ErrorTable[static_cast<size_t>(Code)];
 }
 
+thread_local bool ExitAsException = false;
+
 } // namespace
 
 void LibScopeError::warning(const std::string &Msg) {
@@ -92,6 +123,21 @@ void LibScopeError::warning(const std::string &Msg) {
   fflush(stderr);
 }
 
+ScopedExitAsException::ScopedExitAsException()
+    : PreviousExitAsException(ExitAsException) {
+  ExitAsException = true;
+}
+
+ScopedExitAsException::~ScopedExitAsException() {
+  ExitAsException = PreviousExitAsException;
+}
+
+void LibScopeError::exitProgram(int ExitCode) {
+  if (ExitAsException)
+    throw ExitException(ExitCode, "");
+  exit(ExitCode);
+}
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wformat-nonliteral"
@@ -102,25 +148,41 @@ void LibScopeError::warning(const std::string &Msg) {
 #pragma GCC diagnostic ignored "-Wformat-security"
 #endif
 
-void LibScopeError::fatalError(const ErrorCode Code) {
-  fprintf(stderr, "\n%s: ", getEntry(Code).Name);
-  fprintf(stderr, getEntry(Code).Format);
-  fprintf(stderr, "\n");
+namespace {
+
+// Formats the message of an error, as it is printed.
+std::string formatError(const ErrorCode Code, const char *Detail1 = "",
+                        const char *Detail2 = "") {
+  const ErrorEntry &Entry = getEntry(Code);
+  int Size = snprintf(nullptr, 0, Entry.Format, Detail1, Detail2);
+  std::string Message(Size > 0 ? static_cast<size_t>(Size) : 0, '\0');
+  if (Size > 0)
+    snprintf(&Message[0], Message.size() + 1, Entry.Format, Detail1, Detail2);
+  return std::string("\n") + Entry.Name + ": " + Message + "\n";
+}
+
+[[noreturn]] void exitWithError(const std::string &Message) {
+  if (ExitAsException)
+    throw ExitException(1, Message);
+  // The error follows the output printed before it, wherever stdout and
+  // stderr go.
+  std::cout.flush();
+  fputs(Message.c_str(), stderr);
   exit(1);
 }
+
+} // namespace
+
+void LibScopeError::fatalError(const ErrorCode Code) {
+  exitWithError(formatError(Code));
+}
 void LibScopeError::fatalError(const ErrorCode Code,
                                const std::string &Detail1) {
-  fprintf(stderr, "\n%s: ", getEntry(Code).Name);
-  fprintf(stderr, getEntry(Code).Format, Detail1.c_str());
-  fprintf(stderr, "\n");
-  exit(1);
+  exitWithError(formatError(Code, Detail1.c_str()));
 }
 void LibScopeError::fatalError(const ErrorCode Code, const std::string &Detail1,
                                const std::string &Detail2) {
-  fprintf(stderr, "\n%s: ", getEntry(Code).Name);
-  fprintf(stderr, getEntry(Code).Format, Detail1.c_str(), Detail2.c_str());
-  fprintf(stderr, "\n");
-  exit(1);
+  exitWithError(formatError(Code, Detail1.c_str(), Detail2.c_str()));
 }
 
 #ifdef __clang__
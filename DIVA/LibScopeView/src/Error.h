@@ -27,6 +27,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include <stdexcept>
 #include <string>
 
 #ifndef ERROR_H
@@ -43,13 +44,32 @@ enum class ErrorCode {
   ERR_CMD_INVALID_VALUE,
   ERR_CMD_SHORTCUT_WITH_VALUE,
   ERR_CMD_INVALID_REGEX,
+  ERR_CMD_INCOMPATIBLE_ARGS,
+  ERR_CMD_COMPARE_INPUTS,
+  ERR_CMD_SNAPSHOT_INPUTS,
+  ERR_CMD_REQUIRES_ARG,
+  ERR_CMD_SHARD_INPUTS,
 
   // Reading.
   ERR_READ_FAILED,
+  ERR_WORKER_FAILED,
 
   // ElfDwarfReader.
   ERR_INVALID_DWARF,
 
+  // SnapshotReader.
+  ERR_INVALID_SNAPSHOT,
+  ERR_SNAPSHOT_SETTINGS,
+
+  // Output packs.
+  ERR_INVALID_PACK,
+  ERR_PACK_ENTRY_NOT_FOUND,
+
+  // Shards.
+  ERR_INVALID_SHARD,
+  ERR_SHARD_MISMATCH,
+  ERR_SHARD_MISSING,
+
   // FileIO Error.
   ERR_FILEIO_GET_CWD,
   ERR_FILEIO_ABS_PATH,
@@ -58,10 +78,12 @@ enum class ErrorCode {
 
   // Internal Error.
   ERR_SPLIT_UNABLE_TO_OPEN_FILE,
+  ERR_SPLIT_UNABLE_TO_COMPRESS,
 
   // Start up Error.
   ERR_FILE_NOT_FOUND,
   ERR_INVALID_FILE,
+  ERR_INVALID_BATCH_LINE,
 
   // Last Error.
   ERR_LAST_CODE
@@ -70,6 +92,37 @@ enum class ErrorCode {
 /// \brief Display a warning message.
 void warning(const std::string &Msg);
 
+/// \brief Thrown instead of exiting the program while a ScopedExitAsException
+/// is in scope. what() is the error message that would have been printed.
+class ExitException : public std::runtime_error {
+public:
+  ExitException(int ExitCode, const std::string &Message)
+      : std::runtime_error(Message), ExitCode(ExitCode) {}
+
+  int getExitCode() const { return ExitCode; }
+
+private:
+  int ExitCode;
+};
+
+/// \brief Makes exitProgram and fatalError throw an ExitException on the
+/// current thread while this is in scope, so that a long running process can
+/// report the error and carry on.
+class ScopedExitAsException {
+public:
+  ScopedExitAsException();
+  ~ScopedExitAsException();
+
+  ScopedExitAsException(const ScopedExitAsException &) = delete;
+  ScopedExitAsException &operator=(const ScopedExitAsException &) = delete;
+
+private:
+  bool PreviousExitAsException;
+};
+
+/// \brief Exit the program with the given exit code.
+[[noreturn]] void exitProgram(int ExitCode);
+
 /// \brief Display a fatal error and exit.
 [[noreturn]] void fatalError(const ErrorCode Code);
 [[noreturn]] void fatalError(const ErrorCode Code, const std::string &Detail1);
@@ -36,9 +36,12 @@
 #include <array>
 #include <assert.h>
 #include <cctype>
+#include <cstdio>
 #include <fcntl.h>
 #include <fstream>
 #include <iterator>
+#include <random>
+#include <sstream>
 #include <vector>
 
 #ifdef PLATFORM_WIN
@@ -46,6 +49,8 @@
 #define NOMINMAX
 #include <Windows.h>
 #include <io.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 #elif defined(PLATFORM_LINUX)
 #include <errno.h>
 #include <limits.h>
@@ -286,6 +291,60 @@ bool LibScopeView::isFileFormatElf(const std::string &FileLocation) {
   return std::equal(Bytes.begin(), Bytes.end(), ElfMagic.begin());
 }
 
+bool LibScopeView::getFileStatus(const std::string &FileLocation,
+                                 uint64_t &Size, int64_t &ModifiedTime) {
+#ifdef PLATFORM_WIN
+  struct _stat64 SB;
+  if (_stat64(nativeFilePath(FileLocation).c_str(), &SB) != 0)
+    return false;
+  ModifiedTime = static_cast<int64_t>(SB.st_mtime) * 1000000000;
+#else
+  struct stat SB;
+  if (stat(FileLocation.c_str(), &SB) != 0)
+    return false;
+  ModifiedTime =
+      static_cast<int64_t>(SB.st_mtim.tv_sec) * 1000000000 + SB.st_mtim.tv_nsec;
+#endif
+  Size = static_cast<uint64_t>(SB.st_size);
+  return true;
+}
+
+bool LibScopeView::readFileContents(const std::string &FileLocation,
+                                    std::string &Contents) {
+  std::ifstream File(nativeFilePath(FileLocation),
+                     std::ios::binary | std::ios::ate);
+  std::streamoff Size = File.tellg();
+  if (Size < 0)
+    return false;
+  Contents.assign(static_cast<size_t>(Size), '\0');
+  File.seekg(0);
+  return static_cast<bool>(File.read(&Contents[0], Size));
+}
+
+bool LibScopeView::replaceFileContents(const std::string &FileLocation,
+                                       const std::string &Contents) {
+  std::ostringstream TempPath;
+  TempPath << FileLocation << '.' << std::hex << std::random_device()()
+           << ".tmp";
+  std::string NativeTempPath = nativeFilePath(TempPath.str());
+  {
+    std::ofstream File(NativeTempPath, std::ios::binary);
+    File.write(Contents.data(), static_cast<std::streamsize>(Contents.size()));
+    if (File)
+      File.close();
+    if (!File) {
+      std::remove(NativeTempPath.c_str());
+      return false;
+    }
+  }
+  if (std::rename(NativeTempPath.c_str(),
+                  nativeFilePath(FileLocation).c_str()) != 0) {
+    std::remove(NativeTempPath.c_str());
+    return false;
+  }
+  return true;
+}
+
 FileDescriptor::FileDescriptor(const std::string &UnifiedPath) {
 #ifdef PLATFORM_WIN
   _sopen_s(&FD, nativeFilePath(UnifiedPath).c_str(), _O_BINARY | _O_RDONLY,
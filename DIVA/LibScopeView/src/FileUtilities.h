@@ -31,6 +31,7 @@
 #ifndef FILE_UTILITIES_H
 #define FILE_UTILITIES_H
 
+#include <cstdint>
 #include <string>
 
 namespace LibScopeView {
@@ -75,6 +76,24 @@ bool doesFileExist(const std::string &FileLocation);
 /// \brief Return true if the file is an elf.
 bool isFileFormatElf(const std::string &FileLocation);
 
+/// \brief Get the size and the last modification time of a file.
+///
+/// Returns false if the file can not be found.
+bool getFileStatus(const std::string &FileLocation, uint64_t &Size,
+                   int64_t &ModifiedTime);
+
+/// \brief Read the whole of a file into Contents.
+///
+/// Returns false if the file can not be read.
+bool readFileContents(const std::string &FileLocation, std::string &Contents);
+
+/// \brief Write Contents to a temporary file next to FileLocation and then
+/// move it into place, so that other processes never see it partly written.
+///
+/// Returns false, leaving no file behind, if it can not be written.
+bool replaceFileContents(const std::string &FileLocation,
+                         const std::string &Contents);
+
 /// \brief RAII warpper around an int file descriptor.
 class FileDescriptor {
 public:
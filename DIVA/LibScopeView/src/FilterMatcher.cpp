@@ -0,0 +1,845 @@
+//===-- LibScopeView/FilterMatcher.cpp --------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+///
+/// \file
+/// This file contains the implementation of the FilterMatcher class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "FilterMatcher.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+#include <cctype>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <queue>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Most DFA states built before the patterns are matched with std::regex.
+const size_t MaxDFAStates = 4096;
+// Most NFA nodes built before the patterns are matched with std::regex.
+const size_t MaxNFANodes = 65536;
+// Largest count in a {n,m} repeat that the DFA supports.
+const unsigned MaxRepeatCount = 100;
+// Maximum count of an unbounded repeat.
+const unsigned NoMax = ~0u;
+
+using ByteSet = std::bitset<256>;
+
+// A node of a parsed regular expression.
+struct RegexNode {
+  enum NodeKind { Bytes, Concat, Alternate, Repeat, AssertBegin, AssertEnd };
+
+  explicit RegexNode(NodeKind NKind) : Kind(NKind) {}
+
+  NodeKind Kind;
+  // The bytes matched by a Bytes node.
+  ByteSet Set;
+  std::vector<std::unique_ptr<RegexNode>> Children;
+  // The counts of a Repeat node.
+  unsigned Min = 0;
+  unsigned Max = 0;
+};
+
+using RegexNodePtr = std::unique_ptr<RegexNode>;
+
+RegexNodePtr makeNode(RegexNode::NodeKind Kind) {
+  return RegexNodePtr(new RegexNode(Kind));
+}
+
+bool isDigit(char C) { return std::isdigit(static_cast<unsigned char>(C)) != 0; }
+
+ByteSet getByteSet(unsigned char Byte) {
+  ByteSet Set;
+  Set.set(Byte);
+  return Set;
+}
+
+// Get the bytes matched by the class escapes \d, \w and \s, or by their
+// complements \D, \W and \S.
+ByteSet getClassEscapeSet(char Escape) {
+  ByteSet Set;
+  for (unsigned Byte = 0; Byte < 128; ++Byte) {
+    switch (std::tolower(Escape)) {
+    case 'd':
+      Set[Byte] = std::isdigit(Byte) != 0;
+      break;
+    case 'w':
+      Set[Byte] = std::isalnum(Byte) || Byte == '_';
+      break;
+    case 's':
+      Set[Byte] = std::isspace(Byte) != 0;
+      break;
+    }
+  }
+  if (std::isupper(Escape))
+    Set.flip();
+  return Set;
+}
+
+// Parses the subset of ECMAScript regular expressions that the DFA supports:
+// literals, '.', bracket expressions, the class escapes, groups, alternation,
+// the quantifiers and the '^' and '$' assertions. Returns nullptr for
+// anything else, which is left to std::regex.
+class RegexParser {
+public:
+  explicit RegexParser(const std::string &RegexPattern)
+      : Pattern(RegexPattern) {}
+
+  RegexNodePtr parse() {
+    RegexNodePtr Result = parseAlternate();
+    if (!Result || !atEnd())
+      return nullptr;
+    return Result;
+  }
+
+private:
+  bool atEnd() const { return Pos == Pattern.size(); }
+  char peek() const { return Pattern[Pos]; }
+
+  RegexNodePtr parseAlternate() {
+    auto Result = makeNode(RegexNode::Alternate);
+    while (true) {
+      RegexNodePtr Branch = parseConcat();
+      if (!Branch)
+        return nullptr;
+      Result->Children.push_back(std::move(Branch));
+      if (atEnd() || peek() != '|')
+        return Result;
+      ++Pos;
+    }
+  }
+
+  RegexNodePtr parseConcat() {
+    auto Result = makeNode(RegexNode::Concat);
+    while (!atEnd() && peek() != '|' && peek() != ')') {
+      RegexNodePtr Term = parseRepeat();
+      if (!Term)
+        return nullptr;
+      Result->Children.push_back(std::move(Term));
+    }
+    return Result;
+  }
+
+  RegexNodePtr parseRepeat() {
+    RegexNodePtr Atom = parseAtom();
+    if (!Atom || atEnd())
+      return Atom;
+
+    unsigned Min = 0;
+    unsigned Max = NoMax;
+    switch (peek()) {
+    case '*':
+      ++Pos;
+      break;
+    case '+':
+      Min = 1;
+      ++Pos;
+      break;
+    case '?':
+      Max = 1;
+      ++Pos;
+      break;
+    case '{':
+      if (!parseBraces(Min, Max))
+        return nullptr;
+      break;
+    default:
+      return Atom;
+    }
+    // A lazy quantifier matches the same names as a greedy one.
+    if (!atEnd() && peek() == '?')
+      ++Pos;
+    if (Atom->Kind == RegexNode::AssertBegin ||
+        Atom->Kind == RegexNode::AssertEnd || Min > MaxRepeatCount ||
+        (Max != NoMax && (Max > MaxRepeatCount || Max < Min)))
+      return nullptr;
+
+    auto Result = makeNode(RegexNode::Repeat);
+    Result->Min = Min;
+    Result->Max = Max;
+    Result->Children.push_back(std::move(Atom));
+    return Result;
+  }
+
+  // Parse {n}, {n,} or {n,m}.
+  bool parseBraces(unsigned &Min, unsigned &Max) {
+    ++Pos;
+    if (!parseCount(Min))
+      return false;
+    Max = Min;
+    if (!atEnd() && peek() == ',') {
+      ++Pos;
+      Max = NoMax;
+      if (!atEnd() && isDigit(peek()) && !parseCount(Max))
+        return false;
+    }
+    if (atEnd() || peek() != '}')
+      return false;
+    ++Pos;
+    return true;
+  }
+
+  bool parseCount(unsigned &Count) {
+    size_t Start = Pos;
+    Count = 0;
+    while (!atEnd() && isDigit(peek()) && Pos - Start < 4)
+      Count = Count * 10 + (Pattern[Pos++] - '0');
+    return Pos != Start && (atEnd() || !isDigit(peek()));
+  }
+
+  RegexNodePtr parseAtom() {
+    char C = Pattern[Pos++];
+    switch (C) {
+    case '(': {
+      if (!atEnd() && peek() == '?') {
+        if (Pattern.compare(Pos, 2, "?:") != 0)
+          return nullptr;
+        Pos += 2;
+      }
+      RegexNodePtr Group = parseAlternate();
+      if (!Group || atEnd() || peek() != ')')
+        return nullptr;
+      ++Pos;
+      return Group;
+    }
+    case '[':
+      return parseBracket();
+    case '.': {
+      auto Result = makeNode(RegexNode::Bytes);
+      Result->Set.set();
+      Result->Set.reset('\n');
+      Result->Set.reset('\r');
+      return Result;
+    }
+    case '^':
+      return makeNode(RegexNode::AssertBegin);
+    case '$':
+      return makeNode(RegexNode::AssertEnd);
+    case '\\': {
+      auto Result = makeNode(RegexNode::Bytes);
+      if (!parseEscape(Result->Set))
+        return nullptr;
+      return Result;
+    }
+    case ')':
+    case ']':
+    case '{':
+    case '}':
+    case '*':
+    case '+':
+    case '?':
+    case '|':
+      return nullptr;
+    default: {
+      auto Result = makeNode(RegexNode::Bytes);
+      Result->Set = getByteSet(C);
+      return Result;
+    }
+    }
+  }
+
+  // Parse the escape following a '\', adding the bytes it matches to Set.
+  bool parseEscape(ByteSet &Set) {
+    if (atEnd())
+      return false;
+    char E = Pattern[Pos++];
+    switch (E) {
+    case 'd':
+    case 'D':
+    case 'w':
+    case 'W':
+    case 's':
+    case 'S':
+      Set |= getClassEscapeSet(E);
+      return true;
+    case 't':
+      Set.set('\t');
+      return true;
+    case 'n':
+      Set.set('\n');
+      return true;
+    case 'r':
+      Set.set('\r');
+      return true;
+    case 'f':
+      Set.set('\f');
+      return true;
+    case 'v':
+      Set.set('\v');
+      return true;
+    default:
+      // An escaped punctuation character matches itself. Anything else (back
+      // references, \b, \x, \u, \c ...) is left to std::regex.
+      if (!std::ispunct(static_cast<unsigned char>(E)))
+        return false;
+      Set.set(static_cast<unsigned char>(E));
+      return true;
+    }
+  }
+
+  RegexNodePtr parseBracket() {
+    bool Negate = !atEnd() && peek() == '^';
+    if (Negate)
+      ++Pos;
+    // A leading ']' is not treated the same way by all regex grammars.
+    if (atEnd() || peek() == ']')
+      return nullptr;
+
+    auto Result = makeNode(RegexNode::Bytes);
+    while (true) {
+      if (atEnd())
+        return nullptr;
+      unsigned char From = Pattern[Pos++];
+      if (From == ']')
+        break;
+      bool IsRange = Pos + 1 < Pattern.size() && peek() == '-' &&
+                     Pattern[Pos + 1] != ']';
+      // Character classes ([:alpha:]) and equivalence classes.
+      if (From == '[' && !atEnd() &&
+          (peek() == ':' || peek() == '.' || peek() == '='))
+        return nullptr;
+      if (From == '\\') {
+        if (!parseEscape(Result->Set))
+          return nullptr;
+        if (Pos + 1 < Pattern.size() && peek() == '-' &&
+            Pattern[Pos + 1] != ']')
+          return nullptr;
+        continue;
+      }
+      if (!IsRange) {
+        Result->Set.set(From);
+        continue;
+      }
+      unsigned char To = Pattern[Pos + 1];
+      if (To == '\\' || To == '[' || From >= 0x80 || To >= 0x80 || From > To)
+        return nullptr;
+      Pos += 2;
+      for (unsigned Byte = From; Byte <= To; ++Byte)
+        Result->Set.set(Byte);
+    }
+    if (Negate)
+      Result->Set.flip();
+    return Result;
+  }
+
+  const std::string &Pattern;
+  size_t Pos = 0;
+};
+
+// A node of the NFA built from the parsed regular expressions.
+struct NFANode {
+  enum NodeKind { Epsilon, Bytes, AssertBegin, AssertEnd, Match };
+
+  explicit NFANode(NodeKind NKind) : Kind(NKind) {}
+
+  NodeKind Kind;
+  ByteSet Set;
+  std::vector<uint32_t> Next;
+};
+
+// Builds an NFA from parsed regular expressions, back to front, so that
+// each node is built knowing the node that follows it.
+class NFABuilder {
+public:
+  uint32_t addNode(NFANode::NodeKind Kind) {
+    Nodes.emplace_back(Kind);
+    if (Nodes.size() > MaxNFANodes)
+      TooLarge = true;
+    return static_cast<uint32_t>(Nodes.size() - 1);
+  }
+
+  uint32_t compile(const RegexNode &Node, uint32_t Next) {
+    if (TooLarge)
+      return Next;
+
+    switch (Node.Kind) {
+    case RegexNode::Bytes: {
+      uint32_t Id = addNode(NFANode::Bytes);
+      Nodes[Id].Set = Node.Set;
+      Nodes[Id].Next.push_back(Next);
+      return Id;
+    }
+    case RegexNode::AssertBegin:
+    case RegexNode::AssertEnd: {
+      uint32_t Id = addNode(Node.Kind == RegexNode::AssertBegin
+                                ? NFANode::AssertBegin
+                                : NFANode::AssertEnd);
+      Nodes[Id].Next.push_back(Next);
+      return Id;
+    }
+    case RegexNode::Concat:
+      for (auto Child = Node.Children.rbegin(); Child != Node.Children.rend();
+           ++Child)
+        Next = compile(**Child, Next);
+      return Next;
+    case RegexNode::Alternate: {
+      if (Node.Children.size() == 1)
+        return compile(*Node.Children.front(), Next);
+      uint32_t Id = addNode(NFANode::Epsilon);
+      for (const RegexNodePtr &Child : Node.Children) {
+        uint32_t Branch = compile(*Child, Next);
+        Nodes[Id].Next.push_back(Branch);
+      }
+      return Id;
+    }
+    case RegexNode::Repeat: {
+      const RegexNode &Body = *Node.Children.front();
+      uint32_t Tail = Next;
+      if (Node.Max == NoMax) {
+        uint32_t Loop = addNode(NFANode::Epsilon);
+        uint32_t Start = compile(Body, Loop);
+        Nodes[Loop].Next = {Start, Next};
+        Tail = Loop;
+      } else {
+        for (unsigned Count = Node.Min; Count < Node.Max && !TooLarge;
+             ++Count) {
+          uint32_t Optional = addNode(NFANode::Epsilon);
+          uint32_t Start = compile(Body, Tail);
+          Nodes[Optional].Next = {Start, Next};
+          Tail = Optional;
+        }
+      }
+      for (unsigned Count = 0; Count < Node.Min && !TooLarge; ++Count)
+        Tail = compile(Body, Tail);
+      return Tail;
+    }
+    }
+    return Next;
+  }
+
+  std::vector<NFANode> Nodes;
+  bool TooLarge = false;
+};
+
+// Find the NFA nodes reachable from Seeds without consuming a byte. The '^'
+// assertions are passed only at the start of the name and the '$' assertions
+// only at the end.
+class NFAClosure {
+public:
+  explicit NFAClosure(const std::vector<NFANode> &NFANodes)
+      : Nodes(NFANodes), Visited(NFANodes.size(), 0) {}
+
+  // Get the sorted nodes that consume a byte, or that are an end assertion
+  // or a match, reachable from Seeds.
+  std::vector<uint32_t> getStateNodes(const std::vector<uint32_t> &Seeds,
+                                      bool AtStart) {
+    std::vector<uint32_t> Result;
+    reach(Seeds, AtStart, false, Result);
+    std::sort(Result.begin(), Result.end());
+    return Result;
+  }
+
+  // Return true if a match is reachable from the state nodes at the end of
+  // the name.
+  bool isAccepting(const std::vector<uint32_t> &StateNodes, bool AtStart) {
+    std::vector<uint32_t> Reached;
+    reach(StateNodes, AtStart, true, Reached);
+    for (uint32_t Id : Reached)
+      if (Nodes[Id].Kind == NFANode::Match)
+        return true;
+    return false;
+  }
+
+private:
+  void reach(const std::vector<uint32_t> &Seeds, bool AtStart, bool AtEnd,
+             std::vector<uint32_t> &Result) {
+    ++Generation;
+    std::vector<uint32_t> Stack(Seeds.rbegin(), Seeds.rend());
+    while (!Stack.empty()) {
+      uint32_t Id = Stack.back();
+      Stack.pop_back();
+      if (Visited[Id] == Generation)
+        continue;
+      Visited[Id] = Generation;
+      const NFANode &Node = Nodes[Id];
+      bool Follow = Node.Kind == NFANode::Epsilon ||
+                    (Node.Kind == NFANode::AssertBegin && AtStart) ||
+                    (Node.Kind == NFANode::AssertEnd && AtEnd);
+      if (!Follow) {
+        if (Node.Kind != NFANode::AssertBegin)
+          Result.push_back(Id);
+        continue;
+      }
+      Stack.insert(Stack.end(), Node.Next.rbegin(), Node.Next.rend());
+    }
+  }
+
+  const std::vector<NFANode> &Nodes;
+  std::vector<uint32_t> Visited;
+  uint32_t Generation = 0;
+};
+
+// Find a literal that any name matched by the pattern must contain, for
+// patterns that the DFA does not support. Returns an empty string if none is
+// found.
+std::string findRequiredLiteral(const std::string &Pattern) {
+  // Any alternative might match, so no literal is required.
+  if (Pattern.find('|') != std::string::npos)
+    return std::string();
+
+  std::string Longest;
+  std::string Current;
+  auto endLiteral = [&]() {
+    if (Current.size() > Longest.size())
+      Longest = Current;
+    Current.clear();
+  };
+
+  // Skip a bracket expression or group, starting at its opening character.
+  auto skipNested = [&](size_t Pos) {
+    int Depth = 0;
+    bool InBracket = false;
+    for (; Pos < Pattern.size(); ++Pos) {
+      char C = Pattern[Pos];
+      if (C == '\\') {
+        ++Pos;
+      } else if (InBracket) {
+        InBracket = C != ']';
+      } else if (C == '[') {
+        InBracket = true;
+      } else if (C == '(') {
+        ++Depth;
+      } else if (C == ')') {
+        --Depth;
+      }
+      if (!InBracket && Depth == 0)
+        return Pos + 1;
+    }
+    return Pos;
+  };
+
+  size_t Pos = 0;
+  while (Pos < Pattern.size()) {
+    char C = Pattern[Pos];
+    switch (C) {
+    case '*':
+    case '?':
+    case '{':
+      // The character before the quantifier may not appear.
+      if (!Current.empty())
+        Current.pop_back();
+      endLiteral();
+      Pos = C == '{' ? Pattern.find('}', Pos) : Pos;
+      Pos = Pos == std::string::npos ? Pattern.size() : Pos + 1;
+      break;
+    case '+': {
+      // The character before the quantifier must appear, unless a further
+      // quantifier follows, after the '?' that makes it lazy.
+      size_t Next = Pos + 1;
+      if (Next < Pattern.size() && Pattern[Next] == '?')
+        ++Next;
+      if (Next < Pattern.size() && !Current.empty() &&
+          (Pattern[Next] == '*' || Pattern[Next] == '?' ||
+           Pattern[Next] == '{'))
+        Current.pop_back();
+      endLiteral();
+      Pos = Next;
+      break;
+    }
+    case '(':
+    case '[':
+      endLiteral();
+      Pos = skipNested(Pos);
+      break;
+    case '\\': {
+      char E = Pos + 1 < Pattern.size() ? Pattern[Pos + 1] : '\0';
+      Pos += 2;
+      if (std::ispunct(static_cast<unsigned char>(E))) {
+        Current.push_back(E);
+        break;
+      }
+      endLiteral();
+      // Skip the digits of \xhh, \uhhhh, \cX and back references.
+      if (E == 'x')
+        Pos += 2;
+      else if (E == 'u')
+        Pos += 4;
+      else if (E == 'c')
+        Pos += 1;
+      while (isDigit(E) && Pos < Pattern.size() && isDigit(Pattern[Pos]))
+        ++Pos;
+      break;
+    }
+    case '.':
+    case '^':
+    case '$':
+    case ')':
+    case ']':
+    case '}':
+      endLiteral();
+      ++Pos;
+      break;
+    default:
+      Current.push_back(C);
+      ++Pos;
+      break;
+    }
+  }
+  endLiteral();
+  return Longest;
+}
+
+FilterCacheStatistics CacheStatistics;
+
+} // namespace
+
+FilterCacheStatistics &LibScopeView::getFilterCacheStatistics() {
+  return CacheStatistics;
+}
+
+FilterMatcher::FilterMatcher(const std::vector<std::string> &Patterns,
+                             const std::vector<std::string> &Substrings)
+    : IsEmpty(Patterns.empty() && Substrings.empty()) {
+  for (const std::string &Substring : Substrings)
+    if (Substring.empty())
+      MatchesAll = true;
+
+  // Compile every pattern with std::regex, so that all invalid patterns are
+  // reported in the same way.
+  std::vector<std::regex> Regexs;
+  for (const std::string &Pattern : Patterns)
+    Regexs.emplace_back(Pattern);
+
+  std::vector<bool> InDFA;
+  if (!buildDFA(Patterns, InDFA))
+    InDFA.assign(Patterns.size(), false);
+
+  std::map<std::string, int> LiteralIndexes;
+  for (size_t Index = 0; Index < Patterns.size(); ++Index) {
+    if (InDFA[Index])
+      continue;
+    FallbackRegexs.push_back(std::move(Regexs[Index]));
+    std::string Literal = findRequiredLiteral(Patterns[Index]);
+    if (Literal.empty()) {
+      FallbackLiterals.push_back(-1);
+      continue;
+    }
+    auto Inserted = LiteralIndexes.emplace(Literal, int(Literals.size()));
+    if (Inserted.second)
+      Literals.push_back(Literal);
+    FallbackLiterals.push_back(Inserted.first->second);
+  }
+
+  buildAhoCorasick(Substrings);
+}
+
+bool FilterMatcher::buildDFA(const std::vector<std::string> &Patterns,
+                             std::vector<bool> &InDFA) {
+  InDFA.assign(Patterns.size(), false);
+
+  NFABuilder Builder;
+  uint32_t Match = Builder.addNode(NFANode::Match);
+  uint32_t Start = Builder.addNode(NFANode::Epsilon);
+  for (size_t Index = 0; Index < Patterns.size(); ++Index) {
+    RegexNodePtr Parsed = RegexParser(Patterns[Index]).parse();
+    if (!Parsed)
+      continue;
+    uint32_t PatternStart = Builder.compile(*Parsed, Match);
+    Builder.Nodes[Start].Next.push_back(PatternStart);
+    InDFA[Index] = true;
+  }
+  if (Builder.TooLarge)
+    return false;
+  if (Builder.Nodes[Start].Next.empty())
+    return true;
+  const std::vector<NFANode> &Nodes = Builder.Nodes;
+
+  // Split the bytes into classes that every node either matches all of or
+  // none of.
+  ByteClassCount = 1;
+  std::fill(std::begin(ByteClasses), std::end(ByteClasses), 0);
+  for (const NFANode &Node : Nodes) {
+    if (Node.Kind != NFANode::Bytes)
+      continue;
+    std::map<std::pair<uint8_t, bool>, size_t> Split;
+    for (unsigned Byte = 0; Byte < 256; ++Byte) {
+      auto Key = std::make_pair(ByteClasses[Byte], bool(Node.Set[Byte]));
+      auto Inserted = Split.emplace(Key, Split.size());
+      ByteClasses[Byte] = static_cast<uint8_t>(Inserted.first->second);
+    }
+    ByteClassCount = Split.size();
+  }
+  std::vector<unsigned char> ClassBytes(ByteClassCount);
+  for (unsigned Byte = 0; Byte < 256; ++Byte)
+    ClassBytes[ByteClasses[Byte]] = static_cast<unsigned char>(Byte);
+
+  // Subset construction. State 0 is the dead state and state 1 the start
+  // state, which is the only state where the '^' assertions are passed.
+  NFAClosure Closure(Nodes);
+  std::vector<std::vector<uint32_t>> States;
+  std::map<std::vector<uint32_t>, uint32_t> StateIds;
+  States.emplace_back();
+  States.push_back(Closure.getStateNodes({Start}, true));
+  DFATransitions.assign(2 * ByteClassCount, 0);
+  DFAAccepting.assign(2, false);
+  DFAAccepting[1] = Closure.isAccepting(States[1], true);
+  StateIds.emplace(States[0], 0);
+
+  for (uint32_t State = 1; State < States.size(); ++State) {
+    for (size_t Class = 0; Class < ByteClassCount; ++Class) {
+      std::vector<uint32_t> Seeds;
+      for (uint32_t Id : States[State]) {
+        const NFANode &Node = Nodes[Id];
+        if (Node.Kind == NFANode::Bytes && Node.Set[ClassBytes[Class]])
+          Seeds.push_back(Node.Next.front());
+      }
+      std::vector<uint32_t> Target = Closure.getStateNodes(Seeds, false);
+      auto Inserted = StateIds.emplace(Target, uint32_t(States.size()));
+      if (Inserted.second) {
+        if (States.size() == MaxDFAStates) {
+          DFATransitions.clear();
+          DFAAccepting.clear();
+          return false;
+        }
+        DFAAccepting.push_back(Closure.isAccepting(Target, false));
+        States.push_back(std::move(Target));
+        DFATransitions.resize(States.size() * ByteClassCount, 0);
+      }
+      DFATransitions[State * ByteClassCount + Class] = Inserted.first->second;
+    }
+  }
+  HasDFA = true;
+  return true;
+}
+
+void FilterMatcher::buildAhoCorasick(
+    const std::vector<std::string> &Substrings) {
+  const uint32_t NoState = ~0u;
+  ACTransitions.assign(256, NoState);
+  ACMatchesSubstring.assign(1, false);
+  ACLiterals.assign(1, {});
+
+  // Build the trie of the substrings and literals.
+  auto addString = [&](const std::string &String) {
+    uint32_t State = 0;
+    for (unsigned char C : String) {
+      uint32_t &Next = ACTransitions[State * 256 + C];
+      if (Next == NoState) {
+        Next = static_cast<uint32_t>(ACMatchesSubstring.size());
+        ACTransitions.resize(ACTransitions.size() + 256, NoState);
+        ACMatchesSubstring.push_back(false);
+        ACLiterals.emplace_back();
+      }
+      State = ACTransitions[State * 256 + C];
+    }
+    return State;
+  };
+  for (const std::string &Substring : Substrings)
+    if (!Substring.empty())
+      ACMatchesSubstring[addString(Substring)] = true;
+  for (size_t Index = 0; Index < Literals.size(); ++Index)
+    ACLiterals[addString(Literals[Index])].push_back(uint32_t(Index));
+
+  HasAhoCorasick = ACMatchesSubstring.size() > 1;
+  if (!HasAhoCorasick) {
+    ACTransitions.clear();
+    return;
+  }
+
+  // Fill in the missing transitions breadth first from the failure links, so
+  // that matching never needs to follow a failure link.
+  std::vector<uint32_t> Failure(ACMatchesSubstring.size(), 0);
+  std::queue<uint32_t> Pending;
+  Pending.push(0);
+  while (!Pending.empty()) {
+    uint32_t State = Pending.front();
+    Pending.pop();
+    for (unsigned C = 0; C < 256; ++C) {
+      uint32_t &Next = ACTransitions[State * 256 + C];
+      uint32_t FailureNext =
+          State ? ACTransitions[Failure[State] * 256 + C] : 0;
+      if (Next == NoState) {
+        Next = FailureNext;
+        continue;
+      }
+      Failure[Next] = FailureNext;
+      if (ACMatchesSubstring[FailureNext])
+        ACMatchesSubstring[Next] = true;
+      ACLiterals[Next].insert(ACLiterals[Next].end(),
+                              ACLiterals[FailureNext].begin(),
+                              ACLiterals[FailureNext].end());
+      Pending.push(Next);
+    }
+  }
+}
+
+bool FilterMatcher::matches(const std::string &Name) const {
+  if (IsEmpty)
+    return false;
+  if (MatchesAll)
+    return true;
+
+  std::vector<bool> SeenLiterals(Literals.size(), false);
+  uint32_t DFAState = HasDFA ? 1 : 0;
+  uint32_t ACState = 0;
+  for (unsigned char C : Name) {
+    if (DFAState)
+      DFAState = DFATransitions[DFAState * ByteClassCount + ByteClasses[C]];
+    if (HasAhoCorasick) {
+      ACState = ACTransitions[ACState * 256 + C];
+      if (ACMatchesSubstring[ACState])
+        return true;
+      for (uint32_t Literal : ACLiterals[ACState])
+        SeenLiterals[Literal] = true;
+    } else if (!DFAState && FallbackRegexs.empty()) {
+      return false;
+    }
+  }
+  if (HasDFA && DFAAccepting[DFAState])
+    return true;
+
+  for (size_t Index = 0; Index < FallbackRegexs.size(); ++Index) {
+    int Literal = FallbackLiterals[Index];
+    if (Literal >= 0 && !SeenLiterals[Literal])
+      continue;
+    if (std::regex_match(Name, FallbackRegexs[Index]))
+      return true;
+  }
+  return false;
+}
+
+bool FilterMatcher::matches(StringPoolRef Name) const {
+  assert(Name && "Matching a null name");
+  if (IsEmpty)
+    return false;
+
+  CacheStatistics.Lookups.fetch_add(1, std::memory_order_relaxed);
+  auto Cached = Results.find(Name);
+  if (Cached != Results.end()) {
+    CacheStatistics.Hits.fetch_add(1, std::memory_order_relaxed);
+    return Cached->second;
+  }
+
+  bool Result = matches(*Name);
+  Results.emplace(Name, Result);
+  return Result;
+}
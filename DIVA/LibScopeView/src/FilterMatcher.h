@@ -0,0 +1,124 @@
+//===-- LibScopeView/FilterMatcher.h ----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the FilterMatcher class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_FILTERMATCHER_H
+#define SCOPEVIEW_FILTERMATCHER_H
+
+#include "StringPool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief Counts of the lookups in the FilterMatcher result caches.
+struct FilterCacheStatistics {
+  std::atomic<size_t> Lookups{0};
+  std::atomic<size_t> Hits{0};
+};
+
+/// \brief Get the counts for all the FilterMatchers.
+FilterCacheStatistics &getFilterCacheStatistics();
+
+/// \brief Matches names against a set of filters in a single scan of each
+/// name, however many filters there are.
+///
+/// The regular expressions are compiled together into one DFA, and the
+/// substrings into one Aho-Corasick automaton. Regular expressions using
+/// features the DFA does not support (e.g. back references) are matched with
+/// std::regex, but only for names containing the literal text the expression
+/// requires, which is found by the same Aho-Corasick scan.
+class FilterMatcher {
+public:
+  FilterMatcher() = default;
+
+  /// \brief Compile the filters. Each of Patterns is an ECMAScript regular
+  /// expression that must match the whole name, and each of Substrings must
+  /// appear anywhere in the name. Throws std::regex_error if a pattern is not
+  /// a valid regular expression.
+  FilterMatcher(const std::vector<std::string> &Patterns,
+                const std::vector<std::string> &Substrings);
+
+  /// \brief Return true if there are no filters.
+  bool empty() const { return IsEmpty; }
+
+  /// \brief Return true if Name matches any of the filters.
+  bool matches(const std::string &Name) const;
+
+  /// \brief Return true if the interned Name matches any of the filters. The
+  /// result is cached, so each distinct name is only scanned once. Name must
+  /// not be null.
+  bool matches(StringPoolRef Name) const;
+
+private:
+  // Compile the patterns the DFA supports, returning false if they would
+  // need too many DFA states.
+  bool buildDFA(const std::vector<std::string> &Patterns,
+                std::vector<bool> &InDFA);
+
+  // Build the Aho-Corasick automaton over the substrings and the literals
+  // required by the std::regex patterns.
+  void buildAhoCorasick(const std::vector<std::string> &Substrings);
+
+  bool IsEmpty = true;
+
+  // A substring filter is empty, so every name matches.
+  bool MatchesAll = false;
+
+  // The DFA of the regular expressions, with transitions on classes of
+  // bytes that the expressions do not tell apart.
+  bool HasDFA = false;
+  uint8_t ByteClasses[256] = {};
+  size_t ByteClassCount = 0;
+  std::vector<uint32_t> DFATransitions;
+  std::vector<bool> DFAAccepting;
+
+  // The Aho-Corasick automaton, with a full transition table.
+  bool HasAhoCorasick = false;
+  std::vector<uint32_t> ACTransitions;
+  std::vector<bool> ACMatchesSubstring;
+  std::vector<std::vector<uint32_t>> ACLiterals;
+
+  // The patterns matched with std::regex, and the index of the literal each
+  // needs to appear in a name, or -1 if there is none.
+  std::vector<std::regex> FallbackRegexs;
+  std::vector<int> FallbackLiterals;
+  std::vector<std::string> Literals;
+
+  // The results for the interned names matched so far.
+  mutable std::unordered_map<StringPoolRef, bool> Results;
+};
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_FILTERMATCHER_H
@@ -0,0 +1,266 @@
+//===-- LibScopeView/GzipStream.cpp -----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definitions of GzipStreamBuf's methods.
+///
+//===----------------------------------------------------------------------===//
+
+#include "GzipStream.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <utility>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Window bits used for all streams, 15 (the maximum window size) + 16 to
+// request a gzip header and trailer instead of a zlib one.
+const int GzipWindowBits = 15 + 16;
+
+// Default zlib memory level.
+const int GzipMemLevel = 8;
+
+// Size of the chunks written to the output by the streaming compressor.
+const size_t OutputChunkSize = 64 * 1024;
+
+// Compress Input as a complete gzip member. Returns false on failure.
+bool compressBlock(const std::string &Input, std::string &Compressed) {
+  z_stream Strm;
+  Strm.zalloc = Z_NULL;
+  Strm.zfree = Z_NULL;
+  Strm.opaque = Z_NULL;
+  if (deflateInit2(&Strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, GzipWindowBits,
+                   GzipMemLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+
+  // A buffer of deflateBound bytes is enough to compress in a single call.
+  Compressed.resize(deflateBound(&Strm, static_cast<uLong>(Input.size())));
+  Strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(Input.data()));
+  Strm.avail_in = static_cast<uInt>(Input.size());
+  Strm.next_out = reinterpret_cast<Bytef *>(&Compressed[0]);
+  Strm.avail_out = static_cast<uInt>(Compressed.size());
+
+  int Result = deflate(&Strm, Z_FINISH);
+  Compressed.resize(Strm.total_out);
+  deflateEnd(&Strm);
+  return Result == Z_STREAM_END;
+}
+
+// Number of threads used for a requested number of threads. Each thread
+// compresses a buffered block, so more threads than cores only use memory.
+unsigned getThreadCount(unsigned Threads) {
+  unsigned Cores = std::max(1u, std::thread::hardware_concurrency());
+  return Threads != 0 ? std::min(Threads, Cores) : Cores;
+}
+
+} // end anonymous namespace
+
+bool LibScopeView::compressGzip(const std::string &Input,
+                                std::string &Compressed) {
+  return compressBlock(Input, Compressed);
+}
+
+bool LibScopeView::decompressGzip(const std::string &Compressed,
+                                  std::string &Output) {
+  Output.clear();
+  size_t Position = 0;
+  std::vector<char> OutputChunk(OutputChunkSize);
+  // Each gzip member is inflated in turn, as the multi-threaded compressor
+  // writes several.
+  while (Position < Compressed.size()) {
+    z_stream Strm;
+    Strm.zalloc = Z_NULL;
+    Strm.zfree = Z_NULL;
+    Strm.opaque = Z_NULL;
+    Strm.next_in = Z_NULL;
+    Strm.avail_in = 0;
+    if (inflateInit2(&Strm, GzipWindowBits) != Z_OK)
+      return false;
+    Strm.next_in =
+        reinterpret_cast<Bytef *>(const_cast<char *>(Compressed.data())) +
+        Position;
+    Strm.avail_in = static_cast<uInt>(Compressed.size() - Position);
+    int Result;
+    do {
+      Strm.next_out = reinterpret_cast<Bytef *>(OutputChunk.data());
+      Strm.avail_out = static_cast<uInt>(OutputChunk.size());
+      Result = inflate(&Strm, Z_NO_FLUSH);
+      Output.append(OutputChunk.data(), OutputChunk.size() - Strm.avail_out);
+    } while (Result == Z_OK);
+    Position += Strm.total_in;
+    inflateEnd(&Strm);
+    if (Result != Z_STREAM_END)
+      return false;
+  }
+  return true;
+}
+
+struct GzipStreamBuf::StreamState {
+  z_stream Strm;
+  std::vector<char> OutputChunk;
+};
+
+GzipStreamBuf::GzipStreamBuf(std::ostream &Output, unsigned Threads)
+    : Output(Output), Threads(getThreadCount(Threads)), Finished(false), Good(true), InputBuffer(BlockSize), MembersWritten(0),
+      State(nullptr) {
+  setp(InputBuffer.data(), InputBuffer.data() + InputBuffer.size());
+
+  if (this->Threads == 1) {
+    State = new StreamState;
+    State->Strm.zalloc = Z_NULL;
+    State->Strm.zfree = Z_NULL;
+    State->Strm.opaque = Z_NULL;
+    State->OutputChunk.resize(OutputChunkSize);
+    if (deflateInit2(&State->Strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                     GzipWindowBits, GzipMemLevel,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      delete State;
+      State = nullptr;
+      Good = false;
+    }
+  }
+}
+
+GzipStreamBuf::~GzipStreamBuf() {
+  finish();
+  delete State;
+}
+
+bool GzipStreamBuf::finish() {
+  if (Finished)
+    return Good;
+
+  bool Ok = flushInput(FlushMode::Final);
+  Finished = true;
+  if (State) {
+    deflateEnd(&State->Strm);
+  } else if (Ok && MembersWritten == 0) {
+    // Always write at least one member so that an empty input still gives a
+    // valid gzip file.
+    std::string Compressed;
+    Ok = compressBlock(std::string(), Compressed) &&
+         Output.write(Compressed.data(), Compressed.size());
+  }
+  Output.flush();
+  Good = Ok && Output.good();
+  return Good;
+}
+
+GzipStreamBuf::int_type GzipStreamBuf::overflow(int_type Ch) {
+  if (Finished || !flushInput(FlushMode::None)) {
+    Good = false;
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(Ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(Ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(Ch);
+}
+
+int GzipStreamBuf::sync() {
+  if (Finished)
+    return Good && pptr() == pbase() ? 0 : -1;
+  if (!flushInput(FlushMode::Sync) || !Output.flush()) {
+    Good = false;
+    return -1;
+  }
+  return 0;
+}
+
+bool GzipStreamBuf::flushInput(FlushMode Flush) {
+  if (!Good)
+    return false;
+
+  size_t Size = pptr() - pbase();
+  setp(InputBuffer.data(), InputBuffer.data() + InputBuffer.size());
+
+  if (Threads == 1)
+    return deflateStreaming(InputBuffer.data(), Size, Flush);
+
+  // A flushed partial block is written as a smaller gzip member.
+  if (Size != 0)
+    PendingBlocks.emplace_back(InputBuffer.data(), Size);
+  if (PendingBlocks.size() >= Threads || Flush != FlushMode::None)
+    return deflatePendingBlocks();
+  return true;
+}
+
+bool GzipStreamBuf::deflateStreaming(const char *Input, size_t Size,
+                                     FlushMode Flush) {
+  z_stream &Strm = State->Strm;
+  Strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(Input));
+  Strm.avail_in = static_cast<uInt>(Size);
+  bool Final = Flush == FlushMode::Final;
+  // Z_SYNC_FLUSH writes all the pending output on a byte boundary, so the
+  // data so far can be inflated without ending the stream.
+  int ZlibFlush = Final ? Z_FINISH
+                        : Flush == FlushMode::Sync ? Z_SYNC_FLUSH : Z_NO_FLUSH;
+
+  // Keep deflating while zlib fills the whole output chunk, as it may have
+  // more output pending.
+  int Result;
+  do {
+    Strm.next_out = reinterpret_cast<Bytef *>(State->OutputChunk.data());
+    Strm.avail_out = static_cast<uInt>(State->OutputChunk.size());
+    Result = deflate(&Strm, ZlibFlush);
+    if (Result == Z_STREAM_ERROR)
+      return false;
+    size_t Have = State->OutputChunk.size() - Strm.avail_out;
+    if (!Output.write(State->OutputChunk.data(), Have))
+      return false;
+  } while (Strm.avail_out == 0);
+
+  return !Final || Result == Z_STREAM_END;
+}
+
+bool GzipStreamBuf::deflatePendingBlocks() {
+  using CompressResult = std::pair<bool, std::string>;
+  std::vector<std::future<CompressResult>> Compressing;
+  Compressing.reserve(PendingBlocks.size());
+  for (const std::string &Block : PendingBlocks)
+    Compressing.push_back(std::async(std::launch::async, [&Block]() {
+      CompressResult Result;
+      Result.first = compressBlock(Block, Result.second);
+      return Result;
+    }));
+
+  // Wait for every block, even after a failure, as the tasks reference the
+  // pending blocks.
+  bool Ok = true;
+  for (auto &Future : Compressing) {
+    CompressResult Result = Future.get();
+    Ok = Ok && Result.first &&
+         Output.write(Result.second.data(), Result.second.size());
+    ++MembersWritten;
+  }
+  PendingBlocks.clear();
+  return Ok;
+}
@@ -0,0 +1,151 @@
+//===-- LibScopeView/GzipStream.h -------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the GzipStreamBuf and
+/// GzipOutputStream classes, used to write gzip compressed output, and of the
+/// functions compressing and decompressing gzip data in memory.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_GZIPSTREAM_H
+#define SCOPEVIEW_GZIPSTREAM_H
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief A stream buffer that gzip compresses everything written to it and
+/// writes the compressed bytes to another stream.
+///
+/// With a single thread the data is deflated as one continuous stream. With
+/// more than one thread the data is cut into fixed size blocks which are
+/// compressed independently and in parallel, and each block is written as a
+/// separate gzip member. Consecutive gzip members form a valid gzip file which
+/// standard tools decompress as a single stream.
+///
+/// Flushing the stream compresses and writes the data buffered so far, so
+/// that everything written before the flush can be decompressed.
+class GzipStreamBuf : public std::streambuf {
+public:
+  /// \brief Construct a stream buffer writing to Output, compressing with
+  /// up to Threads threads. A Threads value of 0, or one above the number of
+  /// cores, uses one thread per core.
+  GzipStreamBuf(std::ostream &Output, unsigned Threads = 1);
+  ~GzipStreamBuf() override;
+
+  GzipStreamBuf(const GzipStreamBuf &) = delete;
+  GzipStreamBuf &operator=(const GzipStreamBuf &) = delete;
+
+  /// \brief Compress any remaining data and write the gzip trailer.
+  ///
+  /// Called by the destructor if it has not been called already. Returns
+  /// false if compression or writing the output failed.
+  bool finish();
+
+  /// \brief Number of threads used to compress.
+  unsigned getThreads() const { return Threads; }
+
+  /// \brief Size of the blocks compressed in parallel.
+  static const size_t BlockSize = 256 * 1024;
+
+protected:
+  int_type overflow(int_type Ch) override;
+  int sync() override;
+
+private:
+  // How much of the data handed to the compressor must be written out.
+  enum class FlushMode {
+    None,  // Only what fills the output.
+    Sync,  // Everything, leaving the stream open.
+    Final, // Everything, ending the stream.
+  };
+
+  // Hand the filled part of the input buffer to the compressor.
+  bool flushInput(FlushMode Flush);
+
+  // Deflate Input into the continuous stream (single threaded mode).
+  bool deflateStreaming(const char *Input, size_t Size, FlushMode Flush);
+
+  // Compress all the queued blocks in parallel and write them in order.
+  bool deflatePendingBlocks();
+
+  std::ostream &Output;
+  const unsigned Threads;
+  bool Finished;
+  bool Good;
+
+  // Buffer backing the put area.
+  std::vector<char> InputBuffer;
+  // Blocks waiting to be compressed in parallel.
+  std::vector<std::string> PendingBlocks;
+  // Number of gzip members written in multi-threaded mode.
+  size_t MembersWritten;
+
+  // Opaque zlib stream state for the single threaded mode.
+  struct StreamState;
+  StreamState *State;
+};
+
+/// \brief An output stream that gzip compresses everything written to it.
+///
+/// Typical usage:
+/// \code
+///   std::ofstream File("out.txt.gz", std::ios::binary);
+///   {
+///     GzipOutputStream Compressed(File);
+///     Compressed << "Hello\n";
+///   } // The gzip trailer is written when Compressed is destroyed.
+/// \endcode
+class GzipOutputStream : public std::ostream {
+public:
+  GzipOutputStream(std::ostream &Output, unsigned Threads = 1)
+      : std::ostream(nullptr), Buffer(Output, Threads) {
+    rdbuf(&Buffer);
+  }
+
+  /// \brief Finish the compressed stream, setting badbit on failure.
+  void finish() {
+    if (!Buffer.finish())
+      setstate(std::ios_base::badbit);
+  }
+
+private:
+  GzipStreamBuf Buffer;
+};
+
+/// \brief Compress Input as a single gzip member. Returns false on failure.
+bool compressGzip(const std::string &Input, std::string &Compressed);
+
+/// \brief Decompress the gzip members in Compressed, as written by
+/// GzipStreamBuf or compressGzip, into Output. Returns false if Compressed is
+/// not complete gzip data.
+bool decompressGzip(const std::string &Compressed, std::string &Output);
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_GZIPSTREAM_H
@@ -0,0 +1,147 @@
+//===-- LibScopeView/JSONWriter.cpp -----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definitions of JSONWriter's methods.
+///
+//===----------------------------------------------------------------------===//
+
+#include "JSONWriter.h"
+
+#include <assert.h>
+
+using namespace LibScopeView;
+
+void JSONWriter::objectBegin() {
+  beginValue();
+  Buffer += '{';
+  HasMembers.push_back(false);
+}
+
+void JSONWriter::objectEnd() {
+  assert(!HasMembers.empty() && !AfterKey && "Unbalanced JSON object");
+  Buffer += '}';
+  HasMembers.pop_back();
+}
+
+void JSONWriter::arrayBegin() {
+  beginValue();
+  Buffer += '[';
+  HasMembers.push_back(false);
+}
+
+void JSONWriter::arrayEnd() {
+  assert(!HasMembers.empty() && !AfterKey && "Unbalanced JSON array");
+  Buffer += ']';
+  HasMembers.pop_back();
+}
+
+void JSONWriter::key(const char *Name) {
+  assert(!HasMembers.empty() && !AfterKey && "Key outside of an object");
+  if (HasMembers.back())
+    Buffer += ',';
+  HasMembers.back() = true;
+  Buffer += '"';
+  Buffer += Name;
+  Buffer += "\":";
+  AfterKey = true;
+}
+
+void JSONWriter::string(const std::string &Value) {
+  static const char HexDigits[] = "0123456789abcdef";
+
+  beginValue();
+  Buffer += '"';
+  for (char C : Value) {
+    switch (C) {
+    case '"':
+      Buffer += "\\\"";
+      break;
+    case '\\':
+      Buffer += "\\\\";
+      break;
+    case '\n':
+      Buffer += "\\n";
+      break;
+    case '\r':
+      Buffer += "\\r";
+      break;
+    case '\t':
+      Buffer += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20) {
+        Buffer += "\\u00";
+        Buffer += HexDigits[(C >> 4) & 0xf];
+        Buffer += HexDigits[C & 0xf];
+      } else {
+        Buffer += C;
+      }
+    }
+  }
+  Buffer += '"';
+}
+
+void JSONWriter::number(uint64_t Value) {
+  beginValue();
+  Buffer += std::to_string(Value);
+}
+
+void JSONWriter::boolean(bool Value) {
+  beginValue();
+  Buffer += Value ? "true" : "false";
+}
+
+void JSONWriter::null() {
+  beginValue();
+  Buffer += "null";
+}
+
+void JSONWriter::numberOrString(const std::string &Value) {
+  // Only accept the integers JSON accepts: an optional minus sign followed by
+  // digits without leading zeros.
+  size_t Start = (!Value.empty() && Value[0] == '-') ? 1 : 0;
+  bool IsInteger = Value.size() > Start &&
+                   Value.find_first_not_of("0123456789", Start) ==
+                       std::string::npos &&
+                   (Value[Start] != '0' || Value.size() == Start + 1);
+  if (!IsInteger) {
+    string(Value);
+    return;
+  }
+  beginValue();
+  Buffer += Value;
+}
+
+void JSONWriter::beginValue() {
+  if (AfterKey) {
+    AfterKey = false;
+    return;
+  }
+  if (HasMembers.empty())
+    return;
+  if (HasMembers.back())
+    Buffer += ',';
+  HasMembers.back() = true;
+}
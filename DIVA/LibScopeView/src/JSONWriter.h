@@ -0,0 +1,90 @@
+//===-- LibScopeView/JSONWriter.h -------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the JSONWriter class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_JSONWRITER_H
+#define SCOPEVIEW_JSONWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief Appends compact (single line) JSON to a string buffer.
+///
+/// The writer inserts the separators between members and elements itself, so
+/// callers only describe the structure.
+///
+/// Typical usage:
+/// \code
+///   std::string Buffer;
+///   JSONWriter JSON(Buffer);
+///   JSON.objectBegin();
+///   JSON.key("name");
+///   JSON.string("foo");
+///   JSON.key("line");
+///   JSON.number(42);
+///   JSON.objectEnd();
+///   // Buffer == "{\"name\":\"foo\",\"line\":42}"
+/// \endcode
+class JSONWriter {
+public:
+  JSONWriter(std::string &Buffer) : Buffer(Buffer), AfterKey(false) {}
+
+  void objectBegin();
+  void objectEnd();
+  void arrayBegin();
+  void arrayEnd();
+
+  /// \brief Write the key of the next object member.
+  void key(const char *Name);
+
+  void string(const std::string &Value);
+  void number(uint64_t Value);
+  void boolean(bool Value);
+  void null();
+
+  /// \brief Write Value as a number if it is an integer literal, otherwise
+  /// write it as a string.
+  void numberOrString(const std::string &Value);
+
+private:
+  // Write a separator if needed before a new value.
+  void beginValue();
+
+  std::string &Buffer;
+  // For each open object or array, whether it already has a member.
+  std::vector<bool> HasMembers;
+  // A key has been written and its value is pending.
+  bool AfterKey;
+};
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_JSONWRITER_H
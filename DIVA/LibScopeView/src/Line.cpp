@@ -28,6 +28,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "Line.h"
+#include "JSONWriter.h"
 #include "PrintSettings.h"
 #include "Utilities.h"
 
@@ -83,3 +84,20 @@ std::string Line::getAsYAML() const {
   YAML << getCommonYAML() << "\nattributes:" << Attrs.str();
   return YAML.str();
 }
+
+void Line::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.key("Discriminator");
+  JSON.number(getDiscriminator());
+  JSON.key("NewStatement");
+  JSON.boolean(getIsNewStatement());
+  JSON.key("PrologueEnd");
+  JSON.boolean(getIsPrologueEnd());
+  JSON.key("EndSequence");
+  JSON.boolean(getIsLineEndSequence());
+  JSON.key("BasicBlock");
+  JSON.boolean(getIsNewBasicBlock());
+  JSON.key("EpilogueBegin");
+  JSON.boolean(getIsEpilogueBegin());
+  JSON.objectEnd();
+}
@@ -102,6 +102,10 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
 };
 
 } // namespace LibScopeView
@@ -0,0 +1,143 @@
+//===-- LibScopeView/NameIndex.cpp ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///
+/// \file
+/// This file contains the implementation of the NameIndex class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "NameIndex.h"
+#include "Scope.h"
+#include "ScopeVisitor.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Visitor that collects the named objects in a tree, in tree order.
+class NamedObjectCollector : public ConstScopeVisitor {
+public:
+  std::vector<std::pair<StringPoolRef, const Object *>> NamedObjects;
+
+private:
+  void visitImpl(const Object *Obj) override {
+    if (!isa<ScopeRoot>(*Obj)) {
+      if (StringPoolRef Name = Obj->getNamePoolRef())
+        NamedObjects.emplace_back(Name, Obj);
+    }
+    visitChildren(Obj);
+  }
+};
+
+std::string getFullQualifiedName(const Object *Obj) {
+  return Obj->getQualifiedName() + Obj->getName();
+}
+
+} // namespace
+
+NameIndex::NameIndex(const ScopeRoot &Root) {
+  NamedObjectCollector Collector;
+  Collector.visit(&Root);
+  auto &NamedObjects = Collector.NamedObjects;
+
+  // Group the objects by name, keeping the tree order within each name, and
+  // then order the names by their text.
+  std::stable_sort(NamedObjects.begin(), NamedObjects.end(),
+                   [](const std::pair<StringPoolRef, const Object *> &A,
+                      const std::pair<StringPoolRef, const Object *> &B) {
+                     return A.first < B.first;
+                   });
+  std::vector<std::pair<StringPoolRef, size_t>> Groups;
+  for (size_t Index = 0; Index < NamedObjects.size(); ++Index) {
+    StringPoolRef Name = NamedObjects[Index].first;
+    if (Index == 0 || Name != NamedObjects[Index - 1].first)
+      Groups.emplace_back(Name, Index);
+  }
+  std::vector<size_t> GroupEnds(Groups.size());
+  for (size_t Group = 0; Group < Groups.size(); ++Group)
+    GroupEnds[Group] = Group + 1 < Groups.size() ? Groups[Group + 1].second
+                                                 : NamedObjects.size();
+  std::vector<size_t> Order(Groups.size());
+  for (size_t Group = 0; Group < Groups.size(); ++Group)
+    Order[Group] = Group;
+  std::sort(Order.begin(), Order.end(), [&](size_t A, size_t B) {
+    return *Groups[A].first < *Groups[B].first;
+  });
+
+  Names.reserve(Groups.size());
+  NameStarts.reserve(Groups.size() + 1);
+  Objects.reserve(NamedObjects.size());
+  for (size_t Group : Order) {
+    Names.push_back(Groups[Group].first);
+    NameStarts.push_back(static_cast<uint32_t>(Objects.size()));
+    for (size_t Index = Groups[Group].second; Index < GroupEnds[Group];
+         ++Index)
+      Objects.push_back(NamedObjects[Index].second);
+  }
+  NameStarts.push_back(static_cast<uint32_t>(Objects.size()));
+
+  // Sort the objects by their qualified names.
+  std::vector<std::pair<std::string, const Object *>> Qualified;
+  Qualified.reserve(Objects.size());
+  for (const Object *Obj : Objects)
+    Qualified.emplace_back(getFullQualifiedName(Obj), Obj);
+  std::stable_sort(Qualified.begin(), Qualified.end(),
+                   [](const std::pair<std::string, const Object *> &A,
+                      const std::pair<std::string, const Object *> &B) {
+                     return A.first < B.first;
+                   });
+  QualifiedObjects.reserve(Qualified.size());
+  for (const auto &Entry : Qualified)
+    QualifiedObjects.push_back(Entry.second);
+}
+
+NameIndex::ObjectRange NameIndex::find(const std::string &Name) const {
+  auto Found = std::lower_bound(
+      Names.begin(), Names.end(), Name,
+      [](StringPoolRef Entry, const std::string &Key) { return *Entry < Key; });
+  if (Found == Names.end() || **Found != Name)
+    return ObjectRange();
+  size_t Index = Found - Names.begin();
+  return ObjectRange(Objects.data() + NameStarts[Index],
+                     Objects.data() + NameStarts[Index + 1]);
+}
+
+NameIndex::ObjectRange
+NameIndex::findQualified(const std::string &QualifiedName) const {
+  auto First = std::lower_bound(
+      QualifiedObjects.begin(), QualifiedObjects.end(), QualifiedName,
+      [](const Object *Obj, const std::string &Key) {
+        return getFullQualifiedName(Obj) < Key;
+      });
+  auto Last = std::upper_bound(
+      First, QualifiedObjects.end(), QualifiedName,
+      [](const std::string &Key, const Object *Obj) {
+        return Key < getFullQualifiedName(Obj);
+      });
+  const Object *const *Data = QualifiedObjects.data();
+  return ObjectRange(Data + (First - QualifiedObjects.begin()),
+                     Data + (Last - QualifiedObjects.begin()));
+}
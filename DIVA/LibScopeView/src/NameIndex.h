@@ -0,0 +1,91 @@
+//===-- LibScopeView/NameIndex.h --------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///
+/// \file
+/// This file contains the declaration of the NameIndex class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_NAMEINDEX_H
+#define SCOPEVIEW_NAMEINDEX_H
+
+#include "StringPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+class Object;
+class ScopeRoot;
+
+/// \brief An index of the objects in a tree by name and by qualified name.
+///
+/// The index is built once the tree is complete, and is kept as sorted
+/// arrays so finding all the objects with a name is a binary search rather
+/// than a walk of the whole tree.
+class NameIndex {
+public:
+  /// \brief The objects with a name, in the order they are in the tree.
+  class ObjectRange {
+  public:
+    ObjectRange() = default;
+    ObjectRange(const Object *const *First, const Object *const *Last)
+        : Begin(First), End(Last) {}
+
+    const Object *const *begin() const { return Begin; }
+    const Object *const *end() const { return End; }
+    size_t size() const { return End - Begin; }
+    bool empty() const { return Begin == End; }
+
+  private:
+    const Object *const *Begin = nullptr;
+    const Object *const *End = nullptr;
+  };
+
+  /// \brief Index the objects below Root.
+  explicit NameIndex(const ScopeRoot &Root);
+
+  /// \brief Find the objects named Name.
+  ObjectRange find(const std::string &Name) const;
+
+  /// \brief Find the objects with the qualified name QualifiedName (e.g.
+  /// "NS::Class::Method").
+  ObjectRange findQualified(const std::string &QualifiedName) const;
+
+private:
+  // The distinct names, sorted, and the index in Objects of the first object
+  // with each name. NameStarts has an extra entry for the end of Objects.
+  std::vector<StringPoolRef> Names;
+  std::vector<uint32_t> NameStarts;
+  std::vector<const Object *> Objects;
+
+  // The objects with a qualified name, sorted by it.
+  std::vector<const Object *> QualifiedObjects;
+};
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_NAMEINDEX_H
@@ -28,7 +28,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "Object.h"
+#include "DwarfNames.h"
 #include "FileUtilities.h"
+#include "JSONWriter.h"
 #include "Line.h"
 #include "PrintSettings.h"
 #include "Scope.h"
@@ -326,16 +328,86 @@ std::string Object::getCommonYAML() const {
 
   // Dwarf.
   YAML << "dwarf:\n  offset: 0x" << std::hex << getDieOffset() << "\n  tag: ";
-  if (getDieTag() != 0) {
-    const char *TagName;
-    dwarf_get_TAG_name(getDieTag(), &TagName);
-    YAML << "\"" << TagName << "\"";
-  } else
+  if (getDieTag() != 0)
+    YAML << "\"" << getDwarfTagName(getDieTag()).Name << "\"";
+  else
     YAML << "null";
 
   return YAML.str();
 }
 
+void Object::writeAsJSON(JSONWriter &JSON) const {
+  writeCommonJSON(JSON);
+  JSON.key("attributes");
+  writeAttributesAsJSON(JSON);
+}
+
+void Object::writeCommonJSON(JSONWriter &JSON) const {
+  // Kind.
+  JSON.key("object");
+  JSON.string(getKindAsString());
+
+  // Name.
+  std::string Name;
+  Name += getQualifiedName();
+  if (isa<Symbol>(*this) && cast<Symbol>(this)->getIsUnspecifiedParameter())
+    Name += "...";
+  else
+    Name += getName();
+
+  JSON.key("name");
+  if (!Name.empty())
+    JSON.string(Name);
+  else
+    JSON.null();
+
+  // Type.
+  JSON.key("type");
+
+  // Template's types are printed in attributes.
+  if (getType() && !(isa<TypeTemplateParam>(*this))) {
+    std::string TypeName;
+    TypeName += getType()->getQualifiedName();
+    TypeName += getType()->getName();
+    JSON.string(TypeName);
+  }
+  // Functions must have types.
+  else if (isa<ScopeFunction>(*this))
+    JSON.string("void");
+  else
+    JSON.null();
+
+  // Source.
+  JSON.key("line");
+  if (getLineNumber() != 0)
+    JSON.number(getLineNumber());
+  else
+    JSON.null();
+
+  std::string FileName(getFileName(getFilePath()));
+  JSON.key("file");
+  if (getInvalidFileName())
+    JSON.string("?");
+  else if (!FileName.empty())
+    JSON.string(FileName);
+  else
+    JSON.null();
+
+  // Dwarf.
+  JSON.key("offset");
+  JSON.number(getDieOffset());
+  JSON.key("tag");
+  if (getDieTag() != 0)
+    JSON.string(getDwarfTagName(getDieTag()).Name);
+  else
+    JSON.null();
+}
+
+void Object::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.objectEnd();
+}
+
 //===----------------------------------------------------------------------===//
 // Class to represent the basic data for an object.
 //===----------------------------------------------------------------------===//
@@ -51,6 +51,7 @@
 
 namespace LibScopeView {
 
+class JSONWriter;
 class Object;
 class PrintSettings;
 class Scope;
@@ -226,12 +227,19 @@ public:
   virtual std::string getAsText(const PrintSettings &Settings) const = 0;
   /// \brief Returns a YAML representation of this DIVA Object.
   virtual std::string getAsYAML() const = 0;
+  /// \brief Writes the members of a JSON representation of this DIVA Object.
+  virtual void writeAsJSON(JSONWriter &JSON) const;
 
-protected:
   /// \brief Returns a text representation of attribute information.
   static std::string formatAttributeText(const std::string &AttributeText);
+
+protected:
   /// \brief Returns the common YAML information for this object.
   std::string getCommonYAML() const;
+  /// \brief Writes the common JSON members for this object.
+  void writeCommonJSON(JSONWriter &JSON) const;
+  /// \brief Writes the JSON object holding this object's attributes.
+  virtual void writeAttributesAsJSON(JSONWriter &JSON) const;
 };
 
 /// \brief Class to represent the basic data for an object.
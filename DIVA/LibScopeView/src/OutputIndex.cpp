@@ -0,0 +1,83 @@
+//===-- LibScopeView/OutputIndex.cpp ----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definitions of the OutputIndex class's methods.
+///
+//===----------------------------------------------------------------------===//
+
+#include "OutputIndex.h"
+#include "Error.h"
+#include "FileUtilities.h"
+#include "Object.h"
+
+#include <algorithm>
+
+using namespace LibScopeView;
+
+CountingStreamBuffer::int_type CountingStreamBuffer::overflow(int_type C) {
+  if (traits_type::eq_int_type(C, traits_type::eof()))
+    return traits_type::not_eof(C);
+  if (traits_type::eq_int_type(Target->sputc(traits_type::to_char_type(C)),
+                               traits_type::eof()))
+    return traits_type::eof();
+  ++Offset;
+  if (traits_type::to_char_type(C) == '\n')
+    ++Lines;
+  return C;
+}
+
+std::streamsize CountingStreamBuffer::xsputn(const char *Data,
+                                             std::streamsize Size) {
+  std::streamsize Written = Target->sputn(Data, Size);
+  Offset += static_cast<uint64_t>(Written);
+  Lines += static_cast<uint64_t>(std::count(Data, Data + Written, '\n'));
+  return Written;
+}
+
+OutputIndex::OutputIndex(std::ostream &Output, const std::string &IndexPath)
+    : Path(IndexPath), Buffer(Output.rdbuf()), Stream(&Buffer) {
+  std::string UnifiedPath = unifyFilePath(Path);
+  recursiveMakeDir(getDirectoryName(UnifiedPath));
+  File.open(nativeFilePath(UnifiedPath), std::ios::trunc);
+  if (!File)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+}
+
+OutputIndex::~OutputIndex() { Stream.flush(); }
+
+void OutputIndex::add(const Object &Obj) {
+  File << Buffer.getOffset() << '\t' << Buffer.getLineNumber() << '\t'
+       << Obj.getKindAsString() << '\t' << Obj.getQualifiedName()
+       << Obj.getName() << '\n';
+}
+
+void OutputIndex::finish() {
+  Stream.flush();
+  File.flush();
+  if (!File)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+}
@@ -0,0 +1,107 @@
+//===-- LibScopeView/OutputIndex.h ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the OutputIndex class, which writes
+/// where the objects printed start in the text output.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_OUTPUTINDEX_H
+#define SCOPEVIEW_OUTPUTINDEX_H
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace LibScopeView {
+
+class Object;
+
+/// \brief A stream buffer that passes everything written to it on to another
+/// stream buffer, counting the bytes and lines written.
+class CountingStreamBuffer : public std::streambuf {
+public:
+  explicit CountingStreamBuffer(std::streambuf *Target) : Target(Target) {}
+
+  /// \brief Get the number of bytes written.
+  uint64_t getOffset() const { return Offset; }
+
+  /// \brief Get the number of the line being written, counting from 1.
+  uint64_t getLineNumber() const { return Lines + 1; }
+
+protected:
+  int_type overflow(int_type C) override;
+  std::streamsize xsputn(const char *Data, std::streamsize Size) override;
+  int sync() override { return Target->pubsync(); }
+
+private:
+  std::streambuf *Target;
+  uint64_t Offset = 0;
+  uint64_t Lines = 0;
+};
+
+/// \brief Writes an index of text output, giving the byte offset and the line
+/// of the objects added to it.
+///
+/// The output is written through getStream(), which counts the bytes and
+/// lines as they are written, so the index costs no more than a count of the
+/// new lines. Each line of the index is
+/// \code
+///   <offset> <line> <kind> <name>
+/// \endcode
+/// with the fields separated by tabs, in the order the objects are printed.
+class OutputIndex {
+public:
+  /// \brief Index the text written to Output through getStream() in the file
+  /// at IndexPath, calling fatalError if it can not be created.
+  OutputIndex(std::ostream &Output, const std::string &IndexPath);
+  ~OutputIndex();
+
+  OutputIndex(const OutputIndex &) = delete;
+  OutputIndex &operator=(const OutputIndex &) = delete;
+
+  /// \brief Get the stream to write the indexed output to.
+  std::ostream &getStream() { return Stream; }
+
+  /// \brief Add Obj to the index, as starting at the current position of the
+  /// output.
+  void add(const Object &Obj);
+
+  /// \brief Write any of the index still buffered, calling fatalError if it
+  /// can not be written.
+  void finish();
+
+private:
+  std::string Path;
+  std::ofstream File;
+  CountingStreamBuffer Buffer;
+  std::ostream Stream;
+};
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_OUTPUTINDEX_H
@@ -0,0 +1,279 @@
+//===-- OutputPack.cpp ------------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the writer and the reader of output packs.
+///
+//===----------------------------------------------------------------------===//
+
+#include "OutputPack.h"
+#include "Error.h"
+#include "FileUtilities.h"
+#include "GzipStream.h"
+#include "ScopeHash.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace LibScopeView;
+
+namespace {
+
+const char PackMagic[8] = {'D', 'I', 'V', 'A', 'P', 'A', 'C', 'K'};
+// Changed whenever the layout of the file changes.
+const uint32_t PackVersion = 1;
+const uint64_t HeaderSize = sizeof(PackMagic) + sizeof(PackVersion);
+
+// A slot of the index is the hash of the name, or 0 if the slot is empty, the
+// offset and size of the name, the flags, and the offset, size and hash of
+// the contents.
+const uint64_t SlotSize = 8 + 8 + 4 + 4 + 8 + 8 + 8;
+const uint32_t CompressedFlag = 1 << 0;
+
+// The trailer is the offset of the index, its number of slots, the number of
+// files and the magic string again.
+const uint64_t TrailerSize = 8 + 8 + 8 + sizeof(PackMagic);
+
+uint64_t hashName(const std::string &Name) {
+  HashBuilder Hash;
+  Hash.add(Name);
+  // 0 marks the empty slots.
+  return std::max<uint64_t>(Hash.get(), 1);
+}
+
+uint64_t hashContents(const std::string &Contents) {
+  HashBuilder Hash;
+  Hash.add(Contents);
+  return Hash.get();
+}
+
+} // namespace
+
+OutputPackWriter::OutputPackWriter(const std::string &Path) : Path(Path) {
+  std::string UnifiedPath = unifyFilePath(Path);
+  recursiveMakeDir(getDirectoryName(UnifiedPath));
+  File.open(nativeFilePath(UnifiedPath), std::ios::binary | std::ios::trunc);
+  if (!File)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+  write(PackMagic, sizeof(PackMagic));
+  write(PackVersion);
+}
+
+void OutputPackWriter::add(const std::string &Name,
+                           const std::string &Contents, bool Compress) {
+  OutputPackEntry Entry;
+  Entry.Name = Name;
+  Entry.Hash = hashContents(Contents);
+  Entry.IsCompressed = Compress;
+  std::string Compressed;
+  if (Compress && !compressGzip(Contents, Compressed))
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_COMPRESS, Name);
+  const std::string &Data = Compress ? Compressed : Contents;
+  Entry.Size = Data.size();
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Entry.Offset = Position;
+  write(Data.data(), Data.size());
+  auto Inserted = EntryIndexes.emplace(Name, Entries.size());
+  if (Inserted.second)
+    Entries.push_back(std::move(Entry));
+  else
+    Entries[Inserted.first->second] = std::move(Entry);
+}
+
+void OutputPackWriter::finish() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  std::vector<uint64_t> NameOffsets;
+  NameOffsets.reserve(Entries.size());
+  for (const OutputPackEntry &Entry : Entries) {
+    NameOffsets.push_back(Position);
+    write(Entry.Name.data(), Entry.Name.size());
+  }
+
+  // Place each file in the first free slot from the one its name hashes to.
+  uint64_t SlotCount = 0;
+  if (!Entries.empty())
+    for (SlotCount = 1; SlotCount < Entries.size() * 2;)
+      SlotCount *= 2;
+  std::vector<size_t> Slots(SlotCount, Entries.size());
+  std::vector<uint64_t> NameHashes(Entries.size());
+  for (size_t I = 0; I < Entries.size(); ++I) {
+    NameHashes[I] = hashName(Entries[I].Name);
+    uint64_t Slot = NameHashes[I] & (SlotCount - 1);
+    while (Slots[Slot] != Entries.size())
+      Slot = (Slot + 1) & (SlotCount - 1);
+    Slots[Slot] = I;
+  }
+
+  uint64_t IndexOffset = Position;
+  for (size_t I : Slots) {
+    if (I == Entries.size()) {
+      std::string Empty(SlotSize, '\0');
+      write(Empty.data(), Empty.size());
+      continue;
+    }
+    const OutputPackEntry &Entry = Entries[I];
+    write(NameHashes[I]);
+    write(NameOffsets[I]);
+    write(static_cast<uint32_t>(Entry.Name.size()));
+    write(Entry.IsCompressed ? CompressedFlag : uint32_t(0));
+    write(Entry.Offset);
+    write(Entry.Size);
+    write(Entry.Hash);
+  }
+  write(IndexOffset);
+  write(SlotCount);
+  write(static_cast<uint64_t>(Entries.size()));
+  write(PackMagic, sizeof(PackMagic));
+
+  File.close();
+  if (!File)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+}
+
+void OutputPackWriter::write(const char *Data, size_t Size) {
+  if (!File.write(Data, static_cast<std::streamsize>(Size)))
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+  Position += Size;
+}
+
+OutputPackReader::OutputPackReader(const std::string &Path) : Path(Path) {
+  File.open(nativeFilePath(unifyFilePath(Path)),
+            std::ios::binary | std::ios::ate);
+  if (!File)
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_FILE_NOT_FOUND,
+                              Path);
+  std::streamoff End = File.tellg();
+  if (End < static_cast<std::streamoff>(HeaderSize + TrailerSize))
+    invalidPack();
+  FileSize = static_cast<uint64_t>(End);
+
+  char Magic[sizeof(PackMagic)];
+  read(0, Magic, sizeof(Magic));
+  if (std::memcmp(Magic, PackMagic, sizeof(PackMagic)) != 0 ||
+      read<uint32_t>(sizeof(PackMagic)) != PackVersion)
+    invalidPack();
+
+  uint64_t TrailerOffset = FileSize - TrailerSize;
+  IndexOffset = read<uint64_t>(TrailerOffset);
+  SlotCount = read<uint64_t>(TrailerOffset + 8);
+  EntryCount = read<uint64_t>(TrailerOffset + 16);
+  read(TrailerOffset + 24, Magic, sizeof(Magic));
+  if (std::memcmp(Magic, PackMagic, sizeof(PackMagic)) != 0 ||
+      IndexOffset < HeaderSize || IndexOffset > TrailerOffset ||
+      (TrailerOffset - IndexOffset) / SlotSize != SlotCount ||
+      (TrailerOffset - IndexOffset) % SlotSize != 0 ||
+      (SlotCount & (SlotCount - 1)) != 0 || EntryCount > SlotCount)
+    invalidPack();
+}
+
+bool OutputPackReader::find(const std::string &Name, OutputPackEntry &Entry) {
+  uint64_t Hash = hashName(Name);
+  uint64_t NameHash;
+  for (uint64_t Probe = 0; Probe < SlotCount; ++Probe) {
+    if (!readSlot((Hash + Probe) & (SlotCount - 1), NameHash, Entry))
+      return false;
+    if (NameHash == Hash && Entry.Name == Name)
+      return true;
+  }
+  return false;
+}
+
+std::vector<OutputPackEntry> OutputPackReader::getEntries() {
+  std::vector<OutputPackEntry> Entries;
+  OutputPackEntry Entry;
+  uint64_t NameHash;
+  for (uint64_t Slot = 0; Slot < SlotCount; ++Slot)
+    if (readSlot(Slot, NameHash, Entry))
+      Entries.push_back(Entry);
+  std::sort(Entries.begin(), Entries.end(),
+            [](const OutputPackEntry &A, const OutputPackEntry &B) {
+              return A.Offset < B.Offset;
+            });
+  return Entries;
+}
+
+std::string OutputPackReader::read(const OutputPackEntry &Entry) {
+  if (Entry.Offset < HeaderSize || Entry.Offset > IndexOffset ||
+      IndexOffset - Entry.Offset < Entry.Size)
+    invalidPack();
+  std::string Data(static_cast<size_t>(Entry.Size), '\0');
+  read(Entry.Offset, &Data[0], Data.size());
+  std::string Contents;
+  if (Entry.IsCompressed && !decompressGzip(Data, Contents))
+    invalidPack();
+  if (!Entry.IsCompressed)
+    Contents = std::move(Data);
+  if (hashContents(Contents) != Entry.Hash)
+    invalidPack();
+  return Contents;
+}
+
+bool OutputPackReader::readSlot(uint64_t Index, uint64_t &NameHash,
+                                OutputPackEntry &Entry) {
+  char Slot[SlotSize];
+  read(IndexOffset + Index * SlotSize, Slot, sizeof(Slot));
+  auto Field = [&](size_t Offset, auto &Value) {
+    std::memcpy(&Value, Slot + Offset, sizeof(Value));
+  };
+  Field(0, NameHash);
+  if (!NameHash)
+    return false;
+  uint64_t NameOffset;
+  uint32_t NameSize, Flags;
+  Field(8, NameOffset);
+  Field(16, NameSize);
+  Field(20, Flags);
+  Field(24, Entry.Offset);
+  Field(32, Entry.Size);
+  Field(40, Entry.Hash);
+  Entry.IsCompressed = Flags & CompressedFlag;
+  if (NameOffset < HeaderSize || NameOffset > IndexOffset ||
+      IndexOffset - NameOffset < NameSize)
+    invalidPack();
+  Entry.Name.resize(NameSize);
+  read(NameOffset, &Entry.Name[0], NameSize);
+  return true;
+}
+
+void OutputPackReader::read(uint64_t Offset, char *Data, size_t Size) {
+  File.seekg(static_cast<std::streamoff>(Offset));
+  if (!File.read(Data, static_cast<std::streamsize>(Size)))
+    invalidPack();
+}
+
+void OutputPackReader::invalidPack() const {
+  LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_PACK, Path);
+}
+
+bool LibScopeView::isFileFormatOutputPack(const std::string &FileLocation) {
+  std::ifstream File(nativeFilePath(FileLocation), std::ios::binary);
+  char Magic[sizeof(PackMagic)];
+  return File.read(Magic, sizeof(Magic)) &&
+         std::memcmp(Magic, PackMagic, sizeof(PackMagic)) == 0;
+}
@@ -0,0 +1,133 @@
+//===-- OutputPack.h --------------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the writer and the reader of output packs, which hold
+/// the files of split output in a single file.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_OUTPUTPACK_H
+#define SCOPEVIEW_OUTPUTPACK_H
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief A file held in an output pack.
+struct OutputPackEntry {
+  std::string Name;
+  uint64_t Offset = 0;
+  uint64_t Size = 0;
+  // The hash of the contents, before any compression.
+  uint64_t Hash = 0;
+  bool IsCompressed = false;
+};
+
+/// \brief Writes the files of split output into a single output pack.
+///
+/// A pack starts with a magic string and a version, followed by the contents
+/// of its files one after another, each gzip compressed if asked. The names of
+/// the files come next, then an index and a trailer of a fixed size giving the
+/// offset and size of the index. The index is a hash table of the names with
+/// at least twice as many slots as files, so that a file is found by reading
+/// the trailer and a few slots, whatever the number of files.
+class OutputPackWriter {
+public:
+  /// \brief Create the pack at Path, calling fatalError if it can not be.
+  explicit OutputPackWriter(const std::string &Path);
+
+  OutputPackWriter(const OutputPackWriter &) = delete;
+  OutputPackWriter &operator=(const OutputPackWriter &) = delete;
+
+  /// \brief Add a file to the pack, replacing any file added before with the
+  /// same Name. Files can be added from several threads at once.
+  void add(const std::string &Name, const std::string &Contents,
+           bool Compress);
+
+  /// \brief Write the names and the index, completing the pack.
+  void finish();
+
+private:
+  void write(const char *Data, size_t Size);
+  template <class T> void write(T Value) {
+    write(reinterpret_cast<const char *>(&Value), sizeof(Value));
+  }
+
+  std::string Path;
+  std::ofstream File;
+  uint64_t Position = 0;
+  std::vector<OutputPackEntry> Entries;
+  std::unordered_map<std::string, size_t> EntryIndexes;
+  std::mutex Mutex;
+};
+
+/// \brief Reads the files of an output pack.
+class OutputPackReader {
+public:
+  /// \brief Open the pack at Path, calling fatalError if it is not one.
+  explicit OutputPackReader(const std::string &Path);
+
+  /// \brief Find the file called Name, reading only the slots of the index
+  /// it may be in. Returns false if the pack does not hold it.
+  bool find(const std::string &Name, OutputPackEntry &Entry);
+
+  /// \brief Get all the files of the pack, in the order they were added.
+  std::vector<OutputPackEntry> getEntries();
+
+  /// \brief Read the contents of a file, decompressing them if needed.
+  /// Calls fatalError if they are damaged.
+  std::string read(const OutputPackEntry &Entry);
+
+private:
+  // Read the slot of the index at Index into Entry, returning false if it is
+  // empty.
+  bool readSlot(uint64_t Index, uint64_t &NameHash, OutputPackEntry &Entry);
+  void read(uint64_t Offset, char *Data, size_t Size);
+  template <class T> T read(uint64_t Offset) {
+    T Value;
+    read(Offset, reinterpret_cast<char *>(&Value), sizeof(Value));
+    return Value;
+  }
+  [[noreturn]] void invalidPack() const;
+
+  std::string Path;
+  std::ifstream File;
+  uint64_t FileSize = 0;
+  uint64_t IndexOffset = 0;
+  uint64_t SlotCount = 0;
+  uint64_t EntryCount = 0;
+};
+
+/// \brief Return true if the file is an output pack.
+bool isFileFormatOutputPack(const std::string &FileLocation);
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_OUTPUTPACK_H
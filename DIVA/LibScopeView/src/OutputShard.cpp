@@ -0,0 +1,185 @@
+//===-- LibScopeView/OutputShard.cpp ----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the writer and the reader of the shards printed by
+/// --cu-shard.
+///
+//===----------------------------------------------------------------------===//
+
+#include "OutputShard.h"
+#include "Error.h"
+#include "FileUtilities.h"
+#include "ScopeHash.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace LibScopeView;
+
+namespace {
+
+const char ShardMagic[8] = {'D', 'I', 'V', 'A', 'S', 'H', 'R', 'D'};
+// Changed whenever the layout of the file changes.
+const uint32_t ShardVersion = 1;
+const uint64_t HeaderSize = sizeof(ShardMagic) + sizeof(ShardVersion);
+
+// The trailer is the ShardInfo, the size of the output and the magic string
+// again.
+const uint64_t TrailerSize = 4 + 4 + 8 * 5 + 8 + sizeof(ShardMagic);
+
+template <class T> void writeValue(std::ostream &Output, T Value) {
+  Output.write(reinterpret_cast<const char *>(&Value), sizeof(Value));
+}
+
+template <class T> void readValue(const char *&Data, T &Value) {
+  std::memcpy(&Value, Data, sizeof(Value));
+  Data += sizeof(Value);
+}
+
+} // namespace
+
+ShardInfo LibScopeView::getShardParts(const std::vector<uint64_t> &PartSizes,
+                                      unsigned Index, unsigned Count) {
+  ShardInfo Info;
+  Info.Index = Index;
+  Info.Count = Count;
+  Info.PartCount = PartSizes.size();
+
+  HashBuilder Hash;
+  uint64_t Total = 0;
+  for (uint64_t Size : PartSizes) {
+    Hash.add(Size);
+    Total += Size;
+  }
+  Info.PartsHash = Hash.get();
+
+  // The shards of the parts never decrease, so those of shard Index follow
+  // each other.
+  auto getShard = [&](uint64_t Start, uint64_t Size) {
+    if (!Total)
+      return 0U;
+    uint64_t Middle = Start * 2 + Size;
+    return static_cast<unsigned>(
+        std::min<uint64_t>(Middle * Count / (Total * 2), Count - 1));
+  };
+  Info.FirstPart = Info.EndPart = PartSizes.size();
+  uint64_t Start = 0;
+  for (size_t Part = 0; Part < PartSizes.size(); ++Part) {
+    unsigned Shard = getShard(Start, PartSizes[Part]);
+    Start += PartSizes[Part];
+    if (Shard >= Index && Info.FirstPart == PartSizes.size())
+      Info.FirstPart = Part;
+    if (Shard > Index) {
+      Info.EndPart = Part;
+      break;
+    }
+  }
+  return Info;
+}
+
+ShardWriter::ShardWriter(const std::string &Path) : Path(Path) {
+  std::string UnifiedPath = unifyFilePath(Path);
+  recursiveMakeDir(getDirectoryName(UnifiedPath));
+  File.open(nativeFilePath(UnifiedPath), std::ios::binary | std::ios::trunc);
+  if (!File)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+  File.write(ShardMagic, sizeof(ShardMagic));
+  writeValue(File, ShardVersion);
+}
+
+void ShardWriter::finish(const ShardInfo &Info) {
+  uint64_t OutputSize = static_cast<uint64_t>(File.tellp()) - HeaderSize;
+  writeValue(File, Info.Index);
+  writeValue(File, Info.Count);
+  writeValue(File, Info.FirstPart);
+  writeValue(File, Info.EndPart);
+  writeValue(File, Info.PartCount);
+  writeValue(File, Info.PartsHash);
+  writeValue(File, Info.SettingsHash);
+  writeValue(File, OutputSize);
+  File.write(ShardMagic, sizeof(ShardMagic));
+
+  File.close();
+  if (!File)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+}
+
+ShardReader::ShardReader(const std::string &Path) : Path(Path) {
+  File.open(nativeFilePath(unifyFilePath(Path)),
+            std::ios::binary | std::ios::ate);
+  if (!File)
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_FILE_NOT_FOUND,
+                              Path);
+  std::streamoff End = File.tellg();
+  if (End < static_cast<std::streamoff>(HeaderSize + TrailerSize))
+    invalidShard();
+  uint64_t FileSize = static_cast<uint64_t>(End);
+
+  char Header[HeaderSize];
+  char Trailer[TrailerSize];
+  File.seekg(0);
+  if (!File.read(Header, sizeof(Header)))
+    invalidShard();
+  File.seekg(static_cast<std::streamoff>(FileSize - TrailerSize));
+  if (!File.read(Trailer, sizeof(Trailer)))
+    invalidShard();
+
+  uint32_t Version;
+  std::memcpy(&Version, Header + sizeof(ShardMagic), sizeof(Version));
+  const char *Data = Trailer;
+  readValue(Data, Info.Index);
+  readValue(Data, Info.Count);
+  readValue(Data, Info.FirstPart);
+  readValue(Data, Info.EndPart);
+  readValue(Data, Info.PartCount);
+  readValue(Data, Info.PartsHash);
+  readValue(Data, Info.SettingsHash);
+  readValue(Data, OutputSize);
+  if (std::memcmp(Header, ShardMagic, sizeof(ShardMagic)) != 0 ||
+      Version != ShardVersion ||
+      std::memcmp(Data, ShardMagic, sizeof(ShardMagic)) != 0 ||
+      OutputSize != FileSize - HeaderSize - TrailerSize ||
+      Info.Index >= Info.Count || Info.FirstPart > Info.EndPart ||
+      Info.EndPart > Info.PartCount)
+    invalidShard();
+}
+
+void ShardReader::copyOutput(std::ostream &Output) {
+  File.seekg(static_cast<std::streamoff>(HeaderSize));
+  std::vector<char> Buffer(64 * 1024);
+  for (uint64_t Left = OutputSize; Left;) {
+    size_t Size = static_cast<size_t>(std::min<uint64_t>(Left, Buffer.size()));
+    if (!File.read(Buffer.data(), static_cast<std::streamsize>(Size)))
+      invalidShard();
+    Output.write(Buffer.data(), static_cast<std::streamsize>(Size));
+    Left -= Size;
+  }
+}
+
+void ShardReader::invalidShard() const {
+  LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_SHARD, Path);
+}
@@ -0,0 +1,112 @@
+//===-- LibScopeView/OutputShard.h ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the writer and the reader of the shards printed by
+/// --cu-shard, and how the parts of an input file are split between them.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_OUTPUTSHARD_H
+#define SCOPEVIEW_OUTPUTSHARD_H
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief The parts of an input file printed by one shard, and what the
+/// shards printed from the same input file with the same options share.
+struct ShardInfo {
+  uint32_t Index = 0;
+  uint32_t Count = 1;
+  // The range [FirstPart, EndPart) of the independent parts of the input
+  // file printed by the shard, out of PartCount.
+  uint64_t FirstPart = 0;
+  uint64_t EndPart = 0;
+  uint64_t PartCount = 0;
+  // A hash of the sizes of all the parts of the input file.
+  uint64_t PartsHash = 0;
+  // A hash of the options the output was printed with.
+  uint64_t SettingsHash = 0;
+};
+
+/// \brief Get the parts printed by the shard Index out of Count, from the
+/// sizes of the parts of the input file in bytes.
+///
+/// Each shard prints consecutive parts, so that the output of the shards put
+/// one after another is that of all the parts. A part goes to the shard its
+/// middle byte falls in, which gives each shard about as many bytes of the
+/// input file whatever the number of parts.
+ShardInfo getShardParts(const std::vector<uint64_t> &PartSizes, unsigned Index,
+                        unsigned Count);
+
+/// \brief Writes the output of a shard into a file, followed by its
+/// ShardInfo.
+class ShardWriter {
+public:
+  /// \brief Create the shard at Path, calling fatalError if it can not be.
+  explicit ShardWriter(const std::string &Path);
+
+  ShardWriter(const ShardWriter &) = delete;
+  ShardWriter &operator=(const ShardWriter &) = delete;
+
+  /// \brief Get the stream to print the output of the shard to.
+  std::ostream &getStream() { return File; }
+
+  /// \brief Write Info after the output, completing the shard.
+  void finish(const ShardInfo &Info);
+
+private:
+  std::string Path;
+  std::ofstream File;
+};
+
+/// \brief Reads a shard written by ShardWriter.
+class ShardReader {
+public:
+  /// \brief Open the shard at Path, calling fatalError if it is not one.
+  explicit ShardReader(const std::string &Path);
+
+  const ShardInfo &getInfo() const { return Info; }
+  const std::string &getPath() const { return Path; }
+
+  /// \brief Copy the output of the shard to Output.
+  void copyOutput(std::ostream &Output);
+
+private:
+  [[noreturn]] void invalidShard() const;
+
+  std::string Path;
+  std::ifstream File;
+  ShardInfo Info;
+  uint64_t OutputSize = 0;
+};
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_OUTPUTSHARD_H
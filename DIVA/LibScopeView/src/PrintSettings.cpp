@@ -33,6 +33,7 @@
 #include "Symbol.h"
 #include "Type.h"
 
+#include <algorithm>
 #include <assert.h>
 
 using namespace LibScopeView;
@@ -150,31 +151,18 @@ bool PrintSettings::printObject(const Object &Obj) const {
   return false;
 }
 
-namespace {
-bool matchPattern(const std::string &Name,
-                  const std::vector<std::regex> &RegexFilters,
-                  const std::vector<std::string> &StringFilters) {
-  for (const std::regex &Filter : RegexFilters) {
-    if (std::regex_match(Name, Filter))
-      return true;
-  }
-  for (const std::string &Filter : StringFilters) {
-    if (Name.find(Filter) != std::string::npos)
-      return true;
-  }
-  return false;
-}
-} // namespace
-
-bool PrintSettings::matchesFilterPattern(const std::string &Name) const {
-  return matchPattern(Name, Filters, FilterAnys);
-}
-
-bool PrintSettings::matchesTreeFilterPattern(const std::string &Name) const {
-  return matchPattern(Name, TreeFilters, TreeFilterAnys);
-}
-
 bool PrintSettings::hasFilters() const {
   return !(Filters.empty() && FilterAnys.empty() && TreeFilters.empty() &&
            TreeFilterAnys.empty());
 }
+
+bool PrintSettings::hasOnlyExactNameFilters() const {
+  if (!hasFilters() || !FilterAnys.empty() || !TreeFilterAnys.empty())
+    return false;
+  auto isExactName = [](const std::string &Pattern) {
+    return !Pattern.empty() &&
+           Pattern.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+  };
+  return std::all_of(Filters.begin(), Filters.end(), isExactName) &&
+         std::all_of(TreeFilters.begin(), TreeFilters.end(), isExactName);
+}
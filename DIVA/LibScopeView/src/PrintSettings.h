@@ -32,8 +32,8 @@
 
 #include "Sort.h"
 
-#include <regex>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace LibScopeView {
@@ -51,24 +51,34 @@ public:
   /// \brief Check if an object should be printed given the current settings.
   bool printObject(const Object &Obj) const;
 
-  /// \brief Check if the name matches a --filter pattern.
-  bool matchesFilterPattern(const std::string &Name) const;
-
-  /// \brief Check if the name matches a --tree pattern.
-  bool matchesTreeFilterPattern(const std::string &Name) const;
-
   bool hasFilters() const;
 
+  /// \brief Check if there are filters and they are all exact names, with no
+  /// regex syntax or substring filters, so objects can be found by name.
+  bool hasOnlyExactNameFilters() const;
+
   bool QuietMode = false;
 
   bool SplitOutput = false;
   std::string OutputDirectory;
-
+  bool CompressOutput = false;
+  // Threads used to compress split output, 0 for one thread per core.
+  unsigned CompressionThreads = 1;
+  // Only replace the split output files whose contents changed.
+  bool WriteOnlyChangedOutput = false;
+
+  // The settings from here on change the objects printed, and are added to
+  // the hash of the settings by hashPrintSettings.
   SortingKey SortKey = SortingKey::LINE;
 
-  std::vector<std::regex> Filters;
+  // Keep one copy of the members of the types that are the same in several
+  // compile units.
+  bool ShareTypes = false;
+
+  // The --filter and --tree patterns, compiled by the printers.
+  std::vector<std::string> Filters;
   std::vector<std::string> FilterAnys;
-  std::vector<std::regex> TreeFilters;
+  std::vector<std::string> TreeFilters;
   std::vector<std::string> TreeFilterAnys;
 
   // The defaults for these values are set by showBrief.
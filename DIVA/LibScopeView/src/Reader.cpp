@@ -28,16 +28,25 @@
 //===----------------------------------------------------------------------===//
 
 #include "Reader.h"
+#include "Error.h"
 #include "Line.h"
 #include "ScopeVisitor.h"
+#include "SummaryEstimate.h"
+#include "SummaryTable.h"
 #include "Symbol.h"
 #include "Type.h"
+#include "TypeSharing.h"
 #include "Utilities.h"
+#include "WorkerProcesses.h"
 
 #include <algorithm>
 #include <assert.h>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 using namespace LibScopeView;
@@ -165,6 +174,7 @@ private:
     // Set common attribute values.
     Obj->setName(Reference->getNamePoolRef());
     Obj->setLineNumber(Reference->getLineNumber());
+    updateExtents(Obj);
     Obj->setFilePath(Reference->getFilePathPoolRef());
     if (Reference->getInvalidFileName())
       Obj->setInvalidFileName();
@@ -184,6 +194,17 @@ private:
     if (isa<Symbol>(*Obj) && isa<Symbol>(*Reference))
       Obj->resolveQualifiedName(Reference->getParent());
   }
+
+  // Keep the recorded extents in step with the new line number.
+  static void updateExtents(const Object *Obj) {
+    for (auto *Parent = Obj->getParent(); Parent;
+         Parent = Parent->getParent()) {
+      if (auto *CU = dyn_cast<ScopeCompileUnit>(Parent))
+        CU->getExtents().updateLineNumber(Obj->getLineNumber());
+      else if (auto *Root = dyn_cast<ScopeRoot>(Parent))
+        Root->getExtents().updateLineNumber(Obj->getLineNumber());
+    }
+  }
 };
 
 // Visitor that sets all children of global objects as global.
@@ -196,6 +217,81 @@ private:
     visitChildren(Obj);
   }
 };
+
+// Builds the summaries of the names below each scope, from the distinct
+// names below each child scope, and records the distinct names in the tree.
+class NameSummaryBuilder {
+public:
+  void build(ScopeRoot *Root) {
+    summarise(Root);
+    Names.erase(std::remove(Names.begin(), Names.end(), nullptr), Names.end());
+    Root->getNames() = std::move(Names);
+    Root->setHasNameSummaries();
+  }
+
+private:
+  // Set the summary of Scp, leaving the distinct names below it at the end of
+  // Names. Return true if one of them is not interned.
+  bool summarise(Scope *Scp) {
+    size_t Start = Names.size();
+    bool HasAnyName = false;
+    for (Object *Child : Scp->getChildren()) {
+      HasAnyName |= addName(Child);
+      if (auto *ChildScope = dyn_cast<Scope>(Child))
+        HasAnyName |= summarise(ChildScope);
+    }
+    for (const Object *Ln : Scp->getLines())
+      HasAnyName |= addName(Ln);
+
+    auto Begin = Names.begin() + Start;
+    std::sort(Begin, Names.end(), std::less<StringPoolRef>());
+    Names.erase(std::unique(Begin, Names.end()), Names.end());
+    Scp->getDescendantNames() =
+        HasAnyName ? NameSummary::any()
+                   : NameSummary(Names.begin() + Start, Names.end());
+    return HasAnyName;
+  }
+
+  // Add the name of Obj, and return true if it is not interned.
+  bool addName(const Object *Obj) {
+    StringPoolRef Name = Obj->getNamePoolRef();
+    if (!Name && !Obj->getName().empty())
+      return true;
+    Names.push_back(Name);
+    return false;
+  }
+
+  std::vector<StringPoolRef> Names;
+};
+
+// Hands the parts of a tree from the reading thread to the using thread,
+// holding at most one part that is waiting to be used.
+class PartQueue {
+public:
+  // Wait for room and then add Part, or nullptr to mark the end of the parts.
+  void push(std::unique_ptr<ScopeRoot> Part) {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Changed.wait(Lock, [this]() { return !HasPart; });
+    Waiting = std::move(Part);
+    HasPart = true;
+    Changed.notify_all();
+  }
+
+  // Wait for and take the next part, which is nullptr after the last part.
+  std::unique_ptr<ScopeRoot> pop() {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    Changed.wait(Lock, [this]() { return HasPart; });
+    HasPart = false;
+    Changed.notify_all();
+    return std::move(Waiting);
+  }
+
+private:
+  std::mutex Mutex;
+  std::condition_variable Changed;
+  std::unique_ptr<ScopeRoot> Waiting;
+  bool HasPart = false;
+};
 } // namespace
 
 Reader::~Reader() {}
@@ -208,13 +304,208 @@ std::unique_ptr<ScopeRoot> Reader::loadFile(const std::string &FileName,
   return Root;
 }
 
-void Reader::postCreationActions(ScopeRoot *Root,
-                                 const PrintSettings &Settings) {
-  assert(Root);
+void Reader::loadFileInParts(const std::string &FileName,
+                             const PrintSettings &Settings,
+                             const PartCallback &UsePart) {
+  // Objects are only created by the reading thread, which also does the post
+  // creation actions as they create strings. It adds them to the pool of the
+  // calling thread.
+  PartQueue Parts;
+  StringPool &Pool = getGlobalStringPool();
+  std::thread ReadingThread([&]() {
+    ScopedStringPool UsePool(Pool);
+    createScopesInParts(FileName, [&](std::unique_ptr<ScopeRoot> Part) {
+      postCreationActions(Part.get(), Settings);
+      Parts.push(std::move(Part));
+    });
+    Parts.push(nullptr);
+  });
+
+  while (std::unique_ptr<ScopeRoot> Part = Parts.pop())
+    UsePart(*Part);
+  ReadingThread.join();
+}
+
+size_t Reader::loadFileInProcesses(const std::string &FileName,
+                                   const PrintSettings &Settings,
+                                   unsigned Processes,
+                                   const PrintPartCallback &PrintPart,
+                                   std::ostream &Output) {
+  size_t PartCount = 0;
+  if (Processes > 1 && canRunWorkerProcesses())
+    PartCount = findIndependentParts(FileName).size();
+  if (PartCount) {
+    printIndependentParts(FileName, Settings, 0, PartCount, Processes,
+                          PrintPart, Output);
+    return PartCount;
+  }
+
+  size_t Index = 0;
+  loadFileInParts(FileName, Settings, [&](const ScopeRoot &Part) {
+    PrintPart(Part, Index++, Output);
+  });
+  return Index;
+}
+
+size_t Reader::loadFileShard(const std::string &FileName,
+                             const PrintSettings &Settings, unsigned Index,
+                             unsigned Count, unsigned Processes,
+                             const PrintPartCallback &PrintPart,
+                             std::ostream &Output, ShardInfo &Shard) {
+  Shard = getShardParts(findIndependentParts(FileName), Index, Count);
+  if (Shard.PartCount) {
+    printIndependentParts(FileName, Settings, Shard.FirstPart, Shard.EndPart,
+                          Processes, PrintPart, Output);
+    return Shard.EndPart - Shard.FirstPart;
+  }
 
+  size_t PartIndex = 0;
+  if (Index == 0)
+    loadFileInParts(FileName, Settings, [&](const ScopeRoot &Part) {
+      PrintPart(Part, PartIndex++, Output);
+    });
+  return PartIndex;
+}
+
+void Reader::countObjectsInParts(const std::string &FileName,
+                                 const PrintSettings &Settings,
+                                 unsigned Processes, SummaryTable &Table) {
+  size_t PartCount = findIndependentParts(FileName).size();
+  if (!PartCount) {
+    loadFileInParts(FileName, Settings,
+                    [&](const ScopeRoot &Part) { Table.addObjects(Part); });
+    return;
+  }
+
+  std::vector<size_t> Parts(PartCount);
+  for (size_t Index = 0; Index < PartCount; ++Index)
+    Parts[Index] = Index;
+  countIndependentParts(FileName, Settings, Parts, Processes, Table,
+                        [&](size_t, const SummaryTable &PartTable) {
+                          Table.addTable(PartTable);
+                        });
+}
+
+std::unique_ptr<SummaryEstimate> Reader::estimateObjectsInParts(
+    const std::string &FileName, const PrintSettings &Settings,
+    unsigned Processes, unsigned SampleSize, uint64_t Seed,
+    SummaryTable &Table) {
+  std::vector<uint64_t> PartSizes = findIndependentParts(FileName);
+  if (PartSizes.size() <= SampleSize) {
+    countObjectsInParts(FileName, Settings, Processes, Table);
+    return nullptr;
+  }
+
+  // Only the parts drawn are created, each once however many times it is
+  // drawn.
+  std::vector<unsigned> Draws = drawSampleParts(PartSizes, SampleSize, Seed);
+  std::vector<size_t> Parts;
+  for (size_t Index = 0; Index < Draws.size(); ++Index)
+    if (Draws[Index])
+      Parts.push_back(Index);
+  auto Estimate = std::make_unique<SummaryEstimate>(PartSizes);
+  countIndependentParts(FileName, Settings, Parts, Processes, Table,
+                        [&](size_t Item, const SummaryTable &PartTable) {
+                          Estimate->addPart(Parts[Item], Draws[Parts[Item]],
+                                            PartTable);
+                        });
+  return Estimate;
+}
+
+void Reader::createScopesInParts(const std::string &FileName,
+                                 const CreatedPartCallback &AddPart) {
+  std::unique_ptr<ScopeRoot> Root = createScopes(FileName);
+  if (Root)
+    AddPart(std::move(Root));
+}
+
+std::vector<uint64_t> Reader::findIndependentParts(const std::string &) {
+  return {};
+}
+
+std::unique_ptr<ScopeRoot> Reader::createIndependentPart(const std::string &,
+                                                         size_t) {
+  assert(false && "Reader has no independent parts");
+  return nullptr;
+}
+
+void Reader::printIndependentParts(const std::string &FileName,
+                                   const PrintSettings &Settings,
+                                   size_t FirstPart, size_t EndPart,
+                                   unsigned Processes,
+                                   const PrintPartCallback &PrintPart,
+                                   std::ostream &Output) {
+  auto PrintItem = [&](size_t Item, std::ostream &PartOutput) {
+    std::unique_ptr<ScopeRoot> Part =
+        createIndependentPart(FileName, FirstPart + Item);
+    postCreationActions(Part.get(), Settings);
+    PrintPart(*Part, FirstPart + Item, PartOutput);
+  };
+  if (Processes > 1 &&
+      runInWorkerProcesses(EndPart - FirstPart, Processes, PrintItem, Output))
+    return;
+  for (size_t Item = 0; Item < EndPart - FirstPart; ++Item)
+    PrintItem(Item, Output);
+}
+
+void Reader::countIndependentParts(const std::string &FileName,
+                                   const PrintSettings &Settings,
+                                   const std::vector<size_t> &Parts,
+                                   unsigned Processes,
+                                   const SummaryTable &Table,
+                                   const CountedPartCallback &AddPart) {
+  // The kinds of the objects and whether they are printed depend on their
+  // references and global markings, but not on their order or names.
+  auto CountItem = [&](size_t Item) {
+    std::unique_ptr<ScopeRoot> Part =
+        createIndependentPart(FileName, Parts[Item]);
+    resolveScopes(Part.get(), Settings);
+    SummaryTable PartTable(Table.getSettings());
+    PartTable.addObjects(*Part);
+    return PartTable;
+  };
+  std::stringstream Counts;
+  if (Processes > 1 &&
+      runInWorkerProcesses(
+          Parts.size(), Processes,
+          [&](size_t Item, std::ostream &PartOutput) {
+            CountItem(Item).writeCounts(PartOutput);
+          },
+          Counts)) {
+    for (size_t Item = 0; Item < Parts.size(); ++Item) {
+      SummaryTable PartTable(Table.getSettings());
+      if (!PartTable.addCounts(Counts))
+        LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_READ_FAILED,
+                                  FileName);
+      AddPart(Item, PartTable);
+    }
+    return;
+  }
+  for (size_t Item = 0; Item < Parts.size(); ++Item)
+    AddPart(Item, CountItem(Item));
+}
+
+void Reader::resolveScopes(ScopeRoot *Root, const PrintSettings &Settings) {
   NameResolver(Settings).visit(Root);
   ReferenceAttributeResolver().visit(Root);
   GlobalResolver().visit(Root);
+}
+
+void Reader::postCreationActions(ScopeRoot *Root,
+                                 const PrintSettings &Settings) {
+  assert(Root);
+
+  resolveScopes(Root, Settings);
+  NameSummaryBuilder().build(Root);
 
   Root->sortScopes(Settings.SortKey);
+
+  // Types are compared after sorting, so that their members are in the same
+  // order. A tree loaded from a snapshot may have shared them already.
+  if (Settings.ShareTypes && Root->getSharedTypes().empty())
+    shareTypes(*Root);
+
+  // The printers find the objects matching exact name filters in the index.
+  if (Settings.hasOnlyExactNameFilters())
+    Root->buildNameIndex();
 }
@@ -30,14 +30,20 @@
 #ifndef READER_H
 #define READER_H
 
+#include "OutputShard.h"
 #include "PrintSettings.h"
 #include "Scope.h"
 
+#include <functional>
 #include <memory>
+#include <ostream>
+#include <vector>
 
 namespace LibScopeView {
 
 class Scope;
+class SummaryEstimate;
+class SummaryTable;
 
 /// \brief Representation of a generic reader.
 class Reader {
@@ -52,13 +58,130 @@ public:
   std::unique_ptr<ScopeRoot> loadFile(const std::string &FileName,
                                       const PrintSettings &Settings);
 
+  /// \brief Callback given each part of the ScopeView loaded in parts.
+  using PartCallback = std::function<void(const ScopeRoot &)>;
+
+  /// \brief Load a ScopeView from the file one part at a time.
+  ///
+  /// Each part is a ScopeRoot holding a group of compile units that do not
+  /// reference any objects outside of the group. The parts are passed to
+  /// UsePart in order, and each is freed once UsePart returns. The next part
+  /// is read on another thread while UsePart runs, so UsePart must not create
+  /// any strings in the global StringPool.
+  void loadFileInParts(const std::string &FileName,
+                       const PrintSettings &Settings,
+                       const PartCallback &UsePart);
+
+  /// \brief Callback printing the part Index of the ScopeView to a stream.
+  using PrintPartCallback = std::function<void(
+      const ScopeRoot &Part, size_t Index, std::ostream &Output)>;
+
+  /// \brief Load a ScopeView from the file in parts, as loadFileInParts, but
+  /// read and print the parts in up to Processes forked worker processes.
+  ///
+  /// Each worker reads the file on its own, and takes the next part not yet
+  /// taken, printing it with PrintPart. The output of the parts is written to
+  /// Output in order. If the reader can not create the parts on their own, or
+  /// the platform can not run worker processes, the parts are read and printed
+  /// in this process instead. Returns the number of parts printed.
+  size_t loadFileInProcesses(const std::string &FileName,
+                           const PrintSettings &Settings, unsigned Processes,
+                           const PrintPartCallback &PrintPart,
+                           std::ostream &Output);
+
+  /// \brief Load and print the parts of the file printed by the shard Index
+  /// out of Count, as loadFileInProcesses does, setting Shard to the parts
+  /// printed.
+  ///
+  /// The parts are split between the shards by getShardParts. If the reader
+  /// can not create the parts on their own, the first shard loads the file
+  /// in parts as loadFileInParts and the others print nothing. Returns the
+  /// number of parts printed.
+  size_t loadFileShard(const std::string &FileName,
+                       const PrintSettings &Settings, unsigned Index,
+                       unsigned Count, unsigned Processes,
+                       const PrintPartCallback &PrintPart,
+                       std::ostream &Output, ShardInfo &Shard);
+
+  /// \brief Count the objects of the file in Table without printing them.
+  ///
+  /// The parts found by findIndependentParts are created one at a time, in
+  /// up to Processes worker processes if the platform can run them, which
+  /// only send back their counts. Only the actions the counts depend on are
+  /// done on each part, and it is freed once counted. If the reader can not
+  /// create the parts on their own, the file is loaded as loadFileInParts.
+  void countObjectsInParts(const std::string &FileName,
+                           const PrintSettings &Settings, unsigned Processes,
+                           SummaryTable &Table);
+
+  /// \brief Estimate the counts of the objects of the file from SampleSize
+  /// of the parts found by findIndependentParts, drawn by drawSampleParts
+  /// with Seed.
+  ///
+  /// Only the parts drawn are created, and counted as countObjectsInParts
+  /// does. If the file has no more parts than SampleSize, all its objects are
+  /// counted in Table as countObjectsInParts does and null is returned.
+  std::unique_ptr<SummaryEstimate>
+  estimateObjectsInParts(const std::string &FileName,
+                         const PrintSettings &Settings, unsigned Processes,
+                         unsigned SampleSize, uint64_t Seed,
+                         SummaryTable &Table);
+
+protected:
+  /// \brief Callback given each part created by createScopesInParts.
+  using CreatedPartCallback = std::function<void(std::unique_ptr<ScopeRoot>)>;
+
 private:
   /// \brief Implements the creation of the tree from a file.
   virtual std::unique_ptr<ScopeRoot>
   createScopes(const std::string &FileName) = 0;
 
+  /// \brief Implements the creation of the tree from a file in parts. By
+  /// default the whole tree is created as a single part.
+  virtual void createScopesInParts(const std::string &FileName,
+                                   const CreatedPartCallback &AddPart);
+
+  /// \brief Find the parts of the file that can each be created on their own
+  /// by createIndependentPart, returning the size of each in bytes of the
+  /// file. By default there are none.
+  virtual std::vector<uint64_t>
+  findIndependentParts(const std::string &FileName);
+
+  /// \brief Create the part Index of those found by findIndependentParts.
+  /// This is called in a worker process, which opens the file itself.
+  virtual std::unique_ptr<ScopeRoot>
+  createIndependentPart(const std::string &FileName, size_t Index);
+
+  /// \brief Resolve the names, references and global objects of a created
+  /// tree.
+  virtual void resolveScopes(ScopeRoot *Root, const PrintSettings &Settings);
+
   /// \brief Do general post creation setup on the tree.
   void postCreationActions(ScopeRoot *Root, const PrintSettings &Settings);
+
+  /// \brief Callback given the table of the objects of the part Parts[Item]
+  /// counted by countIndependentParts.
+  using CountedPartCallback =
+      std::function<void(size_t Item, const SummaryTable &PartTable)>;
+
+  /// \brief Create the parts Parts found by findIndependentParts and count
+  /// their objects with the settings of Table, in up to Processes worker
+  /// processes if the platform can run them. AddPart is called with the table
+  /// of each part, in the order of Parts.
+  void countIndependentParts(const std::string &FileName,
+                             const PrintSettings &Settings,
+                             const std::vector<size_t> &Parts,
+                             unsigned Processes, const SummaryTable &Table,
+                             const CountedPartCallback &AddPart);
+
+  /// \brief Create and print the parts [FirstPart, EndPart) found by
+  /// findIndependentParts, in up to Processes worker processes if the
+  /// platform can run them.
+  void printIndependentParts(const std::string &FileName,
+                             const PrintSettings &Settings, size_t FirstPart,
+                             size_t EndPart, unsigned Processes,
+                             const PrintPartCallback &PrintPart,
+                             std::ostream &Output);
 };
 
 } // namespace LibScopeView
@@ -30,7 +30,9 @@
 #include "Scope.h"
 #include "Error.h"
 #include "FileUtilities.h"
+#include "JSONWriter.h"
 #include "Line.h"
+#include "NameIndex.h"
 #include "PrintSettings.h"
 #include "Symbol.h"
 #include "Type.h"
@@ -41,6 +43,51 @@
 
 using namespace LibScopeView;
 
+NameSummary::NameSummary(std::vector<StringPoolRef>::const_iterator First,
+                         std::vector<StringPoolRef>::const_iterator Last) {
+  if (First == Last)
+    return;
+  // Use about 16 bits for each name, so that with two bits set for each name
+  // around one in seventy names not in the summary are reported as present.
+  size_t Words = 1;
+  while (Words * 4 < size_t(Last - First))
+    Words *= 2;
+  Bits.resize(Words);
+  size_t Mask = Words * 64 - 1;
+  for (; First != Last; ++First) {
+    std::pair<size_t, size_t> Found = findBits(*First, Mask);
+    Bits[Found.first / 64] |= uint64_t(1) << (Found.first % 64);
+    Bits[Found.second / 64] |= uint64_t(1) << (Found.second % 64);
+  }
+}
+
+NameSummary NameSummary::any() {
+  NameSummary Summary;
+  Summary.HasAnyName = true;
+  return Summary;
+}
+
+bool NameSummary::mayContain(StringPoolRef Name) const {
+  if (HasAnyName)
+    return true;
+  if (Bits.empty())
+    return false;
+  std::pair<size_t, size_t> Found = findBits(Name, Bits.size() * 64 - 1);
+  return (Bits[Found.first / 64] >> (Found.first % 64) & 1) &&
+         (Bits[Found.second / 64] >> (Found.second % 64) & 1);
+}
+
+std::pair<size_t, size_t> NameSummary::findBits(StringPoolRef Name,
+                                                size_t Mask) {
+  // Mix all the bits of the pointer, as its low bits are aligned.
+  uint64_t Hash = reinterpret_cast<uintptr_t>(Name);
+  Hash = (Hash ^ (Hash >> 33)) * 0xFF51AFD7ED558CCDULL;
+  Hash = (Hash ^ (Hash >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+  Hash ^= Hash >> 33;
+  return {static_cast<size_t>(Hash) & Mask,
+          static_cast<size_t>(Hash >> 32) & Mask};
+}
+
 Scope::Scope(ObjectKind K) : Element(K) {}
 
 Scope::~Scope() {
@@ -118,6 +165,17 @@ std::string Scope::getAsYAML() const {
   return "";
 }
 
+void Scope::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  if (getIsBlock()) {
+    JSON.key("try");
+    JSON.boolean(getIsTryBlock());
+    JSON.key("catch");
+    JSON.boolean(getIsCatchBlock());
+  }
+  JSON.objectEnd();
+}
+
 ScopeAggregate::ScopeAggregate() : Scope(SV_ScopeAggregate) {
   Reference = nullptr;
 }
@@ -173,6 +231,29 @@ std::string ScopeAggregate::getAsYAML() const {
   return Result.str();
 }
 
+void ScopeAggregate::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.key("is_template");
+  JSON.boolean(getIsTemplate());
+
+  // A Union can't have any inheritance attributes.
+  if (!getIsUnionType()) {
+    JSON.key("inherits_from");
+    JSON.arrayBegin();
+    for (const Object *Obj : getChildren()) {
+      if (auto *Ty = dyn_cast<const Type>(Obj)) {
+        if (Ty->getIsInheritance()) {
+          JSON.objectBegin();
+          Ty->writeAsJSON(JSON);
+          JSON.objectEnd();
+        }
+      }
+    }
+    JSON.arrayEnd();
+  }
+  JSON.objectEnd();
+}
+
 std::string ScopeAlias::getAsText(const PrintSettings &Settings) const {
   std::stringstream Result;
   Result << "{" << getKindAsString() << "} \"" << getName() << "\" -> "
@@ -192,6 +273,13 @@ std::string ScopeArray::getAsText(const PrintSettings &Settings) const {
   return Result.str();
 }
 
+void ScopeExtents::merge(const ScopeExtents &Other) {
+  MaxLineNumber = std::max(MaxLineNumber, Other.MaxLineNumber);
+  MaxLevel = std::max(MaxLevel, Other.MaxLevel);
+  ObjectCount += Other.ObjectCount;
+  DwarfTags.insert(Other.DwarfTags.begin(), Other.DwarfTags.end());
+}
+
 void ScopeCompileUnit::setName(const std::string &Name) {
   Scope::setName(unifyFilePath(Name));
 }
@@ -256,6 +344,27 @@ std::string ScopeEnumeration::getAsYAML() const {
   return YAML.str();
 }
 
+void ScopeEnumeration::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.key("class");
+  JSON.boolean(getIsClass());
+  JSON.key("enumerators");
+  JSON.arrayBegin();
+  for (auto *Child : getChildren()) {
+    if (!isa<TypeEnumerator>(*Child))
+      continue;
+    auto *ChildEnumerator = cast<TypeEnumerator>(Child);
+    JSON.objectBegin();
+    JSON.key("enumerator");
+    JSON.string(ChildEnumerator->getName());
+    JSON.key("value");
+    JSON.numberOrString(ChildEnumerator->getValue());
+    JSON.objectEnd();
+  }
+  JSON.arrayEnd();
+  JSON.objectEnd();
+}
+
 ScopeFunction::ScopeFunction(ObjectKind K)
     : Scope(K), Reference(nullptr), IsStatic(false), DeclaredInline(false),
       IsDeclaration(false) {}
@@ -342,6 +451,38 @@ std::string ScopeFunction::getAsYAML() const {
   return YAML.str();
 }
 
+void ScopeFunction::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.key("declaration");
+  JSON.objectBegin();
+  if (Reference && isa<ScopeFunction>(*Reference)) {
+    JSON.key("file");
+    if (!Reference->getInvalidFileName())
+      JSON.string(getFileName(Reference->getFilePath()));
+    else
+      JSON.string("?");
+    JSON.key("line");
+    JSON.number(Reference->getLineNumber());
+  } else {
+    JSON.key("file");
+    JSON.null();
+    JSON.key("line");
+    JSON.null();
+  }
+  JSON.objectEnd();
+  JSON.key("is_template");
+  JSON.boolean(getIsTemplate());
+  JSON.key("static");
+  JSON.boolean(getIsStatic());
+  JSON.key("inline");
+  JSON.boolean(getIsDeclaredInline());
+  JSON.key("is_inlined");
+  JSON.boolean(isa<ScopeFunctionInlined>(*this));
+  JSON.key("is_declaration");
+  JSON.boolean(getIsDeclaration());
+  JSON.objectEnd();
+}
+
 ScopeFunctionInlined::~ScopeFunctionInlined() {}
 
 std::string ScopeNamespace::getAsText(const PrintSettings &) const {
@@ -395,6 +536,24 @@ std::string ScopeTemplatePack::getAsYAML() const {
   return YAML.str();
 }
 
+void ScopeTemplatePack::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.key("types");
+  JSON.arrayBegin();
+  for (const auto *Child : getChildren()) {
+    if (auto *Param = dyn_cast<const TypeTemplateParam>(Child))
+      Param->writeValueAsJSON(JSON);
+  }
+  JSON.arrayEnd();
+  JSON.objectEnd();
+}
+
+ScopeRoot::ScopeRoot() : Scope(SV_ScopeRoot) {}
+
+ScopeRoot::~ScopeRoot() {}
+
+void ScopeRoot::buildNameIndex() { Index.reset(new NameIndex(*this)); }
+
 void ScopeRoot::setName(const std::string &Name) {
   Scope::setName(unifyFilePath(Name));
 }
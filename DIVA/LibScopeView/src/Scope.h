@@ -33,13 +33,51 @@
 #include "Object.h"
 #include "Sort.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace LibScopeView {
 
 class Line;
+class NameIndex;
 class Symbol;
 
+/// \brief A Bloom filter of the names of the objects below a scope, sized for
+/// the number of distinct names there.
+///
+/// These are built after the tree is created, so that the printers can skip
+/// the subtrees that can not contain an object matching the filters.
+class NameSummary {
+public:
+  NameSummary() = default;
+  /// \brief Create the summary of the distinct interned names from First to
+  /// Last, where nullptr is an object with no name.
+  NameSummary(std::vector<StringPoolRef>::const_iterator First,
+              std::vector<StringPoolRef>::const_iterator Last);
+  explicit NameSummary(const std::vector<StringPoolRef> &Names)
+      : NameSummary(Names.begin(), Names.end()) {}
+
+  /// \brief Create the summary of a subtree with a name that is not interned,
+  /// which could match anything.
+  static NameSummary any();
+
+  /// \brief Return false if Name was not in the summarised names.
+  bool mayContain(StringPoolRef Name) const;
+
+private:
+  // The two bits set for Name in a filter of Mask + 1 bits.
+  static std::pair<size_t, size_t> findBits(StringPoolRef Name, size_t Mask);
+
+  // A power of two number of words, empty if there were no names.
+  std::vector<uint64_t> Bits;
+  bool HasAnyName = false;
+};
+
 // TODO: Make Scope pure virtual.
 
 /// \brief Class to represent a DWARF Scope object.
@@ -159,6 +197,10 @@ public:
   const std::vector<Line *> &getLines() const { return TheLines; }
   std::vector<Line *> &getLines() { return TheLines; }
 
+  /// \brief Summary of the names of all the objects below this scope.
+  const NameSummary &getDescendantNames() const { return DescendantNames; }
+  NameSummary &getDescendantNames() { return DescendantNames; }
+
   void sortScopes(const SortingKey &SortKey);
 
   // bring parent method getQualifiedName into scope.
@@ -175,11 +217,17 @@ private:
   // Vector of objects (types, scopes, symbols).
   std::vector<Object *> Children;
 
+  NameSummary DescendantNames;
+
 public:
   /// \brief Returns a text representation of this DIVA Object.
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
 };
 
 /// \brief Class to represent a DWARF Union/Structure/Class object.
@@ -205,6 +253,10 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
 };
 
 /// \brief Class to represent a DWARF Template alias object.
@@ -238,6 +290,60 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
 };
 
+/// \brief The extents of a tree of objects.
+///
+/// These are recorded by the reader as the objects are created, so that the
+/// printers can size their columns without visiting the whole tree first.
+class ScopeExtents {
+public:
+  /// \brief Record an object, where Level is its depth below the compile
+  /// unit (the compile unit itself is at level 0).
+  void addObject(const Object &Obj, size_t Level) {
+    ++ObjectCount;
+    updateLineNumber(Obj.getLineNumber());
+    updateLevel(Level);
+    if (Obj.getDieTag())
+      addDwarfTag(Obj.getDieTag());
+  }
+
+  /// \brief Record a line number set after the object was added.
+  void updateLineNumber(uint64_t LineNumber) {
+    MaxLineNumber = std::max(MaxLineNumber, LineNumber);
+  }
+
+  /// \brief Record the depth of an object below the compile unit.
+  void updateLevel(size_t Level) { MaxLevel = std::max(MaxLevel, Level); }
+
+  /// \brief Record the DWARF tag of an object.
+  void addDwarfTag(Dwarf_Half Tag) { DwarfTags.insert(Tag); }
+
+  /// \brief Record objects added or removed without addObject.
+  void addObjectCount(size_t Count) { ObjectCount += Count; }
+  void removeObjectCount(size_t Count) {
+    ObjectCount -= std::min(ObjectCount, Count);
+  }
+
+  /// \brief Add the extents of another tree to these extents.
+  void merge(const ScopeExtents &Other);
+
+  uint64_t getMaxLineNumber() const { return MaxLineNumber; }
+  size_t getMaxLevel() const { return MaxLevel; }
+  const std::set<Dwarf_Half> &getDwarfTags() const { return DwarfTags; }
+  /// \brief The number of objects in the tree, not counting the root.
+  size_t getObjectCount() const { return ObjectCount; }
+
+  /// \brief Have the extents been recorded for every object in the tree?
+  bool getIsRecorded() const { return IsRecorded; }
+  void setIsRecorded() { IsRecorded = true; }
+
+private:
+  uint64_t MaxLineNumber = 0;
+  size_t MaxLevel = 0;
+  size_t ObjectCount = 0;
+  std::set<Dwarf_Half> DwarfTags;
+  bool IsRecorded = false;
+};
+
 /// \brief Class to represent a DWARF Compilation Unit (CU) object.
 class ScopeCompileUnit : public Scope {
 public:
@@ -250,10 +356,27 @@ public:
 
   void setName(const std::string &Name) override;
 
+  /// \brief Extents of the objects in this compile unit.
+  ScopeExtents &getExtents() { return Extents; }
+  const ScopeExtents &getExtents() const { return Extents; }
+
   /// \brief Returns a text representation of this DIVA Object.
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+
+  /// \brief The hashes of this compile unit for the output cache, kept by
+  /// hashCompileUnit so that they are computed once for all the outputs.
+  struct OutputHashes {
+    bool IsSet = false;
+    uint64_t Content = 0;
+    uint64_t Offsets = 0;
+  };
+  OutputHashes &getOutputHashes() const { return Hashes; }
+
+private:
+  ScopeExtents Extents;
+  mutable OutputHashes Hashes;
 };
 
 /// \brief Class to represent a DWARF enumerator object.
@@ -273,6 +396,11 @@ public:
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
 
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
+
+public:
   void setIsClass() { IsClass = true; }
   bool getIsClass() const { return IsClass; }
 
@@ -321,6 +449,10 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
 };
 
 /// \brief Class to represent a DWARF inlined function object.
@@ -376,12 +508,17 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
 };
 
 /// \brief Class to represent an object file (single or multiple CUs).
 class ScopeRoot : public Scope {
 public:
-  ScopeRoot() : Scope(SV_ScopeRoot) {}
+  ScopeRoot();
+  ~ScopeRoot() override;
 
   /// \brief Return true if Obj is an instance of ScopeRoot.
   static bool classof(const Object *Obj) {
@@ -390,9 +527,45 @@ public:
 
   void setName(const std::string &Name) override;
 
+  /// \brief Extents of the objects in all the compile units.
+  ScopeExtents &getExtents() { return Extents; }
+  const ScopeExtents &getExtents() const { return Extents; }
+
+  /// \brief The distinct interned names in the tree, recorded when the name
+  /// summaries of the scopes are built.
+  const std::vector<StringPoolRef> &getNames() const { return Names; }
+  std::vector<StringPoolRef> &getNames() { return Names; }
+
+  /// \brief Have the name summaries been built for every scope in the tree?
+  bool getHasNameSummaries() const { return HasNameSummaries; }
+  void setHasNameSummaries() { HasNameSummaries = true; }
+
+  /// \brief Build the index of the objects in the tree by name. This must be
+  /// done again if the tree is changed.
+  void buildNameIndex();
+  /// \brief The index of the objects by name, or nullptr if not built.
+  const NameIndex *getNameIndex() const { return Index.get(); }
+
+  /// \brief The types whose members were freed by shareTypes, and the types
+  /// that have their members.
+  std::unordered_map<const Scope *, const Scope *> &getSharedTypes() {
+    return SharedTypes;
+  }
+  const std::unordered_map<const Scope *, const Scope *> &
+  getSharedTypes() const {
+    return SharedTypes;
+  }
+
   bool getIsPrintedAsObject() const override { return false; }
   /// \brief Returns a text representation of this DIVA Object.
   std::string getAsText(const PrintSettings &Settings) const override;
+
+private:
+  ScopeExtents Extents;
+  std::vector<StringPoolRef> Names;
+  bool HasNameSummaries = false;
+  std::unique_ptr<NameIndex> Index;
+  std::unordered_map<const Scope *, const Scope *> SharedTypes;
 };
 
 } // namespace LibScopeView
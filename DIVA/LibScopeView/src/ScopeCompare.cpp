@@ -0,0 +1,326 @@
+//===-- LibScopeView/ScopeCompare.cpp ---------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the ScopeCompare class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ScopeCompare.h"
+#include "JSONWriter.h"
+#include "Scope.h"
+#include "ScopeHash.h"
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+using namespace LibScopeView;
+
+namespace {
+
+// The largest table used for the longest common subsequence of two lists of
+// children. Longer lists are matched greedily.
+const size_t MaxLCSCells = 1 << 22;
+
+std::string quoted(const std::string &Text) {
+  std::string Buffer;
+  JSONWriter(Buffer).string(Text);
+  return Buffer;
+}
+
+} // namespace
+
+ScopeCompare::ScopeCompare(const ScopeRoot &Old, const ScopeRoot &New,
+                           const PrintSettings &PrintingSettings)
+    : Settings(PrintingSettings) {
+  // DIE offsets differ whenever anything before them changes.
+  Settings.ShowDWARFOffset = false;
+
+  Node OldRoot;
+  Node NewRoot;
+  OldRoot.Obj = &Old;
+  NewRoot.Obj = &New;
+  for (const Object *Child : Old.getChildren())
+    buildNode(Child, OldRoot);
+  for (const Object *Child : New.getChildren())
+    buildNode(Child, NewRoot);
+  hashNode(OldRoot);
+  hashNode(NewRoot);
+
+  if (OldRoot.Hash != NewRoot.Hash)
+    compareChildren(OldRoot, NewRoot);
+}
+
+void ScopeCompare::buildNode(const Object *Obj, Node &Parent) const {
+  if (!Obj->getIsPrintedAsObject())
+    return;
+
+  // The children of objects that are not printed are compared as the
+  // children of the closest printed object, as they are printed.
+  Node *ChildrensParent = &Parent;
+  if (Settings.printObject(*Obj)) {
+    Parent.Children.emplace_back();
+    Node &N = Parent.Children.back();
+    N.Obj = Obj;
+    HashBuilder Key;
+    Key.add(Obj->getKindAsString());
+    Key.add(Obj->getQualifiedName() + Obj->getName());
+    N.KeyHash = Key.get();
+    // The line numbers and files are not compared.
+    HashBuilder Own;
+    hashObject(*Obj, /*WithLocation*/ false, Own);
+    // Children printed as attributes, like enumerators, are in the text.
+    if (const auto *Scp = dyn_cast<Scope>(Obj))
+      for (const Object *Child : Scp->getChildren())
+        if (!Child->getIsPrintedAsObject())
+          hashObject(*Child, /*WithLocation*/ false, Own);
+    N.OwnHash = Own.get();
+    ChildrensParent = &N;
+  }
+
+  if (const auto *Scp = dyn_cast<Scope>(Obj))
+    for (const Object *Child : Scp->getChildren())
+      buildNode(Child, *ChildrensParent);
+}
+
+void ScopeCompare::hashNode(Node &N) const {
+  HashBuilder Hash;
+  Hash.add(N.OwnHash);
+  for (Node &Child : N.Children) {
+    hashNode(Child);
+    Hash.add(Child.Hash);
+  }
+  N.Hash = Hash.get();
+}
+
+void ScopeCompare::compareNodes(const Node &Old, const Node &New) {
+  // The hashes cover attributes that the settings may not print, so only the
+  // objects whose text differs are changed.
+  if (Old.OwnHash != New.OwnHash &&
+      Old.Obj->getAsText(Settings) != New.Obj->getAsText(Settings))
+    Differences.push_back(
+        {DifferenceKind::Changed, Old.Obj, New.Obj, Parents});
+  Parents.push_back(New.Obj);
+  compareChildren(Old, New);
+  Parents.pop_back();
+}
+
+void ScopeCompare::compareChildren(const Node &Old, const Node &New) {
+  const std::vector<Node> &OldChildren = Old.Children;
+  const std::vector<Node> &NewChildren = New.Children;
+
+  // Skip the identical children at the start and end.
+  size_t OldBegin = 0;
+  size_t NewBegin = 0;
+  size_t OldEnd = OldChildren.size();
+  size_t NewEnd = NewChildren.size();
+  while (OldBegin < OldEnd && NewBegin < NewEnd &&
+         OldChildren[OldBegin].Hash == NewChildren[NewBegin].Hash) {
+    ++OldBegin;
+    ++NewBegin;
+  }
+  while (OldEnd > OldBegin && NewEnd > NewBegin &&
+         OldChildren[OldEnd - 1].Hash == NewChildren[NewEnd - 1].Hash) {
+    --OldEnd;
+    --NewEnd;
+  }
+
+  size_t OldIndex = OldBegin;
+  size_t NewIndex = NewBegin;
+  auto addUnmatched = [&](size_t OldTo, size_t NewTo) {
+    for (; OldIndex < OldTo; ++OldIndex)
+      Differences.push_back({DifferenceKind::Removed,
+                             OldChildren[OldIndex].Obj, nullptr, Parents});
+    for (; NewIndex < NewTo; ++NewIndex)
+      Differences.push_back({DifferenceKind::Added, nullptr,
+                             NewChildren[NewIndex].Obj, Parents});
+  };
+
+  for (const auto &Match : matchChildren(OldChildren, OldBegin, OldEnd,
+                                         NewChildren, NewBegin, NewEnd)) {
+    addUnmatched(Match.first, Match.second);
+    if (OldChildren[OldIndex].Hash != NewChildren[NewIndex].Hash)
+      compareNodes(OldChildren[OldIndex], NewChildren[NewIndex]);
+    ++OldIndex;
+    ++NewIndex;
+  }
+  addUnmatched(OldEnd, NewEnd);
+}
+
+std::vector<std::pair<size_t, size_t>>
+ScopeCompare::matchChildren(const std::vector<Node> &Old, size_t OldBegin,
+                            size_t OldEnd, const std::vector<Node> &New,
+                            size_t NewBegin, size_t NewEnd) {
+  std::vector<std::pair<size_t, size_t>> Matches;
+  const size_t OldSize = OldEnd - OldBegin;
+  const size_t NewSize = NewEnd - NewBegin;
+  if (!OldSize || !NewSize)
+    return Matches;
+
+  if (OldSize * NewSize > MaxLCSCells) {
+    // Match each old child with the next new child of the same key.
+    std::unordered_map<uint64_t, std::vector<size_t>> NewByKey;
+    for (size_t NewIndex = NewEnd; NewIndex-- > NewBegin;)
+      NewByKey[New[NewIndex].KeyHash].push_back(NewIndex);
+    size_t NextNew = NewBegin;
+    for (size_t OldIndex = OldBegin; OldIndex < OldEnd; ++OldIndex) {
+      auto Found = NewByKey.find(Old[OldIndex].KeyHash);
+      if (Found == NewByKey.end())
+        continue;
+      std::vector<size_t> &Candidates = Found->second;
+      while (!Candidates.empty() && Candidates.back() < NextNew)
+        Candidates.pop_back();
+      if (Candidates.empty())
+        continue;
+      Matches.emplace_back(OldIndex, Candidates.back());
+      NextNew = Candidates.back() + 1;
+      Candidates.pop_back();
+    }
+    return Matches;
+  }
+
+  // Lengths[I][J] is the length of the longest common subsequence of the
+  // keys of Old from OldBegin + I and New from NewBegin + J.
+  const size_t Width = NewSize + 1;
+  std::vector<uint32_t> Lengths((OldSize + 1) * Width, 0);
+  for (size_t I = OldSize; I-- > 0;) {
+    for (size_t J = NewSize; J-- > 0;) {
+      uint32_t &Length = Lengths[I * Width + J];
+      if (Old[OldBegin + I].KeyHash == New[NewBegin + J].KeyHash)
+        Length = Lengths[(I + 1) * Width + J + 1] + 1;
+      else
+        Length = std::max(Lengths[(I + 1) * Width + J],
+                          Lengths[I * Width + J + 1]);
+    }
+  }
+
+  size_t I = 0;
+  size_t J = 0;
+  while (I < OldSize && J < NewSize) {
+    if (Old[OldBegin + I].KeyHash == New[NewBegin + J].KeyHash) {
+      Matches.emplace_back(OldBegin + I, NewBegin + J);
+      ++I;
+      ++J;
+    } else if (Lengths[(I + 1) * Width + J] >= Lengths[I * Width + J + 1]) {
+      ++I;
+    } else {
+      ++J;
+    }
+  }
+  return Matches;
+}
+
+size_t ScopeCompare::count(DifferenceKind Kind) const {
+  return std::count_if(
+      Differences.begin(), Differences.end(),
+      [Kind](const Difference &Diff) { return Diff.Kind == Kind; });
+}
+
+void ScopeCompare::printText(std::ostream &Out, const std::string &OldName,
+                             const std::string &NewName) const {
+  auto printObject = [&](char Marker, const Object *Obj, size_t Level) {
+    std::stringstream Text(Obj->getAsText(Settings));
+    std::string Line;
+    std::string Indent(Level * 2, ' ');
+    std::getline(Text, Line);
+    Out << Marker << ' ' << Indent << Line << '\n';
+    while (std::getline(Text, Line))
+      Out << Marker << ' ' << Indent << Line << '\n';
+  };
+
+  Out << "Comparing \"" << OldName << "\" with \"" << NewName << "\"\n";
+
+  // The parents printed for the previous difference.
+  std::vector<const Object *> Printed;
+  for (const Difference &Diff : Differences) {
+    size_t Common = 0;
+    while (Common < Printed.size() && Common < Diff.Parents.size() &&
+           Printed[Common] == Diff.Parents[Common])
+      ++Common;
+    // Separate the differences in each compile unit.
+    if (&Diff == &Differences.front() ||
+        (Common == 0 && (!Diff.Parents.empty() || !Printed.empty())))
+      Out << '\n';
+    for (size_t Level = Common; Level < Diff.Parents.size(); ++Level)
+      printObject(' ', Diff.Parents[Level], Level);
+    Printed = Diff.Parents;
+
+    size_t Level = Diff.Parents.size();
+    switch (Diff.Kind) {
+    case DifferenceKind::Removed:
+      printObject('-', Diff.Old, Level);
+      break;
+    case DifferenceKind::Added:
+      printObject('+', Diff.New, Level);
+      break;
+    case DifferenceKind::Changed:
+      printObject('<', Diff.Old, Level);
+      printObject('>', Diff.New, Level);
+      break;
+    }
+  }
+
+  Out << "\nAdded " << count(DifferenceKind::Added) << ", removed "
+      << count(DifferenceKind::Removed) << ", changed "
+      << count(DifferenceKind::Changed) << '\n';
+}
+
+void ScopeCompare::printYAML(std::ostream &Out, const std::string &OldName,
+                             const std::string &NewName) const {
+  Out << "old_file: " << quoted(OldName) << '\n'
+      << "new_file: " << quoted(NewName) << '\n'
+      << "differences:";
+  if (Differences.empty())
+    Out << " []";
+  Out << '\n';
+
+  for (const Difference &Diff : Differences) {
+    switch (Diff.Kind) {
+    case DifferenceKind::Removed:
+      Out << "  - change: \"removed\"\n";
+      break;
+    case DifferenceKind::Added:
+      Out << "  - change: \"added\"\n";
+      break;
+    case DifferenceKind::Changed:
+      Out << "  - change: \"changed\"\n";
+      break;
+    }
+    Out << "    parents: [";
+    for (size_t Index = 0; Index < Diff.Parents.size(); ++Index)
+      Out << (Index ? ", " : "")
+          << quoted(Diff.Parents[Index]->getAsText(Settings));
+    Out << "]\n";
+    Out << "    old: "
+        << (Diff.Old ? quoted(Diff.Old->getAsText(Settings)) : "null") << '\n';
+    Out << "    new: "
+        << (Diff.New ? quoted(Diff.New->getAsText(Settings)) : "null") << '\n';
+  }
+
+  Out << "summary:\n"
+      << "  added: " << count(DifferenceKind::Added) << '\n'
+      << "  removed: " << count(DifferenceKind::Removed) << '\n'
+      << "  changed: " << count(DifferenceKind::Changed) << '\n';
+}
@@ -0,0 +1,119 @@
+//===-- LibScopeView/ScopeCompare.h -----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the ScopeCompare class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_SCOPECOMPARE_H
+#define SCOPEVIEW_SCOPECOMPARE_H
+
+#include "PrintSettings.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+class Object;
+class ScopeRoot;
+
+/// \brief Compares the objects of two trees, finding the objects added,
+/// removed and changed in the new tree.
+///
+/// Each printed object is hashed over its text (kind, name, type name and
+/// attributes, without DIE offsets or line numbers) and the hashes of its
+/// printed children. Subtrees with the same hash are skipped without looking
+/// inside them. The children of objects that differ are matched by kind and
+/// name, in order, with a longest common subsequence.
+class ScopeCompare {
+public:
+  enum class DifferenceKind { Added, Removed, Changed };
+
+  /// \brief An object that differs between the trees.
+  struct Difference {
+    DifferenceKind Kind;
+    // The object in the old tree, null if it was added.
+    const Object *Old;
+    // The object in the new tree, null if it was removed.
+    const Object *New;
+    // The printed objects containing it in the new tree, outermost first.
+    std::vector<const Object *> Parents;
+  };
+
+  /// \brief Compare the objects of Old and New that Settings print.
+  ScopeCompare(const ScopeRoot &Old, const ScopeRoot &New,
+               const PrintSettings &Settings);
+
+  /// \brief The differences, in the order of the trees.
+  const std::vector<Difference> &getDifferences() const { return Differences; }
+
+  /// \brief Print the differences as text, each object preceded by "-" if
+  /// removed, "+" if added, or "<" then ">" for its old and new text.
+  void printText(std::ostream &Out, const std::string &OldName,
+                 const std::string &NewName) const;
+
+  /// \brief Print the differences as YAML.
+  void printYAML(std::ostream &Out, const std::string &OldName,
+                 const std::string &NewName) const;
+
+private:
+  // A printed object and the hashes used to compare it.
+  struct Node {
+    const Object *Obj = nullptr;
+    // Hash of the kind and name, for matching the objects of the two trees.
+    uint64_t KeyHash = 0;
+    // Hash of the object without its children or location.
+    uint64_t OwnHash = 0;
+    // Hash of the object and its children's hashes.
+    uint64_t Hash = 0;
+    std::vector<Node> Children;
+  };
+
+  void buildNode(const Object *Obj, Node &Parent) const;
+  void hashNode(Node &N) const;
+  void compareNodes(const Node &Old, const Node &New);
+  void compareChildren(const Node &Old, const Node &New);
+
+  // Align Old and New by key, giving the matched pairs of indices in order.
+  static std::vector<std::pair<size_t, size_t>>
+  matchChildren(const std::vector<Node> &Old, size_t OldBegin, size_t OldEnd,
+                const std::vector<Node> &New, size_t NewBegin, size_t NewEnd);
+
+  size_t count(DifferenceKind Kind) const;
+
+  // The settings used to print and hash the objects, without DIE offsets.
+  PrintSettings Settings;
+  std::vector<Difference> Differences;
+  // The printed objects containing the children being compared.
+  std::vector<const Object *> Parents;
+};
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_SCOPECOMPARE_H
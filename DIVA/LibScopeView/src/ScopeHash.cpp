@@ -0,0 +1,190 @@
+//===-- LibScopeView/ScopeHash.cpp ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the functions hashing the logical view of a compile
+/// unit.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ScopeHash.h"
+#include "FileUtilities.h"
+#include "Line.h"
+#include "Scope.h"
+#include "Symbol.h"
+#include "Type.h"
+
+#include <iomanip>
+#include <string>
+
+using namespace LibScopeView;
+
+namespace {
+
+AccessSpecifier getPrintedAccess(AccessSpecifier Access, const Scope *Parent) {
+  if (Access != AccessSpecifier::Unspecified)
+    return Access;
+  return Parent && Parent->getIsClassType() ? AccessSpecifier::Private
+                                            : AccessSpecifier::Public;
+}
+
+// Add the hashes of the printed objects at or under Obj to Sum. The objects
+// that are not printed are left out, but not their printed children.
+void addLogicalView(const Object &Obj, const PrintSettings &Settings,
+                    uint64_t &Sum);
+
+// Sum the hashes of the printed objects under Obj.
+uint64_t sumChildren(const Object &Obj, const PrintSettings &Settings) {
+  uint64_t Sum = 0;
+  if (const auto *Scp = dyn_cast<Scope>(&Obj))
+    for (const Object *Child : Scp->getChildren())
+      addLogicalView(*Child, Settings, Sum);
+  return Sum;
+}
+
+void addLogicalView(const Object &Obj, const PrintSettings &Settings,
+                    uint64_t &Sum) {
+  // Objects printed as attributes of their parent are always included.
+  if (!Obj.getIsPrintedAsObject() || Settings.printObject(Obj))
+    Sum += hashLogicalView(Obj, Settings);
+  else
+    Sum += sumChildren(Obj, Settings);
+}
+
+} // namespace
+
+void LibScopeView::hashAttributes(const Object &Obj, HashBuilder &Hash) {
+  if (const auto *Scp = dyn_cast<Scope>(&Obj)) {
+    Hash.add(Scp->getIsTemplate());
+    if (Scp->getIsBlock()) {
+      Hash.add(Scp->getIsTryBlock());
+      Hash.add(Scp->getIsCatchBlock());
+    }
+  }
+
+  if (const auto *Enum = dyn_cast<ScopeEnumeration>(&Obj))
+    Hash.add(Enum->getIsClass());
+
+  if (const auto *Func = dyn_cast<ScopeFunction>(&Obj)) {
+    const Scope *Declaration = Func->getReference();
+    if (Declaration && isa<ScopeFunction>(*Declaration)) {
+      Hash.add(Declaration->getInvalidFileName()
+                   ? std::string("?")
+                   : getFileName(Declaration->getFilePath()));
+      Hash.add(Declaration->getLineNumber());
+    }
+    Hash.add(Func->getIsStatic());
+    Hash.add(Func->getIsDeclaredInline());
+    Hash.add(Func->getIsDeclaration());
+  }
+
+  if (const auto *Sym = dyn_cast<Symbol>(&Obj)) {
+    if (Sym->getIsMember())
+      Hash.add(static_cast<uint64_t>(
+          getPrintedAccess(Sym->getAccessSpecifier(), Sym->getParent())));
+    Hash.add(Sym->getIsStatic());
+    Hash.add(Sym->getIsUnspecifiedParameter());
+  }
+
+  if (const auto *Ty = dyn_cast<Type>(&Obj)) {
+    Hash.add(Ty->getValue());
+    if (Ty->getIsBaseType())
+      Hash.add(Ty->getByteSize());
+    if (const auto *Import = dyn_cast<TypeImport>(Ty))
+      if (Import->getIsInheritance())
+        Hash.add(static_cast<uint64_t>(getPrintedAccess(
+            Import->getInheritanceAccess(), Import->getParent())));
+  }
+
+  if (const auto *Ln = dyn_cast<Line>(&Obj)) {
+    Hash.add(Ln->getDiscriminator());
+    Hash.add(Ln->getIsNewStatement());
+    Hash.add(Ln->getIsPrologueEnd());
+    Hash.add(Ln->getIsLineEndSequence());
+    Hash.add(Ln->getIsNewBasicBlock());
+    Hash.add(Ln->getIsEpilogueBegin());
+  }
+}
+
+void LibScopeView::hashObject(const Object &Obj, bool WithLocation,
+                              HashBuilder &Hash) {
+  Hash.add(Obj.getKindAsString());
+  Hash.add(Obj.getQualifiedName() + Obj.getName());
+  if (const Object *Ty = Obj.getType())
+    Hash.add(Obj.getTypeQualifiedName() + Ty->getName());
+  else
+    Hash.add(std::string());
+  if (WithLocation) {
+    Hash.add(Obj.getLineNumber());
+    Hash.add(Obj.getInvalidFileName() ? std::string("?")
+                                      : getFileName(Obj.getFilePath()));
+  }
+  hashAttributes(Obj, Hash);
+}
+
+uint64_t LibScopeView::hashLogicalView(const Object &Obj,
+                                       const PrintSettings &Settings) {
+  HashBuilder Hash;
+  hashObject(Obj, /*WithLocation*/ true, Hash);
+  Hash.add(sumChildren(Obj, Settings));
+  return Hash.get();
+}
+
+void LibScopeView::hashPrintSettings(const PrintSettings &Settings,
+                                     HashBuilder &Hash) {
+  Hash.add(static_cast<uint64_t>(Settings.SortKey));
+  Hash.add(Settings.ShareTypes);
+  for (const auto *Patterns :
+       {&Settings.Filters, &Settings.FilterAnys, &Settings.TreeFilters,
+        &Settings.TreeFilterAnys}) {
+    Hash.add(static_cast<uint64_t>(Patterns->size()));
+    for (const std::string &Pattern : *Patterns)
+      Hash.add(Pattern);
+  }
+  for (bool Show :
+       {Settings.ShowAlias, Settings.ShowBlock, Settings.ShowBlockAttributes,
+        Settings.ShowClass, Settings.ShowEnum, Settings.ShowFunction,
+        Settings.ShowMember, Settings.ShowNamespace, Settings.ShowParameter,
+        Settings.ShowPrimitiveType, Settings.ShowStruct, Settings.ShowTemplate,
+        Settings.ShowUnion, Settings.ShowUsing, Settings.ShowVariable,
+        Settings.ShowCodeline, Settings.ShowCodelineAttributes,
+        Settings.ShowCombined, Settings.ShowDWARFOffset,
+        Settings.ShowDWARFParent, Settings.ShowDWARFTag,
+        Settings.ShowGenerated, Settings.ShowIsGlobal, Settings.ShowIndent,
+        Settings.ShowLevel, Settings.ShowOnlyGlobals, Settings.ShowOnlyLocals,
+        Settings.ShowQualified, Settings.ShowVoid, Settings.ShowZeroLine})
+    Hash.add(Show);
+}
+
+void LibScopeView::printCompileUnitHashes(const ScopeRoot &Root,
+                                          const PrintSettings &Settings,
+                                          std::ostream &Out) {
+  for (const Object *Child : Root.getChildren()) {
+    if (!isa<ScopeCompileUnit>(*Child))
+      continue;
+    Out << std::hex << std::setw(16) << std::setfill('0')
+        << hashLogicalView(*Child, Settings) << std::dec << std::setfill(' ')
+        << "  " << Child->getName() << '\n';
+  }
+}
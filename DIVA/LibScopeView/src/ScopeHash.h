@@ -0,0 +1,106 @@
+//===-- LibScopeView/ScopeHash.h --------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the functions hashing the logical view of a compile
+/// unit.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_SCOPEHASH_H
+#define SCOPEVIEW_SCOPEHASH_H
+
+#include "PrintSettings.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace LibScopeView {
+
+class Object;
+class ScopeRoot;
+
+/// \brief Builds a 64-bit hash from a sequence of values with FNV-1a.
+class HashBuilder {
+public:
+  void add(uint64_t Value) {
+    for (int Byte = 0; Byte < 8; ++Byte) {
+      Hash ^= (Value >> (Byte * 8)) & 0xff;
+      Hash *= 0x100000001b3ULL;
+    }
+  }
+
+  void add(const std::string &Text) { add(Text.data(), Text.size()); }
+
+  void add(const char *Data, size_t Size) {
+    for (size_t I = 0; I < Size; ++I) {
+      Hash ^= static_cast<unsigned char>(Data[I]);
+      Hash *= 0x100000001b3ULL;
+    }
+    // Keep "ab", "c" apart from "a", "bc".
+    add(static_cast<uint64_t>(Size));
+  }
+
+  /// \brief The hash, with its bits mixed so that hashes can be summed.
+  uint64_t get() const {
+    uint64_t Result = Hash;
+    Result = (Result ^ (Result >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    Result = (Result ^ (Result >> 27)) * 0x94d049bb133111ebULL;
+    return Result ^ (Result >> 31);
+  }
+
+private:
+  uint64_t Hash = 0xcbf29ce484222325ULL;
+};
+
+/// \brief Add the attributes of an object, as printed with it, to Hash.
+void hashAttributes(const Object &Obj, HashBuilder &Hash);
+
+/// \brief Add an object without its children to Hash: its kind, name, type
+/// name and attributes, and its line and file if WithLocation is set.
+void hashObject(const Object &Obj, bool WithLocation, HashBuilder &Hash);
+
+/// \brief Hash the logical view of an object and its children, without
+/// formatting any text.
+///
+/// The hash covers the kind, name, type name, source line and attributes of
+/// each object printed with Settings, but not the DIE offsets. The children
+/// are combined without regard to their order, so the hash does not depend
+/// on the order the objects were read or sorted in. The filters are not
+/// applied.
+uint64_t hashLogicalView(const Object &Obj, const PrintSettings &Settings);
+
+/// \brief Add the settings that change the text of the objects printed, and
+/// which objects are printed, to Hash.
+void hashPrintSettings(const PrintSettings &Settings, HashBuilder &Hash);
+
+/// \brief Print the hash of the logical view of each compile unit of Root,
+/// followed by its name, one compile unit per line.
+void printCompileUnitHashes(const ScopeRoot &Root,
+                            const PrintSettings &Settings, std::ostream &Out);
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_SCOPEHASH_H
@@ -0,0 +1,99 @@
+//===-- LibScopeView/ScopeJSONPrinter.cpp -----------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definitions of ScopeJSONPrinter's methods.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ScopeJSONPrinter.h"
+#include "JSONWriter.h"
+#include "Scope.h"
+
+#include <ostream>
+
+using namespace LibScopeView;
+
+ScopeJSONPrinter::ScopeJSONPrinter(const PrintSettings &Settings,
+                                   const std::string &InputFile,
+                                   const std::string &Version)
+    : ScopePrinter(Settings), NextID(1) {
+  JSONWriter JSON(JSONHeader);
+  JSON.objectBegin();
+  JSON.key("input_file");
+  JSON.string(InputFile);
+  JSON.key("output_version");
+  JSON.string(Version);
+  JSON.objectEnd();
+  JSONHeader += '\n';
+}
+
+void ScopeJSONPrinter::initBeforePrint(const Object *) {
+  NextID = 1;
+  ParentIDs.clear();
+}
+
+const std::string &ScopeJSONPrinter::getFileExtension() {
+  static std::string JSONExtension = "jsonl";
+  return JSONExtension;
+}
+
+const std::string &ScopeJSONPrinter::getHeader() { return JSONHeader; }
+
+void ScopeJSONPrinter::printImpl(const Object *Obj,
+                                 std::ostream &OutputStream) {
+  // Don't print anything for the scope root, but do visit the children.
+  if (isa<ScopeRoot>(*Obj)) {
+    printChildren(Obj);
+    return;
+  }
+
+  // Skip objects that shouldn't be printed as an object.
+  if (!Obj->getIsPrintedAsObject())
+    return;
+
+  uint64_t ID = NextID++;
+
+  LineBuffer.clear();
+  JSONWriter JSON(LineBuffer);
+  JSON.objectBegin();
+  JSON.key("id");
+  JSON.number(ID);
+  JSON.key("parent");
+  if (ParentIDs.empty())
+    JSON.null();
+  else
+    JSON.number(ParentIDs.back());
+  Obj->writeAsJSON(JSON);
+  JSON.objectEnd();
+  LineBuffer += '\n';
+  OutputStream.write(LineBuffer.data(), LineBuffer.size());
+
+  // Print children.
+  if (isa<Scope>(*Obj)) {
+    ParentIDs.push_back(ID);
+    printChildren(Obj);
+    ParentIDs.pop_back();
+  }
+}
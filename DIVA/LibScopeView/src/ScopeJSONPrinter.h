@@ -0,0 +1,70 @@
+//===-- LibScopeView/ScopeJSONPrinter.h -------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the ScopeJSONPrinter class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_SCOPEJSONPRINTER_H
+#define SCOPEVIEW_SCOPEJSONPRINTER_H
+
+#include "ScopePrinter.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief A Scope printer that outputs in the JSON Lines format.
+///
+/// The first line is a header object holding the input file and the output
+/// version. It is followed by one JSON object per line for each DIVA object,
+/// in the same order as the other printers. Each object has an "id", unique
+/// within the output, and the "parent" id of its enclosing object (null for
+/// top level objects), so the output can be processed line by line without
+/// building the tree.
+class ScopeJSONPrinter : public ScopePrinter {
+public:
+  ScopeJSONPrinter(const PrintSettings &Settings, const std::string &InputFile,
+                   const std::string &Version);
+
+private:
+  void initBeforePrint(const Object *) override;
+  const std::string &getFileExtension() override;
+  const std::string &getHeader() override;
+  void printImpl(const Object *Obj, std::ostream &OutputStream) override;
+
+  std::string JSONHeader;
+  // Id given to the next object printed.
+  uint64_t NextID;
+  // Ids of the objects enclosing the object being printed.
+  std::vector<uint64_t> ParentIDs;
+  // Buffer reused for each line.
+  std::string LineBuffer;
+};
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_SCOPEJSONPRINTER_H
@@ -30,10 +30,17 @@
 #include "ScopePrinter.h"
 #include "Error.h"
 #include "FileUtilities.h"
+#include "GzipStream.h"
+#include "OutputPack.h"
 #include "Scope.h"
+#include "ScopeHash.h"
+#include "Snapshot.h"
 
 #include <assert.h>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
 using namespace LibScopeView;
 
@@ -67,19 +74,102 @@ void ScopePrinter::print(const ScopeRoot *Root, const std::string &OutputDir) {
     if (isa<ScopeCompileUnit>(*CU)) {
       // Open an output file for each CU.
       std::string OutputPath(SplitOutputDir);
-      OutputPath += flattenFilePath(CU->getName());
-      OutputPath += ".";
-      OutputPath += getFileExtension();
+      OutputPath += getSplitFileName(CU);
+      if (Settings.CompressOutput)
+        OutputPath += ".gz";
 
-      std::ofstream SplitOutputFile(nativeFilePath(OutputPath));
+      // Only replace the files whose contents changed, so that the others
+      // keep their modification times.
+      if (Settings.WriteOnlyChangedOutput) {
+        std::ostringstream SplitOutput(std::ios::out | std::ios::binary);
+        printSplitOutput(CU, SplitOutput, OutputPath);
+        const std::string Contents = SplitOutput.str();
+        std::string Existing;
+        uint64_t ExistingSize;
+        int64_t ModifiedTime;
+        if (getFileStatus(OutputPath, ExistingSize, ModifiedTime) &&
+            ExistingSize == Contents.size() &&
+            readFileContents(OutputPath, Existing) && Existing == Contents)
+          continue;
+        if (!replaceFileContents(OutputPath, Contents))
+          fatalError(LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_OPEN_FILE,
+                     OutputPath);
+        WrittenFiles.push_back(OutputPath);
+        continue;
+      }
+
+      std::ofstream SplitOutputFile(nativeFilePath(OutputPath),
+                                    Settings.CompressOutput
+                                        ? std::ios::out | std::ios::binary
+                                        : std::ios::out);
       if (SplitOutputFile.fail())
         fatalError(LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_OPEN_FILE,
                    OutputPath);
-      printSingleOutput(CU, SplitOutputFile);
+      printSplitOutput(CU, SplitOutputFile, OutputPath);
+      WrittenFiles.push_back(OutputPath);
     }
   }
 }
 
+void ScopePrinter::print(const ScopeRoot *Root, OutputPackWriter &Pack) {
+  if (Root->getChildren().size() == 0)
+    return;
+
+  initBeforePrint(Root);
+  for (const auto *CU : Root->getChildren()) {
+    if (isa<ScopeCompileUnit>(*CU)) {
+      std::ostringstream Output(std::ios::out | std::ios::binary);
+      printSingleOutput(CU, Output);
+      Pack.add(getSplitFileName(CU), Output.str(), Settings.CompressOutput);
+    }
+  }
+}
+
+std::string ScopePrinter::getSplitFileName(const Object *CU) {
+  return flattenFilePath(CU->getName()) + "." + getFileExtension();
+}
+
+void ScopePrinter::printSplitOutput(const Object *CU, std::ostream &Output,
+                                    const std::string &OutputPath) {
+  if (Settings.CompressOutput) {
+    GzipOutputStream CompressedFile(Output, Settings.CompressionThreads);
+    printSingleOutput(CU, CompressedFile);
+    CompressedFile.finish();
+    if (CompressedFile.fail())
+      fatalError(LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_COMPRESS,
+                 OutputPath);
+  } else {
+    printSingleOutput(CU, Output);
+  }
+}
+
+void ScopePrinter::printPart(const ScopeRoot *Part, std::ostream &Output) {
+  // Each part starts from the same state, so that printing it in a worker
+  // process or a shard gives the same output.
+  restoreOutputState(std::string());
+  initBeforePrint(Part);
+  OutputStream = &Output;
+  if (!PrintedPartsHeader) {
+    *OutputStream << getHeader();
+    PrintedPartsHeader = true;
+  }
+  visit(Part);
+}
+
+void ScopePrinter::printIndependentPart(const ScopeRoot *Part,
+                                        std::ostream &Output,
+                                        bool IsFirstPart) {
+  PrintedPartsHeader = !IsFirstPart;
+  printPart(Part, Output);
+}
+
+void ScopePrinter::printEnd(std::ostream &Output) {
+  if (!PrintedPartsHeader)
+    Output << getHeader();
+  Output << getFooter();
+  PrintedPartsHeader = false;
+}
+
 const std::string &ScopePrinter::getHeader() { return EmptyString; }
 
 const std::string &ScopePrinter::getFooter() { return EmptyString; }
@@ -87,10 +177,76 @@ const std::string &ScopePrinter::getFooter() { return EmptyString; }
 void ScopePrinter::printSingleOutput(const Object *Obj, std::ostream &Output) {
   OutputStream = &Output;
   *OutputStream << getHeader();
-  visit(Obj);
+  if (!OutputCacheDirectory.empty() && isa<ScopeCompileUnit>(*Obj))
+    printCachedOutput(cast<ScopeCompileUnit>(*Obj));
+  else
+    visit(Obj);
   *OutputStream << getFooter();
 }
 
+void ScopePrinter::printCachedOutput(const ScopeCompileUnit &CU) {
+  HashBuilder Hash;
+  if (!hashOutputState(CU, Hash)) {
+    visit(&CU);
+    return;
+  }
+  hashPrintSettings(Settings, Hash);
+  const ScopeCompileUnit::OutputHashes &CUHashes = hashCompileUnit(CU);
+  Hash.add(CUHashes.Content);
+  // Sorting by offset also orders the lines by address among the other
+  // objects.
+  if (printsOffsets() || Settings.SortKey == SortingKey::OFFSET)
+    Hash.add(CUHashes.Offsets);
+  std::ostringstream EntryPath;
+  EntryPath << unifyFilePath(OutputCacheDirectory) << '/' << std::hex
+            << std::setw(16) << std::setfill('0') << Hash.get() << '.'
+            << getFileExtension();
+
+  // An entry is a hash of the rest of it, the size of the saved state, the
+  // state, and then the output.
+  std::string Entry;
+  uint64_t EntryHash;
+  uint32_t StateSize;
+  const size_t PrefixSize = sizeof(EntryHash) + sizeof(StateSize);
+  if (readFileContents(EntryPath.str(), Entry) && Entry.size() >= PrefixSize) {
+    std::memcpy(&EntryHash, Entry.data(), sizeof(EntryHash));
+    std::memcpy(&StateSize, Entry.data() + sizeof(EntryHash),
+                sizeof(StateSize));
+    HashBuilder Check;
+    Check.add(Entry.data() + sizeof(EntryHash),
+              Entry.size() - sizeof(EntryHash));
+    if (Check.get() == EntryHash && Entry.size() - PrefixSize >= StateSize) {
+      restoreOutputState(Entry.substr(PrefixSize, StateSize));
+      OutputStream->write(Entry.data() + PrefixSize + StateSize,
+                          static_cast<std::streamsize>(
+                              Entry.size() - PrefixSize - StateSize));
+      return;
+    }
+  }
+
+  std::ostream *Output = OutputStream;
+  std::ostringstream CUOutput;
+  OutputStream = &CUOutput;
+  visit(&CU);
+  OutputStream = Output;
+  std::string Text = CUOutput.str();
+  *OutputStream << Text;
+
+  // The cache is only an aid, so an entry that cannot be written is left out.
+  std::string State = saveOutputState();
+  StateSize = static_cast<uint32_t>(State.size());
+  Entry.assign(sizeof(EntryHash), '\0');
+  Entry.append(reinterpret_cast<const char *>(&StateSize), sizeof(StateSize));
+  Entry += State;
+  Entry += Text;
+  HashBuilder Check;
+  Check.add(Entry.data() + sizeof(EntryHash), Entry.size() - sizeof(EntryHash));
+  EntryHash = Check.get();
+  std::memcpy(&Entry[0], &EntryHash, sizeof(EntryHash));
+  recursiveMakeDir(unifyFilePath(OutputCacheDirectory));
+  replaceFileContents(EntryPath.str(), Entry);
+}
+
 void ScopePrinter::visitImpl(const Object *Obj) {
   assert(OutputStream && "ScopePrinter methods calling ScopePrinter::visit "
                          "should set OutputStream first");
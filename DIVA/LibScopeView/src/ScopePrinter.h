@@ -34,10 +34,14 @@
 #include "PrintSettings.h"
 
 #include <string>
+#include <vector>
 
 namespace LibScopeView {
 
+class HashBuilder;
 class Object;
+class OutputPackWriter;
+class ScopeCompileUnit;
 class ScopeRoot;
 
 /// \brief An abstract base class for a scope printer.
@@ -73,6 +77,37 @@ public:
   /// \brief Print each CU under the ScopeRoot to a file in OutputDir.
   void print(const ScopeRoot *Root, const std::string &OutputDir);
 
+  /// \brief Print each CU under the ScopeRoot into Pack, as the file that
+  /// printing to an OutputDir would write.
+  void print(const ScopeRoot *Root, OutputPackWriter &Pack);
+
+  /// \brief Get the files written by printing to an OutputDir, which leave
+  /// out those left unchanged when only the changed outputs are written.
+  const std::vector<std::string> &getWrittenFiles() const {
+    return WrittenFiles;
+  }
+
+  /// \brief Print one part of a tree that is read in parts to Output. The
+  /// header is printed before the first part, and the output of each part
+  /// does not depend on the parts printed before it.
+  void printPart(const ScopeRoot *Part, std::ostream &Output);
+
+  /// \brief Print one part of a tree that is read in parts to Output, as if
+  /// no part was printed before it. The header is printed before the part if
+  /// IsFirstPart.
+  void printIndependentPart(const ScopeRoot *Part, std::ostream &Output,
+                            bool IsFirstPart);
+
+  /// \brief Finish printing a tree that was read in parts to Output.
+  void printEnd(std::ostream &Output);
+
+  /// \brief Keep the output of each compile unit printed to its own file in
+  /// Directory, and copy it from there when the same compile unit is printed
+  /// again with the same settings.
+  void setOutputCache(const std::string &Directory) {
+    OutputCacheDirectory = Directory;
+  }
+
 protected:
   void printChildren(const Object *Obj) { visitChildren(Obj); }
 
@@ -97,14 +132,52 @@ private:
   /// bottom of each split file.
   virtual const std::string &getFooter();
 
+  /// \brief Add the state of the printer that the output of CU depends on,
+  /// other than CU and the settings, to Hash. Return false if the output of
+  /// CU cannot be kept in the output cache.
+  virtual bool hashOutputState(const ScopeCompileUnit &, HashBuilder &) {
+    return false;
+  }
+
+  /// \brief Return true if the output prints the DIE offsets or line
+  /// addresses of the objects, rather than only depending on their order.
+  virtual bool printsOffsets() const { return true; }
+
+  /// \brief Get the state left by printing a compile unit that the output of
+  /// the next ones depends on, kept with its output in the cache.
+  virtual std::string saveOutputState() { return std::string(); }
+
+  /// \brief Restore the state saved by saveOutputState, when the output of a
+  /// compile unit is copied from the cache.
+  virtual void restoreOutputState(const std::string &) {}
+
   // Do the printing for one output.
   void printSingleOutput(const Object *Obj, std::ostream &OutputStream);
 
+  // Get the name of the file of CU in split output, without any ".gz".
+  std::string getSplitFileName(const Object *CU);
+
+  // Print the file of CU in split output, compressing it if needed.
+  void printSplitOutput(const Object *CU, std::ostream &Output,
+                        const std::string &OutputPath);
+
+  // Print CU, copying its output from the output cache if it is there.
+  void printCachedOutput(const ScopeCompileUnit &CU);
+
   // Call printImpl() on the object with the appropriate OutputStream.
   void visitImpl(const Object *Obj) override;
 
   // Current output stream.
   std::ostream *OutputStream;
+
+  // Has printPart printed the header?
+  bool PrintedPartsHeader = false;
+
+  // The directory of the output cache, or empty for none.
+  std::string OutputCacheDirectory;
+
+  // The files written by printing to an OutputDir.
+  std::vector<std::string> WrittenFiles;
 };
 
 } // end namespace LibScopeView
@@ -28,11 +28,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "ScopeTextPrinter.h"
+#include "DwarfNames.h"
 #include "FileUtilities.h"
 #include "Object.h"
+#include "OutputIndex.h"
 #include "Scope.h"
+#include "ScopeHash.h"
 
 #include <cassert>
+#include <initializer_list>
 #include <iomanip>
 #include <sstream>
 
@@ -51,71 +55,138 @@ size_t findLevel(const Object *Obj) {
   return Result;
 }
 
-// Visitor that finds the maximum sizes of text output for aligning printing.
+// Get the name of the compile unit containing Obj.
+std::string findCompileUnitName(const Object *Obj) {
+  while (Obj && !isa<ScopeCompileUnit>(*Obj))
+    Obj = Obj->getParent();
+  return Obj ? Obj->getName() : std::string();
+}
+
+// Get the length of the longest DWARF tag name in Tags.
+size_t findTagNameIndent(const std::set<Dwarf_Half> &Tags) {
+  size_t Result = 0;
+  for (Dwarf_Half Tag : Tags)
+    Result = std::max(Result, getDwarfTagName(Tag).Length);
+  return Result;
+}
+
+// Get the extents recorded by the reader for Obj, if there are any.
+const ScopeExtents *findRecordedExtents(const Object *Obj) {
+  const ScopeExtents *Extents = nullptr;
+  if (auto *Root = dyn_cast<ScopeRoot>(Obj))
+    Extents = &Root->getExtents();
+  else if (auto *CU = dyn_cast<ScopeCompileUnit>(Obj))
+    Extents = &CU->getExtents();
+  return Extents && Extents->getIsRecorded() ? Extents : nullptr;
+}
+
+// Visitor that finds the maximum sizes of text output for aligning printing,
+// used for trees that the reader didn't record the extents of.
 class IndentSizeFinder : private ConstScopeVisitor {
 public:
-  IndentSizeFinder(const Object *Obj)
-      : CurrentLevel(findLevel(Obj)), TagNameIndent(0), MaxLine(0),
-        MaxLevel(0) {
+  IndentSizeFinder(const Object *Obj) : CurrentLevel(findLevel(Obj)) {
     visit(Obj);
   }
 
-  size_t getLineIndent() { return std::to_string(MaxLine).size(); }
-  size_t getTagIndent() { return TagNameIndent; }
-  size_t getLevelIndent() { return std::to_string(MaxLevel).size(); }
+  const ScopeExtents &getExtents() { return Extents; }
 
 private:
   void visitImpl(const Object *Obj) override {
-    MaxLine = std::max(MaxLine, Obj->getLineNumber());
-    MaxLevel = std::max(MaxLevel, CurrentLevel);
-
     // Root doesn't have a level.
-    if (Obj->getParent())
-      ++CurrentLevel;
-
-    // TODO: Store the tag name string in the Object.
-    Dwarf_Half Tag = Obj->getDieTag();
-    if (Tag && !SeenDwarfTags.count(Tag)) {
-      SeenDwarfTags.emplace(Tag);
-      const char *TagName;
-      dwarf_get_TAG_name(Tag, &TagName);
-      TagNameIndent = std::max(TagNameIndent, strlen(TagName));
+    if (!Obj->getParent()) {
+      visitChildren(Obj);
+      return;
     }
 
+    Extents.addObject(*Obj, CurrentLevel);
+    ++CurrentLevel;
     visitChildren(Obj);
+    --CurrentLevel;
   }
 
   size_t CurrentLevel;
+  ScopeExtents Extents;
+};
 
-  size_t TagNameIndent;
-  uint64_t MaxLine;
-  size_t MaxLevel;
+// Check if the name of Obj matches the filters, using the result cached for
+// its interned name if it has one.
+bool matchesName(const FilterMatcher &Matcher, const Object *Obj) {
+  if (StringPoolRef NameRef = Obj->getNamePoolRef())
+    return Matcher.matches(NameRef);
+  return Matcher.matches(Obj->getName());
+}
 
-  std::set<Dwarf_Half> SeenDwarfTags;
-};
+// Add all the parents of Obj to Parents.
+void addParents(const Object *Obj,
+                std::unordered_set<const Object *> &Parents) {
+  for (const Object *Parent = Obj->getParent(); Parent;
+       Parent = Parent->getParent())
+    Parents.emplace(Parent);
+}
 
-// Visitor that finds Objects with children that match a tree filter.
+// Find the names in the tree summarised in Root that match any of Matchers,
+// with nullptr if they match an object with no name. Return false if there
+// are more than MaxNames of them.
+bool findMatchingNames(const ScopeRoot &Root,
+                       std::initializer_list<const FilterMatcher *> Matchers,
+                       size_t MaxNames, std::vector<StringPoolRef> &Names) {
+  Names.clear();
+  for (const FilterMatcher *Matcher : Matchers) {
+    if (Matcher->matches(std::string())) {
+      Names.push_back(nullptr);
+      break;
+    }
+  }
+  for (StringPoolRef Name : Root.getNames()) {
+    bool Matches = false;
+    for (const FilterMatcher *Matcher : Matchers)
+      Matches = Matches || Matcher->matches(Name);
+    if (!Matches)
+      continue;
+    Names.push_back(Name);
+    if (Names.size() > MaxNames)
+      return false;
+  }
+  return true;
+}
+
+// Check if the summary of Scp may contain one of Names.
+bool mayContainAny(const Scope &Scp, const std::vector<StringPoolRef> &Names) {
+  for (StringPoolRef Name : Names)
+    if (Scp.getDescendantNames().mayContain(Name))
+      return true;
+  return false;
+}
+
+// Visitor that finds Objects with children that match a tree filter. If the
+// names matching the tree filter are given, the scopes that have none of them
+// below are skipped.
 class TreeFilteredParentFinder : private ConstScopeVisitor {
 public:
   TreeFilteredParentFinder(
-      const Object *Obj, const PrintSettings &PrintingSettings,
+      const Object *Obj, const FilterMatcher &TreeFilterMatcher,
+      const std::vector<StringPoolRef> *TreeFilteredNames,
       std::unordered_set<const Object *> &FilteredParentsOut)
-      : Settings(PrintingSettings), FilteredParents(FilteredParentsOut) {
+      : TreeFilter(TreeFilterMatcher), Names(TreeFilteredNames),
+        FilteredParents(FilteredParentsOut) {
     visit(Obj);
   }
 
 private:
   void visitImpl(const Object *Obj) override {
-    if (Settings.matchesTreeFilterPattern(Obj->getName())) {
-      for (const Object *Parent = Obj->getParent(); Parent;
-           Parent = Parent->getParent())
-        FilteredParents.emplace(Parent);
+    if (matchesName(TreeFilter, Obj)) {
+      addParents(Obj, FilteredParents);
       return;
     }
+    if (Names)
+      if (const auto *Scp = dyn_cast<Scope>(Obj))
+        if (!mayContainAny(*Scp, *Names))
+          return;
     visitChildren(Obj);
   }
 
-  const PrintSettings &Settings;
+  const FilterMatcher &TreeFilter;
+  const std::vector<StringPoolRef> *Names;
   std::unordered_set<const Object *> &FilteredParents;
 };
 
@@ -147,12 +218,9 @@ std::string getDWARFAttributesString(const Object *Obj, size_t Level,
   AttrString << std::setfill(' ');
   // [TAG]
   if (Settings.ShowDWARFTag) {
-    const char *TagName = "";
-    auto Tag = Obj->getDieTag();
-    if (Tag)
-      dwarf_get_TAG_name(Tag, &TagName);
+    const DwarfName &TagName = getDwarfTagName(Obj->getDieTag());
     std::string TagNameWithBraces("[");
-    TagNameWithBraces.append(TagName).append("]");
+    TagNameWithBraces.append(TagName.Name, TagName.Length).append("]");
     AttrString << std::setw(static_cast<int>(TagIndentSize) + 2) << std::left
                << TagNameWithBraces;
   }
@@ -177,14 +245,28 @@ ScopeTextPrinter::ScopeTextPrinter(const PrintSettings &PrintingSettings,
                                    std::string InputFile, uint8_t Indent)
     : ScopePrinter(PrintingSettings),
       HeaderText(std::string("{InputFile} \"") + InputFile + "\"\n"),
-      IndentSize(Indent) {}
+      IndentSize(Indent),
+      Filter(PrintingSettings.Filters, PrintingSettings.FilterAnys),
+      TreeFilter(PrintingSettings.TreeFilters,
+                 PrintingSettings.TreeFilterAnys) {}
 
 void ScopeTextPrinter::initBeforePrint(const Object *Obj) {
-  // Set all the indent sizes by examining Obj and its children.
-  IndentSizeFinder IndentSizes(Obj);
-  LineNumberIndentSize = IndentSizes.getLineIndent();
-  TagIndentSize = IndentSizes.getTagIndent();
-  LevelNumberIndentSize = IndentSizes.getLevelIndent();
+  // Set all the indent sizes from the extents of Obj and its children,
+  // examining them only if the reader didn't record the extents.
+  ScopeExtents FoundExtents;
+  const ScopeExtents *Extents = findRecordedExtents(Obj);
+  if (!Extents) {
+    FoundExtents = IndentSizeFinder(Obj).getExtents();
+    Extents = &FoundExtents;
+  }
+  LineNumberIndentSize = std::to_string(Extents->getMaxLineNumber()).size();
+  TagIndentSize = findTagNameIndent(Extents->getDwarfTags());
+  // The level column is sized for as many levels as there are objects below
+  // Obj, rather than for their depth.
+  size_t ObjectCount = Extents->getObjectCount();
+  LevelNumberIndentSize =
+      std::to_string(ObjectCount ? findLevel(Obj) + ObjectCount - 1 : 0)
+          .size();
 
   // Figure out how much indent will be needed on lines without dwarf attributes
   // by getting the length of any dwarf attribute line.
@@ -196,10 +278,65 @@ void ScopeTextPrinter::initBeforePrint(const Object *Obj) {
   AttributesIndentSize = DAttrs.size() + FAttrs.size();
   FollowingLineExtraIndent = AttributesIndentSize + LineNumberIndentSize;
 
+  const auto *Root = dyn_cast<ScopeRoot>(Obj);
+  const NameIndex *Index = Root ? Root->getNameIndex() : nullptr;
+  SharedTypes =
+      Root && !Root->getSharedTypes().empty() ? &Root->getSharedTypes() : nullptr;
+  UseNameIndex = Index && Settings.hasOnlyExactNameFilters();
+
+  // If the reader summarised the names below each scope, find the few names
+  // that match the filters, to skip the scopes that have none of them. This
+  // is also done when Obj is a compile unit, using the names of the whole
+  // tree.
+  const Object *Top = Obj;
+  while (Top->getParent())
+    Top = Top->getParent();
+  const auto *TopRoot = dyn_cast<ScopeRoot>(Top);
+  bool HasNameSummaries = !UseNameIndex && TopRoot &&
+                          TopRoot->getHasNameSummaries() &&
+                          Settings.hasFilters();
+  CanSkipSubtrees =
+      HasNameSummaries && findMatchingNames(*TopRoot, {&Filter, &TreeFilter},
+                                            MaxFilteredNames, FilteredNames);
+  std::vector<StringPoolRef> TreeFilteredNames;
+  bool CanSkipTreeFiltered =
+      HasNameSummaries && !TreeFilter.empty() &&
+      findMatchingNames(*TopRoot, {&TreeFilter}, MaxFilteredNames,
+                        TreeFilteredNames);
+
   // If we are tree filtering then find parents that need to be printed.
   ObjectsWithTreeFilteredChildren.clear();
-  if (!(Settings.TreeFilters.empty() && Settings.TreeFilterAnys.empty()))
-    TreeFilteredParentFinder(Obj, Settings, ObjectsWithTreeFilteredChildren);
+  if (UseNameIndex)
+    findTreeFilteredParents(*Index);
+  else if (!TreeFilter.empty())
+    TreeFilteredParentFinder(Obj, TreeFilter,
+                             CanSkipTreeFiltered ? &TreeFilteredNames : nullptr,
+                             ObjectsWithTreeFilteredChildren);
+
+  // With exact name filters, only the parents of the objects found in the
+  // index have children to print.
+  ObjectsWithFilteredChildren.clear();
+  if (UseNameIndex) {
+    for (const auto *Patterns : {&Settings.Filters, &Settings.TreeFilters})
+      for (const std::string &Pattern : *Patterns)
+        for (const Object *Found : Index->find(Pattern))
+          addParents(Found, ObjectsWithFilteredChildren);
+  }
+}
+
+void ScopeTextPrinter::findTreeFilteredParents(const NameIndex &Index) {
+  // As TreeFilteredParentFinder, ignore objects inside an object that
+  // matches a tree filter.
+  for (const std::string &Pattern : Settings.TreeFilters) {
+    for (const Object *Found : Index.find(Pattern)) {
+      bool InsideMatch = false;
+      for (const Object *Parent = Found->getParent(); Parent && !InsideMatch;
+           Parent = Parent->getParent())
+        InsideMatch = matchesName(TreeFilter, Parent);
+      if (!InsideMatch)
+        addParents(Found, ObjectsWithTreeFilteredChildren);
+    }
+  }
 }
 
 const std::string &ScopeTextPrinter::getFileExtension() {
@@ -213,6 +350,58 @@ const std::string &ScopeTextPrinter::getHeader() {
   return HeaderText;
 }
 
+bool ScopeTextPrinter::printsOffsets() const {
+  return Settings.ShowDWARFOffset || Settings.ShowDWARFParent;
+}
+
+bool ScopeTextPrinter::hashOutputState(const ScopeCompileUnit &CU,
+                                       HashBuilder &Hash) {
+  for (size_t Size :
+       {static_cast<size_t>(IndentSize), CurrentLevel, IndentLevel,
+        LineNumberIndentSize, TagIndentSize, LevelNumberIndentSize,
+        AttributesIndentSize, FollowingLineExtraIndent})
+    Hash.add(static_cast<uint64_t>(Size));
+  Hash.add(IgnoreFilters);
+  Hash.add(getCurrentFileState());
+
+  // The compile units that the members of the shared types in CU are printed
+  // in.
+  if (SharedTypes) {
+    std::vector<const Scope *> Scopes = {&CU};
+    while (!Scopes.empty()) {
+      const Scope *Scp = Scopes.back();
+      Scopes.pop_back();
+      auto Found = SharedTypes->find(Scp);
+      if (Found != SharedTypes->end()) {
+        Hash.add(Scp->getDieOffset() - CU.getDieOffset());
+        Hash.add(findCompileUnitName(Found->second));
+      }
+      for (const Object *Child : Scp->getChildren())
+        if (const auto *ChildScope = dyn_cast<Scope>(Child))
+          Scopes.push_back(ChildScope);
+    }
+  }
+  return true;
+}
+
+std::string ScopeTextPrinter::saveOutputState() {
+  return getCurrentFileState();
+}
+
+void ScopeTextPrinter::restoreOutputState(const std::string &State) {
+  // The path is not added to the string pool, which may be in use by the
+  // thread reading the tree.
+  CurrentFileRef = nullptr;
+  HasRestoredFilePath = !State.empty();
+  RestoredFilePath = HasRestoredFilePath ? State.substr(1) : std::string();
+}
+
+std::string ScopeTextPrinter::getCurrentFileState() const {
+  if (CurrentFileRef)
+    return '+' + *CurrentFileRef;
+  return HasRestoredFilePath ? '+' + RestoredFilePath : std::string();
+}
+
 void ScopeTextPrinter::printImpl(const Object *Obj,
                                  std::ostream &OutputStream) {
   // Don't print anything for the scope root, but do visit the children.
@@ -226,7 +415,8 @@ void ScopeTextPrinter::printImpl(const Object *Obj,
 
   if (!Settings.printObject(*Obj)) {
     // --no-show-*, Don't print, but show the children.
-    printIndentedChildren(Obj);
+    if (!canSkipChildren(Obj))
+      printIndentedChildren(Obj);
     return;
   }
 
@@ -237,17 +427,18 @@ void ScopeTextPrinter::printImpl(const Object *Obj,
       printObjectText(Obj, OutputStream);
       printIndentedChildren(Obj);
       return;
-    } else if (Settings.matchesTreeFilterPattern(Obj->getName())) {
+    } else if (matchesName(TreeFilter, Obj)) {
       // Print this and all children regardless of filters.
       printObjectText(Obj, OutputStream);
       IgnoreFilters = true;
       printIndentedChildren(Obj);
       IgnoreFilters = false;
       return;
-    } else if (!Settings.matchesFilterPattern(Obj->getName())) {
+    } else if (!matchesName(Filter, Obj)) {
       // Doesn't match the filters so don't print. It's children might so visit
       // them.
-      printIndentedChildren(Obj);
+      if (!canSkipChildren(Obj))
+        printIndentedChildren(Obj);
       return;
     }
   }
@@ -261,14 +452,25 @@ void ScopeTextPrinter::printObjectText(const Object *Obj,
   // Print file names.
   StringPoolRef FileNameRef = Obj->getFilePathPoolRef();
   if (FileNameRef && CurrentFileRef != FileNameRef) {
+    bool IsRestoredFile = !CurrentFileRef && HasRestoredFilePath &&
+                          *FileNameRef == RestoredFilePath;
     CurrentFileRef = FileNameRef;
-    std::string FileName(getFileName(Obj->getFilePath()));
-    FileName = FileName.empty() ? "?" : FileName;
-    OutputStream << '\n'
-                 << std::string(AttributesIndentSize, ' ') << "{Source} \""
-                 << FileName << "\"\n";
+    HasRestoredFilePath = false;
+    if (!IsRestoredFile) {
+      std::string FileName(getFileName(Obj->getFilePath()));
+      FileName = FileName.empty() ? "?" : FileName;
+      OutputStream << '\n'
+                   << std::string(AttributesIndentSize, ' ') << "{Source} \""
+                   << FileName << "\"\n";
+    }
   }
 
+  // Index the compile units and the scopes directly in them.
+  if (TextIndex && isa<Scope>(*Obj) &&
+      (isa<ScopeCompileUnit>(*Obj) ||
+       (Obj->getParent() && isa<ScopeCompileUnit>(*Obj->getParent()))))
+    TextIndex->add(*Obj);
+
   // Preceding attributes.
   OutputStream << getDWARFAttributesString(
       Obj, CurrentLevel, Settings, LevelNumberIndentSize, TagIndentSize);
@@ -285,7 +487,14 @@ void ScopeTextPrinter::printObjectText(const Object *Obj,
                                   ' ');
 
   // Print the first line of the text.
-  std::stringstream ObjText(Obj->getAsText(Settings));
+  std::string Text(Obj->getAsText(Settings));
+  if (SharedTypes && isa<Scope>(*Obj)) {
+    auto Found = SharedTypes->find(cast<Scope>(Obj));
+    if (Found != SharedTypes->end())
+      Text.append("\n").append(Object::formatAttributeText(
+          "Members printed in \"" + findCompileUnitName(Found->second) + '"'));
+  }
+  std::stringstream ObjText(Text);
   assert(!ObjText.str().empty());
   std::string TextOutputLine;
   std::getline(ObjText, TextOutputLine);
@@ -298,6 +507,17 @@ void ScopeTextPrinter::printObjectText(const Object *Obj,
   }
 }
 
+bool ScopeTextPrinter::canSkipChildren(const Object *Obj) const {
+  if (IgnoreFilters)
+    return false;
+  if (UseNameIndex)
+    return !ObjectsWithFilteredChildren.count(Obj);
+  if (!CanSkipSubtrees || ObjectsWithTreeFilteredChildren.count(Obj))
+    return false;
+  const auto *Scp = dyn_cast<Scope>(Obj);
+  return Scp && !mayContainAny(*Scp, FilteredNames);
+}
+
 void ScopeTextPrinter::printIndentedChildren(const Object *Obj) {
   ++CurrentLevel;
   ++IndentLevel;
@@ -30,34 +30,63 @@
 #ifndef SCOPEVIEW_SCOPETEXTPRINTER_H
 #define SCOPEVIEW_SCOPETEXTPRINTER_H
 
+#include "FilterMatcher.h"
+#include "NameIndex.h"
+#include "Scope.h"
 #include "ScopePrinter.h"
 #include "StringPool.h"
 
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace LibScopeView {
 
+class OutputIndex;
+
 /// \brief A Scope printer that outputs in the text format.
 class ScopeTextPrinter : public ScopePrinter {
 public:
   ScopeTextPrinter(const PrintSettings &PrintingSettings, std::string InputFile,
                    uint8_t IndentSize = 2);
 
+  /// \brief Add each compile unit printed, and each scope printed directly in
+  /// one, to Index. The output must be printed to the stream of Index.
+  void setOutputIndex(OutputIndex *Index) { TextIndex = Index; }
+
 private:
   void initBeforePrint(const Object *Obj) override;
 
   const std::string &getFileExtension() override;
   const std::string &getHeader() override;
 
+  bool printsOffsets() const override;
+  bool hashOutputState(const ScopeCompileUnit &CU, HashBuilder &Hash) override;
+  std::string saveOutputState() override;
+  void restoreOutputState(const std::string &State) override;
+  /// \brief Get the path of the current file, after a marker so that no file
+  /// differs from an empty path, or an empty string if there is none.
+  std::string getCurrentFileState() const;
+
   void printImpl(const Object *Obj, std::ostream &OutputStream) override;
   void printObjectText(const Object *Obj, std::ostream &OutputStream);
   void printIndentedChildren(const Object *Obj);
+  /// \brief Return true if none of the children of Obj can be printed with
+  /// the current filters.
+  bool canSkipChildren(const Object *Obj) const;
+  /// \brief Find the parents of the objects matching the tree filters using
+  /// the name index, instead of walking the tree.
+  void findTreeFilteredParents(const NameIndex &Index);
 
   std::string HeaderText;
   const uint8_t IndentSize;
   size_t CurrentLevel = 0;
   size_t IndentLevel = 1;
   StringPoolRef CurrentFileRef = nullptr;
+  // The current file given by restoreOutputState, which is only known by its
+  // path until an object in it is printed.
+  bool HasRestoredFilePath = false;
+  std::string RestoredFilePath;
 
   // Indent sizes calculated from the tree being printed.
   size_t LineNumberIndentSize = 0;
@@ -66,10 +95,33 @@ private:
   size_t AttributesIndentSize = 0;
   size_t FollowingLineExtraIndent = 0;
 
+  // The compiled --filter and --tree patterns, kept for all the trees printed
+  // so that the results cached for each name are reused.
+  FilterMatcher Filter;
+  FilterMatcher TreeFilter;
+
   // Objects where the children match a tree filter.
   std::unordered_set<const Object *> ObjectsWithTreeFilteredChildren;
   // Set to true when the parent matched a tree filter.
   bool IgnoreFilters = false;
+
+  // Set when the filters are exact names that were found in the name index,
+  // and the objects with a child to print.
+  bool UseNameIndex = false;
+  std::unordered_set<const Object *> ObjectsWithFilteredChildren;
+
+  // The names matching the filters, used to skip scopes with none of them
+  // below. Only done for up to MaxFilteredNames names.
+  static const size_t MaxFilteredNames = 32;
+  bool CanSkipSubtrees = false;
+  std::vector<StringPoolRef> FilteredNames;
+
+  // The types of the tree whose members are printed with another copy.
+  const std::unordered_map<const Scope *, const Scope *> *SharedTypes =
+      nullptr;
+
+  // The index of the output, if one is being written.
+  OutputIndex *TextIndex = nullptr;
 };
 
 } // end namespace LibScopeView
@@ -29,6 +29,7 @@
 
 #include "ScopeYAMLPrinter.h"
 #include "Scope.h"
+#include "ScopeHash.h"
 
 #include <algorithm>
 #include <assert.h>
@@ -71,6 +72,13 @@ const std::string &ScopeYAMLPrinter::getFileExtension() {
 
 const std::string &ScopeYAMLPrinter::getHeader() { return YAMLHeader; }
 
+bool ScopeYAMLPrinter::hashOutputState(const ScopeCompileUnit &,
+                                       HashBuilder &Hash) {
+  Hash.add(static_cast<uint64_t>(IndentSize));
+  Hash.add(static_cast<uint64_t>(IndentLevel));
+  return true;
+}
+
 void ScopeYAMLPrinter::printImpl(const Object *Obj,
                                  std::ostream &OutputStream) {
   // Don't print anything for the scope root, but do visit the children.
@@ -43,6 +43,7 @@ public:
 private:
   const std::string &getFileExtension() override;
   const std::string &getHeader() override;
+  bool hashOutputState(const ScopeCompileUnit &CU, HashBuilder &Hash) override;
   void printImpl(const Object *Obj, std::ostream &OutputStream) override;
 
   std::string YAMLHeader;
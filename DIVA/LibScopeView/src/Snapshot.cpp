@@ -0,0 +1,839 @@
+//===-- Snapshot.cpp --------------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the functions saving a tree into a snapshot file, and
+/// the reader that loads it back.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Snapshot.h"
+#include "Error.h"
+#include "FileUtilities.h"
+#include "Line.h"
+#include "Scope.h"
+#include "ScopeHash.h"
+#include "StringPool.h"
+#include "Symbol.h"
+#include "Type.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+using namespace LibScopeView;
+
+namespace {
+
+const char SnapshotMagic[8] = {'D', 'I', 'V', 'A', 'S', 'N', 'A', 'P'};
+// Changed whenever the layout of the file changes.
+const uint32_t SnapshotVersion = 3;
+
+// The settings that changed how the saved tree was resolved.
+enum SnapshotSettings : uint32_t {
+  ShowVoidBit = 1 << 0,
+  ShareTypesBit = 1 << 1,
+};
+
+// Index written for a missing string or object. Others are written plus one,
+// and the objects outside of the saved subtree follow those in it.
+const uint32_t NoIndex = 0;
+
+/// \brief Thrown when the data loaded is damaged or from another version.
+struct InvalidSnapshot {};
+
+/// \brief A flag of an object, saved as one bit of the object's record.
+template <class T> struct Flag {
+  bool (T::*Get)() const;
+  void (T::*Set)();
+};
+
+const Flag<Object> ObjectFlags[] = {
+    {&Object::getIsGlobalReference, &Object::setIsGlobalReference},
+    {&Object::getInvalidFileName, &Object::setInvalidFileName},
+};
+const uint32_t GlobalReferenceFlag = 1 << 0;
+
+const Flag<Scope> ScopeFlags[] = {
+    {&Scope::getIsBlock, &Scope::setIsBlock},
+    {&Scope::getIsCatchBlock, &Scope::setIsCatchBlock},
+    {&Scope::getIsLexicalBlock, &Scope::setIsLexicalBlock},
+    {&Scope::getIsTryBlock, &Scope::setIsTryBlock},
+    {&Scope::getIsEntryPoint, &Scope::setIsEntryPoint},
+    {&Scope::getIsSubprogram, &Scope::setIsSubprogram},
+    {&Scope::getIsSubroutineType, &Scope::setIsSubroutineType},
+    {&Scope::getIsLabel, &Scope::setIsLabel},
+    {&Scope::getIsTemplate, &Scope::setIsTemplate},
+    {&Scope::getIsClassType, &Scope::setIsClassType},
+    {&Scope::getIsStructType, &Scope::setIsStructType},
+    {&Scope::getIsUnionType, &Scope::setIsUnionType},
+    {&Scope::getHasDiscriminator, &Scope::setHasDiscriminator},
+    {&Scope::getIsCombinedScope, &Scope::setIsCombinedScope},
+};
+
+const Flag<ScopeFunction> FunctionFlags[] = {
+    {&ScopeFunction::getIsStatic, &ScopeFunction::setIsStatic},
+    {&ScopeFunction::getIsDeclaredInline, &ScopeFunction::setIsDeclaredInline},
+    {&ScopeFunction::getIsDeclaration, &ScopeFunction::setIsDeclaration},
+};
+
+const Flag<ScopeEnumeration> EnumerationFlags[] = {
+    {&ScopeEnumeration::getIsClass, &ScopeEnumeration::setIsClass},
+};
+
+const Flag<Symbol> SymbolFlags[] = {
+    {&Symbol::getIsMember, &Symbol::setIsMember},
+    {&Symbol::getIsParameter, &Symbol::setIsParameter},
+    {&Symbol::getIsUnspecifiedParameter, &Symbol::setIsUnspecifiedParameter},
+    {&Symbol::getIsVariable, &Symbol::setIsVariable},
+    {&Symbol::getIsStatic, &Symbol::setIsStatic},
+};
+
+const Flag<Type> TypeFlags[] = {
+    {&Type::getIsBaseType, &Type::setIsBaseType},
+    {&Type::getIsConstType, &Type::setIsConstType},
+    {&Type::getIsImportedDeclaration, &Type::setIsImportedDeclaration},
+    {&Type::getIsImportedModule, &Type::setIsImportedModule},
+    {&Type::getIsInheritance, &Type::setIsInheritance},
+    {&Type::getIsPointerType, &Type::setIsPointerType},
+    {&Type::getIsPointerMemberType, &Type::setIsPointerMemberType},
+    {&Type::getIsReferenceType, &Type::setIsReferenceType},
+    {&Type::getIsRestrictType, &Type::setIsRestrictType},
+    {&Type::getIsRvalueReferenceType, &Type::setIsRvalueReferenceType},
+    {&Type::getIsTemplateType, &Type::setIsTemplateType},
+    {&Type::getIsTemplateValue, &Type::setIsTemplateValue},
+    {&Type::getIsTemplateTemplate, &Type::setIsTemplateTemplate},
+    {&Type::getIsUnspecifiedType, &Type::setIsUnspecifiedType},
+    {&Type::getIsVolatileType, &Type::setIsVolatileType},
+    {&Type::getIncludeInPrint, &Type::setIncludeInPrint},
+};
+
+const Flag<Line> LineFlags[] = {
+    {&Line::getIsLineEndSequence, &Line::setIsLineEndSequence},
+    {&Line::getIsNewBasicBlock, &Line::setIsNewBasicBlock},
+    {&Line::getIsNewStatement, &Line::setIsNewStatement},
+    {&Line::getIsEpilogueBegin, &Line::setIsEpilogueBegin},
+    {&Line::getIsPrologueEnd, &Line::setIsPrologueEnd},
+};
+
+template <class T, size_t N>
+uint32_t getFlags(const T &Obj, const Flag<T> (&Flags)[N]) {
+  static_assert(N <= 32, "Too many flags to save");
+  uint32_t Bits = 0;
+  for (size_t I = 0; I < N; ++I)
+    if ((Obj.*Flags[I].Get)())
+      Bits |= uint32_t(1) << I;
+  return Bits;
+}
+
+template <class T, size_t N>
+void setFlags(T &Obj, const Flag<T> (&Flags)[N], uint32_t Bits) {
+  for (size_t I = 0; I < N; ++I)
+    if (Bits & (uint32_t(1) << I))
+      (Obj.*Flags[I].Set)();
+}
+
+/// \brief Create an object of the given kind, or null for an unknown kind.
+Object *createObject(uint8_t Kind) {
+  switch (Kind) {
+  case Object::SV_Line:
+    return new Line();
+  case Object::SV_Scope:
+    return new Scope();
+  case Object::SV_ScopeAggregate:
+    return new ScopeAggregate();
+  case Object::SV_ScopeAlias:
+    return new ScopeAlias();
+  case Object::SV_ScopeArray:
+    return new ScopeArray();
+  case Object::SV_ScopeCompileUnit:
+    return new ScopeCompileUnit();
+  case Object::SV_ScopeEnumeration:
+    return new ScopeEnumeration();
+  case Object::SV_ScopeFunction:
+    return new ScopeFunction();
+  case Object::SV_ScopeFunctionInlined:
+    return new ScopeFunctionInlined();
+  case Object::SV_ScopeNamespace:
+    return new ScopeNamespace();
+  case Object::SV_ScopeTemplatePack:
+    return new ScopeTemplatePack();
+  case Object::SV_Symbol:
+    return new Symbol();
+  case Object::SV_Type:
+    return new Type();
+  case Object::SV_TypeDefinition:
+    return new TypeDefinition();
+  case Object::SV_TypeEnumerator:
+    return new TypeEnumerator();
+  case Object::SV_TypeImport:
+    return new TypeImport();
+  case Object::SV_TypeTemplateParam:
+    return new TypeTemplateParam();
+  case Object::SV_TypeSubrange:
+    return new TypeSubrange();
+  default:
+    return nullptr;
+  }
+}
+
+/// \brief Writes the snapshot of a tree, or of a compile unit, into a buffer.
+class SnapshotWriter {
+public:
+  /// \brief Write the subtree of Top, with the DIE offsets of its objects
+  /// relative to BaseOffset.
+  SnapshotWriter(const Scope &Top, uint32_t SettingsBits,
+                 Dwarf_Off BaseOffset);
+
+  const std::string &getBuffer() const { return Buffer; }
+
+private:
+  template <class T> void write(T Value) {
+    Buffer.append(reinterpret_cast<const char *>(&Value), sizeof(Value));
+  }
+
+  void addObjects(const Object &Obj);
+  uint32_t addString(const std::string &Str);
+  uint32_t getIndex(const Object *Obj);
+
+  void writeObject(const Object &Obj);
+  void writeExtents(const ScopeExtents &Extents);
+
+  const Scope &Top;
+  Dwarf_Off BaseOffset;
+  std::string Buffer;
+  std::vector<const std::string *> Strings;
+  std::unordered_map<const std::string *, uint32_t> StringIndexes;
+  std::vector<const Object *> Objects;
+  std::unordered_map<const Object *, uint32_t> ObjectIndexes;
+  // The DIE offsets of the objects outside of the subtree referred to.
+  std::vector<Dwarf_Off> ExternalOffsets;
+  std::unordered_map<const Object *, uint32_t> ExternalIndexes;
+};
+
+SnapshotWriter::SnapshotWriter(const Scope &Top, uint32_t SettingsBits,
+                               Dwarf_Off BaseOffset)
+    : Top(Top), BaseOffset(BaseOffset) {
+  // Number the objects first, as they refer to objects later in the tree.
+  addObjects(Top);
+
+  std::string ObjectRecords;
+  std::swap(Buffer, ObjectRecords);
+  write(static_cast<uint32_t>(Objects.size()));
+  for (const Object *Obj : Objects)
+    writeObject(*Obj);
+  const auto *Root = dyn_cast<ScopeRoot>(&Top);
+  write(static_cast<uint32_t>(Root ? Root->getSharedTypes().size() : 0));
+  if (Root) {
+    for (const auto &Shared : Root->getSharedTypes()) {
+      write(getIndex(Shared.first));
+      write(getIndex(Shared.second));
+    }
+  }
+  write(static_cast<uint32_t>(ExternalOffsets.size()));
+  for (Dwarf_Off Offset : ExternalOffsets)
+    write(static_cast<uint64_t>(Offset));
+  std::swap(Buffer, ObjectRecords);
+
+  // The strings were gathered while writing the objects.
+  Buffer.append(SnapshotMagic, sizeof(SnapshotMagic));
+  write(SnapshotVersion);
+  write(SettingsBits);
+  write(static_cast<uint32_t>(Strings.size()));
+  for (const std::string *Str : Strings) {
+    write(static_cast<uint32_t>(Str->size()));
+    Buffer.append(*Str);
+  }
+  Buffer.append(ObjectRecords);
+}
+
+void SnapshotWriter::addObjects(const Object &Obj) {
+  ObjectIndexes.emplace(&Obj, static_cast<uint32_t>(Objects.size()));
+  Objects.push_back(&Obj);
+  if (auto *Scp = dyn_cast<Scope>(&Obj)) {
+    for (const Line *Ln : Scp->getLines())
+      addObjects(*Ln);
+    for (const Object *Child : Scp->getChildren())
+      addObjects(*Child);
+  }
+}
+
+uint32_t SnapshotWriter::addString(const std::string &Str) {
+  if (Str.empty())
+    return NoIndex;
+  // The strings are in a pool, so each is found by its address.
+  auto Inserted = StringIndexes.emplace(
+      &Str, static_cast<uint32_t>(Strings.size() + 1));
+  if (Inserted.second)
+    Strings.push_back(&Str);
+  return Inserted.first->second;
+}
+
+uint32_t SnapshotWriter::getIndex(const Object *Obj) {
+  if (!Obj)
+    return NoIndex;
+  auto Found = ObjectIndexes.find(Obj);
+  if (Found != ObjectIndexes.end())
+    return Found->second + 1;
+
+  // Only a compile unit refers to objects outside of it, in other compile
+  // units, which are found again by their DIE offsets.
+  assert(!isa<ScopeRoot>(Top) && "Object refers outside of the tree");
+  auto Inserted = ExternalIndexes.emplace(
+      Obj, static_cast<uint32_t>(Objects.size() + ExternalOffsets.size() + 1));
+  if (Inserted.second)
+    ExternalOffsets.push_back(Obj->getDieOffset());
+  return Inserted.first->second;
+}
+
+void SnapshotWriter::writeObject(const Object &Obj) {
+  write(static_cast<uint8_t>(Obj.getKind()));
+  write(&Obj == &Top ? NoIndex : getIndex(Obj.getParent()));
+  // The objects of a compile unit are marked as global references by the
+  // other compile units, which are not saved with it.
+  uint32_t Flags = getFlags(Obj, ObjectFlags);
+  if (isa<ScopeCompileUnit>(Top))
+    Flags &= ~GlobalReferenceFlag;
+  write(Flags);
+  write(Obj.getLineNumber());
+  // The DIE offset of a line is its address.
+  write(static_cast<uint64_t>(
+      isa<Line>(Obj) ? Obj.getDieOffset() : Obj.getDieOffset() - BaseOffset));
+  write(static_cast<uint16_t>(Obj.getDieTag()));
+  write(addString(Obj.getName()));
+  write(addString(Obj.getQualifiedName()));
+  write(addString(Obj.getFilePath()));
+  write(getIndex(Obj.getType()));
+
+  if (auto *Scp = dyn_cast<Scope>(&Obj)) {
+    write(getFlags(*Scp, ScopeFlags));
+    write(getIndex(Scp->getReference()));
+    if (auto *Function = dyn_cast<ScopeFunction>(Scp))
+      write(getFlags(*Function, FunctionFlags));
+    if (auto *Enumeration = dyn_cast<ScopeEnumeration>(Scp))
+      write(getFlags(*Enumeration, EnumerationFlags));
+    if (auto *CompileUnit = dyn_cast<ScopeCompileUnit>(Scp))
+      writeExtents(CompileUnit->getExtents());
+    if (auto *Root = dyn_cast<ScopeRoot>(Scp))
+      writeExtents(Root->getExtents());
+  } else if (auto *Sym = dyn_cast<Symbol>(&Obj)) {
+    write(getFlags(*Sym, SymbolFlags));
+    write(getIndex(Sym->getReference()));
+    write(static_cast<uint8_t>(Sym->getIsMember() ? Sym->getAccessSpecifier()
+                                                  : AccessSpecifier()));
+  } else if (auto *Ty = dyn_cast<Type>(&Obj)) {
+    write(getFlags(*Ty, TypeFlags));
+    write(static_cast<uint32_t>(Ty->getByteSize()));
+    write(addString(Ty->getValue()));
+    auto *Import = dyn_cast<TypeImport>(Ty);
+    write(static_cast<uint8_t>(Import && Import->getIsInheritance()
+                                   ? Import->getInheritanceAccess()
+                                   : AccessSpecifier()));
+  } else if (auto *Ln = dyn_cast<Line>(&Obj)) {
+    write(getFlags(*Ln, LineFlags));
+    write(static_cast<uint16_t>(Ln->getDiscriminator()));
+  }
+}
+
+void SnapshotWriter::writeExtents(const ScopeExtents &Extents) {
+  write(static_cast<uint64_t>(Extents.getMaxLineNumber()));
+  write(static_cast<uint64_t>(Extents.getMaxLevel()));
+  write(static_cast<uint64_t>(Extents.getObjectCount()));
+  write(static_cast<uint8_t>(Extents.getIsRecorded()));
+  write(static_cast<uint32_t>(Extents.getDwarfTags().size()));
+  for (Dwarf_Half Tag : Extents.getDwarfTags())
+    write(static_cast<uint16_t>(Tag));
+}
+
+/// \brief Reads the snapshot of a tree, or of a compile unit, from a buffer.
+/// Throws InvalidSnapshot if the buffer is damaged or from another version.
+class SnapshotLoader {
+public:
+  /// \brief Read from Data, adding BaseOffset to the DIE offsets of the
+  /// objects. AddReference is given the references to objects outside of the
+  /// subtree read, if they are expected.
+  SnapshotLoader(const char *Data, size_t Size, Dwarf_Off BaseOffset,
+                 const ExternalReferenceCallback *AddReference)
+      : Data(Data), Size(Size), BaseOffset(BaseOffset),
+        AddReference(AddReference) {}
+
+  /// \brief Read a subtree whose top object is of the kind TopKind.
+  std::unique_ptr<Scope> load(Object::ObjectKind TopKind,
+                              uint32_t &SettingsBits);
+
+private:
+  template <class T> T read() {
+    if (Size - Pos < sizeof(T))
+      invalid();
+    T Value;
+    std::memcpy(&Value, Data + Pos, sizeof(T));
+    Pos += sizeof(T);
+    return Value;
+  }
+
+  [[noreturn]] void invalid() const { throw InvalidSnapshot(); }
+
+  StringPoolRef readString();
+  void readObject(Object &Obj);
+  void readExtents(ScopeExtents &Extents);
+  Object *getObject(uint32_t Index) const;
+  void checkReference(const Object &Obj, bool IsType, uint32_t Index) const;
+  void setReference(Object &Obj, bool IsType, uint32_t Index);
+
+  const char *Data;
+  size_t Size;
+  Dwarf_Off BaseOffset;
+  const ExternalReferenceCallback *AddReference;
+  size_t Pos = 0;
+  std::vector<StringPoolRef> Strings;
+  std::vector<Object *> Objects;
+
+  // The objects referred to may be later in the tree, so they are set once
+  // all the objects are created.
+  struct References {
+    uint32_t Type;
+    uint32_t Reference;
+  };
+  std::vector<References> ObjectReferences;
+  std::vector<Dwarf_Off> ExternalOffsets;
+};
+
+std::unique_ptr<Scope> SnapshotLoader::load(Object::ObjectKind TopKind,
+                                            uint32_t &SettingsBits) {
+  if (Size < sizeof(SnapshotMagic) ||
+      !std::equal(std::begin(SnapshotMagic), std::end(SnapshotMagic), Data))
+    invalid();
+  Pos = sizeof(SnapshotMagic);
+  if (read<uint32_t>() != SnapshotVersion)
+    invalid();
+  SettingsBits = read<uint32_t>();
+
+  uint32_t StringCount = read<uint32_t>();
+  StringPool &Pool = getGlobalStringPool();
+  Strings.reserve(std::min<size_t>(StringCount, Size));
+  for (uint32_t I = 0; I < StringCount; ++I) {
+    uint32_t StringSize = read<uint32_t>();
+    if (Size - Pos < StringSize)
+      invalid();
+    Strings.push_back(Pool.get(std::string(Data + Pos, StringSize)));
+    Pos += StringSize;
+  }
+
+  // The first object is the top of the subtree, and every other object
+  // follows its parent, so that each object is owned by the top once created.
+  uint32_t ObjectCount = read<uint32_t>();
+  if (ObjectCount == 0 || read<uint8_t>() != TopKind ||
+      read<uint32_t>() != NoIndex)
+    invalid();
+  // A root is only ever the top object.
+  std::unique_ptr<Scope> Top;
+  if (TopKind == Object::SV_ScopeRoot)
+    Top = std::make_unique<ScopeRoot>();
+  else
+    Top.reset(cast<Scope>(createObject(TopKind)));
+  Objects.reserve(std::min<size_t>(ObjectCount, Size));
+  ObjectReferences.reserve(Objects.capacity());
+  Objects.push_back(Top.get());
+  readObject(*Top);
+  for (uint32_t I = 1; I < ObjectCount; ++I) {
+    std::unique_ptr<Object> Obj(createObject(read<uint8_t>()));
+    auto *Parent = dyn_cast<Scope>(getObject(read<uint32_t>()));
+    if (!Obj || !Parent)
+      invalid();
+    Parent->addChild(Obj.get());
+    Objects.push_back(Obj.release());
+    readObject(*Objects.back());
+  }
+
+  uint32_t SharedCount = read<uint32_t>();
+  auto *Root = dyn_cast<ScopeRoot>(Top.get());
+  if (SharedCount && !Root)
+    invalid();
+  for (uint32_t I = 0; I < SharedCount; ++I) {
+    auto *Copy = dyn_cast<Scope>(getObject(read<uint32_t>()));
+    auto *First = dyn_cast<Scope>(getObject(read<uint32_t>()));
+    if (!Copy || !First)
+      invalid();
+    Root->getSharedTypes().emplace(Copy, First);
+  }
+
+  uint32_t ExternalCount = read<uint32_t>();
+  if (ExternalCount && !AddReference)
+    invalid();
+  ExternalOffsets.reserve(std::min<size_t>(ExternalCount, Size));
+  for (uint32_t I = 0; I < ExternalCount; ++I)
+    ExternalOffsets.push_back(read<uint64_t>());
+  if (Pos != Size)
+    invalid();
+
+  // Check every reference before setting any, so that no reference to an
+  // object outside of the subtree is given out from a subtree that is then
+  // freed.
+  for (size_t I = 0; I < Objects.size(); ++I) {
+    checkReference(*Objects[I], /*IsType*/ true, ObjectReferences[I].Type);
+    checkReference(*Objects[I], /*IsType*/ false,
+                   ObjectReferences[I].Reference);
+  }
+  for (size_t I = 0; I < Objects.size(); ++I) {
+    setReference(*Objects[I], /*IsType*/ true, ObjectReferences[I].Type);
+    setReference(*Objects[I], /*IsType*/ false,
+                 ObjectReferences[I].Reference);
+  }
+
+  return Top;
+}
+
+StringPoolRef SnapshotLoader::readString() {
+  uint32_t Index = read<uint32_t>();
+  if (Index > Strings.size())
+    invalid();
+  return Index == NoIndex ? nullptr : Strings[Index - 1];
+}
+
+void SnapshotLoader::readObject(Object &Obj) {
+  setFlags(Obj, ObjectFlags, read<uint32_t>());
+  Obj.setLineNumber(read<uint64_t>());
+  uint64_t Offset = read<uint64_t>();
+  Obj.setDieOffset(isa<Line>(Obj) ? Offset : Offset + BaseOffset);
+  Obj.setDieTag(read<uint16_t>());
+  if (StringPoolRef Name = readString())
+    Obj.setName(Name);
+  if (StringPoolRef QualifiedName = readString())
+    Obj.setQualifiedName(*QualifiedName);
+  if (StringPoolRef FilePath = readString())
+    Obj.setFilePath(FilePath);
+  References Refs = {read<uint32_t>(), NoIndex};
+
+  if (auto *Scp = dyn_cast<Scope>(&Obj)) {
+    setFlags(*Scp, ScopeFlags, read<uint32_t>());
+    Refs.Reference = read<uint32_t>();
+    if (auto *Function = dyn_cast<ScopeFunction>(Scp))
+      setFlags(*Function, FunctionFlags, read<uint32_t>());
+    if (auto *Enumeration = dyn_cast<ScopeEnumeration>(Scp))
+      setFlags(*Enumeration, EnumerationFlags, read<uint32_t>());
+    if (auto *CompileUnit = dyn_cast<ScopeCompileUnit>(Scp))
+      readExtents(CompileUnit->getExtents());
+    if (auto *Root = dyn_cast<ScopeRoot>(Scp))
+      readExtents(Root->getExtents());
+  } else if (auto *Sym = dyn_cast<Symbol>(&Obj)) {
+    setFlags(*Sym, SymbolFlags, read<uint32_t>());
+    Refs.Reference = read<uint32_t>();
+    auto Access = static_cast<AccessSpecifier>(read<uint8_t>());
+    if (Sym->getIsMember())
+      Sym->setAccessSpecifier(Access);
+  } else if (auto *Ty = dyn_cast<Type>(&Obj)) {
+    setFlags(*Ty, TypeFlags, read<uint32_t>());
+    Ty->setByteSize(read<uint32_t>());
+    if (StringPoolRef Value = readString())
+      Ty->setValue(*Value);
+    auto Access = static_cast<AccessSpecifier>(read<uint8_t>());
+    auto *Import = dyn_cast<TypeImport>(Ty);
+    if (Import && Import->getIsInheritance())
+      Import->setInheritanceAccess(Access);
+  } else if (auto *Ln = dyn_cast<Line>(&Obj)) {
+    setFlags(*Ln, LineFlags, read<uint32_t>());
+    Ln->setDiscriminator(read<uint16_t>());
+  }
+  ObjectReferences.push_back(Refs);
+}
+
+void SnapshotLoader::readExtents(ScopeExtents &Extents) {
+  Extents.updateLineNumber(read<uint64_t>());
+  Extents.updateLevel(read<uint64_t>());
+  Extents.addObjectCount(read<uint64_t>());
+  if (read<uint8_t>())
+    Extents.setIsRecorded();
+  uint32_t TagCount = read<uint32_t>();
+  for (uint32_t I = 0; I < TagCount; ++I)
+    Extents.addDwarfTag(read<uint16_t>());
+}
+
+Object *SnapshotLoader::getObject(uint32_t Index) const {
+  if (Index > Objects.size())
+    invalid();
+  return Index == NoIndex ? nullptr : Objects[Index - 1];
+}
+
+void SnapshotLoader::checkReference(const Object &Obj, bool IsType,
+                                    uint32_t Index) const {
+  if (Index > Objects.size()) {
+    if (Index - Objects.size() - 1 >= ExternalOffsets.size())
+      invalid();
+    return;
+  }
+
+  Object *Reference = getObject(Index);
+  if (IsType || !Reference)
+    return;
+  if ((isa<Scope>(Obj) && !isa<Scope>(*Reference)) ||
+      (isa<Symbol>(Obj) && !isa<Symbol>(*Reference)))
+    invalid();
+}
+
+void SnapshotLoader::setReference(Object &Obj, bool IsType, uint32_t Index) {
+  if (Index > Objects.size()) {
+    (*AddReference)(Obj, IsType, ExternalOffsets[Index - Objects.size() - 1]);
+    return;
+  }
+
+  Object *Reference = getObject(Index);
+  if (IsType)
+    Obj.setType(Reference);
+  else if (!Reference)
+    return;
+  else if (auto *Scp = dyn_cast<Scope>(&Obj))
+    Scp->setReference(cast<Scope>(Reference));
+  else if (auto *Sym = dyn_cast<Symbol>(&Obj))
+    Sym->setReference(cast<Symbol>(Reference));
+}
+
+} // namespace
+
+void LibScopeView::saveSnapshot(const ScopeRoot &Root,
+                                const PrintSettings &Settings,
+                                const std::string &Path) {
+  uint32_t SettingsBits = 0;
+  if (Settings.ShowVoid)
+    SettingsBits |= ShowVoidBit;
+  if (Settings.ShareTypes)
+    SettingsBits |= ShareTypesBit;
+  SnapshotWriter Writer(Root, SettingsBits, /*BaseOffset*/ 0);
+  std::string UnifiedPath = unifyFilePath(Path);
+  recursiveMakeDir(getDirectoryName(UnifiedPath));
+  std::ofstream File(nativeFilePath(UnifiedPath),
+                     std::ios::binary | std::ios::trunc);
+  const std::string &Buffer = Writer.getBuffer();
+  if (!File || !File.write(Buffer.data(), Buffer.size()) || !File.flush())
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_FILEIO_OPEN_FAILURE, Path);
+}
+
+std::string LibScopeView::saveCompileUnit(const ScopeCompileUnit &CU,
+                                          Dwarf_Off BaseOffset) {
+  return SnapshotWriter(CU, /*SettingsBits*/ 0, BaseOffset).getBuffer();
+}
+
+namespace {
+
+/// \brief Hashes a compile unit for the output cache, walking its objects as
+/// SnapshotWriter does but adding each value to a hash rather than a buffer.
+class CompileUnitHasher {
+public:
+  explicit CompileUnitHasher(const ScopeCompileUnit &CU);
+
+  const ScopeCompileUnit::OutputHashes &getHashes() const { return Hashes; }
+
+private:
+  void addObjects(const Object &Obj);
+  uint64_t getIndex(const Object *Obj);
+  void hashObject(const Object &Obj);
+  void hashExternalObject(const Object &Obj);
+
+  const ScopeCompileUnit &CU;
+  HashBuilder Content;
+  HashBuilder Offsets;
+  std::vector<const Object *> Objects;
+  std::unordered_map<const Object *, uint64_t> ObjectIndexes;
+  // The first line address, which the others are hashed relative to.
+  const Line *FirstLine = nullptr;
+  ScopeCompileUnit::OutputHashes Hashes;
+};
+
+CompileUnitHasher::CompileUnitHasher(const ScopeCompileUnit &CU) : CU(CU) {
+  addObjects(CU);
+  Content.add(static_cast<uint64_t>(Objects.size()));
+  for (const Object *Obj : Objects)
+    hashObject(*Obj);
+
+  Offsets.add(CU.getDieOffset());
+  Offsets.add(FirstLine ? FirstLine->getDieOffset() : 0);
+  Hashes.Content = Content.get();
+  Hashes.Offsets = Offsets.get();
+  Hashes.IsSet = true;
+}
+
+void CompileUnitHasher::addObjects(const Object &Obj) {
+  ObjectIndexes.emplace(&Obj, Objects.size() + 1);
+  Objects.push_back(&Obj);
+  if (auto *Scp = dyn_cast<Scope>(&Obj)) {
+    for (const Line *Ln : Scp->getLines()) {
+      if (!FirstLine)
+        FirstLine = Ln;
+      addObjects(*Ln);
+    }
+    for (const Object *Child : Scp->getChildren())
+      addObjects(*Child);
+  }
+}
+
+uint64_t CompileUnitHasher::getIndex(const Object *Obj) {
+  if (!Obj)
+    return NoIndex;
+  auto Inserted = ObjectIndexes.emplace(Obj, ObjectIndexes.size() + 1);
+  // An object in another compile unit is hashed as it is printed, where it
+  // is first referred to.
+  if (Inserted.second)
+    hashExternalObject(*Obj);
+  return Inserted.first->second;
+}
+
+void CompileUnitHasher::hashObject(const Object &Obj) {
+  Content.add(static_cast<uint64_t>(Obj.getKind()));
+  Content.add(&Obj == &CU ? NoIndex : getIndex(Obj.getParent()));
+  Content.add(getFlags(Obj, ObjectFlags));
+  Content.add(Obj.getLineNumber());
+  // Only the order of the DIE offsets and line addresses within the compile
+  // unit matters unless they are printed, so they are hashed relative to
+  // those of the compile unit, which are hashed in Offsets.
+  Content.add(isa<Line>(Obj) ? Obj.getDieOffset() - FirstLine->getDieOffset()
+                             : Obj.getDieOffset() - CU.getDieOffset());
+  Content.add(Obj.getDieTag());
+  Content.add(Obj.getName());
+  Content.add(Obj.getQualifiedName());
+  Content.add(Obj.getFilePath());
+  Content.add(getIndex(Obj.getType()));
+
+  if (auto *Scp = dyn_cast<Scope>(&Obj)) {
+    Content.add(getFlags(*Scp, ScopeFlags));
+    Content.add(getIndex(Scp->getReference()));
+    if (auto *Function = dyn_cast<ScopeFunction>(Scp))
+      Content.add(getFlags(*Function, FunctionFlags));
+    if (auto *Enumeration = dyn_cast<ScopeEnumeration>(Scp))
+      Content.add(getFlags(*Enumeration, EnumerationFlags));
+    if (auto *CompileUnit = dyn_cast<ScopeCompileUnit>(Scp)) {
+      const ScopeExtents &Extents = CompileUnit->getExtents();
+      Content.add(Extents.getMaxLineNumber());
+      Content.add(Extents.getMaxLevel());
+      Content.add(Extents.getIsRecorded());
+      for (Dwarf_Half Tag : Extents.getDwarfTags())
+        Content.add(Tag);
+    }
+  } else if (auto *Sym = dyn_cast<Symbol>(&Obj)) {
+    Content.add(getFlags(*Sym, SymbolFlags));
+    Content.add(getIndex(Sym->getReference()));
+    Content.add(static_cast<uint64_t>(
+        Sym->getIsMember() ? Sym->getAccessSpecifier() : AccessSpecifier()));
+  } else if (auto *Ty = dyn_cast<Type>(&Obj)) {
+    Content.add(getFlags(*Ty, TypeFlags));
+    Content.add(Ty->getByteSize());
+    Content.add(Ty->getValue());
+    auto *Import = dyn_cast<TypeImport>(Ty);
+    Content.add(static_cast<uint64_t>(Import && Import->getIsInheritance()
+                                          ? Import->getInheritanceAccess()
+                                          : AccessSpecifier()));
+  } else if (auto *Ln = dyn_cast<Line>(&Obj)) {
+    Content.add(getFlags(*Ln, LineFlags));
+    Content.add(Ln->getDiscriminator());
+  }
+}
+
+void CompileUnitHasher::hashExternalObject(const Object &Obj) {
+  Content.add(static_cast<uint64_t>(Obj.getKind()));
+  Content.add(Obj.getName());
+  Content.add(Obj.getQualifiedName());
+  Content.add(Obj.getInvalidFileName());
+  Content.add(Obj.getFilePath());
+  Content.add(Obj.getLineNumber());
+  const Object *Ty = Obj.getType();
+  Content.add(Ty ? Ty->getQualifiedName() + Ty->getName() : std::string());
+  Offsets.add(Obj.getDieOffset());
+}
+
+} // end anonymous namespace
+
+const ScopeCompileUnit::OutputHashes &
+LibScopeView::hashCompileUnit(const ScopeCompileUnit &CU) {
+  ScopeCompileUnit::OutputHashes &Hashes = CU.getOutputHashes();
+  if (!Hashes.IsSet)
+    Hashes = CompileUnitHasher(CU).getHashes();
+  return Hashes;
+}
+
+std::unique_ptr<ScopeCompileUnit>
+LibScopeView::loadCompileUnit(const char *Data, size_t Size,
+                              Dwarf_Off BaseOffset,
+                              const ExternalReferenceCallback &AddReference) {
+  uint32_t SettingsBits;
+  try {
+    SnapshotLoader Loader(Data, Size, BaseOffset, &AddReference);
+    return std::unique_ptr<ScopeCompileUnit>(cast<ScopeCompileUnit>(
+        Loader.load(Object::SV_ScopeCompileUnit, SettingsBits).release()));
+  } catch (const InvalidSnapshot &) {
+    return nullptr;
+  }
+}
+
+bool LibScopeView::isFileFormatSnapshot(const std::string &FileLocation) {
+  std::ifstream File(nativeFilePath(FileLocation), std::ios::binary);
+  char Magic[sizeof(SnapshotMagic)];
+  if (!File.read(Magic, sizeof(Magic)))
+    return false;
+  return std::equal(std::begin(Magic), std::end(Magic),
+                    std::begin(SnapshotMagic));
+}
+
+std::unique_ptr<ScopeRoot>
+SnapshotReader::createScopes(const std::string &FileName) {
+  // The whole file is read at once and the objects created in one pass.
+  std::ifstream File(nativeFilePath(FileName),
+                     std::ios::binary | std::ios::ate);
+  if (!File)
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_FILE_NOT_FOUND,
+                              FileName);
+  std::vector<char> Buffer(static_cast<size_t>(File.tellg()));
+  File.seekg(0);
+  if (!File.read(Buffer.data(), Buffer.size()))
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_SNAPSHOT,
+                              FileName);
+
+  uint32_t SettingsBits = 0;
+  std::unique_ptr<ScopeRoot> Root;
+  try {
+    SnapshotLoader Loader(Buffer.data(), Buffer.size(), /*BaseOffset*/ 0,
+                          /*AddReference*/ nullptr);
+    Root.reset(cast<ScopeRoot>(
+        Loader.load(Object::SV_ScopeRoot, SettingsBits).release()));
+  } catch (const InvalidSnapshot &) {
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_SNAPSHOT,
+                              FileName);
+  }
+  SnapshotFile = FileName;
+  SavedShowVoid = SettingsBits & ShowVoidBit;
+  SavedShareTypes = SettingsBits & ShareTypesBit;
+  return Root;
+}
+
+void SnapshotReader::resolveScopes(ScopeRoot *,
+                                   const PrintSettings &Settings) {
+  if (Settings.ShowVoid != SavedShowVoid)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_SNAPSHOT_SETTINGS, SnapshotFile,
+        SavedShowVoid ? "--show-void" : "--no-show-void");
+  if (Settings.ShareTypes != SavedShareTypes)
+    LibScopeError::fatalError(
+        LibScopeError::ErrorCode::ERR_SNAPSHOT_SETTINGS, SnapshotFile,
+        SavedShareTypes ? "--share-types" : "--no-share-types");
+}
@@ -0,0 +1,107 @@
+//===-- Snapshot.h ----------------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the functions saving a tree into a snapshot file, and
+/// the reader that loads it back.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_SNAPSHOT_H
+#define SCOPEVIEW_SNAPSHOT_H
+
+#include "Reader.h"
+
+#include <functional>
+#include <string>
+
+namespace LibScopeView {
+
+/// \brief Save a tree read with Settings into the snapshot file at Path.
+///
+/// A snapshot holds the objects of the tree once their names and references
+/// are resolved, so that loading it skips reading the DWARF. The file starts
+/// with a magic string and a version, followed by a table of the strings and
+/// a table of the objects in tree order that refer to each other by index.
+void saveSnapshot(const ScopeRoot &Root, const PrintSettings &Settings,
+                  const std::string &Path);
+
+/// \brief Save a compile unit read from DWARF into a buffer, for a cache of
+/// the compile units that are the same in several builds of a program.
+///
+/// The DIE offsets of its objects are saved relative to BaseOffset, the
+/// offset of the compile unit, and its references to objects in other
+/// compile units as the DIE offsets of those objects. Whether its objects are
+/// referred to from other compile units is not saved.
+std::string saveCompileUnit(const ScopeCompileUnit &CU,
+                            Dwarf_Off BaseOffset);
+
+/// \brief Hash a resolved compile unit, together with the names, source
+/// lines and types of the objects in other compile units it refers to, for a
+/// cache of the output printed for it.
+///
+/// The DIE offsets and line addresses of its objects are hashed in Content
+/// relative to those of the compile unit, so that the hash does not change
+/// when an earlier compile unit grows. Those of the compile unit and of the
+/// objects in other compile units are hashed in Offsets, for the outputs that
+/// print them. The hashes are kept with the compile unit once computed.
+const ScopeCompileUnit::OutputHashes &
+hashCompileUnit(const ScopeCompileUnit &CU);
+
+/// \brief Callback given each reference from a loaded compile unit to an
+/// object in another compile unit, by the DIE offset of that object. IsType
+/// is true for the type of Obj, and false for its reference.
+using ExternalReferenceCallback =
+    std::function<void(Object &Obj, bool IsType, Dwarf_Off Offset)>;
+
+/// \brief Load a compile unit saved by saveCompileUnit, whose offset is now
+/// BaseOffset. Returns null if Data is damaged or from another version.
+std::unique_ptr<ScopeCompileUnit>
+loadCompileUnit(const char *Data, size_t Size, Dwarf_Off BaseOffset,
+                const ExternalReferenceCallback &AddReference);
+
+/// \brief Return true if the file is a snapshot.
+bool isFileFormatSnapshot(const std::string &FileLocation);
+
+/// \brief Reader of the trees saved by saveSnapshot.
+class SnapshotReader : public Reader {
+public:
+  SnapshotReader() = default;
+  ~SnapshotReader() override = default;
+
+private:
+  std::unique_ptr<ScopeRoot> createScopes(const std::string &FileName) override;
+
+  /// \brief The saved tree is already resolved. It can only be printed with
+  /// the settings that changed how it was resolved.
+  void resolveScopes(ScopeRoot *Root, const PrintSettings &Settings) override;
+
+  std::string SnapshotFile;
+  bool SavedShowVoid = false;
+  bool SavedShareTypes = false;
+};
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_SNAPSHOT_H
@@ -38,8 +38,16 @@ using namespace LibScopeView;
 
 namespace {
 StringPool GlobalStringPool;
-}
+thread_local StringPool *CurrentStringPool = &GlobalStringPool;
+} // namespace
 
 StringPool &LibScopeView::getGlobalStringPool() {
-  return GlobalStringPool;
+  return *CurrentStringPool;
+}
+
+ScopedStringPool::ScopedStringPool(StringPool &Pool)
+    : PreviousPool(CurrentStringPool) {
+  CurrentStringPool = &Pool;
 }
+
+ScopedStringPool::~ScopedStringPool() { CurrentStringPool = PreviousPool; }
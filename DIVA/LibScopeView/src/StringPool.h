@@ -49,8 +49,24 @@ private:
   std::unordered_set<std::string> Pool;
 };
 
+/// \brief Get the pool that the current thread adds strings to. This is a pool
+/// shared by all threads, unless a ScopedStringPool is in use.
 StringPool &getGlobalStringPool();
 
+/// \brief Makes the current thread add strings to another pool while this is
+/// in scope, so that threads reading separate trees do not share a pool.
+class ScopedStringPool {
+public:
+  explicit ScopedStringPool(StringPool &Pool);
+  ~ScopedStringPool();
+
+  ScopedStringPool(const ScopedStringPool &) = delete;
+  ScopedStringPool &operator=(const ScopedStringPool &) = delete;
+
+private:
+  StringPool *PreviousPool;
+};
+
 } // namespace LibScopeView
 
 #endif // STRINGPOOL_H_
@@ -0,0 +1,157 @@
+//===-- LibScopeView/SummaryEstimate.cpp ------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation for the SummaryEstimate class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "SummaryEstimate.h"
+#include "SummaryTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <sstream>
+
+using namespace LibScopeView;
+
+std::vector<unsigned>
+LibScopeView::drawSampleParts(const std::vector<uint64_t> &PartSizes,
+                              unsigned SampleSize, uint64_t Seed) {
+  std::vector<uint64_t> SizeEnds;
+  uint64_t TotalSize = 0;
+  for (uint64_t Size : PartSizes)
+    SizeEnds.push_back(TotalSize += Size);
+
+  std::vector<unsigned> Draws(PartSizes.size(), 0);
+  if (!TotalSize)
+    return Draws;
+
+  // The distributions of <random> differ between the standard libraries, but
+  // the output of the engine does not. The bias of the modulo is negligible
+  // for the size of a file.
+  std::mt19937_64 Engine(Seed);
+  for (unsigned Draw = 0; Draw < SampleSize; ++Draw) {
+    uint64_t Byte = Engine() % TotalSize;
+    ++Draws[std::upper_bound(SizeEnds.begin(), SizeEnds.end(), Byte) -
+            SizeEnds.begin()];
+  }
+  return Draws;
+}
+
+void SummaryEstimate::Sums::add(double PartFound, double PartPrinted,
+                                unsigned Draws) {
+  Found += Draws * PartFound;
+  FoundSquares += Draws * PartFound * PartFound;
+  Printed += Draws * PartPrinted;
+  PrintedSquares += Draws * PartPrinted * PartPrinted;
+}
+
+SummaryEstimate::SummaryEstimate(const std::vector<uint64_t> &Sizes)
+    : PartSizes(Sizes), TotalSize(0), SampleDraws(0), SampleParts(0),
+      SampleSize(0) {
+  for (uint64_t Size : PartSizes)
+    TotalSize += Size;
+}
+
+void SummaryEstimate::addPart(size_t Index, unsigned Draws,
+                              const SummaryTable &Part) {
+  assert(Index < PartSizes.size() && PartSizes[Index]);
+  if (!Draws)
+    return;
+
+  // Each draw of a part drawn with a chance of Size / TotalSize estimates the
+  // amount in the whole file as its own amount scaled up by TotalSize / Size.
+  double Scale = double(TotalSize) / double(PartSizes[Index]);
+  uint64_t PartFound = 0;
+  uint64_t PartPrinted = 0;
+  for (const std::string &Label : Part.getLabels()) {
+    uint32_t Found = Part.getFound(Label);
+    uint32_t Printed = Part.getPrinted(Label);
+    Rows[Label].add(Found * Scale, Printed * Scale, Draws);
+    PartFound += Found;
+    PartPrinted += Printed;
+  }
+  Totals.add(PartFound * Scale, PartPrinted * Scale, Draws);
+
+  SampleDraws += Draws;
+  ++SampleParts;
+  SampleSize += PartSizes[Index];
+}
+
+void SummaryEstimate::printSummaryEstimate(std::ostream &Out) const {
+  const uint32_t NumberOfColumns = 4;
+  const uint32_t DividerLength = LabelWidth + ColumnWidth * NumberOfColumns;
+
+  const std::string Indent(IndentWidth, ' ');
+  const std::string Divider(DividerLength, '-');
+
+  // The mean of the draws estimates the amount, and the variance of the draws
+  // its standard error, giving the interval of 1.96 standard errors either
+  // side of it.
+  auto printEstimate = [&](double Sum, double Squares) {
+    double N = SampleDraws;
+    double Mean = N ? Sum / N : 0;
+    double Variance = N > 1 ? (Squares - N * Mean * Mean) / (N * (N - 1)) : 0;
+    double Interval = 1.96 * std::sqrt(std::max(Variance, 0.0));
+    Out << std::setw(ColumnWidth) << std::llround(Mean)
+        << std::setw(ColumnWidth) << std::llround(Interval);
+  };
+  auto printRow = [&](const std::string &Label, const Sums &Row) {
+    Out << Indent << std::left << std::setw(LabelWidth) << Label << std::right;
+    printEstimate(Row.Found, Row.FoundSquares);
+    printEstimate(Row.Printed, Row.PrintedSquares);
+    Out << "\n";
+  };
+
+  // Output the header.
+  Out << Indent << Divider << "\n"
+      << std::left << Indent << std::setw(LabelWidth) << "Object"
+      << std::right << std::setw(ColumnWidth) << "Total"
+      << std::setw(ColumnWidth) << "+/-" << std::setw(ColumnWidth)
+      << "Printed" << std::setw(ColumnWidth) << "+/-"
+      << "\n"
+      << Indent << Divider << "\n";
+
+  for (const auto &Row : Rows)
+    printRow(Row.first, Row.second);
+
+  // Output the footer, and the sample the estimates come from.
+  Out << Indent << Divider << "\n";
+  printRow("Totals", Totals);
+  std::ostringstream SamplePercent;
+  SamplePercent << std::fixed << std::setprecision(1)
+                << (TotalSize ? 100.0 * SampleSize / TotalSize : 0.0);
+  Out << "\n"
+      << Indent << "Estimated from " << SampleDraws << " draws of "
+      << PartSizes.size() << " groups of compile units.\n"
+      << Indent << "The " << SampleParts << " groups drawn hold "
+      << SamplePercent.str() << "% of the bytes.\n"
+      << Indent << "+/- is the 95% confidence interval of each estimate.\n"
+      << "\n";
+}
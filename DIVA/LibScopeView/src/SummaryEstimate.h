@@ -0,0 +1,97 @@
+//===-- LibScopeView/SummaryEstimate.h --------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Interface for the SummaryEstimate class, which estimates the summary table
+/// of a file from a sample of its parts.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SUMMARY_ESTIMATE_H
+#define SUMMARY_ESTIMATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+class SummaryTable;
+
+/// \brief Draw SampleSize parts at random, with replacement, each with a
+/// chance in proportion to its size in PartSizes. Returns how many times each
+/// part is drawn. The same Seed draws the same parts on every platform.
+std::vector<unsigned> drawSampleParts(const std::vector<uint64_t> &PartSizes,
+                                      unsigned SampleSize, uint64_t Seed);
+
+class SummaryEstimate {
+public:
+  /// \brief Create an empty estimate of the summary table of a file made of
+  /// parts of the sizes \p PartSizes.
+  explicit SummaryEstimate(const std::vector<uint64_t> &PartSizes);
+
+  /// \brief Add the stats of the part \p Index, drawn \p Draws times by
+  /// drawSampleParts.
+  void addPart(size_t Index, unsigned Draws, const SummaryTable &Part);
+
+  /// \brief Output the estimated summary table, with the 95% confidence
+  /// interval of each estimate.
+  void printSummaryEstimate(std::ostream &Out) const;
+
+private:
+  // The sums over the draws of the amounts of a row scaled up to the whole
+  // file, and of their squares.
+  struct Sums {
+    void add(double Found, double Printed, unsigned Draws);
+
+    double Found = 0;
+    double FoundSquares = 0;
+    double Printed = 0;
+    double PrintedSquares = 0;
+  };
+
+  std::vector<uint64_t> PartSizes;
+  uint64_t TotalSize;
+
+  // Map of the rows, indexed via the ObjectsClassID string.
+  std::map<std::string, Sums> Rows;
+  Sums Totals;
+
+  // The draws, distinct parts and bytes of the sample added.
+  unsigned SampleDraws;
+  size_t SampleParts;
+  uint64_t SampleSize;
+
+  // Column width values.
+  const static uint32_t LabelWidth = 19;
+  const static uint32_t ColumnWidth = 10;
+  const static uint32_t IndentWidth = 5;
+};
+
+} // namespace LibScopeView
+
+#endif // SUMMARY_ESTIMATE_H
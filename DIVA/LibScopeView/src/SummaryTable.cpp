@@ -34,6 +34,7 @@
 
 #include <assert.h>
 #include <iomanip>
+#include <istream>
 #include <ostream>
 #include <vector>
 
@@ -60,7 +61,12 @@ void SummaryTable::SummaryTableCounter::visitImpl(const Object *Obj) {
 }
 
 SummaryTable::SummaryTable(const Object &Root, const PrintSettings *Settings)
-    : TotalFound(0), TotalPrinted(0) {
+    : SummaryTable(Settings) {
+  addObjects(Root);
+}
+
+SummaryTable::SummaryTable(const PrintSettings *PSettings)
+    : TotalFound(0), TotalPrinted(0), Settings(PSettings) {
   // Create a list of row labels for each DIVA Object.
   static const std::vector<std::string> RowLabels = {"Alias",
                                                      "Block",
@@ -83,11 +89,64 @@ SummaryTable::SummaryTable(const Object &Root, const PrintSettings *Settings)
   for (auto Label : RowLabels) {
     Rows.emplace(Label, SummaryTableRow());
   }
+}
 
-  // Gather the stats.
+void SummaryTable::addObjects(const Object &Root) {
   SummaryTableCounter(*this, Settings).visit(&Root);
 }
 
+void SummaryTable::addTable(const SummaryTable &Other) {
+  for (const auto &OtherRow : Other.Rows) {
+    SummaryTableRow &Row = Rows[OtherRow.first];
+    Row.ObjectsFound += OtherRow.second.ObjectsFound;
+    Row.ObjectsPrinted += OtherRow.second.ObjectsPrinted;
+  }
+  TotalFound += Other.TotalFound;
+  TotalPrinted += Other.TotalPrinted;
+}
+
+// The label of the last line written by writeCounts, ending the table.
+static const char CountsEndLabel[] = "Totals";
+
+void SummaryTable::writeCounts(std::ostream &Out) const {
+  for (const auto &Row : Rows)
+    Out << Row.first << ' ' << Row.second.ObjectsFound << ' '
+        << Row.second.ObjectsPrinted << '\n';
+  Out << CountsEndLabel << ' ' << TotalFound << ' ' << TotalPrinted << '\n';
+}
+
+bool SummaryTable::addCounts(std::istream &In) {
+  std::string Label;
+  uint32_t Found, Printed;
+  while (In >> Label >> Found >> Printed) {
+    if (Label == CountsEndLabel)
+      return true;
+    SummaryTableRow &Row = Rows[Label];
+    Row.ObjectsFound += Found;
+    Row.ObjectsPrinted += Printed;
+    TotalFound += Found;
+    TotalPrinted += Printed;
+  }
+  return false;
+}
+
+std::vector<std::string> SummaryTable::getLabels() const {
+  std::vector<std::string> Labels;
+  for (const auto &Row : Rows)
+    Labels.push_back(Row.first);
+  return Labels;
+}
+
+uint32_t SummaryTable::getFound(const std::string &Label) const {
+  auto RowIt = Rows.find(Label);
+  return RowIt == Rows.end() ? 0 : RowIt->second.ObjectsFound;
+}
+
+uint32_t SummaryTable::getPrinted(const std::string &Label) const {
+  auto RowIt = Rows.find(Label);
+  return RowIt == Rows.end() ? 0 : RowIt->second.ObjectsPrinted;
+}
+
 void SummaryTable::printSummaryTable(std::ostream &Out) const {
   // Calculate and create indent and divider strings.
   const uint32_t NumberOfColumns = 2;
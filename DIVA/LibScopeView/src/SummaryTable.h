@@ -30,8 +30,11 @@
 #ifndef SUMMARY_TABLE_H
 #define SUMMARY_TABLE_H
 
+#include <cstdint>
+#include <iosfwd>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace LibScopeView {
 
@@ -46,6 +49,34 @@ public:
   /// found object amounts.
   SummaryTable(const Object &Root, const PrintSettings *Settings);
 
+  /// \brief Create an empty summary table, for adding the stats on a tree
+  /// that is read in parts.
+  explicit SummaryTable(const PrintSettings *Settings);
+
+  /// \brief Add the stats on \p Root and its children to the table.
+  void addObjects(const Object &Root);
+
+  /// \brief Add the stats of another table, such as one for another input.
+  void addTable(const SummaryTable &Other);
+
+  /// \brief Write the stats of the table to \p Out, to be added to another
+  /// table by addCounts, such as in another process.
+  void writeCounts(std::ostream &Out) const;
+
+  /// \brief Add the stats of one table written by writeCounts from \p In.
+  /// Returns false if they can not be read.
+  bool addCounts(std::istream &In);
+
+  /// \brief Get the labels of the rows of the table, in the printed order.
+  std::vector<std::string> getLabels() const;
+
+  /// \brief Get the amount of objects found or printed in the row \p Label.
+  uint32_t getFound(const std::string &Label) const;
+  uint32_t getPrinted(const std::string &Label) const;
+
+  /// \brief Get the settings deciding which objects are printed, or null.
+  const PrintSettings *getSettings() const { return Settings; }
+
   /// \brief Outut the summary table.
   void printSummaryTable(std::ostream &out) const;
 
@@ -73,6 +104,9 @@ private:
   unsigned int TotalFound;
   unsigned int TotalPrinted;
 
+  // Settings deciding which objects are printed, or null for all of them.
+  const PrintSettings *Settings;
+
   // Column width values.
   const static uint32_t LabelWidth = 19;
   const static uint32_t ColumnWidth = 9;
@@ -28,6 +28,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "Symbol.h"
+#include "JSONWriter.h"
 #include "PrintSettings.h"
 #include "Scope.h"
 
@@ -133,3 +134,32 @@ std::string Symbol::getAsYAML() const {
   YAML << getCommonYAML() << "\nattributes:" << Attrs.str();
   return YAML.str();
 }
+
+void Symbol::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+
+  // Access specifier.
+  if (getIsMember()) {
+    JSON.key("access_specifier");
+    switch (getAccessSpecifier()) {
+    case AccessSpecifier::Private:
+      JSON.string("private");
+      break;
+    case AccessSpecifier::Protected:
+      JSON.string("protected");
+      break;
+    case AccessSpecifier::Public:
+      JSON.string("public");
+      break;
+    case AccessSpecifier::Unspecified:
+      assert(getParent());
+      if (getParent() && getParent()->getIsClassType())
+        JSON.string("private");
+      else
+        JSON.string("public");
+      break;
+    }
+  }
+
+  JSON.objectEnd();
+}
@@ -27,7 +27,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "Type.h"
+#include "DwarfNames.h"
 #include "FileUtilities.h"
+#include "JSONWriter.h"
 #include "PrintSettings.h"
 #include "Scope.h"
 #include "StringPool.h"
@@ -124,16 +126,43 @@ std::string Type::getAsYAML() const {
        << getName() << "\"\nsource:\n  line: null\n  file: null\n"
        << "dwarf:\n  offset: 0x" << std::hex << getDieOffset() << "\n";
 
-  const char *TagName = "";
-  if (getDieTag())
-    dwarf_get_TAG_name(getDieTag(), &TagName);
-  YAML << "  tag: \"" << TagName << "\"\n";
+  YAML << "  tag: \"" << getDwarfTagName(getDieTag()).Name << "\"\n";
 
   YAML << "attributes:\n  size: " << std::dec << getByteSize();
 
   return YAML.str();
 }
 
+void Type::writeAsJSON(JSONWriter &JSON) const {
+  if (!getIsBaseType()) {
+    Object::writeAsJSON(JSON);
+    return;
+  }
+
+  // We can't use writeCommonJSON here as the name is printed under 'type'.
+  JSON.key("object");
+  JSON.string(getKindAsString());
+  JSON.key("name");
+  JSON.null();
+  JSON.key("type");
+  JSON.string(getName());
+  JSON.key("line");
+  JSON.null();
+  JSON.key("file");
+  JSON.null();
+  JSON.key("offset");
+  JSON.number(getDieOffset());
+
+  JSON.key("tag");
+  JSON.string(getDwarfTagName(getDieTag()).Name);
+
+  JSON.key("attributes");
+  JSON.objectBegin();
+  JSON.key("size");
+  JSON.number(getByteSize());
+  JSON.objectEnd();
+}
+
 unsigned Type::getByteSize() const { return ByteSize; }
 
 void Type::setByteSize(unsigned Size) { ByteSize = Size; }
@@ -334,16 +363,94 @@ std::string TypeImport::getUsingAsYAML() const {
          << getFileName(getFilePath()) << "\""
          << "\ndwarf:"
          << "\n  offset: 0x" << std::hex << getDieOffset();
-  const char *TagName;
   assert(getDieTag());
-  dwarf_get_TAG_name(getDieTag(), &TagName);
-  Result << "\n  tag: \"" << TagName << "\""
+  Result << "\n  tag: \"" << getDwarfTagName(getDieTag()).Name << "\""
          << "\nattributes:"
          << "\n  using_type:" << UsingType;
 
   return Result.str();
 }
 
+void TypeImport::writeAsJSON(JSONWriter &JSON) const {
+  // If type import is inheritance, then this object is written as an
+  // attribute of its parent.
+  if (getIsInheritance()) {
+    JSON.key("parent");
+    JSON.string(getType() ? getType()->getName() : "");
+    JSON.key("access_specifier");
+    switch (getInheritanceAccess()) {
+    case AccessSpecifier::Private:
+      JSON.string("private");
+      break;
+    case AccessSpecifier::Protected:
+      JSON.string("protected");
+      break;
+    case AccessSpecifier::Public:
+      JSON.string("public");
+      break;
+    case AccessSpecifier::Unspecified:
+      assert(getParent());
+      if (getParent() && getParent()->getIsClassType())
+        JSON.string("private");
+      else
+        JSON.string("public");
+    }
+    return;
+  }
+
+  // Determine the UsingType and name for the Using object.
+  const char *UsingType = nullptr;
+  std::string Name;
+  Object *ObjType = getType();
+  if (ObjType) {
+    Scope *Parent = ObjType->getParent();
+    if (getIsImportedModule())
+      UsingType = "namespace";
+    else if (getIsImportedDeclaration()) {
+      if (isa<Type>(*ObjType) || isa<ScopeAggregate>(*ObjType))
+        UsingType = "type";
+      else if (isa<ScopeFunction>(*ObjType))
+        UsingType = "function";
+      else if (Symbol *Sym = dyn_cast<Symbol>(ObjType))
+        if (Sym->getIsVariable() || Sym->getIsMember())
+          UsingType = "variable";
+    }
+
+    if (Parent != nullptr && !isa<ScopeCompileUnit>(*Parent))
+      Parent->getQualifiedName(Name);
+    if (!Name.empty())
+      Name.append("::");
+    Name.append(ObjType->getName());
+  }
+
+  // We can't use writeCommonJSON here as it writes the name of the Using as
+  // its type.
+  JSON.key("object");
+  JSON.string(getKindAsString());
+  JSON.key("name");
+  JSON.string(Name);
+  JSON.key("type");
+  JSON.null();
+  JSON.key("line");
+  JSON.number(getLineNumber());
+  JSON.key("file");
+  JSON.string(getFileName(getFilePath()));
+  JSON.key("offset");
+  JSON.number(getDieOffset());
+  assert(getDieTag());
+  JSON.key("tag");
+  JSON.string(getDwarfTagName(getDieTag()).Name);
+
+  JSON.key("attributes");
+  JSON.objectBegin();
+  JSON.key("using_type");
+  if (UsingType)
+    JSON.string(UsingType);
+  else
+    JSON.null();
+  JSON.objectEnd();
+}
+
 const std::string &TypeTemplateParam::getValue() const {
   return ValueRef ? *ValueRef : EmptyString;
 }
@@ -408,4 +515,25 @@ std::string TypeTemplateParam::getAsYAML() const {
   return YAML.str();
 }
 
+void TypeTemplateParam::writeValueAsJSON(JSONWriter &JSON) const {
+  if (getIsTemplateType())
+    JSON.string(getTypeQualifiedName() + (getType() ? getType()->getName()
+                                                    : std::string()));
+  else if (getIsTemplateValue())
+    JSON.numberOrString(getValue());
+  else {
+    assert(getIsTemplateTemplate());
+    JSON.string(getValue());
+  }
+}
+
+void TypeTemplateParam::writeAttributesAsJSON(JSONWriter &JSON) const {
+  JSON.objectBegin();
+  JSON.key("types");
+  JSON.arrayBegin();
+  writeValueAsJSON(JSON);
+  JSON.arrayEnd();
+  JSON.objectEnd();
+}
+
 TypeSubrange::~TypeSubrange() {}
@@ -149,6 +149,8 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+  /// \brief Writes the members of a JSON representation of this DIVA Object.
+  void writeAsJSON(JSONWriter &JSON) const override;
 
 private:
   // DW_AT_byte_size for PrimitiveType.
@@ -227,6 +229,8 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+  /// \brief Writes the members of a JSON representation of this DIVA Object.
+  void writeAsJSON(JSONWriter &JSON) const override;
 
 private:
   virtual std::string getInheritanceAsText(const PrintSettings &Settings) const;
@@ -262,6 +266,12 @@ public:
   std::string getAsText(const PrintSettings &Settings) const override;
   /// \brief Returns a YAML representation of this DIVA Object.
   std::string getAsYAML() const override;
+  /// \brief Writes the value of this template parameter as a JSON value.
+  void writeValueAsJSON(JSONWriter &JSON) const;
+
+protected:
+  /// \brief Writes the JSON object holding this object's attributes.
+  void writeAttributesAsJSON(JSONWriter &JSON) const override;
 };
 
 /// \brief Class to represent a DW_TAG_subrange_type
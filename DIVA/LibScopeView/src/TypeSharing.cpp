@@ -0,0 +1,231 @@
+//===-- LibScopeView/TypeSharing.cpp ----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the function sharing identical types between the
+/// compile units of a tree.
+///
+//===----------------------------------------------------------------------===//
+
+#include "TypeSharing.h"
+#include "Scope.h"
+#include "ScopeHash.h"
+#include "ScopeVisitor.h"
+#include "Symbol.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Hash the members of Obj and its subtree in order, without DIE offsets.
+uint64_t hashSubtree(const Object &Obj) {
+  HashBuilder Hash;
+  Hash.add(static_cast<uint64_t>(Obj.getKind()));
+  Hash.add(Obj.getName());
+  Hash.add(Obj.getQualifiedName());
+  Hash.add(Obj.getType() ? Obj.getType()->getName() : std::string());
+  Hash.add(Obj.getLineNumber());
+  Hash.add(Obj.getFilePath());
+  hashAttributes(Obj, Hash);
+  if (const auto *Scp = dyn_cast<Scope>(&Obj))
+    for (const Object *Child : Scp->getChildren())
+      Hash.add(hashSubtree(*Child));
+  return Hash.get();
+}
+
+// Check that two subtrees are the same but for their DIE offsets.
+bool isSameSubtree(const Object &A, const Object &B) {
+  if (A.getKind() != B.getKind() || A.getDieTag() != B.getDieTag() ||
+      A.getName() != B.getName() ||
+      A.getQualifiedName() != B.getQualifiedName() ||
+      A.getLineNumber() != B.getLineNumber() ||
+      A.getFilePathPoolRef() != B.getFilePathPoolRef() ||
+      A.getInvalidFileName() != B.getInvalidFileName() ||
+      A.getIsGlobalReference() != B.getIsGlobalReference())
+    return false;
+
+  const Object *AType = A.getType();
+  const Object *BType = B.getType();
+  if (!AType != !BType ||
+      (AType && (AType->getName() != BType->getName() ||
+                 A.getTypeQualifiedName() != B.getTypeQualifiedName())))
+    return false;
+
+  HashBuilder AAttributes;
+  HashBuilder BAttributes;
+  hashAttributes(A, AAttributes);
+  hashAttributes(B, BAttributes);
+  if (AAttributes.get() != BAttributes.get())
+    return false;
+
+  const auto *AScope = dyn_cast<Scope>(&A);
+  const auto *BScope = dyn_cast<Scope>(&B);
+  if (!AScope)
+    return true;
+  if (!AScope->getLines().empty() || !BScope->getLines().empty())
+    return false;
+  const std::vector<Object *> &AChildren = AScope->getChildren();
+  const std::vector<Object *> &BChildren = BScope->getChildren();
+  if (AChildren.size() != BChildren.size())
+    return false;
+  for (size_t Index = 0; Index < AChildren.size(); ++Index)
+    if (!isSameSubtree(*AChildren[Index], *BChildren[Index]))
+      return false;
+  return true;
+}
+
+// Count Obj and the objects below it.
+size_t countObjects(const Object &Obj) {
+  size_t Count = 1;
+  if (const auto *Scp = dyn_cast<Scope>(&Obj)) {
+    for (const Object *Child : Scp->getChildren())
+      Count += countObjects(*Child);
+    Count += Scp->getLines().size();
+  }
+  return Count;
+}
+
+// Visitor moving the references to freed objects to their shared copies.
+class ReferenceMover : public ScopeVisitor {
+public:
+  ReferenceMover(const std::unordered_map<Object *, Object *> &Moved)
+      : Moved(Moved) {}
+
+private:
+  void visitImpl(Object *Obj) override {
+    if (Object *Ty = Obj->getType()) {
+      auto Found = Moved.find(Ty);
+      if (Found != Moved.end())
+        Obj->setType(Found->second);
+    }
+    if (auto *Scp = dyn_cast<Scope>(Obj)) {
+      if (Scope *Reference = Scp->getReference()) {
+        auto Found = Moved.find(Reference);
+        if (Found != Moved.end())
+          Scp->setReference(cast<Scope>(Found->second));
+      }
+    } else if (auto *Sym = dyn_cast<Symbol>(Obj)) {
+      if (Symbol *Reference = Sym->getReference()) {
+        auto Found = Moved.find(Reference);
+        if (Found != Moved.end())
+          Sym->setReference(cast<Symbol>(Found->second));
+      }
+    }
+    visitChildren(Obj);
+  }
+
+  const std::unordered_map<Object *, Object *> &Moved;
+};
+
+class TypeSharer {
+public:
+  explicit TypeSharer(ScopeRoot &Root) : Root(Root) {}
+
+  void share() {
+    for (Object *CU : Root.getChildren())
+      if (auto *Scp = dyn_cast<ScopeCompileUnit>(CU))
+        findTypes(*Scp);
+    if (Moved.empty())
+      return;
+    ReferenceMover(Moved).visit(&Root);
+    Freed.clear();
+  }
+
+private:
+  // Share the types in Scp and the namespaces in it.
+  void findTypes(Scope &Scp) {
+    for (Object *Child : Scp.getChildren()) {
+      if (auto *Namespace = dyn_cast<ScopeNamespace>(Child))
+        findTypes(*Namespace);
+      else if (auto *Aggregate = dyn_cast<ScopeAggregate>(Child))
+        if (!Aggregate->getName().empty() &&
+            !Aggregate->getChildren().empty())
+          shareType(*Aggregate);
+    }
+  }
+
+  void shareType(ScopeAggregate &Type) {
+    std::vector<ScopeAggregate *> &Copies = FirstCopies[hashSubtree(Type)];
+    for (ScopeAggregate *First : Copies) {
+      if (isSameSubtree(*First, Type)) {
+        freeMembers(*First, Type);
+        Root.getSharedTypes().emplace(&Type, First);
+        return;
+      }
+    }
+    Copies.push_back(&Type);
+  }
+
+  // Free the children of Copy that are printed as objects, moving the
+  // references to them and their children to those of First.
+  // The freed objects are taken off the counts of the recorded extents.
+  void freeMembers(Scope &First, Scope &Copy) {
+    std::vector<Object *> &Children = Copy.getChildren();
+    std::vector<Object *> Kept;
+    size_t FreedCount = 0;
+    for (size_t Index = 0; Index < Children.size(); ++Index) {
+      Object *Child = Children[Index];
+      if (!Child->getIsPrintedAsObject()) {
+        Kept.push_back(Child);
+        continue;
+      }
+      addMoved(*First.getChildren()[Index], *Child);
+      FreedCount += countObjects(*Child);
+      Freed.emplace_back(Child);
+    }
+    Children.swap(Kept);
+
+    Root.getExtents().removeObjectCount(FreedCount);
+    for (Object *Parent = Copy.getParent(); Parent;
+         Parent = Parent->getParent())
+      if (auto *CU = dyn_cast<ScopeCompileUnit>(Parent))
+        CU->getExtents().removeObjectCount(FreedCount);
+  }
+
+  void addMoved(Object &First, Object &Copy) {
+    Moved.emplace(&Copy, &First);
+    if (auto *CopyScope = dyn_cast<Scope>(&Copy)) {
+      auto &FirstScope = cast<Scope>(First);
+      for (size_t Index = 0; Index < CopyScope->getChildren().size(); ++Index)
+        addMoved(*FirstScope.getChildren()[Index],
+                 *CopyScope->getChildren()[Index]);
+    }
+  }
+
+  ScopeRoot &Root;
+  // The first copy of each type, by the hash of its subtree.
+  std::unordered_map<uint64_t, std::vector<ScopeAggregate *>> FirstCopies;
+  // The objects freed from later copies, and their shared objects.
+  std::unordered_map<Object *, Object *> Moved;
+  // The freed objects, deleted once no object references them.
+  std::vector<std::unique_ptr<Object>> Freed;
+};
+
+} // namespace
+
+void LibScopeView::shareTypes(ScopeRoot &Root) { TypeSharer(Root).share(); }
@@ -0,0 +1,51 @@
+//===-- LibScopeView/TypeSharing.h ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the function sharing identical types between the
+/// compile units of a tree.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_TYPESHARING_H
+#define SCOPEVIEW_TYPESHARING_H
+
+namespace LibScopeView {
+
+class ScopeRoot;
+
+/// \brief Keep one copy of the members of each class, structure and union
+/// that is the same in several compile units.
+///
+/// The types at namespace scope are matched by a hash of their subtree and
+/// then compared in full, ignoring the DIE offsets. The first copy of a type
+/// keeps its members. The later copies stay in their compile units, so that
+/// they are printed in place, but their members are freed and the references
+/// to them are moved to the members of the first copy. Each later copy is
+/// added to the shared types of Root.
+void shareTypes(ScopeRoot &Root);
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_TYPESHARING_H
@@ -120,6 +120,14 @@ void LibScopeView::printTimeTaken(
             << " seconds\n";
 }
 
+void LibScopeView::printFilterCacheHitRate(size_t Hits, size_t Lookups) {
+  double HitRate = Lookups ? 100.0 * Hits / Lookups : 0.0;
+  std::cout << "\nFilter cache hit rate: " << std::fixed
+            << std::setprecision(1) << HitRate << "% (" << Hits << " of "
+            << Lookups << " lookups)\n"
+            << std::defaultfloat;
+}
+
 std::string LibScopeView::trim(const std::string &text) {
   size_t first = text.find_first_not_of(' ');
   if (first == std::string::npos) {
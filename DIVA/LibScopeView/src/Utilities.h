@@ -56,6 +56,9 @@ std::chrono::steady_clock::time_point getCurrentTime();
 void printTimeTaken(const std::chrono::steady_clock::time_point &StartTime,
                     const std::chrono::steady_clock::time_point &EndTime);
 
+/// \brief Print the hit rate of the filter result caches to std::cout.
+void printFilterCacheHitRate(size_t Hits, size_t Lookups);
+
 /// \brief Remove leading and trailing spaces.
 std::string trim(const std::string &Text);
 
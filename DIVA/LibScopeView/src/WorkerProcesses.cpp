@@ -0,0 +1,454 @@
+//===-- LibScopeView/WorkerProcesses.cpp ------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of runInWorkerProcesses, and the shared
+/// memory and ring buffers used by the worker processes.
+///
+//===----------------------------------------------------------------------===//
+
+#include "WorkerProcesses.h"
+#include "Error.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(PLATFORM_LINUX)
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#endif // PLATFORM_LINUX
+
+using namespace LibScopeView;
+
+#if defined(PLATFORM_LINUX)
+
+namespace {
+
+// The size of the ring buffer of each worker.
+const size_t RingSize = 1 << 20;
+// The largest chunk of output a worker writes into its ring at once.
+const size_t ChunkSize = 64 * 1024;
+// How often the workers are checked on while waiting for their output.
+const long WaitCheckNanoseconds = 100 * 1000 * 1000;
+
+size_t alignOffset(size_t Offset) { return (Offset + 63) & ~size_t(63); }
+
+// The state shared by the calling process and the workers.
+struct SharedState {
+  pthread_mutex_t Mutex;
+  // Signalled when a worker takes an item or writes into its ring.
+  pthread_cond_t Written;
+  // Signalled when the calling process reads from a ring.
+  pthread_cond_t Read;
+  // The next item for a worker to take.
+  uint64_t NextItem;
+};
+
+// The positions in a ring buffer, as the total number of bytes written into
+// it and read from it.
+struct RingState {
+  uint64_t WrittenSize;
+  uint64_t ReadSize;
+};
+
+// A mapping of memory shared with the forked workers, holding the shared
+// state, the worker that took each item, and the ring buffer of each worker.
+class SharedMemory {
+public:
+  SharedMemory(size_t ItemCount, unsigned Workers)
+      : OwnersOffset(alignOffset(sizeof(SharedState))),
+        RingsOffset(alignOffset(OwnersOffset + ItemCount * sizeof(int32_t))),
+        RingStride(alignOffset(sizeof(RingState)) + RingSize),
+        Size(RingsOffset + RingStride * Workers) {
+    Base = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (Base == MAP_FAILED)
+      return;
+
+    // A worker killed while holding the mutex leaves it to the next owner,
+    // rather than stopping the others.
+    SharedState &State = getState();
+    pthread_mutexattr_t MutexAttr;
+    pthread_mutexattr_init(&MutexAttr);
+    pthread_mutexattr_setpshared(&MutexAttr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&MutexAttr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&State.Mutex, &MutexAttr);
+    pthread_mutexattr_destroy(&MutexAttr);
+    pthread_condattr_t CondAttr;
+    pthread_condattr_init(&CondAttr);
+    pthread_condattr_setpshared(&CondAttr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&CondAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&State.Written, &CondAttr);
+    pthread_cond_init(&State.Read, &CondAttr);
+    pthread_condattr_destroy(&CondAttr);
+    State.NextItem = 0;
+    std::fill(getOwners(), getOwners() + ItemCount, -1);
+  }
+
+  ~SharedMemory() {
+    if (Base == MAP_FAILED)
+      return;
+    pthread_cond_destroy(&getState().Read);
+    pthread_cond_destroy(&getState().Written);
+    pthread_mutex_destroy(&getState().Mutex);
+    munmap(Base, Size);
+  }
+
+  SharedMemory(const SharedMemory &) = delete;
+  SharedMemory &operator=(const SharedMemory &) = delete;
+
+  bool isValid() const { return Base != MAP_FAILED; }
+
+  SharedState &getState() { return *static_cast<SharedState *>(Base); }
+  int32_t *getOwners() {
+    return reinterpret_cast<int32_t *>(static_cast<char *>(Base) +
+                                       OwnersOffset);
+  }
+  RingState &getRing(unsigned Worker) {
+    return *reinterpret_cast<RingState *>(static_cast<char *>(Base) +
+                                          RingsOffset + RingStride * Worker);
+  }
+  char *getRingData(unsigned Worker) {
+    return static_cast<char *>(Base) + RingsOffset + RingStride * Worker +
+           alignOffset(sizeof(RingState));
+  }
+
+  void lock() {
+    if (pthread_mutex_lock(&getState().Mutex) == EOWNERDEAD)
+      pthread_mutex_consistent(&getState().Mutex);
+  }
+  void unlock() { pthread_mutex_unlock(&getState().Mutex); }
+
+  // Wait for Cond to be signalled, for no longer than WaitCheckNanoseconds
+  // if Timed. The mutex must be locked.
+  void wait(pthread_cond_t &Cond, bool Timed) {
+    int Result;
+    if (Timed) {
+      timespec Until;
+      clock_gettime(CLOCK_MONOTONIC, &Until);
+      Until.tv_nsec += WaitCheckNanoseconds;
+      if (Until.tv_nsec >= 1000 * 1000 * 1000) {
+        Until.tv_nsec -= 1000 * 1000 * 1000;
+        ++Until.tv_sec;
+      }
+      Result = pthread_cond_timedwait(&Cond, &getState().Mutex, &Until);
+    } else {
+      Result = pthread_cond_wait(&Cond, &getState().Mutex);
+    }
+    if (Result == EOWNERDEAD)
+      pthread_mutex_consistent(&getState().Mutex);
+  }
+
+private:
+  const size_t OwnersOffset;
+  const size_t RingsOffset;
+  const size_t RingStride;
+  const size_t Size;
+  void *Base;
+};
+
+// The stream buffer of a worker, writing the output of its items into its
+// ring in chunks. Each chunk is its size followed by its bytes, and a size of
+// 0 ends the output of an item.
+class RingStreamBuffer : public std::streambuf {
+public:
+  RingStreamBuffer(SharedMemory &Memory, unsigned Worker)
+      : Memory(Memory), Worker(Worker), Buffer(ChunkSize) {
+    setp(Buffer.data(), Buffer.data() + Buffer.size());
+  }
+
+  // End the output of the current item.
+  void endItem() {
+    writeChunk();
+    const uint32_t End = 0;
+    write(reinterpret_cast<const char *>(&End), sizeof(End));
+  }
+
+protected:
+  int_type overflow(int_type C) override {
+    writeChunk();
+    if (traits_type::eq_int_type(C, traits_type::eof()))
+      return traits_type::not_eof(C);
+    *pptr() = traits_type::to_char_type(C);
+    pbump(1);
+    return C;
+  }
+
+  int sync() override {
+    writeChunk();
+    return 0;
+  }
+
+private:
+  void writeChunk() {
+    const uint32_t Size = static_cast<uint32_t>(pptr() - pbase());
+    if (!Size)
+      return;
+    write(reinterpret_cast<const char *>(&Size), sizeof(Size));
+    write(pbase(), Size);
+    setp(Buffer.data(), Buffer.data() + Buffer.size());
+  }
+
+  // Write Data into the ring, waiting for the calling process to read from it
+  // whenever it is full.
+  void write(const char *Data, size_t Size) {
+    RingState &Ring = Memory.getRing(Worker);
+    char *RingData = Memory.getRingData(Worker);
+    while (Size) {
+      Memory.lock();
+      while (Ring.WrittenSize - Ring.ReadSize == RingSize)
+        Memory.wait(Memory.getState().Read, /*Timed*/ false);
+      const uint64_t Position = Ring.WrittenSize;
+      const size_t Free =
+          RingSize - static_cast<size_t>(Position - Ring.ReadSize);
+      Memory.unlock();
+
+      // Only this worker writes to the free part of the ring.
+      const size_t Count = std::min(Size, Free);
+      const size_t Start = static_cast<size_t>(Position % RingSize);
+      const size_t FirstPart = std::min(Count, RingSize - Start);
+      std::memcpy(RingData + Start, Data, FirstPart);
+      std::memcpy(RingData, Data + FirstPart, Count - FirstPart);
+
+      Memory.lock();
+      Ring.WrittenSize += Count;
+      pthread_cond_broadcast(&Memory.getState().Written);
+      Memory.unlock();
+      Data += Count;
+      Size -= Count;
+    }
+  }
+
+  SharedMemory &Memory;
+  const unsigned Worker;
+  std::vector<char> Buffer;
+};
+
+// Take and run items until there are none left, then exit the worker.
+[[noreturn]] void runWorker(SharedMemory &Memory, unsigned Worker,
+                            size_t ItemCount, pid_t Parent,
+                            const WorkerItemCallback &RunItem) {
+  // Stop with the calling process, rather than waiting on it forever.
+  prctl(PR_SET_PDEATHSIG, SIGKILL);
+  if (getppid() != Parent)
+    _exit(1);
+
+  RingStreamBuffer Buffer(Memory, Worker);
+  std::ostream Output(&Buffer);
+  while (true) {
+    Memory.lock();
+    const uint64_t Item = Memory.getState().NextItem;
+    if (Item < ItemCount) {
+      ++Memory.getState().NextItem;
+      Memory.getOwners()[Item] = static_cast<int32_t>(Worker);
+      pthread_cond_broadcast(&Memory.getState().Written);
+    }
+    Memory.unlock();
+    if (Item >= ItemCount)
+      break;
+
+    RunItem(static_cast<size_t>(Item), Output);
+    Output.flush();
+    Buffer.endItem();
+  }
+
+  // The worker's copy of anything buffered by the calling process is left
+  // unwritten.
+  std::cerr.flush();
+  _exit(0);
+}
+
+// The workers seen from the calling process.
+class WorkerPool {
+public:
+  WorkerPool(SharedMemory &Memory, std::vector<pid_t> Workers)
+      : Memory(Memory), Workers(std::move(Workers)),
+        IsRunning(this->Workers.size(), true) {}
+
+  // Wait for an item to be taken, returning the worker that took it.
+  unsigned waitForOwner(size_t Item) {
+    while (true) {
+      Memory.lock();
+      int32_t Owner = Memory.getOwners()[Item];
+      if (Owner < 0) {
+        Memory.wait(Memory.getState().Written, /*Timed*/ true);
+        Owner = Memory.getOwners()[Item];
+      }
+      Memory.unlock();
+      if (Owner >= 0)
+        return static_cast<unsigned>(Owner);
+      checkWorkers();
+    }
+  }
+
+  // Read Size bytes from the ring of Worker into Data, waiting for them to be
+  // written.
+  void read(unsigned Worker, char *Data, size_t Size) {
+    RingState &Ring = Memory.getRing(Worker);
+    const char *RingData = Memory.getRingData(Worker);
+    while (Size) {
+      Memory.lock();
+      if (Ring.WrittenSize == Ring.ReadSize)
+        Memory.wait(Memory.getState().Written, /*Timed*/ true);
+      const uint64_t Position = Ring.ReadSize;
+      const size_t Available = static_cast<size_t>(Ring.WrittenSize - Position);
+      Memory.unlock();
+      if (!Available) {
+        checkWorkers();
+        continue;
+      }
+
+      // Only the calling process reads the written part of the ring.
+      const size_t Count = std::min(Size, Available);
+      const size_t Start = static_cast<size_t>(Position % RingSize);
+      const size_t FirstPart = std::min(Count, RingSize - Start);
+      std::memcpy(Data, RingData + Start, FirstPart);
+      std::memcpy(Data + FirstPart, RingData, Count - FirstPart);
+
+      Memory.lock();
+      Ring.ReadSize += Count;
+      pthread_cond_broadcast(&Memory.getState().Read);
+      Memory.unlock();
+      Data += Count;
+      Size -= Count;
+    }
+  }
+
+  // Wait for all the workers to exit.
+  void waitForAll() {
+    for (size_t Index = 0; Index < Workers.size(); ++Index) {
+      int Status;
+      if (IsRunning[Index] && waitpid(Workers[Index], &Status, 0) > 0) {
+        IsRunning[Index] = false;
+        checkStatus(Status);
+      }
+    }
+  }
+
+private:
+  // Check for any worker that has failed.
+  void checkWorkers() {
+    for (size_t Index = 0; Index < Workers.size(); ++Index) {
+      int Status;
+      if (IsRunning[Index] &&
+          waitpid(Workers[Index], &Status, WNOHANG) == Workers[Index]) {
+        IsRunning[Index] = false;
+        checkStatus(Status);
+      }
+    }
+  }
+
+  // End the program if a worker exited with Status because it failed.
+  void checkStatus(int Status) {
+    if (WIFEXITED(Status) && WEXITSTATUS(Status) == 0)
+      return;
+    for (size_t Index = 0; Index < Workers.size(); ++Index) {
+      if (IsRunning[Index]) {
+        kill(Workers[Index], SIGKILL);
+        waitpid(Workers[Index], nullptr, 0);
+        IsRunning[Index] = false;
+      }
+    }
+    if (WIFEXITED(Status))
+      LibScopeError::exitProgram(WEXITSTATUS(Status));
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_WORKER_FAILED,
+                              std::to_string(WTERMSIG(Status)));
+  }
+
+  SharedMemory &Memory;
+  const std::vector<pid_t> Workers;
+  std::vector<bool> IsRunning;
+};
+
+} // namespace
+
+bool LibScopeView::runInWorkerProcesses(size_t ItemCount, unsigned Processes,
+                                        const WorkerItemCallback &RunItem,
+                                        std::ostream &Output) {
+  const unsigned WorkerCount = static_cast<unsigned>(
+      std::min<size_t>(Processes, ItemCount));
+  if (!WorkerCount)
+    return false;
+  SharedMemory Memory(ItemCount, WorkerCount);
+  if (!Memory.isValid())
+    return false;
+
+  // Anything left buffered would be written again by each worker.
+  Output.flush();
+  std::cout.flush();
+  std::cerr.flush();
+
+  const pid_t Parent = getpid();
+  std::vector<pid_t> Workers;
+  for (unsigned Worker = 0; Worker < WorkerCount; ++Worker) {
+    const pid_t Pid = fork();
+    if (Pid < 0)
+      break;
+    if (Pid == 0)
+      runWorker(Memory, Worker, ItemCount, Parent, RunItem);
+    Workers.push_back(Pid);
+  }
+  if (Workers.empty())
+    return false;
+
+  // Copy the output of each item in turn from the ring of its worker.
+  WorkerPool Pool(Memory, std::move(Workers));
+  std::vector<char> Chunk;
+  for (size_t Item = 0; Item < ItemCount; ++Item) {
+    const unsigned Worker = Pool.waitForOwner(Item);
+    while (true) {
+      uint32_t Size;
+      Pool.read(Worker, reinterpret_cast<char *>(&Size), sizeof(Size));
+      if (!Size)
+        break;
+      Chunk.resize(Size);
+      Pool.read(Worker, Chunk.data(), Size);
+      Output.write(Chunk.data(), static_cast<std::streamsize>(Size));
+    }
+  }
+  Pool.waitForAll();
+  return true;
+}
+
+#else
+
+bool LibScopeView::runInWorkerProcesses(size_t, unsigned,
+                                        const WorkerItemCallback &,
+                                        std::ostream &) {
+  return false;
+}
+
+#endif // PLATFORM_LINUX
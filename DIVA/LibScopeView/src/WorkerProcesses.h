@@ -0,0 +1,77 @@
+//===-- LibScopeView/WorkerProcesses.h --------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of runInWorkerProcesses, which shares
+/// numbered items of work between forked worker processes.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_WORKERPROCESSES_H
+#define SCOPEVIEW_WORKERPROCESSES_H
+
+#include "Platform.h"
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+
+namespace LibScopeView {
+
+/// \brief Callback run in a worker process for the item Index, printing the
+/// output of the item to Output.
+using WorkerItemCallback =
+    std::function<void(size_t Index, std::ostream &Output)>;
+
+/// \brief Return true if runInWorkerProcesses is supported on this platform.
+inline static constexpr bool canRunWorkerProcesses() {
+#if defined(PLATFORM_LINUX)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// \brief Run the items [0, ItemCount) in up to Processes forked worker
+/// processes, and write the output of each item to Output in item order.
+///
+/// Each worker takes the next item that no worker has taken yet, so the work
+/// is shared evenly whatever the sizes of the items. A worker writes the
+/// output of its items into its own ring buffer in shared memory, in chunks
+/// that the calling process copies to Output as soon as the item is the next
+/// one to be written, so the output of an item can be larger than the ring.
+///
+/// A worker that fails ends the program: with the worker's exit code if it
+/// exited, as it has reported the error itself, or with a fatalError if it was
+/// killed by a signal. The calling process must only have the one thread, as
+/// the other threads are not copied into the workers.
+///
+/// Returns false without running any item if no worker could be started.
+bool runInWorkerProcesses(size_t ItemCount, unsigned Processes,
+                          const WorkerItemCallback &RunItem,
+                          std::ostream &Output);
+
+} // namespace LibScopeView
+
+#endif // SCOPEVIEW_WORKERPROCESSES_H
@@ -0,0 +1,74 @@
+import py
+import pytest
+import re
+import subprocess
+
+examples_dir = py.path.local(__file__).dirpath().dirpath().dirpath('Examples')
+inputs = ('example_01.o', 'example_02.o', 'example_03.o', 'example_04.o',
+          'example_05.o', 'example_16.elf')
+
+
+@pytest.fixture()
+def elfs(tmpdir_autodel):
+    for name in inputs:
+        examples_dir.join(name).copy(tmpdir_autodel.join(name))
+    return tmpdir_autodel
+
+
+@pytest.mark.parametrize('jobs', ('1', '3'))
+def test_same_output(diva, elfs, jobs):
+    elfs.join('batch.txt').write('\n'.join(inputs[1:]) + '\n')
+    command = [inputs[0], '--batch=batch.txt', '--show-all', '--jobs=' + jobs]
+    assert diva(command, getelfs=False, cwd=elfs) == \
+        diva(list(inputs) + ['--show-all'], getelfs=False, cwd=elfs)
+
+
+@pytest.mark.parametrize('jobs', ('1', '3'))
+def test_output_files(diva, elfs, jobs):
+    elfs.join('batch.txt').write(''.join(
+        '{} "out dir/{}.txt"\n'.format(name, name) for name in inputs[:3]) +
+        inputs[3] + '\n')
+    output = diva(['--batch=batch.txt', '--jobs=' + jobs], getelfs=False,
+                  cwd=elfs)
+    assert output == diva(inputs[3], getelfs=False, cwd=elfs)
+    for name in inputs[:3]:
+        assert elfs.join('out dir', name + '.txt').read() == \
+            diva(name, getelfs=False, cwd=elfs)
+
+
+def _totals(output):
+    return [tuple(map(int, totals))
+            for totals in re.findall(r'Totals +(\d+) +(\d+)', output)]
+
+
+@pytest.mark.parametrize('jobs', ('1', '3'))
+def test_one_summary(diva, elfs, jobs):
+    elfs.join('batch.txt').write('\n'.join(inputs) + '\n')
+    output = diva(['--batch=batch.txt', '--show-summary', '--quiet',
+                   '--jobs=' + jobs], getelfs=False, cwd=elfs)
+    separate = _totals(diva(list(inputs) + ['--show-summary', '--quiet'],
+                            getelfs=False, cwd=elfs))
+    assert _totals(output) == [(sum(found for found, _ in separate),
+                                sum(printed for _, printed in separate))]
+
+
+def test_stdin(diva, elfs):
+    proc = subprocess.Popen(['diva', '--batch=-'], cwd=str(elfs),
+                            stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                            universal_newlines=True)
+    stdout, _ = proc.communicate('example_01.o\n\nexample_02.o\n')
+    assert proc.returncode == 0
+    assert stdout == diva('example_01.o example_02.o', getelfs=False,
+                          cwd=elfs)
+
+
+def test_errors(diva, elfs):
+    assert diva('--batch=missing.txt', getelfs=False, cwd=elfs,
+                nonzero=True) == \
+        (1, "\nERR_FILE_NOT_FOUND: Unable to open file 'missing.txt'.\n")
+
+    elfs.join('batch.txt').write('example_01.o a.txt b.txt\n')
+    assert diva('--batch=batch.txt', getelfs=False, cwd=elfs,
+                nonzero=True) == \
+        (1, "\nERR_INVALID_BATCH_LINE: Invalid line 'example_01.o a.txt "
+            "b.txt' in batch file 'batch.txt'.\n")
@@ -0,0 +1,85 @@
+import py
+import pytest
+import subprocess
+
+examples_dir = py.path.local(__file__).dirpath().dirpath().dirpath('Examples')
+
+
+def test_differences(diva):
+    assert diva('--compare scopes_org.o scopes_mod.o') == """\
+Comparing "scopes_org.o" with "scopes_mod.o"
+
+  {CompileUnit} "scopes.cpp"
+-   {Alias} "INT" -> "int"
+    {Function} "foo" -> "void"
+        - No declaration
++     {Alias} "INT" -> "int"
+
+Added 1, removed 1, changed 0
+"""
+
+
+def test_no_differences(diva):
+    assert diva('--compare helloworld.o helloworld.o --show-all') == """\
+Comparing "helloworld.o" with "helloworld.o"
+
+Added 0, removed 0, changed 0
+"""
+
+
+def test_yaml(diva):
+    assert diva('--compare scopes_org.o scopes_mod.o --output=yaml') == """\
+old_file: "scopes_org.o"
+new_file: "scopes_mod.o"
+differences:
+  - change: "removed"
+    parents: ["{CompileUnit} \\"scopes.cpp\\""]
+    old: "{Alias} \\"INT\\" -> \\"int\\""
+    new: null
+  - change: "added"
+    parents: ["{CompileUnit} \\"scopes.cpp\\"", "{Function} \\"foo\\" -> \\"void\\"\\n    - No declaration"]
+    old: null
+    new: "{Alias} \\"INT\\" -> \\"int\\""
+summary:
+  added: 1
+  removed: 1
+  changed: 0
+"""
+
+
+def test_hidden_objects(diva):
+    assert 'Added 0, removed 0, changed 0' in \
+        diva('--compare scopes_org.o scopes_mod.o --no-show-alias')
+
+
+@pytest.mark.parametrize('args, message', (
+    ('--compare scopes_org.o',
+     "ERR_CMD_COMPARE_INPUTS: Argument '--compare' requires two input files, "
+     "got 1."),
+    ('--compare scopes_org.o scopes_mod.o helloworld.o',
+     "ERR_CMD_COMPARE_INPUTS: Argument '--compare' requires two input files, "
+     "got 3."),
+    ('--compare scopes_org.o scopes_mod.o --output=json',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--compare' can not be used with "
+     "'--output=json'."),
+    ('--compare scopes_org.o scopes_mod.o --filter=foo',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--compare' can not be used with "
+     "'--filter'."),
+    ('--compare scopes_org.o scopes_mod.o --tree-any=foo',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--compare' can not be used with "
+     "'--tree-any'."),
+))
+def test_errors(diva, args, message):
+    assert diva(args, nonzero=True) == (1, '\n' + message + '\n')
+
+
+def test_serve(diva, tmpdir_autodel):
+    for name in ('scopes_org.o', 'scopes_mod.o'):
+        examples_dir.join(name).copy(tmpdir_autodel.join(name))
+    proc = subprocess.Popen(['diva', '--serve'], cwd=str(tmpdir_autodel),
+                            stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                            universal_newlines=True)
+    stdout, _ = proc.communicate('--compare scopes_org.o scopes_mod.o\n')
+    assert proc.returncode == 0
+    expected = diva('--compare scopes_org.o scopes_mod.o', getelfs=False)
+    assert stdout == 'Result: 0 {}\n{}'.format(len(expected), expected)
@@ -0,0 +1,129 @@
+import py
+import pytest
+
+examples_dir = py.path.local(__file__).dirpath().dirpath().dirpath('Examples')
+
+
+@pytest.fixture()
+def elfs(tmpdir_autodel):
+    for name in ('example_01.o', 'example_10.elf', 'example_16.elf',
+                 'example_16_lto.elf'):
+        examples_dir.join(name).copy(tmpdir_autodel.join(name))
+    return tmpdir_autodel
+
+
+@pytest.mark.parametrize('name', (
+    'example_10.elf',
+    'example_16.elf',
+    # Refers to objects in other compile units.
+    'example_16_lto.elf',
+))
+@pytest.mark.parametrize('args', (
+    [],
+    ['--show-all', '--show-DWARF-offset'],
+    ['--show-all', '--show-only-globals'],
+    ['--show-all', '--output=text,yaml,json'],
+    ['--share-types', '--pipeline'],
+    ['--show-summary'],
+))
+def test_same_output(diva, elfs, name, args):
+    expected = diva([name] + args, getelfs=False, cwd=elfs)
+    # Read into the cache, and then loaded from it.
+    for _ in range(2):
+        assert diva([name, '--cu-cache=cache'] + args, getelfs=False,
+                    cwd=elfs) == expected
+    assert elfs.join('cache').listdir()
+
+
+def test_changed_compile_unit(diva, elfs):
+    diva(['example_16.elf', '--cu-cache=cache', '--quiet'], getelfs=False,
+         cwd=elfs)
+    entries = set(elfs.join('cache').listdir())
+    assert len(entries) == 3
+
+    # Rename a file of one compile unit, keeping the size of the DWARF.
+    data = elfs.join('example_16.elf').read_binary()
+    elfs.join('changed.elf').write_binary(
+        data.replace(b'example_16_local.cpp', b'example_16_lokal.cpp'))
+    output = diva(['changed.elf', '--cu-cache=cache', '--show-all'],
+                  getelfs=False, cwd=elfs)
+    assert output == diva(['changed.elf', '--show-all'], getelfs=False,
+                          cwd=elfs)
+    assert '"example_16_lokal.cpp"' in output
+    # Only the changed compile unit was read again.
+    assert len(set(elfs.join('cache').listdir()) - entries) == 1
+
+
+def test_damaged_entries(diva, elfs):
+    diva(['example_16_lto.elf', '--cu-cache=cache', '--quiet'],
+         getelfs=False, cwd=elfs)
+    for entry in elfs.join('cache').listdir():
+        data = entry.read_binary()
+        entry.write_binary(data[:len(data) // 2])
+    assert diva(['example_16_lto.elf', '--cu-cache=cache', '--show-all'],
+                getelfs=False, cwd=elfs) == \
+        diva(['example_16_lto.elf', '--show-all'], getelfs=False, cwd=elfs)
+
+
+def test_object_files_not_cached(diva, elfs):
+    assert diva(['example_01.o', '--cu-cache=cache'], getelfs=False,
+                cwd=elfs) == diva(['example_01.o'], getelfs=False, cwd=elfs)
+    assert not elfs.join('cache').check()
+
+
+def test_jobs(diva, elfs):
+    args = ['example_10.elf', 'example_16.elf', '--jobs=2']
+    expected = diva(args, getelfs=False, cwd=elfs)
+    for _ in range(2):
+        assert diva(args + ['--cu-cache=cache'], getelfs=False,
+                    cwd=elfs) == expected
+
+
+def read_split_output(directory):
+    return {entry.basename: entry.read_binary()
+            for entry in directory.listdir()}
+
+
+@pytest.mark.parametrize('args', (
+    [],
+    ['--show-all', '--show-DWARF-offset', '--show-global'],
+    ['--show-all', '--tree=any=foo', '--show-level'],
+    ['--output=text,yaml,json'],
+    ['--share-types', '--show-all'],
+    ['--pipeline'],
+    ['--output-compress'],
+))
+def test_same_split_output(diva, elfs, args):
+    args = ['example_16_lto.elf'] + args
+    diva(args + ['--output-dir=expected'], getelfs=False, cwd=elfs)
+    expected = read_split_output(elfs.join('expected'))
+    # Printed into the cache, and then copied from it.
+    for run in range(2):
+        output_dir = 'output_{}'.format(run)
+        diva(args + ['--output-dir=' + output_dir, '--cu-cache=cache'],
+             getelfs=False, cwd=elfs)
+        assert read_split_output(elfs.join(output_dir)) == expected
+    assert any(entry.ext in ('.txt', '.yaml')
+               for entry in elfs.join('cache').listdir())
+
+
+def test_changed_split_output_options(diva, elfs):
+    for args in ([], ['--show-all'], ['--show-all', '--show-DWARF-offset']):
+        args = ['example_16.elf', '--output-dir=output'] + args
+        diva(args + ['--cu-cache=cache'], getelfs=False, cwd=elfs)
+        cached = read_split_output(elfs.join('output'))
+        diva(args, getelfs=False, cwd=elfs)
+        assert read_split_output(elfs.join('output')) == cached
+
+
+def test_damaged_split_output_entries(diva, elfs):
+    args = ['example_16.elf', '--output-dir=output']
+    diva(args, getelfs=False, cwd=elfs)
+    expected = read_split_output(elfs.join('output'))
+    diva(args + ['--cu-cache=cache'], getelfs=False, cwd=elfs)
+    for entry in elfs.join('cache').listdir():
+        if entry.ext == '.txt':
+            data = entry.read_binary()
+            entry.write_binary(data[:-4] + b'XXXX')
+    diva(args + ['--cu-cache=cache'], getelfs=False, cwd=elfs)
+    assert read_split_output(elfs.join('output')) == expected
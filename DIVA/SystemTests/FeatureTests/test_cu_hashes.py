@@ -0,0 +1,54 @@
+import pytest
+
+
+def test_hashes(diva):
+    assert diva('--cu-hashes example_16.elf') == """\
+61e91796cc3dc51a  example_16.cpp
+a7df812d122fde91  example_16_global.cpp
+4683fb08d0fb5c86  example_16_local.cpp
+"""
+
+
+@pytest.mark.parametrize('args', ('--sort=name', '--sort=offset',
+                                  '--pipeline', '--jobs=2'))
+def test_same_hashes(diva, args):
+    expected = sorted(diva('--cu-hashes example_16.elf').splitlines())
+    output = diva('--cu-hashes example_16.elf ' + args)
+    assert sorted(output.splitlines()) == expected
+
+
+def test_changed_file(diva):
+    old, new = (diva('--cu-hashes ' + name)
+                for name in ('scopes_org.o', 'scopes_mod.o'))
+    assert old.split()[1] == new.split()[1] == 'scopes.cpp'
+    assert old.split()[0] != new.split()[0]
+    # The changed object is not printed without --show-alias.
+    assert diva('--cu-hashes scopes_org.o --no-show-alias') == \
+        diva('--cu-hashes scopes_mod.o --no-show-alias')
+
+
+def test_summary(diva):
+    output = diva('--cu-hashes scopes_org.o --show-summary')
+    assert output.startswith('6dcf9ebd1cfddbc8  scopes.cpp\n\n')
+    assert 'Totals' in output
+
+
+@pytest.mark.parametrize('args, message', (
+    ('--cu-hashes scopes_org.o --output=yaml',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-hashes' can not be used with "
+     "'--output=yaml'."),
+    ('--cu-hashes scopes_org.o --output-dir=out',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-hashes' can not be used with "
+     "'--output-dir'."),
+    ('--cu-hashes scopes_org.o --filter-any=foo',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-hashes' can not be used with "
+     "'--filter-any'."),
+    ('--cu-hashes scopes_org.o --tree=foo',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-hashes' can not be used with "
+     "'--tree'."),
+    ('--cu-hashes --compare scopes_org.o scopes_mod.o',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--compare' can not be used with "
+     "'--cu-hashes'."),
+))
+def test_errors(diva, args, message):
+    assert diva(args, nonzero=True) == (1, '\n' + message + '\n')
@@ -0,0 +1,91 @@
+import py
+import pytest
+
+# Adjacent groups of compile units of this library end and start with objects
+# from the same source file.
+libmpich = str(py.path.local(__file__).join(
+    '../../../../ExternalDependencies/RegressionTests/legendre/'
+    'libmpich.so.1.0'))
+
+
+def save_shards(diva, command, count):
+    for index in range(count):
+        assert diva('{} --cu-shard={}/{} --save-shard=shard{}'.format(
+            command, index, count, index)) == ''
+    return ['shard{}'.format(index) for index in range(count)]
+
+
+@pytest.mark.parametrize('elf, count', [
+    (elf, count)
+    for elf in ('example_16.elf', 'example_16_lto.elf', 'example_10.elf')
+    for count in (1, 2, 5)] + [(libmpich, 3)])
+def test_same_as_pipeline(diva, elf, count):
+    command = '{} --pipeline --show-all --show-DWARF-offset --show-global' \
+        .format(elf)
+    shards = save_shards(diva, command, count)
+    merged = diva(['--merge-shards'] + shards[::-1], getelfs=False)
+    assert merged == diva(command)
+
+
+def test_processes(diva):
+    command = 'example_16.elf --pipeline --show-all'
+    shards = save_shards(diva, command + ' --processes=2', 2)
+    assert diva(['--merge-shards'] + shards, getelfs=False) == diva(command)
+
+
+def test_cu_hashes(diva):
+    command = 'example_10.elf --pipeline --cu-hashes'
+    shards = save_shards(diva, command, 2)
+    assert diva(['--merge-shards'] + shards, getelfs=False) == diva(command)
+
+
+@pytest.mark.parametrize('shards, message', (
+    (['shard0'],
+     "ERR_SHARD_MISSING: Shard 1/2 is missing."),
+    (['shard0', 'shard0', 'shard1'],
+     "ERR_SHARD_MISMATCH: Shard 'shard0' can not be merged with 'shard0'."),
+    (['shard0', 'other1'],
+     "ERR_SHARD_MISMATCH: Shard 'other1' can not be merged with 'shard0'."),
+    (['shard0', 'output.txt'],
+     "ERR_INVALID_SHARD: Failed to read shard 'output.txt', it is damaged or "
+     "from another version."),
+))
+def test_merge_errors(diva, tmpdir_autodel, shards, message):
+    save_shards(diva, 'example_10.elf --pipeline', 2)
+    assert diva('example_10.elf --pipeline --show-all --cu-shard=1/2 '
+                '--save-shard=other1') == ''
+    tmpdir_autodel.join('output.txt').write(diva('example_10.elf'))
+    assert diva(['--merge-shards'] + shards, nonzero=True,
+                getelfs=False) == (1, '\n' + message + '\n')
+
+
+@pytest.mark.parametrize('args, message', (
+    ('example_16.elf --cu-shard=0/2 --save-shard=shard0',
+     "ERR_CMD_REQUIRES_ARG: Argument '--cu-shard' can only be used with "
+     "'--pipeline'."),
+    ('example_16.elf --pipeline --cu-shard=0/2',
+     "ERR_CMD_REQUIRES_ARG: Argument '--cu-shard' can only be used with "
+     "'--save-shard'."),
+    ('example_16.elf --pipeline --save-shard=shard0',
+     "ERR_CMD_REQUIRES_ARG: Argument '--save-shard' can only be used with "
+     "'--cu-shard'."),
+    ('example_16.elf --pipeline --cu-shard=2/2 --save-shard=shard0',
+     "ERR_CMD_INVALID_VALUE: Argument '--cu-shard' was given the invalid "
+     "value '2/2'."),
+    ('example_16.elf --pipeline --cu-shard=1 --save-shard=shard0',
+     "ERR_CMD_INVALID_VALUE: Argument '--cu-shard' was given the invalid "
+     "value '1'."),
+    ('example_16.elf example_10.elf --pipeline --cu-shard=0/2 '
+     '--save-shard=shard0',
+     "ERR_CMD_SHARD_INPUTS: Argument '--cu-shard' requires one input file, "
+     "got 2."),
+    ('example_16.elf --pipeline --cu-shard=0/2 --save-shard=shard0 '
+     '--show-summary',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-shard' can not be used with "
+     "'--show-summary'."),
+    ('--merge-shards --unpack shard0',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--merge-shards' can not be used "
+     "with '--unpack'."),
+))
+def test_option_errors(diva, args, message):
+    assert diva(args, nonzero=True) == (1, '\n' + message + '\n')
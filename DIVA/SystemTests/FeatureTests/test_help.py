@@ -17,11 +17,103 @@ Output options
                                attributes
   -b  --show-brief             Print all common objects and attributes (default)
   -t  --show-summary           Print the summary table
+      --summary-only           Print only the summary table, counting the
+                               objects of one group of compile units at a time
+                               without sorting or printing them. --processes
+                               counts the groups in several processes.
+      --summary-sample=<n>     Estimate the summary table of --summary-only from
+                               <n> groups of compile units drawn at random, each
+                               with a chance in proportion to its size, printing
+                               the 95% confidence interval of each count.
+      --sample-seed=<seed>     Seed of the random draws of --summary-sample,
+                               drawing the same groups for the same seed and
+                               input file. By default 0.
   -d  --output-dir[=<dir>]     Print the output into a directory with each
                                compile unit's output in a separate file. If no
                                dir is given, then diva will use the input_file
                                string to create an output directory.
-      --output=<text|yaml>     A comma separated list of output formats.
+      --output-compress        Gzip compress each file written by --output-dir,
+                               adding a ".gz" extension.
+      --output-if-changed[=<file>]
+                               Only replace the files written by --output-dir
+                               whose contents changed, leaving the others
+                               untouched. If a file is given, the files replaced
+                               are listed in it, one per line.
+      --output-pack=<file>     Print the output into <file>, packing together
+                               the files that --output-dir would write, with an
+                               index to find each one. --output-compress
+                               compresses each of them.
+      --unpack[=<name>]        Print the file <name> from the packs written by
+                               --output-pack that are given as input files, or
+                               list the files they hold if no name is given.
+      --output-index=<file>    Write an index of the text output into <file>,
+                               giving the byte offset and line where each
+                               compile unit and each scope directly in one
+                               starts, so that a viewer can go straight to them.
+      --compress-threads=<n>   Number of threads used to compress the output of
+                               --output-compress. 0, or more than the number of
+                               cores, uses one thread per core. By default 1.
+      --output=<json|text|yaml>
+                               A comma separated list of output formats.
+      --pipeline               Read and print the compile units in groups,
+                               freeing each group once printed, to limit memory
+                               use. Only the text output is supported. The
+                               groups are printed in the order they are read,
+                               each with its own column widths.
+      --processes=<n>          Number of processes reading and printing the
+                               groups of compile units of --pipeline at once,
+                               each reading the input file on its own. The
+                               groups are printed in the order they are read. 0
+                               uses one process per core. By default 1. Only
+                               Linux runs several processes.
+      --cu-shard=<i/n>         Print only the shard <i> out of <n> of the groups
+                               of compile units of --pipeline, counting from 0,
+                               into the file given to --save-shard. The shards
+                               hold about as many bytes of the input file each.
+      --save-shard=<file>      Save the output of the shard printed by
+                               --cu-shard into <file>.
+      --merge-shards           Print the output of the shards saved by
+                               --save-shard that are given as input files, one
+                               after another, after checking that they are all
+                               the shards of the same input file and options.
+      --jobs=<n>               Number of input files read and printed at once.
+                               Each file's output is printed in the order the
+                               files are given. 0 uses one job per core. By
+                               default 1.
+      --serve                  Read diva command lines from stdin and print the
+                               output of each, keeping the input files read in
+                               memory for later command lines. Any input_file
+                               given is read before the first command line.
+      --batch=<file>           Read more input files from <file>, one per line,
+                               each optionally followed by a file to print its
+                               output into. A <file> of - reads them from stdin.
+                               The summary table is printed once for all the
+                               input files.
+      --compare                Compare the two input files, printing the objects
+                               added, removed and changed in the second. Only
+                               the text and yaml outputs are supported.
+      --cu-hashes              Print a hash of the logical view of each compile
+                               unit, followed by its name, rather than the view.
+                               The hash does not depend on the DWARF offsets or
+                               the order of the objects.
+      --share-types            Keep one copy of the members of each class,
+                               structure and union that is the same in several
+                               compile units, to save memory. The later copies
+                               are printed, and counted in the summary table,
+                               without their members. Only the text output is
+                               supported.
+      --save-snapshot=<file>   Save the tree read from the input file into
+                               <file>, which can be given as an input file to
+                               print it again without reading the DWARF. It must
+                               be printed with the same --show-void and
+                               --share-types settings.
+      --cu-cache=<dir>         Keep the compile units read from the input files
+                               in <dir>, and load those whose DWARF did not
+                               change from there rather than reading them again.
+                               Object files are not cached. The text and YAML
+                               output of each compile unit split into its own
+                               file is kept there too, and copied from there
+                               when it is printed again with the same options.
 
 Sort options
       --sort=<line|name|offset>
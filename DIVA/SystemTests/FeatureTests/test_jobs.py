@@ -0,0 +1,59 @@
+import re
+
+import py
+import pytest
+
+inputs = ('example_01.o example_02.o example_03.o example_04.o example_05.o '
+          'example_06.o example_07.o example_16.elf')
+
+
+@pytest.mark.parametrize('jobs', ('2', '4', '0'))
+def test_same_output(diva, jobs):
+    command = inputs + ' --show-all --show-summary'
+    assert diva(command + ' --jobs=' + jobs) == diva(command)
+
+
+def test_pipeline(diva):
+    command = inputs + ' --pipeline --show-all'
+    assert diva(command + ' --jobs=3') == diva(command)
+
+
+def test_invalid_file_in_order(diva):
+    # The error is reported after the output of the files before it.
+    returncode, output = diva('example_01.o not_an_elf.elf example_02.o '
+                              '--jobs=3', nonzero=True)
+    assert returncode == 1
+    assert output == diva('example_01.o') + (
+        "\nERR_INVALID_FILE: Invalid input file 'not_an_elf.elf', please "
+        "provide a file in a supported format.\n")
+
+
+@pytest.mark.parametrize('value', ('x', '-1', '12345'))
+def test_invalid_value(diva, value):
+    returncode, output = diva('example_01.o --jobs=' + value, nonzero=True)
+    assert returncode == 1
+    assert ("ERR_CMD_INVALID_VALUE: Argument '--jobs' was given the invalid "
+            "value '{}'.".format(value)) in output
+
+
+def test_read_error_in_order(diva, tmpdir_autodel):
+    # A file that fails to be read ends diva after the output of the files
+    # before it, as without --jobs.
+    diva('example_01.o example_02.o example_03.o')
+    corrupted = py.path.local(__file__).dirpath().join(
+        '..', 'StabilityTests', 'corrupted.o')
+    corrupted.copy(tmpdir_autodel.join('corrupted.o'))
+
+    def run(args):
+        returncode, output = diva(
+            'example_01.o example_02.o corrupted.o example_03.o' + args,
+            nonzero=True, getelfs=False)
+        # Debug builds also print the libdwarf error as soon as it happens.
+        return returncode, re.sub(r'DW_DLE_\w+ \(\d+\)', '', output)
+
+    expected = run('')
+    assert expected == (1, diva('example_01.o example_02.o', getelfs=False) +
+                        "\nERR_INVALID_DWARF: Failed to read DWARF from "
+                        "'corrupted.o'.\n")
+    for jobs in ('2', '4'):
+        assert run(' --jobs=' + jobs) == expected
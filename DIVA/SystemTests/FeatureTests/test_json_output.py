@@ -0,0 +1,32 @@
+import json
+
+import pytest
+
+
+@pytest.mark.parametrize('elf', ('all_objects.o', 'example_16.elf'))
+def test(diva, elf):
+    command = '{} --show-all'.format(elf)
+    json_lines = diva(command + ' --output=json').splitlines()
+    yaml_output = diva(command + ' --output=yaml')
+
+    header = json.loads(json_lines[0])
+    assert header['input_file'] == elf
+    assert header['output_version'] == '0.1'
+
+    records = [json.loads(line) for line in json_lines[1:]]
+
+    # Ids are sequential and each parent is printed before its children.
+    seen = set()
+    for expected_id, record in enumerate(records, start=1):
+        assert record['id'] == expected_id
+        assert record['parent'] is None or record['parent'] in seen
+        seen.add(record['id'])
+        for key in ('object', 'name', 'type', 'line', 'file', 'offset', 'tag',
+                    'attributes'):
+            assert key in record
+
+    # The same objects are printed as in the YAML output.
+    yaml_objects = [line.split('object: ')[1].strip('"')
+                    for line in yaml_output.splitlines()
+                    if line.lstrip().startswith('- object: ')]
+    assert [record['object'] for record in records] == yaml_objects
@@ -0,0 +1,66 @@
+import pytest
+
+
+def check_index(output, index):
+    data = output.encode()
+    lines = data.split(b'\n')
+    entries = [line.split('\t') for line in index.splitlines()]
+    for offset, line, kind, name in entries:
+        text = data[int(offset):].split(b'\n')[0]
+        assert text == lines[int(line) - 1]
+        assert '{' + kind + '} "' + name + '"' in text.decode()
+    return [(kind, name) for _, _, kind, name in entries]
+
+
+@pytest.mark.parametrize('args', (
+    [],
+    ['--pipeline'],
+    ['--show-all', '--show-summary'],
+    ['--output=text,yaml'],
+))
+def test_index_positions(diva, tmpdir_autodel, args):
+    output = diva(['example_16.elf', '--output-index=out.idx'] + args)
+    entries = check_index(output, tmpdir_autodel.join('out.idx').read())
+    # --pipeline prints the compile units in the order they are read.
+    assert sorted(entries) == sorted([
+        ('CompileUnit', 'example_16.cpp'),
+        ('Function', 'main'),
+        ('CompileUnit', 'example_16_global.cpp'),
+        ('Class', 'Global'),
+        ('Function', 'foo'),
+        ('CompileUnit', 'example_16_local.cpp'),
+        ('Class', 'Global'),
+        ('Class', 'Local'),
+        ('Function', 'foo'),
+        ('Function', 'do_local'),
+        ('Function', 'do_global'),
+    ])
+
+
+def test_several_inputs(diva, tmpdir_autodel):
+    output = diva(['example_16.elf', 'example_10.elf', '--jobs=2',
+                   '--output-index=out.idx'])
+    entries = check_index(output, tmpdir_autodel.join('out.idx').read())
+    assert [name for kind, name in entries if kind == 'CompileUnit'] == [
+        'example_16.cpp', 'example_16_global.cpp', 'example_16_local.cpp',
+        'example_10_lib.cpp', 'example_10_main.cpp']
+
+
+def test_filtered_objects_left_out(diva, tmpdir_autodel):
+    output = diva(['example_16.elf', '--filter=do_local',
+                   '--output-index=out.idx'])
+    entries = check_index(output, tmpdir_autodel.join('out.idx').read())
+    assert entries == [('Function', 'do_local')]
+
+
+@pytest.mark.parametrize('args, other', (
+    (['--output-dir=split'], '--output-dir'),
+    (['--output-pack=out.pack'], '--output-pack'),
+    (['--output=yaml'], '--output'),
+    (['--cu-hashes'], '--cu-hashes'),
+))
+def test_incompatible_args(diva, tmpdir_autodel, args, other):
+    assert diva(['example_16.elf', '--output-index=out.idx'] + args,
+                nonzero=True) == \
+        (1, "\nERR_CMD_INCOMPATIBLE_ARGS: Argument '--output-index' can not "
+            "be used with '" + other + "'.\n")
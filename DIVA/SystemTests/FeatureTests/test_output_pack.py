@@ -0,0 +1,65 @@
+import gzip
+
+import pytest
+
+outfiles = (
+    'example_16_cpp',
+    'example_16_global_cpp',
+    'example_16_local_cpp',
+)
+
+
+@pytest.mark.parametrize('args', (
+    [],
+    ['--output-compress'],
+    ['--pipeline'],
+    ['--show-all', '--output=text,yaml'],
+))
+def test_same_as_split_output(diva, tmpdir_autodel, args):
+    command = ['example_16.elf'] + args
+    assert diva(command + ['--output-dir=split']) == ''
+    assert diva(command + ['--output-pack=out.pack']) == ''
+
+    split_dir = tmpdir_autodel.join('split')
+    names = sorted(entry.basename.replace('.gz', '')
+                   for entry in split_dir.listdir())
+    listing = diva(['--unpack', 'out.pack'], getelfs=False)
+    assert sorted(line.split('  ')[1] for line in listing.splitlines()) == \
+        names
+    for name in names:
+        if '--output-compress' in args:
+            with gzip.open(str(split_dir.join(name + '.gz')), 'rt') as f:
+                expected = f.read()
+        else:
+            expected = split_dir.join(name).read()
+        assert diva(['--unpack=' + name, 'out.pack'],
+                    getelfs=False) == expected
+
+
+def test_several_inputs(diva, tmpdir_autodel):
+    assert diva(['example_16.elf', 'example_10.elf',
+                 '--output-pack=out.pack', '--jobs=2']) == ''
+    listing = diva(['--unpack', 'out.pack'], getelfs=False)
+    assert sorted(line.split('  ')[1] for line in listing.splitlines()) == \
+        sorted([name + '.txt' for name in outfiles] +
+               ['example_10_lib_cpp.txt', 'example_10_main_cpp.txt'])
+
+
+@pytest.mark.parametrize('args, message', (
+    (['--unpack=missing.txt', 'out.pack'],
+     "ERR_PACK_ENTRY_NOT_FOUND: No file 'missing.txt' in output pack "
+     "'out.pack'."),
+    (['--unpack', 'example_16.elf'],
+     "ERR_INVALID_PACK: Failed to read output pack 'example_16.elf', it is "
+     "damaged or from another version."),
+    (['example_16.elf', '--output-pack=out.pack', '--output-dir=split'],
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--output-pack' can not be used "
+     "with '--output-dir'."),
+    (['--unpack', '--output-pack=other.pack', 'out.pack'],
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--unpack' can not be used with "
+     "'--output-pack'."),
+))
+def test_errors(diva, tmpdir_autodel, args, message):
+    diva(['example_16.elf', '--output-pack=out.pack'])
+    assert diva(args, nonzero=True, getelfs=False) == \
+        (1, '\n' + message + '\n')
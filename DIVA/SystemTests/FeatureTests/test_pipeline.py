@@ -0,0 +1,51 @@
+import pytest
+
+
+def _words(text):
+    # The column widths of each group of compile units can differ, so only
+    # compare the text of each line.
+    return sorted(' '.join(line.split()) for line in text.splitlines())
+
+
+@pytest.mark.parametrize('elf', ('example_16.elf', 'example_10.elf'))
+def test_same_objects(diva, elf):
+    command = '{} --show-all --show-DWARF-offset --show-global'.format(elf)
+    assert _words(diva(command + ' --pipeline')) == _words(diva(command))
+
+
+def test_cross_cu_references(diva):
+    # The LTO compile units reference each other so are read and printed as
+    # one group, giving the same output as reading the whole file.
+    command = 'example_16_lto.elf --show-all --show-DWARF-offset --show-global'
+    assert diva(command + ' --pipeline') == diva(command)
+
+
+def test_split(diva, tmpdir_autodel):
+    split_dir = tmpdir_autodel.join('split')
+    pipeline_dir = tmpdir_autodel.join('pipeline')
+
+    assert diva('example_16.elf --output-dir={}'.format(split_dir)) == ''
+    assert diva('example_16.elf --pipeline --output-dir={}'.format(
+        pipeline_dir)) == ''
+
+    outfiles = ('example_16_cpp.txt', 'example_16_global_cpp.txt',
+                'example_16_local_cpp.txt')
+    for outfile in outfiles:
+        assert pipeline_dir.join(outfile).check(file=True)
+        assert _words(pipeline_dir.join(outfile).read()) == \
+            _words(split_dir.join(outfile).read())
+
+
+def test_summary(diva):
+    command = 'example_16.elf --show-summary --quiet'
+    assert diva(command + ' --pipeline') == diva(command)
+
+
+@pytest.mark.parametrize('option', ('--output=yaml', '--output=json',
+                                    '--scope-allocation'))
+def test_incompatible(diva, option):
+    returncode, output = diva('example_16.elf --pipeline {}'.format(option),
+                              nonzero=True)
+    assert returncode == 1
+    assert ("ERR_CMD_INCOMPATIBLE_ARGS: Argument '--pipeline' can not be used "
+            "with '{}'.".format(option)) in output
@@ -0,0 +1,57 @@
+import py
+import pytest
+
+# Adjacent groups of compile units of this library end and start with objects
+# from the same source file.
+libmpich = str(py.path.local(__file__).join(
+    '../../../../ExternalDependencies/RegressionTests/legendre/'
+    'libmpich.so.1.0'))
+
+
+@pytest.mark.parametrize('elf, processes', [
+    (elf, processes)
+    for elf in ('example_16.elf', 'example_16_lto.elf', 'example_10.elf')
+    for processes in ('2', '4', '0')] + [(libmpich, '4')])
+def test_same_as_pipeline(diva, elf, processes):
+    command = '{} --pipeline --show-all --show-DWARF-offset --show-global' \
+        .format(elf)
+    assert diva(command + ' --processes=' + processes) == diva(command)
+
+
+def test_cu_hashes(diva):
+    command = 'example_16.elf --pipeline --cu-hashes'
+    assert diva(command + ' --processes=3') == diva(command)
+
+
+def test_split(diva, tmpdir_autodel):
+    pipeline_dir = tmpdir_autodel.join('pipeline')
+    processes_dir = tmpdir_autodel.join('processes')
+
+    assert diva('example_16.elf --pipeline --output-dir={}'.format(
+        pipeline_dir)) == ''
+    assert diva('example_16.elf --pipeline --processes=2 --output-dir={}'
+                .format(processes_dir)) == ''
+
+    outfiles = ('example_16_cpp.txt', 'example_16_global_cpp.txt',
+                'example_16_local_cpp.txt')
+    for outfile in outfiles:
+        assert processes_dir.join(outfile).read() == \
+            pipeline_dir.join(outfile).read()
+
+
+def test_requires_pipeline(diva):
+    assert diva('example_16.elf --processes=2', nonzero=True) == \
+        (1, "\nERR_CMD_REQUIRES_ARG: Argument '--processes' can only be used "
+            "with '--pipeline'.\n")
+
+
+@pytest.mark.parametrize('option', ('--jobs=2', '--show-summary',
+                                    '--output-pack=out.pack',
+                                    '--output-index=out.idx'))
+def test_incompatible(diva, option):
+    returncode, output = diva(
+        'example_16.elf --pipeline --processes=2 {}'.format(option),
+        nonzero=True)
+    assert returncode == 1
+    assert ("ERR_CMD_INCOMPATIBLE_ARGS: Argument '--processes' can not be "
+            "used with '{}'.".format(option.split('=')[0])) in output
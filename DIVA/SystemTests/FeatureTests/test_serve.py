@@ -0,0 +1,95 @@
+import py
+import pytest
+import subprocess
+
+examples_dir = py.path.local(__file__).dirpath().dirpath().dirpath('Examples')
+
+
+def _serve(cwd, command_lines, args=()):
+    # Run a server for the command lines, returning each (exit code, output).
+    proc = subprocess.Popen(
+        ['diva', '--serve'] + list(args),
+        cwd=str(cwd),
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+    )
+    stdout, _ = proc.communicate(
+        ''.join(line + '\n' for line in command_lines).encode())
+    assert proc.returncode == 0, stdout
+
+    results = []
+    while stdout:
+        header, stdout = stdout.split(b'\n', 1)
+        result, exit_code, size = header.decode().split(' ')
+        assert result == 'Result:'
+        results.append((int(exit_code), stdout[:int(size)].decode()))
+        stdout = stdout[int(size):]
+    return results
+
+
+@pytest.fixture()
+def elfs(tmpdir_autodel):
+    for name in ('example_01.o', 'example_02.o', 'example_16.elf'):
+        examples_dir.join(name).copy(tmpdir_autodel.join(name))
+    return tmpdir_autodel
+
+
+commands = (
+    'example_16.elf',
+    'example_16.elf --show-all --show-DWARF-offset',
+    'example_16.elf --filter=foo --show-summary',
+    'example_16.elf --tree-any=a --no-show-void --sort=name',
+    'example_16.elf --output=json',
+    'example_01.o example_02.o --sort=offset',
+)
+
+
+def test_same_output(diva, elfs):
+    results = _serve(elfs, commands, args=['example_16.elf'])
+    assert results == [(0, diva(command, getelfs=False, cwd=elfs))
+                       for command in commands]
+
+
+def test_errors(elfs):
+    results = _serve(elfs, ['--bogus', 'missing.o', '--pipeline example_01.o',
+                            'example_01.o --filter=foo'])
+    assert results[:3] == [
+        (1, "\nERR_CMD_UNKNOWN_ARG: Unknown argument '--bogus'.\n"),
+        (1, "\nERR_FILE_NOT_FOUND: Unable to open file 'missing.o'.\n"),
+        (1, "\nERR_CMD_INCOMPATIBLE_ARGS: Argument '--pipeline' can not be "
+            "used with '--serve'.\n"),
+    ]
+    # The server carries on after an error.
+    assert results[3][0] == 0
+    assert '{Function} "foo"' in results[3][1]
+
+
+def test_quoted_arguments(diva, elfs):
+    results = _serve(elfs, ['example_16.elf "--filter-any=unsigned int"'])
+    assert results == [
+        (0, diva(['example_16.elf', '--filter-any=unsigned int'],
+                 getelfs=False, cwd=elfs))]
+
+
+def test_reread_changed_file(elfs):
+    proc = subprocess.Popen(['diva', '--serve'], cwd=str(elfs),
+                            stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                            universal_newlines=True)
+
+    def query():
+        proc.stdin.write('input.o\n')
+        proc.stdin.flush()
+        header = proc.stdout.readline()
+        return proc.stdout.read(int(header.split()[2]))
+
+    # Replace the file between command lines.
+    examples_dir.join('example_01.o').copy(elfs.join('input.o'))
+    first = query()
+    examples_dir.join('example_02.o').copy(elfs.join('input.o'))
+    second = query()
+    proc.stdin.close()
+    assert proc.wait() == 0
+
+    assert '"example_01.cpp"' in first
+    assert '"example_02.cpp"' in second
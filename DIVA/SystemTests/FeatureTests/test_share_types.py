@@ -0,0 +1,72 @@
+import pytest
+
+
+def test_shared_type(diva):
+    output = diva('example_16.elf --share-types')
+    assert output.endswith("""\
+    {CompileUnit} "example_16_local.cpp"
+
+{Source} "example_16_global.h"
+ 2    {Class} "Global"
+          - Members printed in "example_16_global.cpp"
+
+{Source} "example_16_local.h"
+ 2    {Class} "Local"
+ 4      {Function} "Local::foo" -> "int"
+            - Is declaration
+          {Parameter} "" -> "Local *"
+          {Parameter} "" -> "int"
+ 6      {Member} private "m_l" -> "int"
+ 4    {Function} "foo" -> "int"
+          - Declaration @ example_16_local.h,4
+        {Parameter} "this" -> "Local *"
+
+{Source} "example_16_local.cpp"
+ 5      {Parameter} "l" -> "int"
+12    {Function} "do_local" -> "int"
+          - No declaration
+12      {Parameter} "l" -> "int"
+14      {Variable} "local" -> "Local"
+19    {Function} "do_global" -> "int"
+          - No declaration
+19      {Parameter} "g" -> "int"
+21      {Variable} "global" -> "Global"
+""")
+    # The later copy of the type is printed without its members, which are
+    # only printed with the first copy.
+    members = (' 4      {Function} "Global::foo" -> "int"\n'
+               '            - Is declaration\n'
+               '          {Parameter} "" -> "Global *"\n'
+               '          {Parameter} "" -> "int"\n'
+               ' 6      {Member} private "m_g" -> "int"\n')
+    expected = diva('example_16.elf')
+    later = expected.rindex(members)
+    assert output == (expected[:later] +
+                      '          - Members printed in "example_16_global.cpp"\n' +
+                      expected[later + len(members):])
+
+
+def test_summary(diva):
+    # The members of the later copy of the type are not counted.
+    output = diva('example_16.elf --share-types --show-summary')
+    assert '     Member                     2        2\n' in output
+    assert '     Totals                    51       29\n' in output
+    assert '     Totals                    55       33\n' in \
+        diva('example_16.elf --show-summary')
+
+
+def test_no_shared_types(diva):
+    assert diva('example_01.o --share-types --show-all') == \
+        diva('example_01.o --show-all')
+
+
+@pytest.mark.parametrize('args, message', (
+    ('example_16.elf --share-types --output=yaml',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--share-types' can not be used "
+     "with '--output=yaml'."),
+    ('example_16.elf --share-types --cu-hashes',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--share-types' can not be used "
+     "with '--cu-hashes'."),
+))
+def test_errors(diva, args, message):
+    assert diva(args, nonzero=True) == (1, '\n' + message + '\n')
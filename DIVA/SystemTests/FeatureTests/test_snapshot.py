@@ -0,0 +1,76 @@
+import py
+import pytest
+
+examples_dir = py.path.local(__file__).dirpath().dirpath().dirpath('Examples')
+
+
+@pytest.fixture()
+def elf(tmpdir_autodel):
+    examples_dir.join('example_16.elf').copy(
+        tmpdir_autodel.join('example_16.elf'))
+    return tmpdir_autodel
+
+
+@pytest.mark.parametrize('args', (
+    [],
+    ['--show-all'],
+    ['--show-all', '--sort=name'],
+    ['--show-all', '--no-show-void', '--show-DWARF-offset'],
+    ['--show-all', '--output=text,yaml,json'],
+    ['--share-types'],
+    ['--show-summary'],
+    ['--cu-hashes'],
+))
+def test_same_output(diva, elf, args):
+    output = diva(['example_16.elf', '--save-snapshot=out/16.snap'] + args,
+                  getelfs=False, cwd=elf)
+    assert output == diva(['example_16.elf'] + args, getelfs=False, cwd=elf)
+    # The output only differs in the name of the input file.
+    loaded = diva(['out/16.snap'] + args, getelfs=False, cwd=elf)
+    assert loaded == output.replace('example_16.elf', 'out/16.snap')
+
+
+def test_other_sort(diva, elf):
+    diva(['example_16.elf', '--save-snapshot=16.snap', '--quiet'],
+         getelfs=False, cwd=elf)
+    assert diva(['16.snap', '--sort=offset', '--show-all'], getelfs=False,
+                cwd=elf) == \
+        diva(['example_16.elf', '--sort=offset', '--show-all'], getelfs=False,
+             cwd=elf).replace('example_16.elf', '16.snap')
+
+
+@pytest.mark.parametrize('save_args, load_args, message', (
+    ('--no-show-void', '',
+     "ERR_SNAPSHOT_SETTINGS: Snapshot '16.snap' can only be read with "
+     "'--no-show-void'."),
+    ('', '--share-types',
+     "ERR_SNAPSHOT_SETTINGS: Snapshot '16.snap' can only be read with "
+     "'--no-share-types'."),
+))
+def test_different_settings(diva, elf, save_args, load_args, message):
+    diva(['example_16.elf', '--save-snapshot=16.snap', '--quiet'] +
+         save_args.split(), getelfs=False, cwd=elf)
+    assert diva(['16.snap'] + load_args.split(), nonzero=True, getelfs=False,
+                cwd=elf) == (1, '\n' + message + '\n')
+
+
+def test_damaged(diva, elf):
+    diva(['example_16.elf', '--save-snapshot=16.snap', '--quiet'],
+         getelfs=False, cwd=elf)
+    data = elf.join('16.snap').read_binary()
+    elf.join('16.snap').write_binary(data[:len(data) // 2])
+    assert diva(['16.snap'], nonzero=True, getelfs=False, cwd=elf) == \
+        (1, "\nERR_INVALID_SNAPSHOT: Failed to read snapshot '16.snap', it is "
+            "damaged or from another version.\n")
+
+
+@pytest.mark.parametrize('args, message', (
+    ('example_01.o example_02.o --save-snapshot=a.snap',
+     "ERR_CMD_SNAPSHOT_INPUTS: Argument '--save-snapshot' requires one input "
+     "file, got 2."),
+    ('example_01.o --save-snapshot=a.snap --pipeline',
+     "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--save-snapshot' can not be used "
+     "with '--pipeline'."),
+))
+def test_errors(diva, args, message):
+    assert diva(args, nonzero=True) == (1, '\n' + message + '\n')
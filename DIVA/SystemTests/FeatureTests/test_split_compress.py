@@ -0,0 +1,28 @@
+import gzip
+
+import pytest
+
+
+@pytest.mark.parametrize('threads', ('1', '4'))
+@pytest.mark.parametrize('fmt,ext', (('text', 'txt'), ('yaml', 'yaml')))
+def test(diva, tmpdir_autodel, threads, fmt, ext):
+    plain_dir = tmpdir_autodel.join('plain')
+    compressed_dir = tmpdir_autodel.join('compressed')
+
+    command = 'example_16.elf --show-all --output={}'.format(fmt)
+    assert diva(command + ' --output-dir={}'.format(plain_dir)) == ''
+    assert diva(command + ' --output-dir={} --output-compress '
+                '--compress-threads={}'.format(compressed_dir, threads)) == ''
+
+    outfiles = (
+        'example_16_cpp',
+        'example_16_global_cpp',
+        'example_16_local_cpp'
+    )
+    for outfile in outfiles:
+        plain = plain_dir.join(outfile + '.' + ext)
+        compressed = compressed_dir.join(outfile + '.' + ext + '.gz')
+        assert not compressed_dir.join(outfile + '.' + ext).check()
+        assert compressed.check(file=True)
+        with gzip.open(str(compressed), 'rt') as f:
+            assert f.read() == plain.read()
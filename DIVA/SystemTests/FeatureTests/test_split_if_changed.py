@@ -0,0 +1,71 @@
+import pytest
+
+outfiles = (
+    'example_16_cpp.txt',
+    'example_16_global_cpp.txt',
+    'example_16_local_cpp.txt',
+)
+
+
+def modified_times(directory):
+    return {name: directory.join(name).mtime() for name in outfiles}
+
+
+@pytest.mark.parametrize('args', ([], ['--pipeline'], ['--jobs=2']))
+def test_unchanged_files_kept(diva, tmpdir_autodel, args):
+    output_dir = tmpdir_autodel.join('output')
+    changed_list = tmpdir_autodel.join('changed.txt')
+    command = ['example_16.elf', '--output-dir={}'.format(output_dir),
+               '--output-if-changed={}'.format(changed_list)] + args
+    assert diva(command) == ''
+    assert changed_list.read().splitlines() == \
+        sorted(str(output_dir.join(name)) for name in outfiles)
+    expected = {name: output_dir.join(name).read() for name in outfiles}
+
+    # Make the files look older, so that a rewrite would be seen.
+    for name in outfiles:
+        output_dir.join(name).setmtime(1000000000)
+    assert diva(command) == ''
+    assert changed_list.read() == ''
+    assert set(modified_times(output_dir).values()) == {1000000000}
+    assert {name: output_dir.join(name).read() for name in outfiles} == \
+        expected
+
+
+def test_changed_file_replaced(diva, tmpdir_autodel):
+    output_dir = tmpdir_autodel.join('output')
+    changed_list = tmpdir_autodel.join('changed.txt')
+    command = ['example_16.elf', '--output-dir={}'.format(output_dir),
+               '--output-if-changed={}'.format(changed_list)]
+    assert diva(command) == ''
+    expected = output_dir.join(outfiles[1]).read()
+    output_dir.join(outfiles[1]).write('changed')
+    for name in outfiles:
+        output_dir.join(name).setmtime(1000000000)
+
+    assert diva(command) == ''
+    assert changed_list.read() == str(output_dir.join(outfiles[1])) + '\n'
+    assert output_dir.join(outfiles[1]).read() == expected
+    times = modified_times(output_dir)
+    assert times[outfiles[1]] != 1000000000
+    assert times[outfiles[0]] == times[outfiles[2]] == 1000000000
+
+
+def test_same_output(diva, tmpdir_autodel):
+    plain_dir = tmpdir_autodel.join('plain')
+    if_changed_dir = tmpdir_autodel.join('if_changed')
+    command = ['example_16.elf', '--show-all', '--output=text,yaml']
+    assert diva(command + ['--output-dir={}'.format(plain_dir)]) == ''
+    assert diva(command + ['--output-dir={}'.format(if_changed_dir),
+                           '--output-if-changed']) == ''
+    assert sorted(entry.basename for entry in if_changed_dir.listdir()) == \
+        sorted(entry.basename for entry in plain_dir.listdir())
+    for entry in plain_dir.listdir():
+        assert if_changed_dir.join(entry.basename).read() == entry.read()
+
+
+def test_serve(diva):
+    assert diva(['--serve', '--output-if-changed=changed.txt'],
+                nonzero=True) == \
+        (1, "\nERR_CMD_INCOMPATIBLE_ARGS: Argument '--output-if-changed' can "
+            "not be used with '--serve'.\n")
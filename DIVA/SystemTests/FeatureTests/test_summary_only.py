@@ -0,0 +1,31 @@
+import pytest
+
+
+@pytest.mark.parametrize('elf', ('example_16.elf', 'example_16_lto.elf',
+                                 'example_10.elf'))
+@pytest.mark.parametrize('args', ('', '--show-all', '--show-only-globals',
+                                  '--show-only-locals --no-show-codeline'))
+def test_same_as_show_summary(diva, elf, args):
+    command = '{} {}'.format(elf, args).strip()
+    expected = diva(command + ' --show-summary --quiet').lstrip('\n')
+    assert diva(command + ' --summary-only') == expected
+    assert diva(command + ' --summary-only --processes=3') == expected
+
+
+def test_batch(diva, tmpdir_autodel):
+    batch = tmpdir_autodel.join('batch.txt')
+    batch.write('example_16.elf\nexample_10.elf\n')
+    diva('example_16.elf example_10.elf')
+    assert diva('--batch=batch.txt --summary-only') == \
+        diva('--batch=batch.txt --show-summary --quiet')
+
+
+@pytest.mark.parametrize('option', ('--output-dir', '--output=yaml',
+                                    '--output-pack=out.pack', '--cu-hashes',
+                                    '--share-types'))
+def test_incompatible(diva, option):
+    returncode, output = diva(
+        'example_16.elf --summary-only {}'.format(option), nonzero=True)
+    assert returncode == 1
+    assert ("ERR_CMD_INCOMPATIBLE_ARGS: Argument '--summary-only' can not be "
+            "used with '{}'.".format(option.split('=')[0])) in output
@@ -0,0 +1,46 @@
+import re
+
+import pytest
+
+
+def test_same_as_summary_only_with_all_groups(diva):
+    # example_16.elf has 3 groups of compile units.
+    assert diva('example_16.elf --summary-only --summary-sample=3') == \
+        diva('example_16.elf --summary-only')
+
+
+@pytest.mark.parametrize('args', ('', '--processes=2', '--sample-seed=0'))
+def test_estimate(diva, args):
+    output = diva('example_16.elf --summary-only --summary-sample=2 ' + args)
+    assert output == diva('example_16.elf --summary-only --summary-sample=2')
+    assert re.search(r'^     Object +Total +\+/- +Printed +\+/-$', output,
+                     re.MULTILINE)
+    assert re.search(r'^     Totals( +\d+){4}$', output, re.MULTILINE)
+    assert 'Estimated from 2 draws of 3 groups of compile units.' in output
+    assert '+/- is the 95% confidence interval of each estimate.' in output
+
+
+def test_seed(diva):
+    outputs = set(
+        diva('example_16.elf --summary-only --summary-sample=2 '
+             '--sample-seed={}'.format(seed)) for seed in range(8))
+    assert len(outputs) > 1
+
+
+@pytest.mark.parametrize('args, message', (
+    ('--summary-only --summary-sample=1',
+     "ERR_CMD_INVALID_VALUE: Argument '--summary-sample' was given the "
+     "invalid value '1'."),
+    ('--summary-only --summary-sample=2 --sample-seed=x',
+     "ERR_CMD_INVALID_VALUE: Argument '--sample-seed' was given the invalid "
+     "value 'x'."),
+    ('--summary-sample=2',
+     "ERR_CMD_REQUIRES_ARG: Argument '--summary-sample' can only be used "
+     "with '--summary-only'."),
+    ('--summary-only --sample-seed=1',
+     "ERR_CMD_REQUIRES_ARG: Argument '--sample-seed' can only be used with "
+     "'--summary-sample'."),
+))
+def test_errors(diva, args, message):
+    assert diva('example_16.elf ' + args, nonzero=True) == \
+        (1, '\n' + message + '\n')
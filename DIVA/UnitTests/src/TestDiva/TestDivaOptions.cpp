@@ -48,8 +48,24 @@ TEST(DivaOptions, Defaults) {
 
   EXPECT_FALSE(DOptForQuietDefault.PrintingSettings.QuietMode);
   EXPECT_FALSE(DOpt.ShowSummary);
+  EXPECT_FALSE(DOpt.Pipeline);
+  EXPECT_EQ(DOpt.Jobs, 1u);
+  EXPECT_FALSE(DOpt.Serve);
+  EXPECT_TRUE(DOpt.BatchFile.empty());
+  EXPECT_FALSE(DOpt.Compare);
+  EXPECT_FALSE(DOpt.CUHashes);
+  EXPECT_FALSE(PSet.ShareTypes);
+  EXPECT_TRUE(DOpt.SnapshotFile.empty());
+  EXPECT_TRUE(DOpt.CUCacheDirectory.empty());
   EXPECT_FALSE(PSet.SplitOutput);
   EXPECT_TRUE(PSet.OutputDirectory.empty());
+  EXPECT_FALSE(PSet.CompressOutput);
+  EXPECT_EQ(PSet.CompressionThreads, 1u);
+  EXPECT_FALSE(PSet.WriteOnlyChangedOutput);
+  EXPECT_TRUE(DOpt.ChangedFilesList.empty());
+  EXPECT_TRUE(DOpt.OutputPackFile.empty());
+  EXPECT_TRUE(DOpt.OutputIndexFile.empty());
+  EXPECT_FALSE(DOpt.Unpack);
   EXPECT_EQ(DOpt.OutputFormats, std::set<OutputFormat>({OutputFormat::TEXT}));
 
   EXPECT_EQ(PSet.SortKey, LibScopeView::SortingKey::LINE);
@@ -129,6 +145,43 @@ TEST(DivaOptions, OutputDir) {
   }
 }
 
+TEST(DivaOptions, OutputCompress) {
+  std::stringstream Output;
+
+  {
+    DivaOptions DOpt({"-d", "--output-compress"}, Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_TRUE(DOpt.PrintingSettings.CompressOutput);
+    EXPECT_EQ(DOpt.PrintingSettings.CompressionThreads, 1u);
+  }
+  {
+    DivaOptions DOpt({"-d", "--output-compress", "--compress-threads=4"},
+                     Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_TRUE(DOpt.PrintingSettings.CompressOutput);
+    EXPECT_EQ(DOpt.PrintingSettings.CompressionThreads, 4u);
+  }
+  {
+    DivaOptions DOpt({"--compress-threads=0"}, Output, Output, Output);
+    EXPECT_EQ(DOpt.PrintingSettings.CompressionThreads, 0u);
+  }
+}
+
+TEST(DivaOptions, Jobs) {
+  std::stringstream Output;
+
+  {
+    DivaOptions DOpt({"--jobs=4"}, Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.Jobs, 4u);
+  }
+  {
+    DivaOptions DOpt({"--jobs=0"}, Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.Jobs, 0u);
+  }
+}
+
 TEST(DivaOptions, EarlyExitArgs) {
   std::stringstream Output;
   // Version.
@@ -178,6 +231,12 @@ TEST(DivaOptions, OutputFormat) {
     EXPECT_EQ(DOpt.OutputFormats,
               std::set<OutputFormat>({OutputFormat::TEXT, OutputFormat::YAML}));
   }
+
+  {
+    DivaOptions DOpt({"--output=json"}, Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.OutputFormats, std::set<OutputFormat>({OutputFormat::JSON}));
+  }
 }
 
 TEST(DivaOptions, Sorting) {
@@ -212,15 +271,10 @@ TEST(DivaOptions, Filters) {
   EXPECT_EQ(DOpt.PrintingSettings.TreeFilterAnys,
             std::vector<std::string>({"ta1", "ta2", "ta3"}));
 
-  ASSERT_EQ(DOpt.PrintingSettings.Filters.size(), 3U);
-  EXPECT_TRUE(std::regex_match("f1", DOpt.PrintingSettings.Filters[0]));
-  EXPECT_TRUE(std::regex_match("f2", DOpt.PrintingSettings.Filters[1]));
-  EXPECT_TRUE(std::regex_match("f3", DOpt.PrintingSettings.Filters[2]));
-
-  ASSERT_EQ(DOpt.PrintingSettings.TreeFilters.size(), 3U);
-  EXPECT_TRUE(std::regex_match("t1", DOpt.PrintingSettings.TreeFilters[0]));
-  EXPECT_TRUE(std::regex_match("t2", DOpt.PrintingSettings.TreeFilters[1]));
-  EXPECT_TRUE(std::regex_match("t3", DOpt.PrintingSettings.TreeFilters[2]));
+  EXPECT_EQ(DOpt.PrintingSettings.Filters,
+            std::vector<std::string>({"f1", "f2", "f3"}));
+  EXPECT_EQ(DOpt.PrintingSettings.TreeFilters,
+            std::vector<std::string>({"t1", "t2", "t3"}));
 }
 
 TEST(DivaOptions, ShowNone) {
@@ -306,6 +360,11 @@ TEST(DivaOptions, FlagArguments) {
 
   CHECK_FLAG("quiet", PrintingSettings.QuietMode);
   CHECK_FLAG("show-summary", ShowSummary);
+  CHECK_FLAG("output-compress", PrintingSettings.CompressOutput);
+  CHECK_FLAG("pipeline", Pipeline);
+  CHECK_FLAG("serve", Serve);
+  CHECK_FLAG("cu-hashes", CUHashes);
+  CHECK_FLAG("share-types", PrintingSettings.ShareTypes);
 
   CHECK_FLAG("show-alias", PrintingSettings.ShowAlias);
   CHECK_FLAG("show-block", PrintingSettings.ShowBlock);
@@ -386,4 +445,103 @@ TEST(DivaOptions, Errors) {
       ExitedWithCode(1),
       "ERR_CMD_INVALID_VALUE: Argument '--output' was given the invalid value "
       "'bad'.");
+
+  // Invalid number.
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--compress-threads=two"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INVALID_VALUE: Argument '--compress-threads' was given the "
+      "invalid value 'two'.");
+  EXPECT_EXIT(
+      { DivaOptions DOpt1({"--jobs=-2"}, Output, Output, std::cerr); },
+      ExitedWithCode(1),
+      "ERR_CMD_INVALID_VALUE: Argument '--jobs' was given the invalid value "
+      "'-2'.");
+
+  // Incompatible arguments.
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--pipeline", "--output=text,yaml"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--pipeline' can not be used with "
+      "'--output=yaml'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--pipeline", "--scope-allocation"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--pipeline' can not be used with "
+      "'--scope-allocation'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--serve", "--pipeline"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--pipeline' can not be used with "
+      "'--serve'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--serve", "--batch=-"}, Output, Output, std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--batch' can not be used with "
+      "'--serve'.");
+  // A command line sent to the server can compare, but not cache.
+  EXPECT_TRUE(DivaOptions({"--compare", "a.o", "b.o"}, Output, Output,
+                          std::cerr, /*Serving*/ true)
+                  .Compare);
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--cu-cache=dir", "a.o"}, Output, Output,
+                          std::cerr, /*Serving*/ true);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-cache' can not be used with "
+      "'--serve'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--compare", "a.o", "b.o", "--show-summary"},
+                          Output, Output, std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--compare' can not be used with "
+      "'--show-summary'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--compare", "a.o"}, Output, Output, std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_COMPARE_INPUTS: Argument '--compare' requires two input files, "
+      "got 1.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--cu-hashes", "--output=json"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--cu-hashes' can not be used with "
+      "'--output=json'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--share-types", "--output=json"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_INCOMPATIBLE_ARGS: Argument '--share-types' can not be used "
+      "with '--output=json'.");
+  EXPECT_EXIT(
+      {
+        DivaOptions DOpt1({"--save-snapshot=a.snap"}, Output, Output,
+                          std::cerr);
+      },
+      ExitedWithCode(1),
+      "ERR_CMD_SNAPSHOT_INPUTS: Argument '--save-snapshot' requires one input "
+      "file, got 0.");
 }
@@ -0,0 +1,82 @@
+//===-- UnitTests/TestLibScopeView/TestDwarfNames.cpp -----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for the LibScopeView DWARF name tables.
+///
+//===----------------------------------------------------------------------===//
+
+#include "DwarfNames.h"
+
+#include "dwarf.h"
+#include "dwarf_names.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Check every possible value has the same name as given by libdwarf.
+void checkAgainstLibDwarf(const DwarfName &(*GetName)(Dwarf_Half),
+                          int (*GetLibDwarfName)(unsigned int, const char **)) {
+  for (unsigned int Value = 0; Value <= 0xffff; ++Value) {
+    const DwarfName &Name = GetName(static_cast<Dwarf_Half>(Value));
+    const char *Expected = "";
+    if (GetLibDwarfName(Value, &Expected) != DW_DLV_OK)
+      Expected = "";
+    EXPECT_STREQ(Name.Name, Expected) << "value 0x" << std::hex << Value;
+    EXPECT_EQ(Name.Length, strlen(Name.Name)) << "value 0x" << std::hex
+                                              << Value;
+  }
+}
+
+} // end anonymous namespace.
+
+TEST(DwarfNames, getDwarfTagName) {
+  EXPECT_STREQ(getDwarfTagName(DW_TAG_class_type).Name, "DW_TAG_class_type");
+  EXPECT_EQ(getDwarfTagName(DW_TAG_class_type).Length, 17U);
+  EXPECT_STREQ(getDwarfTagName(DW_TAG_GNU_call_site).Name,
+               "DW_TAG_GNU_call_site");
+  EXPECT_STREQ(getDwarfTagName(0).Name, "");
+  EXPECT_EQ(getDwarfTagName(0).Length, 0U);
+  checkAgainstLibDwarf(getDwarfTagName, dwarf_get_TAG_name);
+}
+
+TEST(DwarfNames, getDwarfAttrName) {
+  EXPECT_STREQ(getDwarfAttrName(DW_AT_name).Name, "DW_AT_name");
+  EXPECT_STREQ(getDwarfAttrName(DW_AT_MIPS_linkage_name).Name,
+               "DW_AT_MIPS_linkage_name");
+  EXPECT_STREQ(getDwarfAttrName(0).Name, "");
+  checkAgainstLibDwarf(getDwarfAttrName, dwarf_get_AT_name);
+}
+
+TEST(DwarfNames, getDwarfFormName) {
+  EXPECT_STREQ(getDwarfFormName(DW_FORM_data1).Name, "DW_FORM_data1");
+  EXPECT_STREQ(getDwarfFormName(DW_FORM_GNU_strp_alt).Name,
+               "DW_FORM_GNU_strp_alt");
+  EXPECT_STREQ(getDwarfFormName(0).Name, "");
+  checkAgainstLibDwarf(getDwarfFormName, dwarf_get_FORM_name);
+}
@@ -0,0 +1,60 @@
+//===-- UnitTests/TestLibScopeView/TestError.cpp ----------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeError.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace LibScopeError;
+
+TEST(Error, FatalErrorExits) {
+  EXPECT_EXIT(fatalError(ErrorCode::ERR_FILE_NOT_FOUND, "a.o"),
+              testing::ExitedWithCode(1),
+              "ERR_FILE_NOT_FOUND: Unable to open file 'a.o'.");
+  EXPECT_EXIT(exitProgram(2), testing::ExitedWithCode(2), "");
+}
+
+TEST(Error, ScopedExitAsException) {
+  ScopedExitAsException ExitAsException;
+  try {
+    fatalError(ErrorCode::ERR_CMD_INCOMPATIBLE_ARGS, "--a", "--b");
+    FAIL() << "fatalError did not throw";
+  } catch (const ExitException &Exit) {
+    EXPECT_EQ(Exit.getExitCode(), 1);
+    EXPECT_STREQ(Exit.what(), "\nERR_CMD_INCOMPATIBLE_ARGS: Argument '--a' can "
+                              "not be used with '--b'.\n");
+  }
+  try {
+    exitProgram(0);
+    FAIL() << "exitProgram did not throw";
+  } catch (const ExitException &Exit) {
+    EXPECT_EQ(Exit.getExitCode(), 0);
+    EXPECT_STREQ(Exit.what(), "");
+  }
+}
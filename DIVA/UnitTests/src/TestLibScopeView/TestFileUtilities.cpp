@@ -202,3 +202,16 @@ TEST(FileUtilities, isElfSucceedsOnElfs) {
   EXPECT_TRUE(isFileFormatElf(FileLocation));
 }
 
+
+TEST(FileUtilities, getFileStatus) {
+  uint64_t Size = 0;
+  int64_t ModifiedTime = 0;
+  EXPECT_FALSE(getFileStatus(getTestInputFilePath("DoesntExist.elf"), Size,
+                             ModifiedTime));
+
+  const std::string FileLocation = getTestInputFilePath("3Bytes.o");
+  ASSERT_TRUE(getFileStatus(FileLocation, Size, ModifiedTime))
+      << FileNotFoundError << FileLocation;
+  EXPECT_EQ(Size, 3u);
+  EXPECT_NE(ModifiedTime, 0);
+}
@@ -0,0 +1,252 @@
+//===-- UnitTests/TestLibScopeView/TestFilterMatcher.cpp --------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for the LibScopeView FilterMatcher.
+///
+//===----------------------------------------------------------------------===//
+
+#include "FilterMatcher.h"
+
+#include "gtest/gtest.h"
+
+#include <regex>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Check the matcher gives the same result as std::regex for every name.
+void checkAgainstRegex(const std::vector<std::string> &Patterns,
+                       const std::vector<std::string> &Substrings,
+                       const std::vector<std::string> &Names) {
+  FilterMatcher Matcher(Patterns, Substrings);
+  for (const std::string &Name : Names) {
+    bool Expected = false;
+    for (const std::string &Pattern : Patterns)
+      Expected |= std::regex_match(Name, std::regex(Pattern));
+    for (const std::string &Substring : Substrings)
+      Expected |= Name.find(Substring) != std::string::npos;
+    EXPECT_EQ(Matcher.matches(Name), Expected)
+        << "Name: '" << Name << "' Pattern: '"
+        << (Patterns.empty() ? "" : Patterns.front()) << "'";
+  }
+}
+
+const std::vector<std::string> TestNames = {
+    "",
+    "a",
+    "b",
+    "ab",
+    "abc",
+    "aab",
+    "abab",
+    "main",
+    "foo",
+    "foobar",
+    "barfoo",
+    "Foo",
+    "foo1",
+    "foo_bar",
+    "foo::bar",
+    "std::vector<int>",
+    "operator()",
+    "operator[]",
+    "operator+=",
+    "~Foo",
+    "x1y2",
+    "12",
+    "a.b",
+    "a\nb",
+    "tab\there",
+    "a b",
+    "\xc3\xa9t\xc3\xa9",
+    "aaaaaaaaaa",
+    "a-b",
+    "a|b",
+    "(a)",
+    "[a]",
+    "{a}",
+    "$a^",
+};
+
+} // namespace
+
+TEST(FilterMatcher, Empty) {
+  FilterMatcher Matcher;
+  EXPECT_TRUE(Matcher.empty());
+  EXPECT_FALSE(Matcher.matches("a"));
+
+  FilterMatcher NoFilters({}, {});
+  EXPECT_TRUE(NoFilters.empty());
+  EXPECT_FALSE(NoFilters.matches(""));
+}
+
+TEST(FilterMatcher, Substrings) {
+  FilterMatcher Matcher({}, {"foo", "bar", "oob"});
+  EXPECT_FALSE(Matcher.empty());
+  EXPECT_TRUE(Matcher.matches("foo"));
+  EXPECT_TRUE(Matcher.matches("xbarx"));
+  EXPECT_TRUE(Matcher.matches("fooba"));
+  EXPECT_FALSE(Matcher.matches("fo"));
+  EXPECT_FALSE(Matcher.matches("ba"));
+  EXPECT_FALSE(Matcher.matches(""));
+
+  // An empty substring matches every name.
+  FilterMatcher All({}, {""});
+  EXPECT_TRUE(All.matches(""));
+  EXPECT_TRUE(All.matches("a"));
+
+  checkAgainstRegex({}, {"a", "ab", "bab", "foo", "::", "("}, TestNames);
+}
+
+TEST(FilterMatcher, Patterns) {
+  FilterMatcher Matcher({"foo", "ba[rz]"}, {});
+  EXPECT_TRUE(Matcher.matches("foo"));
+  EXPECT_TRUE(Matcher.matches("bar"));
+  EXPECT_TRUE(Matcher.matches("baz"));
+  EXPECT_FALSE(Matcher.matches("foobar"));
+  EXPECT_FALSE(Matcher.matches("bax"));
+}
+
+TEST(FilterMatcher, PatternsAndSubstrings) {
+  FilterMatcher Matcher({"f.o"}, {"bar"});
+  EXPECT_TRUE(Matcher.matches("fxo"));
+  EXPECT_TRUE(Matcher.matches("foobar"));
+  EXPECT_FALSE(Matcher.matches("fxox"));
+
+  checkAgainstRegex({"a+", "foo.*", "(?:ab)*"}, {"::", "~"}, TestNames);
+}
+
+TEST(FilterMatcher, InvalidPattern) {
+  EXPECT_THROW(FilterMatcher({"("}, {}), std::regex_error);
+  EXPECT_THROW(FilterMatcher({"a", "[a"}, {}), std::regex_error);
+}
+
+TEST(FilterMatcher, MatchesStdRegex) {
+  // Patterns supported by the DFA, and patterns matched with std::regex.
+  const std::vector<std::string> Patterns = {
+      "",
+      "a",
+      "ab",
+      "a*",
+      "a+b",
+      "a?b",
+      "a*?b",
+      "a{2}",
+      "a{2,}",
+      "a{1,3}b?",
+      "(ab)+",
+      "(?:ab)*c?",
+      "a|b|ab",
+      "foo|bar.*",
+      "(foo|bar)+",
+      ".*",
+      ".+o.*",
+      "a.b",
+      "[a-c]+",
+      "[^a]*",
+      "[-a]b",
+      "[a-]b",
+      "[\\w:<>]+",
+      "\\w+",
+      "\\W",
+      "\\d+",
+      "\\D*",
+      "\\s",
+      "\\S+",
+      "a\\.b",
+      "a\\|b",
+      "operator\\(\\)",
+      "operator\\[\\]",
+      "operator\\+=",
+      "\\$a\\^",
+      "\\(a\\)",
+      "tab\\there",
+      "^a",
+      "a$",
+      "^ab$",
+      "^$",
+      "a^b",
+      "a$b",
+      "(^a|b)+",
+      "(a|$)b?",
+      "std::.*",
+      "~.*",
+      ".*::.*",
+      "\\xc3\\xa9t\\xc3\\xa9",
+      "(a)\\1",
+      "(a|b)\\1",
+      "foo\\b",
+      "\\bfoo",
+      "(?=f)foo.*",
+      "(?!f).*",
+      "x\\d\\w(?=\\d)\\d",
+      "[[:alpha:]]+",
+      "a{200}",
+  };
+  for (const std::string &Pattern : Patterns)
+    checkAgainstRegex({Pattern}, {}, TestNames);
+
+  // All the patterns together.
+  checkAgainstRegex(Patterns, {}, TestNames);
+}
+
+TEST(FilterMatcher, StackedQuantifiers) {
+  // A quantifier after '+' makes the repeated character optional.
+  const std::vector<std::string> Names = {"", "a", "c", "1", "1c", "aa", "ba"};
+  for (const char *Pattern : {"a+*", "a+??", ".a+?*?", "1+*?[^a]", "a+?b?"})
+    checkAgainstRegex({Pattern}, {}, Names);
+  EXPECT_TRUE(FilterMatcher({"a+*"}, {}).matches(""));
+  EXPECT_TRUE(FilterMatcher({"1+*?[^a]"}, {}).matches("c"));
+}
+
+TEST(FilterMatcher, ManyStates) {
+  // Too many DFA states, so std::regex is used for every pattern.
+  checkAgainstRegex({".*a.{12}", "foo"}, {"bar"},
+                    {"foo", "foobar", "a123456789012", "ba123456789012",
+                     "a12345678901", "b"});
+}
+
+TEST(FilterMatcher, CachedResults) {
+  StringPool Pool;
+  StringPoolRef Foo = Pool.get("foo");
+  StringPoolRef Bar = Pool.get("bar");
+  FilterCacheStatistics &Statistics = getFilterCacheStatistics();
+  size_t Lookups = Statistics.Lookups;
+  size_t Hits = Statistics.Hits;
+
+  FilterMatcher Matcher({"f.*"}, {"x"});
+  EXPECT_TRUE(Matcher.matches(Foo));
+  EXPECT_FALSE(Matcher.matches(Bar));
+  EXPECT_TRUE(Matcher.matches(Foo));
+  EXPECT_FALSE(Matcher.matches(Bar));
+  EXPECT_EQ(Statistics.Lookups - Lookups, 4U);
+  EXPECT_EQ(Statistics.Hits - Hits, 2U);
+
+  // Nothing is looked up without filters.
+  FilterMatcher Empty;
+  EXPECT_FALSE(Empty.matches(Foo));
+  EXPECT_EQ(Statistics.Lookups - Lookups, 4U);
+}
@@ -0,0 +1,206 @@
+//===-- UnitTests/TestLibScopeView/TestGzipStream.cpp -----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for the GzipStream.
+///
+//===----------------------------------------------------------------------===//
+
+#include "GzipStream.h"
+
+#include "gtest/gtest.h"
+
+#include <zlib.h>
+
+#include <sstream>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Decompress gzip data which may contain several concatenated members.
+bool gunzip(const std::string &Compressed, std::string &Decompressed) {
+  z_stream Strm;
+  Strm.zalloc = Z_NULL;
+  Strm.zfree = Z_NULL;
+  Strm.opaque = Z_NULL;
+  Strm.next_in = Z_NULL;
+  Strm.avail_in = 0;
+  if (inflateInit2(&Strm, 15 + 16) != Z_OK)
+    return false;
+
+  Strm.next_in =
+      reinterpret_cast<Bytef *>(const_cast<char *>(Compressed.data()));
+  Strm.avail_in = static_cast<uInt>(Compressed.size());
+  char Chunk[4096];
+  int Result = Z_OK;
+  while (Strm.avail_in != 0 || Result != Z_STREAM_END) {
+    if (Result == Z_STREAM_END)
+      inflateReset(&Strm);
+    Strm.next_out = reinterpret_cast<Bytef *>(Chunk);
+    Strm.avail_out = sizeof(Chunk);
+    Result = inflate(&Strm, Z_NO_FLUSH);
+    if (Result != Z_OK && Result != Z_STREAM_END)
+      break;
+    Decompressed.append(Chunk, sizeof(Chunk) - Strm.avail_out);
+  }
+  inflateEnd(&Strm);
+  return Result == Z_STREAM_END;
+}
+
+// Decompress the start of gzip data which may not be finished yet.
+std::string gunzipFlushed(const std::string &Compressed) {
+  z_stream Strm;
+  Strm.zalloc = Z_NULL;
+  Strm.zfree = Z_NULL;
+  Strm.opaque = Z_NULL;
+  Strm.next_in = Z_NULL;
+  Strm.avail_in = 0;
+  if (inflateInit2(&Strm, 15 + 16) != Z_OK)
+    return std::string();
+
+  Strm.next_in =
+      reinterpret_cast<Bytef *>(const_cast<char *>(Compressed.data()));
+  Strm.avail_in = static_cast<uInt>(Compressed.size());
+  std::string Decompressed;
+  char Chunk[4096];
+  int Result = Z_OK;
+  while (Strm.avail_in != 0 && (Result == Z_OK || Result == Z_STREAM_END)) {
+    if (Result == Z_STREAM_END)
+      inflateReset(&Strm);
+    Strm.next_out = reinterpret_cast<Bytef *>(Chunk);
+    Strm.avail_out = sizeof(Chunk);
+    Result = inflate(&Strm, Z_SYNC_FLUSH);
+    Decompressed.append(Chunk, sizeof(Chunk) - Strm.avail_out);
+  }
+  inflateEnd(&Strm);
+  return Decompressed;
+}
+
+// Input large enough to span several compression blocks.
+std::string createLargeInput() {
+  std::string Input;
+  for (size_t I = 0; Input.size() < GzipStreamBuf::BlockSize * 3 + 100; ++I)
+    Input += "{Line} " + std::to_string(I) + " {Variable} 'Var'\n";
+  return Input;
+}
+
+void checkRoundTrip(const std::string &Input, unsigned Threads) {
+  std::stringstream Output;
+  {
+    GzipOutputStream Compressed(Output, Threads);
+    Compressed << Input;
+    Compressed.finish();
+    EXPECT_TRUE(Compressed.good());
+  }
+  std::string Decompressed;
+  EXPECT_TRUE(gunzip(Output.str(), Decompressed));
+  EXPECT_EQ(Decompressed, Input);
+}
+
+} // namespace
+
+TEST(GzipStream, Empty) {
+  checkRoundTrip("", 1);
+  checkRoundTrip("", 4);
+}
+
+TEST(GzipStream, SingleThreaded) {
+  checkRoundTrip("Hello\n", 1);
+  checkRoundTrip(createLargeInput(), 1);
+}
+
+TEST(GzipStream, MultiThreaded) {
+  checkRoundTrip("Hello\n", 4);
+  checkRoundTrip(createLargeInput(), 2);
+  checkRoundTrip(createLargeInput(), 4);
+  checkRoundTrip(createLargeInput(), 0);
+}
+
+TEST(GzipStream, ThreadsLimitedToCores) {
+  std::stringstream Output;
+  GzipStreamBuf OneThread(Output, 1);
+  EXPECT_EQ(OneThread.getThreads(), 1u);
+  GzipStreamBuf PerCore(Output, 0);
+  EXPECT_GE(PerCore.getThreads(), 1u);
+  GzipStreamBuf TooMany(Output, 9999);
+  EXPECT_EQ(TooMany.getThreads(), PerCore.getThreads());
+}
+
+TEST(GzipStream, Flush) {
+  // The data written before a flush can be decompressed straight away.
+  for (unsigned Threads : {1u, 4u}) {
+    std::stringstream Output;
+    GzipOutputStream Compressed(Output, Threads);
+    Compressed << "Hello\n" << std::flush;
+    EXPECT_TRUE(Compressed.good());
+    EXPECT_EQ(gunzipFlushed(Output.str()), "Hello\n");
+
+    Compressed << "World\n";
+    Compressed.finish();
+    EXPECT_TRUE(Compressed.good());
+    std::string Decompressed;
+    EXPECT_TRUE(gunzip(Output.str(), Decompressed));
+    EXPECT_EQ(Decompressed, "Hello\nWorld\n");
+  }
+}
+
+TEST(GzipStream, FinishOnDestruction) {
+  std::stringstream Output;
+  {
+    GzipOutputStream Compressed(Output);
+    Compressed << "Hello\n";
+  }
+  std::string Decompressed;
+  EXPECT_TRUE(gunzip(Output.str(), Decompressed));
+  EXPECT_EQ(Decompressed, "Hello\n");
+}
+
+TEST(GzipStream, CompressInMemory) {
+  for (const std::string &Input : {std::string(), createLargeInput()}) {
+    std::string Compressed;
+    ASSERT_TRUE(compressGzip(Input, Compressed));
+    std::string Decompressed;
+    EXPECT_TRUE(decompressGzip(Compressed, Decompressed));
+    EXPECT_EQ(Decompressed, Input);
+  }
+}
+
+TEST(GzipStream, DecompressMembers) {
+  // The output of several threads is several gzip members.
+  std::string Input = createLargeInput();
+  std::stringstream Output;
+  {
+    GzipOutputStream Compressed(Output, 4);
+    Compressed << Input;
+  }
+  std::string Decompressed;
+  EXPECT_TRUE(decompressGzip(Output.str(), Decompressed));
+  EXPECT_EQ(Decompressed, Input);
+
+  // Incomplete data is not accepted.
+  std::string Truncated = Output.str();
+  Truncated.resize(Truncated.size() - 10);
+  EXPECT_FALSE(decompressGzip(Truncated, Decompressed));
+}
@@ -0,0 +1,93 @@
+//===-- UnitTests/TestLibScopeView/TestNameIndex.cpp ------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+///
+/// \file
+/// Tests for the LibScopeView NameIndex.
+///
+//===----------------------------------------------------------------------===//
+
+#include "NameIndex.h"
+#include "Line.h"
+#include "Scope.h"
+#include "Symbol.h"
+
+#include "gtest/gtest.h"
+
+using namespace LibScopeView;
+
+namespace {
+
+std::vector<const Object *> toVector(const NameIndex::ObjectRange &Range) {
+  return std::vector<const Object *>(Range.begin(), Range.end());
+}
+
+} // namespace
+
+TEST(NameIndex, Find) {
+  ScopeRoot Root;
+  Root.setName("root.o");
+  auto *CU = new ScopeCompileUnit;
+  CU->setName("a.cpp");
+  auto *NS = new ScopeNamespace;
+  NS->setName("NS");
+  auto *Func = new ScopeFunction;
+  Func->setName("f");
+  Func->setQualifiedName("NS::");
+  auto *Var = new Symbol;
+  Var->setName("f");
+  auto *Unnamed = new Line;
+  Root.addChild(CU);
+  CU->addChild(NS);
+  NS->addChild(Func);
+  CU->addChild(Var);
+  Func->addChild(Unnamed);
+
+  Root.buildNameIndex();
+  const NameIndex *Index = Root.getNameIndex();
+  ASSERT_NE(Index, nullptr);
+
+  // Objects with the same name are in tree order.
+  EXPECT_EQ(toVector(Index->find("f")),
+            (std::vector<const Object *>{Func, Var}));
+  EXPECT_EQ(toVector(Index->find("NS")), std::vector<const Object *>{NS});
+  EXPECT_EQ(toVector(Index->find("a.cpp")), std::vector<const Object *>{CU});
+  EXPECT_TRUE(Index->find("root.o").empty());
+  EXPECT_TRUE(Index->find("").empty());
+  EXPECT_TRUE(Index->find("g").empty());
+  EXPECT_EQ(Index->find("f").size(), 2U);
+
+  EXPECT_EQ(toVector(Index->findQualified("NS::f")),
+            std::vector<const Object *>{Func});
+  EXPECT_EQ(toVector(Index->findQualified("f")),
+            std::vector<const Object *>{Var});
+  EXPECT_TRUE(Index->findQualified("NS::g").empty());
+}
+
+TEST(NameIndex, NotBuilt) {
+  ScopeRoot Root;
+  EXPECT_EQ(Root.getNameIndex(), nullptr);
+  Root.buildNameIndex();
+  ASSERT_NE(Root.getNameIndex(), nullptr);
+  EXPECT_TRUE(Root.getNameIndex()->find("a").empty());
+  EXPECT_TRUE(Root.getNameIndex()->findQualified("a").empty());
+}
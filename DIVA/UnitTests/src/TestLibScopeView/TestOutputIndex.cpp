@@ -0,0 +1,79 @@
+//===-- UnitTests/TestLibScopeView/TestOutputIndex.cpp ----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for the LibScopeView output index.
+///
+//===----------------------------------------------------------------------===//
+
+#include "OutputIndex.h"
+#include "FileUtilities.h"
+#include "Scope.h"
+#include "UtilsForTesting.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+using namespace LibScopeView;
+
+TEST(OutputIndex, CountingStreamBuffer) {
+  std::ostringstream Target;
+  CountingStreamBuffer Buffer(Target.rdbuf());
+  std::ostream Stream(&Buffer);
+  EXPECT_EQ(Buffer.getOffset(), 0U);
+  EXPECT_EQ(Buffer.getLineNumber(), 1U);
+
+  Stream << "first\nsecond" << '\n' << 42;
+  EXPECT_EQ(Target.str(), "first\nsecond\n42");
+  EXPECT_EQ(Buffer.getOffset(), 15U);
+  EXPECT_EQ(Buffer.getLineNumber(), 3U);
+}
+
+TEST(OutputIndex, AddObjects) {
+  ScopeCompileUnit CU;
+  CU.setName("test.cpp");
+  ScopeFunction Func;
+  Func.setName("main");
+
+  const std::string Path = getTestOutputFilePath("AddObjects.idx");
+  std::ostringstream Output;
+  {
+    OutputIndex Index(Output, Path);
+    Index.getStream() << "{InputFile} \"test.elf\"\n";
+    Index.add(CU);
+    Index.getStream() << "{CompileUnit} \"test.cpp\"\n\n";
+    Index.add(Func);
+    Index.getStream() << "{Function} \"main\"\n";
+    Index.finish();
+  }
+
+  EXPECT_EQ(Output.str(), "{InputFile} \"test.elf\"\n"
+                          "{CompileUnit} \"test.cpp\"\n\n"
+                          "{Function} \"main\"\n");
+  std::string Contents;
+  ASSERT_TRUE(readFileContents(Path, Contents));
+  EXPECT_EQ(Contents, "23\t2\tCompileUnit\ttest.cpp\n"
+                      "49\t4\tFunction\tmain\n");
+}
@@ -0,0 +1,125 @@
+//===-- UnitTests/TestLibScopeView/TestOutputPack.cpp -----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for writing and reading LibScopeView output packs.
+///
+//===----------------------------------------------------------------------===//
+
+#include "OutputPack.h"
+#include "Error.h"
+#include "FileUtilities.h"
+#include "UtilsForTesting.h"
+
+#include "gtest/gtest.h"
+
+using namespace LibScopeView;
+
+namespace {
+
+// Write a pack of Count files called "file<n>.txt", holding "contents <n>".
+void writeTestPack(const std::string &Path, size_t Count, bool Compress) {
+  OutputPackWriter Pack(Path);
+  for (size_t I = 0; I < Count; ++I)
+    Pack.add("file" + std::to_string(I) + ".txt",
+             "contents " + std::to_string(I) + '\n', Compress);
+  Pack.finish();
+}
+
+} // namespace
+
+TEST(OutputPack, WriteAndFind) {
+  for (bool Compress : {false, true}) {
+    const std::string Path = getTestOutputFilePath("WriteAndFind.pack");
+    writeTestPack(Path, 100, Compress);
+    EXPECT_TRUE(isFileFormatOutputPack(Path));
+
+    OutputPackReader Pack(Path);
+    for (size_t I : {0, 1, 42, 99}) {
+      OutputPackEntry Entry;
+      ASSERT_TRUE(Pack.find("file" + std::to_string(I) + ".txt", Entry));
+      EXPECT_EQ(Entry.IsCompressed, Compress);
+      EXPECT_EQ(Pack.read(Entry), "contents " + std::to_string(I) + '\n');
+    }
+    OutputPackEntry Entry;
+    EXPECT_FALSE(Pack.find("file100.txt", Entry));
+    EXPECT_FALSE(Pack.find("", Entry));
+
+    // The files are listed in the order they were added.
+    std::vector<OutputPackEntry> Entries = Pack.getEntries();
+    ASSERT_EQ(Entries.size(), 100u);
+    for (size_t I = 0; I < Entries.size(); ++I)
+      EXPECT_EQ(Entries[I].Name, "file" + std::to_string(I) + ".txt");
+  }
+}
+
+TEST(OutputPack, Empty) {
+  const std::string Path = getTestOutputFilePath("Empty.pack");
+  writeTestPack(Path, 0, false);
+  OutputPackReader Pack(Path);
+  OutputPackEntry Entry;
+  EXPECT_FALSE(Pack.find("file0.txt", Entry));
+  EXPECT_TRUE(Pack.getEntries().empty());
+}
+
+TEST(OutputPack, ReplacedFile) {
+  const std::string Path = getTestOutputFilePath("ReplacedFile.pack");
+  {
+    OutputPackWriter Pack(Path);
+    Pack.add("a.txt", "first", false);
+    Pack.add("b.txt", "b", false);
+    Pack.add("a.txt", "second", false);
+    Pack.finish();
+  }
+  OutputPackReader Pack(Path);
+  OutputPackEntry Entry;
+  ASSERT_TRUE(Pack.find("a.txt", Entry));
+  EXPECT_EQ(Pack.read(Entry), "second");
+  EXPECT_EQ(Pack.getEntries().size(), 2u);
+}
+
+TEST(OutputPack, Damaged) {
+  const std::string Path = getTestOutputFilePath("Damaged.pack");
+  writeTestPack(Path, 3, false);
+  std::string Contents;
+  ASSERT_TRUE(readFileContents(Path, Contents));
+
+  LibScopeError::ScopedExitAsException ExitAsException;
+  // Changed contents no longer match their hash.
+  std::string Changed = Contents;
+  Changed.replace(Changed.find("contents 1"), 10, "CONTENTS 1");
+  ASSERT_TRUE(replaceFileContents(Path, Changed));
+  {
+    OutputPackReader Pack(Path);
+    OutputPackEntry Entry;
+    ASSERT_TRUE(Pack.find("file1.txt", Entry));
+    EXPECT_THROW(Pack.read(Entry), LibScopeError::ExitException);
+  }
+
+  // A cut short pack has no trailer.
+  Contents.pop_back();
+  ASSERT_TRUE(replaceFileContents(Path, Contents));
+  EXPECT_THROW(OutputPackReader Pack(Path), LibScopeError::ExitException);
+  EXPECT_FALSE(isFileFormatOutputPack(getTestInputFilePath("test.o")));
+}
@@ -0,0 +1,133 @@
+//===-- UnitTests/TestLibScopeView/TestOutputShard.cpp ----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for splitting the parts of an input file between shards, and for
+/// writing and reading LibScopeView shards.
+///
+//===----------------------------------------------------------------------===//
+
+#include "OutputShard.h"
+#include "Error.h"
+#include "FileUtilities.h"
+#include "UtilsForTesting.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+using namespace LibScopeView;
+
+TEST(OutputShard, ShardsFollowEachOther) {
+  const std::vector<uint64_t> Sizes = {5, 100, 3, 3, 40, 60, 1, 80, 7, 9};
+  for (unsigned Count : {1, 2, 3, 4, 7, 10, 20}) {
+    uint64_t EndPart = 0;
+    for (unsigned Index = 0; Index < Count; ++Index) {
+      ShardInfo Info = getShardParts(Sizes, Index, Count);
+      EXPECT_EQ(Info.Index, Index);
+      EXPECT_EQ(Info.Count, Count);
+      EXPECT_EQ(Info.PartCount, Sizes.size());
+      EXPECT_EQ(Info.FirstPart, EndPart);
+      EXPECT_LE(Info.FirstPart, Info.EndPart);
+      EndPart = Info.EndPart;
+    }
+    EXPECT_EQ(EndPart, Sizes.size());
+  }
+}
+
+TEST(OutputShard, ShardsBalancedBySize) {
+  // A large part is alone in its shard, and the small ones share the others.
+  const std::vector<uint64_t> Sizes = {10, 10, 10, 10, 10, 10, 300, 10, 10,
+                                       10, 10, 10, 10};
+  ShardInfo First = getShardParts(Sizes, 0, 3);
+  ShardInfo Middle = getShardParts(Sizes, 1, 3);
+  ShardInfo Last = getShardParts(Sizes, 2, 3);
+  EXPECT_EQ(First.FirstPart, 0u);
+  EXPECT_EQ(First.EndPart, 6u);
+  EXPECT_EQ(Middle.FirstPart, 6u);
+  EXPECT_EQ(Middle.EndPart, 7u);
+  EXPECT_EQ(Last.FirstPart, 7u);
+  EXPECT_EQ(Last.EndPart, 13u);
+
+  // Other sizes give another hash.
+  EXPECT_EQ(First.PartsHash, Last.PartsHash);
+  EXPECT_NE(First.PartsHash, getShardParts({10, 10}, 0, 3).PartsHash);
+}
+
+TEST(OutputShard, NoParts) {
+  ShardInfo Info = getShardParts({}, 1, 2);
+  EXPECT_EQ(Info.PartCount, 0u);
+  EXPECT_EQ(Info.FirstPart, 0u);
+  EXPECT_EQ(Info.EndPart, 0u);
+}
+
+TEST(OutputShard, WriteAndRead) {
+  const std::string Path = getTestOutputFilePath("WriteAndRead.shard");
+  ShardInfo Info;
+  Info.Index = 1;
+  Info.Count = 3;
+  Info.FirstPart = 4;
+  Info.EndPart = 9;
+  Info.PartCount = 12;
+  Info.PartsHash = 0x1234;
+  Info.SettingsHash = 0x5678;
+  const std::string Output(100000, 'x');
+  {
+    ShardWriter Shard(Path);
+    Shard.getStream() << Output;
+    Shard.finish(Info);
+  }
+
+  ShardReader Shard(Path);
+  const ShardInfo &Read = Shard.getInfo();
+  EXPECT_EQ(Read.Index, Info.Index);
+  EXPECT_EQ(Read.Count, Info.Count);
+  EXPECT_EQ(Read.FirstPart, Info.FirstPart);
+  EXPECT_EQ(Read.EndPart, Info.EndPart);
+  EXPECT_EQ(Read.PartCount, Info.PartCount);
+  EXPECT_EQ(Read.PartsHash, Info.PartsHash);
+  EXPECT_EQ(Read.SettingsHash, Info.SettingsHash);
+  std::ostringstream Copy;
+  Shard.copyOutput(Copy);
+  EXPECT_EQ(Copy.str(), Output);
+}
+
+TEST(OutputShard, Damaged) {
+  const std::string Path = getTestOutputFilePath("Damaged.shard");
+  {
+    ShardWriter Shard(Path);
+    Shard.getStream() << "output\n";
+    Shard.finish(ShardInfo());
+  }
+  std::string Contents;
+  ASSERT_TRUE(readFileContents(Path, Contents));
+
+  LibScopeError::ScopedExitAsException ExitAsException;
+  // A cut short shard has no trailer.
+  Contents.erase(Contents.find("output"), 1);
+  ASSERT_TRUE(replaceFileContents(Path, Contents));
+  EXPECT_THROW(ShardReader Shard(Path), LibScopeError::ExitException);
+  EXPECT_THROW(ShardReader Shard(getTestInputFilePath("test.o")),
+               LibScopeError::ExitException);
+}
@@ -945,3 +945,87 @@ TEST(Scope, notPrintedAsObject) {
   EXPECT_FALSE(ScopeArray().getIsPrintedAsObject());
   EXPECT_FALSE(ScopeRoot().getIsPrintedAsObject());
 }
+
+TEST(Scope, Extents) {
+  ScopeExtents Extents;
+  EXPECT_EQ(Extents.getMaxLineNumber(), 0U);
+  EXPECT_EQ(Extents.getMaxLevel(), 0U);
+  EXPECT_TRUE(Extents.getDwarfTags().empty());
+  EXPECT_FALSE(Extents.getIsRecorded());
+
+  ScopeFunction Func;
+  Func.setLineNumber(42);
+  Func.setDieTag(DW_TAG_subprogram);
+  Extents.addObject(Func, 3);
+
+  // Objects without a tag don't add one.
+  Line Ln;
+  Ln.setLineNumber(7);
+  Extents.addObject(Ln, 1);
+
+  EXPECT_EQ(Extents.getMaxLineNumber(), 42U);
+  EXPECT_EQ(Extents.getMaxLevel(), 3U);
+  EXPECT_EQ(Extents.getObjectCount(), 2U);
+  EXPECT_EQ(Extents.getDwarfTags(), std::set<Dwarf_Half>{DW_TAG_subprogram});
+
+  Extents.updateLineNumber(100);
+  EXPECT_EQ(Extents.getMaxLineNumber(), 100U);
+  Extents.setIsRecorded();
+  EXPECT_TRUE(Extents.getIsRecorded());
+}
+
+TEST(Scope, Extents_merge) {
+  ScopeFunction Func;
+  Func.setLineNumber(42);
+  Func.setDieTag(DW_TAG_subprogram);
+  ScopeCompileUnit CU;
+  CU.setDieTag(DW_TAG_compile_unit);
+
+  ScopeExtents First;
+  First.addObject(CU, 0);
+  First.addObject(Func, 2);
+  ScopeExtents Second;
+  Second.addObject(CU, 0);
+  Second.updateLineNumber(9);
+
+  ScopeRoot Root;
+  Root.getExtents().merge(First);
+  Root.getExtents().merge(Second);
+
+  const ScopeExtents &Merged = Root.getExtents();
+  EXPECT_EQ(Merged.getMaxLineNumber(), 42U);
+  EXPECT_EQ(Merged.getMaxLevel(), 2U);
+  EXPECT_EQ(Merged.getObjectCount(), 3U);
+  EXPECT_EQ(Merged.getDwarfTags(),
+            (std::set<Dwarf_Half>{DW_TAG_compile_unit, DW_TAG_subprogram}));
+  EXPECT_FALSE(Merged.getIsRecorded());
+}
+
+TEST(Scope, NameSummary) {
+  StringPool Pool;
+  StringPoolRef Foo = Pool.get("foo");
+  StringPoolRef Bar = Pool.get("bar");
+
+  NameSummary Empty;
+  EXPECT_FALSE(Empty.mayContain(Foo));
+  EXPECT_FALSE(Empty.mayContain(nullptr));
+
+  NameSummary Summary({Foo, nullptr});
+  EXPECT_TRUE(Summary.mayContain(Foo));
+  EXPECT_TRUE(Summary.mayContain(nullptr));
+
+  EXPECT_TRUE(NameSummary::any().mayContain(Bar));
+
+  // The summary grows with the names, so that few of the other names are
+  // reported as present, however many names are in it.
+  std::vector<StringPoolRef> Names;
+  for (int I = 0; I < 1000; ++I)
+    Names.push_back(Pool.get("name" + std::to_string(I)));
+  NameSummary Large(Names);
+  for (StringPoolRef Name : Names)
+    EXPECT_TRUE(Large.mayContain(Name));
+  int Found = 0;
+  for (int I = 0; I < 1000; ++I)
+    Found += Large.mayContain(Pool.get("other" + std::to_string(I)));
+  EXPECT_LT(Found, 50);
+}
@@ -0,0 +1,228 @@
+//===-- UnitTests/TestLibScopeView/TestScopeCompare.cpp ---------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::ScopeCompare.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ScopeCompare.h"
+#include "Scope.h"
+#include "Symbol.h"
+#include "Type.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+using namespace LibScopeView;
+
+namespace {
+
+using Kind = ScopeCompare::DifferenceKind;
+
+// A tree with a compile unit holding a function for each name, each with a
+// variable "i" of the given type.
+class TestTree {
+public:
+  TestTree(const std::vector<std::pair<std::string, const Type *>> &Functions,
+           Dwarf_Off FirstOffset = 0) {
+    Root.setName("test.o");
+    CU = new ScopeCompileUnit;
+    CU->setName("test.cpp");
+    CU->setDieOffset(FirstOffset);
+    Root.addChild(CU);
+    for (const auto &Function : Functions) {
+      auto *Func = new ScopeFunction;
+      Func->setName(Function.first);
+      Func->setDieOffset(++FirstOffset);
+      CU->addChild(Func);
+      auto *Var = new Symbol;
+      Var->setIsVariable();
+      Var->setName("i");
+      Var->setType(const_cast<Type *>(Function.second));
+      Var->setDieOffset(++FirstOffset);
+      Func->addChild(Var);
+      Objects.push_back(Func);
+      Objects.push_back(Var);
+    }
+  }
+
+  ScopeRoot Root;
+  ScopeCompileUnit *CU;
+  // The function and variable of each name.
+  std::vector<Object *> Objects;
+};
+
+class ScopeCompareTest : public testing::Test {
+protected:
+  ScopeCompareTest() {
+    Int.setIsBaseType();
+    Int.setName("int");
+    Long.setIsBaseType();
+    Long.setName("long");
+  }
+
+  Type Int;
+  Type Long;
+  PrintSettings Settings;
+};
+
+} // namespace
+
+TEST_F(ScopeCompareTest, SameTrees) {
+  // DIE offsets are not compared.
+  TestTree Old({{"f", &Int}, {"g", &Int}}, 0);
+  TestTree New({{"f", &Int}, {"g", &Int}}, 100);
+  Settings.ShowDWARFOffset = true;
+  EXPECT_TRUE(
+      ScopeCompare(Old.Root, New.Root, Settings).getDifferences().empty());
+}
+
+TEST_F(ScopeCompareTest, Differences) {
+  TestTree Old({{"f", &Int}, {"g", &Int}, {"h", &Int}});
+  TestTree New({{"f", &Long}, {"h", &Int}, {"k", &Int}});
+  ScopeCompare Compare(Old.Root, New.Root, Settings);
+
+  const auto &Differences = Compare.getDifferences();
+  ASSERT_EQ(Differences.size(), 3u);
+
+  EXPECT_EQ(Differences[0].Kind, Kind::Changed);
+  EXPECT_EQ(Differences[0].Old, Old.Objects[1]);
+  EXPECT_EQ(Differences[0].New, New.Objects[1]);
+  EXPECT_EQ(Differences[0].Parents,
+            (std::vector<const Object *>{New.CU, New.Objects[0]}));
+
+  EXPECT_EQ(Differences[1].Kind, Kind::Removed);
+  EXPECT_EQ(Differences[1].Old, Old.Objects[2]);
+  EXPECT_EQ(Differences[1].New, nullptr);
+  EXPECT_EQ(Differences[1].Parents, std::vector<const Object *>{New.CU});
+
+  EXPECT_EQ(Differences[2].Kind, Kind::Added);
+  EXPECT_EQ(Differences[2].Old, nullptr);
+  EXPECT_EQ(Differences[2].New, New.Objects[4]);
+  EXPECT_EQ(Differences[2].Parents, std::vector<const Object *>{New.CU});
+
+  std::stringstream Text;
+  Compare.printText(Text, "old.o", "new.o");
+  EXPECT_EQ(Text.str(), "Comparing \"old.o\" with \"new.o\"\n"
+                        "\n"
+                        "  {CompileUnit} \"test.cpp\"\n"
+                        "    {Function} \"f\" -> \"void\"\n"
+                        "        - No declaration\n"
+                        "<     {Variable} \"i\" -> \"int\"\n"
+                        ">     {Variable} \"i\" -> \"long\"\n"
+                        "-   {Function} \"g\" -> \"void\"\n"
+                        "-       - No declaration\n"
+                        "+   {Function} \"k\" -> \"void\"\n"
+                        "+       - No declaration\n"
+                        "\n"
+                        "Added 1, removed 1, changed 1\n");
+
+  std::stringstream YAML;
+  Compare.printYAML(YAML, "old.o", "new.o");
+  EXPECT_EQ(YAML.str(),
+            "old_file: \"old.o\"\n"
+            "new_file: \"new.o\"\n"
+            "differences:\n"
+            "  - change: \"changed\"\n"
+            "    parents: [\"{CompileUnit} \\\"test.cpp\\\"\", \"{Function} "
+            "\\\"f\\\" -> \\\"void\\\"\\n    - No declaration\"]\n"
+            "    old: \"{Variable} \\\"i\\\" -> \\\"int\\\"\"\n"
+            "    new: \"{Variable} \\\"i\\\" -> \\\"long\\\"\"\n"
+            "  - change: \"removed\"\n"
+            "    parents: [\"{CompileUnit} \\\"test.cpp\\\"\"]\n"
+            "    old: \"{Function} \\\"g\\\" -> \\\"void\\\"\\n    - No "
+            "declaration\"\n"
+            "    new: null\n"
+            "  - change: \"added\"\n"
+            "    parents: [\"{CompileUnit} \\\"test.cpp\\\"\"]\n"
+            "    old: null\n"
+            "    new: \"{Function} \\\"k\\\" -> \\\"void\\\"\\n    - No "
+            "declaration\"\n"
+            "summary:\n"
+            "  added: 1\n"
+            "  removed: 1\n"
+            "  changed: 1\n");
+}
+
+TEST_F(ScopeCompareTest, HiddenObjects) {
+  // Objects that are not printed are not compared.
+  TestTree Old({{"f", &Int}});
+  TestTree New({{"f", &Long}});
+  Settings.ShowVariable = false;
+  EXPECT_TRUE(
+      ScopeCompare(Old.Root, New.Root, Settings).getDifferences().empty());
+}
+
+TEST_F(ScopeCompareTest, ManyChildren) {
+  // Too many children for a full longest common subsequence.
+  std::vector<std::pair<std::string, const Type *>> OldFunctions;
+  std::vector<std::pair<std::string, const Type *>> NewFunctions;
+  for (int Index = 0; Index < 3000; ++Index) {
+    OldFunctions.emplace_back("f" + std::to_string(Index), &Int);
+    if (Index != 1000)
+      NewFunctions.emplace_back("f" + std::to_string(Index),
+                                Index == 2000 ? &Long : &Int);
+  }
+  NewFunctions.emplace_back("g", &Int);
+  NewFunctions.emplace(NewFunctions.begin(), "g", &Int);
+  TestTree Old(OldFunctions);
+  TestTree New(NewFunctions);
+
+  ScopeCompare Compare(Old.Root, New.Root, Settings);
+  const auto &Differences = Compare.getDifferences();
+  ASSERT_EQ(Differences.size(), 4u);
+  EXPECT_EQ(Differences[0].Kind, Kind::Added);
+  EXPECT_EQ(Differences[0].New, New.Objects[0]);
+  EXPECT_EQ(Differences[1].Kind, Kind::Removed);
+  EXPECT_EQ(Differences[1].Old, Old.Objects[2000]);
+  EXPECT_EQ(Differences[2].Kind, Kind::Changed);
+  EXPECT_EQ(Differences[2].Old, Old.Objects[4001]);
+  EXPECT_EQ(Differences[3].Kind, Kind::Added);
+  EXPECT_EQ(Differences[3].New, New.Objects.end()[-2]);
+}
+
+TEST_F(ScopeCompareTest, Enumerators) {
+  // Enumerators are printed as attributes of their enumeration.
+  TestTree Old({});
+  TestTree New({});
+  for (TestTree *Tree : {&Old, &New}) {
+    auto *Enum = new ScopeEnumeration;
+    Enum->setName("days");
+    Tree->CU->addChild(Enum);
+    auto *Monday = new TypeEnumerator;
+    Monday->setName("monday");
+    Monday->setValue(Tree == &Old ? "1" : "2");
+    Enum->addChild(Monday);
+    Tree->Objects.push_back(Enum);
+  }
+
+  ScopeCompare Compare(Old.Root, New.Root, Settings);
+  const auto &Differences = Compare.getDifferences();
+  ASSERT_EQ(Differences.size(), 1u);
+  EXPECT_EQ(Differences[0].Kind, Kind::Changed);
+  EXPECT_EQ(Differences[0].Old, Old.Objects[0]);
+  EXPECT_EQ(Differences[0].New, New.Objects[0]);
+}
@@ -0,0 +1,164 @@
+//===-- UnitTests/TestLibScopeView/TestScopeHash.cpp ------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for the functions in LibScopeView/ScopeHash.h.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ScopeHash.h"
+#include "Scope.h"
+#include "Symbol.h"
+#include "Type.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+using namespace LibScopeView;
+
+namespace {
+
+// A compile unit with a function holding the variables "a" and "b".
+class TestTree {
+public:
+  TestTree(Type &AType, Dwarf_Off FirstOffset = 0, bool Reversed = false) {
+    CU = new ScopeCompileUnit;
+    CU->setName("test.cpp");
+    CU->setDieOffset(FirstOffset);
+    Root.addChild(CU);
+    Func = new ScopeFunction;
+    Func->setName("f");
+    Func->setLineNumber(1);
+    Func->setDieOffset(++FirstOffset);
+    CU->addChild(Func);
+    for (const char *Name : {"a", "b"}) {
+      Vars.push_back(new Symbol);
+      Vars.back()->setIsVariable();
+      Vars.back()->setName(Name);
+      Vars.back()->setType(&AType);
+      Vars.back()->setDieOffset(++FirstOffset);
+    }
+    if (Reversed)
+      std::swap(Vars[0], Vars[1]);
+    for (Symbol *Var : Vars)
+      Func->addChild(Var);
+  }
+
+  ScopeRoot Root;
+  ScopeCompileUnit *CU;
+  ScopeFunction *Func;
+  std::vector<Symbol *> Vars;
+};
+
+class ScopeHashTest : public testing::Test {
+protected:
+  ScopeHashTest() {
+    Int.setIsBaseType();
+    Int.setName("int");
+    Long.setIsBaseType();
+    Long.setName("long");
+  }
+
+  Type Int;
+  Type Long;
+  PrintSettings Settings;
+};
+
+} // namespace
+
+TEST_F(ScopeHashTest, SameView) {
+  // DIE offsets and the order of the children are not hashed.
+  TestTree Tree(Int);
+  TestTree Moved(Int, 100, true);
+  EXPECT_EQ(hashLogicalView(*Tree.CU, Settings),
+            hashLogicalView(*Moved.CU, Settings));
+}
+
+TEST_F(ScopeHashTest, DifferentView) {
+  TestTree Tree(Int);
+  const uint64_t Hash = hashLogicalView(*Tree.CU, Settings);
+
+  TestTree Changed(Long);
+  EXPECT_NE(hashLogicalView(*Changed.CU, Settings), Hash);
+
+  TestTree Renamed(Int);
+  Renamed.Vars[1]->setName("c");
+  EXPECT_NE(hashLogicalView(*Renamed.CU, Settings), Hash);
+
+  TestTree Moved(Int);
+  Moved.Func->setLineNumber(2);
+  EXPECT_NE(hashLogicalView(*Moved.CU, Settings), Hash);
+
+  TestTree Static(Int);
+  Static.Func->setIsStatic();
+  EXPECT_NE(hashLogicalView(*Static.CU, Settings), Hash);
+
+  // The same objects as the children of another object.
+  TestTree Nested(Int);
+  Nested.Func->getChildren().clear();
+  Nested.Func->addChild(Nested.Vars[0]);
+  auto *Block = new Scope;
+  Block->setIsBlock();
+  Nested.Func->addChild(Block);
+  Block->addChild(Nested.Vars[1]);
+  Settings.ShowBlock = true;
+  EXPECT_NE(hashLogicalView(*Nested.CU, Settings),
+            hashLogicalView(*Tree.CU, Settings));
+}
+
+TEST_F(ScopeHashTest, HiddenObjects) {
+  TestTree Tree(Int);
+  TestTree Changed(Long);
+  Settings.ShowVariable = false;
+  EXPECT_EQ(hashLogicalView(*Tree.CU, Settings),
+            hashLogicalView(*Changed.CU, Settings));
+
+  // The children of hidden objects are hashed as the children of their
+  // parent.
+  Settings.ShowVariable = true;
+  Settings.ShowFunction = false;
+  EXPECT_NE(hashLogicalView(*Tree.CU, Settings),
+            hashLogicalView(*Changed.CU, Settings));
+}
+
+TEST_F(ScopeHashTest, PrintCompileUnitHashes) {
+  TestTree Tree(Int);
+  auto *CU = new ScopeCompileUnit;
+  CU->setName("other.cpp");
+  Tree.Root.addChild(CU);
+
+  std::stringstream Hash;
+  Hash << std::hex << hashLogicalView(*Tree.CU, Settings);
+  std::stringstream OtherHash;
+  OtherHash << std::hex << hashLogicalView(*CU, Settings);
+
+  std::stringstream Output;
+  printCompileUnitHashes(Tree.Root, Settings, Output);
+  EXPECT_EQ(Output.str(),
+            std::string(16 - Hash.str().size(), '0') + Hash.str() +
+                "  test.cpp\n" +
+                std::string(16 - OtherHash.str().size(), '0') +
+                OtherHash.str() + "  other.cpp\n");
+}
@@ -0,0 +1,163 @@
+//===-- UnitTests/TestLibScopeView/TestScopeJSONPrinter.cpp -----*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+
+#include "JSONWriter.h"
+#include "Scope.h"
+#include "ScopeJSONPrinter.h"
+#include "Type.h"
+
+#include "gtest/gtest.h"
+
+using namespace LibScopeView;
+
+namespace {
+
+PrintSettings Settings;
+
+class FakeObject : public Scope {
+public:
+  FakeObject(std::string FakeName) : FakeName(FakeName) {}
+  void writeAsJSON(JSONWriter &JSON) const override {
+    JSON.key("object");
+    JSON.string("Fake");
+    JSON.key("name");
+    JSON.string(FakeName);
+  }
+  std::string FakeName;
+};
+
+class FakeNoJSONObject : public Scope {
+public:
+  bool getIsPrintedAsObject() const override { return false; }
+};
+
+} // namespace
+
+TEST(JSONWriter, Write) {
+  std::string Buffer;
+  JSONWriter JSON(Buffer);
+  JSON.objectBegin();
+  JSON.key("string");
+  JSON.string("a\"b\\c\nd\x01");
+  JSON.key("number");
+  JSON.number(42);
+  JSON.key("array");
+  JSON.arrayBegin();
+  JSON.boolean(true);
+  JSON.boolean(false);
+  JSON.null();
+  JSON.objectBegin();
+  JSON.objectEnd();
+  JSON.arrayEnd();
+  JSON.key("values");
+  JSON.arrayBegin();
+  JSON.numberOrString("-12");
+  JSON.numberOrString("0");
+  JSON.numberOrString("007");
+  JSON.numberOrString("1.5");
+  JSON.numberOrString("-");
+  JSON.arrayEnd();
+  JSON.objectEnd();
+
+  EXPECT_EQ(Buffer, "{\"string\":\"a\\\"b\\\\c\\nd\\u0001\",\"number\":42,"
+                    "\"array\":[true,false,null,{}],"
+                    "\"values\":[-12,0,\"007\",\"1.5\",\"-\"]}");
+}
+
+TEST(ScopeJSONPrinter, Print) {
+  ScopeRoot Root;
+  auto *Top = new FakeObject("Top");
+  auto *Child1 = new FakeObject("Child1");
+  auto *Child2 = new FakeObject("Child2");
+  auto *Child3 = new FakeObject("Child3");
+  Root.addChild(Top);
+  Top->addChild(Child1);
+  Top->addChild(Child2);
+  Child1->addChild(Child3);
+
+  std::stringstream Output;
+  ScopeJSONPrinter(Settings, "In.o", "V0").print(&Root, Output);
+
+  std::string ExpectedJSON(
+      "{\"input_file\":\"In.o\",\"output_version\":\"V0\"}\n");
+  ExpectedJSON +=
+      "{\"id\":1,\"parent\":null,\"object\":\"Fake\",\"name\":\"Top\"}\n";
+  ExpectedJSON +=
+      "{\"id\":2,\"parent\":1,\"object\":\"Fake\",\"name\":\"Child1\"}\n";
+  ExpectedJSON +=
+      "{\"id\":3,\"parent\":2,\"object\":\"Fake\",\"name\":\"Child3\"}\n";
+  ExpectedJSON +=
+      "{\"id\":4,\"parent\":1,\"object\":\"Fake\",\"name\":\"Child2\"}\n";
+
+  EXPECT_EQ(Output.str(), ExpectedJSON);
+}
+
+TEST(ScopeJSONPrinter, SkipObjectsWithNoJSON) {
+  ScopeRoot Root;
+  auto *Top = new FakeObject("Top");
+  auto *Child1NoJSON = new FakeNoJSONObject;
+  auto *Child2 = new FakeObject("Child2");
+  Root.addChild(Top);
+  Top->addChild(Child1NoJSON);
+  Child1NoJSON->addChild(new FakeObject("Hidden"));
+  Top->addChild(Child2);
+
+  std::stringstream Output;
+  std::string InputFile = "..\\file.o";
+  ScopeJSONPrinter(Settings, InputFile, "V0").print(&Root, Output);
+
+  std::string ExpectedJSON(
+      "{\"input_file\":\"..\\\\file.o\",\"output_version\":\"V0\"}\n");
+  ExpectedJSON +=
+      "{\"id\":1,\"parent\":null,\"object\":\"Fake\",\"name\":\"Top\"}\n";
+  ExpectedJSON +=
+      "{\"id\":2,\"parent\":1,\"object\":\"Fake\",\"name\":\"Child2\"}\n";
+
+  EXPECT_EQ(Output.str(), ExpectedJSON);
+}
+
+TEST(ScopeJSONPrinter, ObjectAttributes) {
+  ScopeRoot Root;
+  auto *Enum = new ScopeEnumeration;
+  Enum->setName("Colour");
+  Enum->setLineNumber(3);
+  auto *Red = new TypeEnumerator;
+  Red->setName("Red");
+  Red->setValue("0");
+  Enum->addChild(Red);
+  Root.addChild(Enum);
+
+  std::stringstream Output;
+  ScopeJSONPrinter(Settings, "In.o", "V0").print(&Root, Output);
+
+  std::string ExpectedJSON(
+      "{\"input_file\":\"In.o\",\"output_version\":\"V0\"}\n");
+  ExpectedJSON += "{\"id\":1,\"parent\":null,\"object\":\"Enum\","
+                  "\"name\":\"Colour\",\"type\":null,\"line\":3,"
+                  "\"file\":null,\"offset\":0,\"tag\":null,"
+                  "\"attributes\":{\"class\":false,\"enumerators\":"
+                  "[{\"enumerator\":\"Red\",\"value\":0}]}}\n";
+
+  EXPECT_EQ(Output.str(), ExpectedJSON);
+}
@@ -29,6 +29,7 @@
 
 #include "FileUtilities.h"
 #include "Scope.h"
+#include "ScopeHash.h"
 #include "ScopePrinter.h"
 #include "UtilsForTesting.h"
 
@@ -46,6 +47,7 @@ public:
   TestNamePrinter() : ScopePrinter(TestSettings) {}
 
   const Object *InitObj = nullptr;
+  unsigned InitCount = 0;
 
 private:
   void printImpl(const Object *Obj, std::ostream &OutputStream) override {
@@ -68,9 +70,38 @@ private:
     return Footer;
   }
   void initBeforePrint(const Object *Obj) override {
-    // Should only be called once.
-    assert(InitObj == nullptr);
     InitObj = Obj;
+    ++InitCount;
+  }
+};
+
+// Test printer that can keep its output in the output cache, with the name of
+// the last object printed as its state.
+class TestCachingPrinter : public ScopePrinter {
+public:
+  TestCachingPrinter() : ScopePrinter(TestSettings) {}
+
+  unsigned PrintCount = 0;
+  std::string LastName;
+
+private:
+  void printImpl(const Object *Obj, std::ostream &OutputStream) override {
+    ++PrintCount;
+    LastName = Obj->getName();
+    OutputStream << LastName << '\n';
+    printChildren(Obj);
+  }
+  const std::string &getFileExtension() override {
+    static std::string Ext = "txt";
+    return Ext;
+  }
+  bool hashOutputState(const ScopeCompileUnit &, HashBuilder &Hash) override {
+    Hash.add(LastName);
+    return true;
+  }
+  std::string saveOutputState() override { return LastName; }
+  void restoreOutputState(const std::string &State) override {
+    LastName = State;
   }
 };
 
@@ -88,6 +119,37 @@ TEST(ScopePrinter, StandardPrint) {
   Printer.print(&Scp1, Output);
   EXPECT_EQ(Output.str(), "HEADER\nScope1\nScope2\nFOOTER\n");
   EXPECT_EQ(Printer.InitObj, &Scp1);
+  EXPECT_EQ(Printer.InitCount, 1u);
+}
+
+TEST(ScopePrinter, PartsPrint) {
+  std::stringstream Output;
+  ScopeRoot Part1;
+  auto *CU1 = new ScopeCompileUnit;
+  CU1->setName("CU1");
+  Part1.addChild(CU1);
+  ScopeRoot Part2;
+  auto *CU2 = new ScopeCompileUnit;
+  CU2->setName("CU2");
+  Part2.addChild(CU2);
+
+  // The header and footer are printed once around all the parts, and each
+  // part is initialized before it is printed.
+  TestNamePrinter Printer;
+  Printer.printPart(&Part1, Output);
+  EXPECT_EQ(Printer.InitObj, &Part1);
+  Printer.printPart(&Part2, Output);
+  EXPECT_EQ(Printer.InitObj, &Part2);
+  Printer.printEnd(Output);
+  EXPECT_EQ(Output.str(), "HEADER\n\nCU1\n\nCU2\nFOOTER\n");
+  EXPECT_EQ(Printer.InitCount, 2u);
+
+  // Without any parts only the header and footer are printed.
+  std::stringstream EmptyOutput;
+  TestNamePrinter EmptyPrinter;
+  EmptyPrinter.printEnd(EmptyOutput);
+  EXPECT_EQ(EmptyOutput.str(), "HEADER\nFOOTER\n");
+  EXPECT_EQ(EmptyPrinter.InitCount, 0u);
 }
 
 TEST(ScopePrinter, SplitPrint) {
@@ -132,4 +194,46 @@ TEST(ScopePrinter, SplitPrint) {
             "HEADER\ntest.cu.2\nChild3\nChild4\nFOOTER\n");
 
   EXPECT_EQ(Printer.InitObj, &Root);
+  EXPECT_EQ(Printer.InitCount, 1u);
+}
+
+TEST(ScopePrinter, CachedSplitPrint) {
+  ScopeRoot Root;
+  for (const char *Name : {"cached/cu/1", "cached/cu/2"}) {
+    auto *CU = new ScopeCompileUnit;
+    Root.addChild(CU);
+    CU->setName(Name);
+    auto *Child = new Scope;
+    Child->setName(std::string(Name) + "/child");
+    CU->addChild(Child);
+  }
+  std::string CacheDir(getTestOutputFilePath("output_cache"));
+
+  // Whether or not the first print found the output in the cache, the
+  // second finds it there, and restores the state after each compile unit.
+  TestCachingPrinter First;
+  First.setOutputCache(CacheDir);
+  First.print(&Root, getTestOutputDir());
+  EXPECT_EQ(First.LastName, "cached/cu/2/child");
+  EXPECT_EQ(readTestOutputFile("cached_cu_1.txt"),
+            "cached/cu/1\ncached/cu/1/child\n");
+
+  clearTestOutputFile("cached_cu_1.txt");
+  clearTestOutputFile("cached_cu_2.txt");
+  TestCachingPrinter Second;
+  Second.setOutputCache(CacheDir);
+  Second.print(&Root, getTestOutputDir());
+  EXPECT_EQ(Second.PrintCount, 0u);
+  EXPECT_EQ(Second.LastName, "cached/cu/2/child");
+  EXPECT_EQ(readTestOutputFile("cached_cu_1.txt"),
+            "cached/cu/1\ncached/cu/1/child\n");
+  EXPECT_EQ(readTestOutputFile("cached_cu_2.txt"),
+            "cached/cu/2\ncached/cu/2/child\n");
+
+  // Printers that do not hash their state print each compile unit again.
+  TestNamePrinter Uncached;
+  Uncached.setOutputCache(CacheDir);
+  Uncached.print(&Root, getTestOutputDir());
+  EXPECT_EQ(readTestOutputFile("cached_cu_1.txt"),
+            "HEADER\ncached/cu/1\ncached/cu/1/child\nFOOTER\n");
 }
@@ -82,6 +82,57 @@ TEST(ScopeTextPrinter, PrintNoChildren) {
   EXPECT_EQ(Output.str(), Expected);
 }
 
+TEST(ScopeTextPrinter, PrintRecordedExtents) {
+  PrintSettings Settings;
+  Settings.showAll();
+
+  // The recorded extents are used instead of examining the tree.
+  ScopeRoot Root;
+  Root.addChild(new FakeObject("Top", 11, "foo.cpp"));
+  Root.getExtents().updateLineNumber(1234);
+  Root.getExtents().setIsRecorded();
+
+  std::stringstream Output;
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+
+  std::string Expected("{InputFile} \"In.o\"\n\n"
+                       "{Source} \"foo.cpp\"\n"
+                       "  11  {Fake} Top\n"
+                       "        - Attr\n");
+
+  EXPECT_EQ(Output.str(), Expected);
+}
+
+TEST(ScopeTextPrinter, PrintLevelWithRecordedExtents) {
+  PrintSettings Settings;
+  Settings.showAll();
+  Settings.ShowLevel = true;
+
+  // The level column is as wide as the count of the recorded objects,
+  // rather than their depth.
+  ScopeRoot Root;
+  auto *Top = new FakeObject("Top", 1, "foo.cpp");
+  Root.addChild(Top);
+  Root.getExtents().addObject(*Top, 0);
+  for (int Index = 0; Index < 10; ++Index) {
+    auto *Child = new FakeObject("Child", 2, "foo.cpp");
+    Top->addChild(Child);
+    Root.getExtents().addObject(*Child, 1);
+  }
+  Root.getExtents().setIsRecorded();
+
+  std::stringstream Output;
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+
+  std::string Printed = Output.str();
+  EXPECT_EQ(Printed.substr(0, Printed.find("{Fake} Child")),
+            "     {InputFile} \"In.o\"\n\n"
+            "     {Source} \"foo.cpp\"\n"
+            "00   1  {Fake} Top\n"
+            "          - Attr\n"
+            "01   2    ");
+}
+
 TEST(ScopeTextPrinter, Print) {
   PrintSettings Settings;
   Settings.showAll();
@@ -204,7 +255,7 @@ TEST(ScopeTextPrinter, SkipObjectsDependingOnFilters) {
 
   std::stringstream Output;
 
-  Settings.Filters = {std::regex("Child1")};
+  Settings.Filters = {"Child1"};
   ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
   EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n\n"
                           "{Source} \"foo.cpp\"\n"
@@ -228,7 +279,7 @@ TEST(ScopeTextPrinter, SkipObjectsDependingOnFilters) {
 
   Output.str("");
   Settings.FilterAnys.clear();
-  Settings.TreeFilters = {std::regex("Child1")};
+  Settings.TreeFilters = {"Child1"};
   ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
   EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n\n"
                           "{Source} \"foo.cpp\"\n"
@@ -242,17 +293,118 @@ TEST(ScopeTextPrinter, SkipObjectsDependingOnFilters) {
                           "            - Attr\n");
 
   Output.str("");
-  Settings.TreeFilters = {std::regex("Child2")};
-  Settings.Filters = {std::regex("Child3")};
+  Settings.TreeFilters = {"Child2"};
+  Settings.Filters = {"Child3"};
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+  EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n\n"
+                          "{Source} \"foo.cpp\"\n"
+                          "  11  {Fake} Top\n"
+                          "        - Attr\n"
+                          "   1      {Fake} Child3\n"
+                          "            - Attr\n"
+                          "1122    {Fake} Child2\n"
+                          "          - Attr\n");
+}
+
+TEST(ScopeTextPrinter, SkipSubtreesWithoutFilteredNames) {
+  PrintSettings Settings;
+  Settings.showAll();
+
+  ScopeRoot Root;
+  auto *Top = new FakeObject("Top", 11, "foo.cpp");
+  auto *Child1 = new FakeObject("Child1", 111, "foo.cpp");
+  auto *Child2 = new FakeObject("Child2", 1122, "foo.cpp");
+  auto *Child3 = new FakeObject("Child3", 1, "foo.cpp");
+  Root.addChild(Top);
+  Top->addChild(Child1);
+  Top->addChild(Child2);
+  Child1->addChild(Child3);
+
+  // Summarise the names as the reader does.
+  for (FakeObject *Obj : {Top, Child1, Child2, Child3}) {
+    Obj->setName(Obj->FakeName);
+    Root.getNames().push_back(Obj->getNamePoolRef());
+  }
+  Child1->getDescendantNames() = NameSummary({Child3->getNamePoolRef()});
+  Top->getDescendantNames() =
+      NameSummary({Child1->getNamePoolRef(), Child2->getNamePoolRef(),
+                   Child3->getNamePoolRef()});
+  Root.getDescendantNames() = NameSummary(Root.getNames());
+  Root.setHasNameSummaries();
+
+  std::stringstream Output;
+  Settings.Filters = {"Child3"};
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+  EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n\n"
+                          "{Source} \"foo.cpp\"\n"
+                          "   1      {Fake} Child3\n"
+                          "            - Attr\n");
+
+  // The children of Child1 are not visited if its summary does not have the
+  // filtered name.
+  Output.str("");
+  Child1->getDescendantNames() = NameSummary();
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+  EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n");
+
+  // The same is done when printing a compile unit of the tree.
+  Output.str("");
+  ScopeTextPrinter(Settings, "In.o").print(Top, Output);
+  EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n");
+
+  // And when finding the objects matching a tree filter.
+  Output.str("");
+  Settings.Filters.clear();
+  Settings.TreeFilters = {"Child3"};
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+  EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n");
+}
+
+TEST(ScopeTextPrinter, FindExactNamesInIndex) {
+  PrintSettings Settings;
+  Settings.showAll();
+
+  ScopeRoot Root;
+  auto *Top = new FakeObject("Top", 11, "foo.cpp");
+  auto *Child1 = new FakeObject("Child1", 111, "foo.cpp");
+  auto *Child2 = new FakeObject("Child2", 1122, "foo.cpp");
+  auto *Child3 = new FakeObject("Child3", 1, "foo.cpp");
+  Root.addChild(Top);
+  Top->addChild(Child1);
+  Top->addChild(Child2);
+  Child1->addChild(Child3);
+  for (FakeObject *Obj : {Top, Child1, Child2, Child3})
+    Obj->setName(Obj->FakeName);
+  Root.buildNameIndex();
+
+  std::stringstream Output;
+  Settings.TreeFilters = {"Child1"};
+  Settings.Filters = {"Child2"};
   ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
   EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n\n"
                           "{Source} \"foo.cpp\"\n"
                           "  11  {Fake} Top\n"
                           "        - Attr\n"
+                          " 111    {Fake} Child1\n"
+                          "          - Attr\n"
                           "   1      {Fake} Child3\n"
                           "            - Attr\n"
                           "1122    {Fake} Child2\n"
                           "          - Attr\n");
+
+  // Only the objects found in the index are printed, so an object added
+  // after the index was built is not.
+  Output.str("");
+  Settings.TreeFilters.clear();
+  Settings.Filters = {"Child3"};
+  auto *Child4 = new FakeObject("Child3", 2, "foo.cpp");
+  Child4->setName(Child4->FakeName);
+  Child2->addChild(Child4);
+  ScopeTextPrinter(Settings, "In.o").print(&Root, Output);
+  EXPECT_EQ(Output.str(), "{InputFile} \"In.o\"\n\n"
+                          "{Source} \"foo.cpp\"\n"
+                          "   1      {Fake} Child3\n"
+                          "            - Attr\n");
 }
 
 TEST(ScopeTextPrinter, PrintZeroLine) {
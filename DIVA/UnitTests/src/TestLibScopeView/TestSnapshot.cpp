@@ -0,0 +1,319 @@
+//===-- UnitTests/TestLibScopeView/TestSnapshot.cpp -------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for saving and loading LibScopeView snapshots.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Snapshot.h"
+#include "Error.h"
+#include "Line.h"
+#include "Scope.h"
+#include "Symbol.h"
+#include "Type.h"
+#include "UtilsForTesting.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Save a compile unit with a class, an enumeration, a function and its
+// declaration, and a line.
+void saveTestSnapshot(const std::string &Path, const PrintSettings &Settings) {
+  ScopeRoot Root;
+  Root.setName("test.elf");
+
+  auto *CU = new ScopeCompileUnit;
+  CU->setName("test.cpp");
+  CU->setDieOffset(0x10);
+  CU->getExtents().updateLineNumber(7);
+  CU->getExtents().updateLevel(3);
+  CU->getExtents().addObjectCount(9);
+  CU->getExtents().addDwarfTag(0x11);
+  CU->getExtents().setIsRecorded();
+  Root.addChild(CU);
+
+  auto *Class = new ScopeAggregate;
+  Class->setIsClassType();
+  Class->setName("C");
+  Class->setQualifiedName("ns::");
+  Class->setLineNumber(1);
+  Class->setDieOffset(0x20);
+  Class->setDieTag(0x2);
+  CU->addChild(Class);
+
+  auto *Member = new Symbol;
+  Member->setIsMember();
+  Member->setAccessSpecifier(AccessSpecifier::Private);
+  Member->setName("m");
+  Member->setLineNumber(2);
+  Member->setDieOffset(0x30);
+  Class->addChild(Member);
+
+  auto *Enumeration = new ScopeEnumeration;
+  Enumeration->setIsClass();
+  Enumeration->setName("E");
+  Enumeration->setLineNumber(3);
+  CU->addChild(Enumeration);
+
+  auto *Enumerator = new TypeEnumerator;
+  Enumerator->setName("A");
+  Enumerator->setValue("4");
+  Enumeration->addChild(Enumerator);
+
+  auto *Declaration = new ScopeFunction;
+  Declaration->setIsDeclaration();
+  Declaration->setName("f");
+  Declaration->setLineNumber(4);
+  Class->addChild(Declaration);
+
+  auto *Definition = new ScopeFunction;
+  Definition->setIsStatic();
+  Definition->setName("f");
+  Definition->setFilePath("test.h");
+  Definition->setLineNumber(5);
+  Definition->setReference(Declaration);
+  CU->addChild(Definition);
+
+  auto *Ln = new Line;
+  Ln->setIsNewStatement();
+  Ln->setAddress(0x400);
+  Ln->setLineNumber(6);
+  Definition->addChild(Ln);
+
+  auto *Int = new Type;
+  Int->setIsBaseType();
+  Int->setName("int");
+  Int->setByteSize(4);
+  Int->setLineNumber(7);
+  CU->addChild(Int);
+  // The type is later in the tree than the function.
+  Definition->setType(Int);
+
+  saveSnapshot(Root, Settings, Path);
+}
+
+} // namespace
+
+TEST(Snapshot, SaveAndLoad) {
+  const std::string Path = getTestOutputFilePath("SaveAndLoad.snap");
+  clearTestOutputFile("SaveAndLoad.snap");
+  PrintSettings Settings;
+  saveTestSnapshot(Path, Settings);
+
+  ASSERT_TRUE(isFileFormatSnapshot(Path));
+  std::unique_ptr<ScopeRoot> Root = SnapshotReader().loadFile(Path, Settings);
+  ASSERT_TRUE(Root);
+  EXPECT_EQ(Root->getName(), "test.elf");
+  ASSERT_EQ(Root->getChildren().size(), 1u);
+
+  auto *CU = dyn_cast<ScopeCompileUnit>(Root->getChildren()[0]);
+  ASSERT_TRUE(CU);
+  EXPECT_EQ(CU->getName(), "test.cpp");
+  EXPECT_EQ(CU->getDieOffset(), 0x10u);
+  EXPECT_EQ(CU->getExtents().getMaxLineNumber(), 7u);
+  EXPECT_EQ(CU->getExtents().getMaxLevel(), 3u);
+  EXPECT_EQ(CU->getExtents().getObjectCount(), 9u);
+  EXPECT_EQ(CU->getExtents().getDwarfTags(), std::set<Dwarf_Half>{0x11});
+  EXPECT_TRUE(CU->getExtents().getIsRecorded());
+  ASSERT_EQ(CU->getChildren().size(), 4u);
+
+  auto *Class = dyn_cast<ScopeAggregate>(CU->getChildren()[0]);
+  ASSERT_TRUE(Class);
+  EXPECT_TRUE(Class->getIsClassType());
+  EXPECT_FALSE(Class->getIsUnionType());
+  EXPECT_EQ(Class->getQualifiedName(), "ns::");
+  EXPECT_EQ(Class->getDieOffset(), 0x20u);
+  EXPECT_EQ(Class->getDieTag(), 0x2);
+  ASSERT_EQ(Class->getChildren().size(), 2u);
+
+  auto *Member = dyn_cast<Symbol>(Class->getChildren()[0]);
+  ASSERT_TRUE(Member);
+  EXPECT_TRUE(Member->getIsMember());
+  EXPECT_EQ(Member->getAccessSpecifier(), AccessSpecifier::Private);
+  EXPECT_EQ(Member->getName(), "m");
+  EXPECT_EQ(Member->getParent(), Class);
+
+  auto *Enumeration = dyn_cast<ScopeEnumeration>(CU->getChildren()[1]);
+  ASSERT_TRUE(Enumeration);
+  EXPECT_TRUE(Enumeration->getIsClass());
+  ASSERT_EQ(Enumeration->getChildren().size(), 1u);
+  auto *Enumerator = dyn_cast<TypeEnumerator>(Enumeration->getChildren()[0]);
+  ASSERT_TRUE(Enumerator);
+  EXPECT_EQ(Enumerator->getValue(), "4");
+
+  auto *Definition = dyn_cast<ScopeFunction>(CU->getChildren()[2]);
+  ASSERT_TRUE(Definition);
+  EXPECT_TRUE(Definition->getIsStatic());
+  EXPECT_FALSE(Definition->getIsDeclaration());
+  EXPECT_EQ(Definition->getFilePath(), "test.h");
+  EXPECT_EQ(Definition->getReference(), Class->getChildren()[1]);
+  EXPECT_EQ(Definition->getType(), CU->getChildren()[3]);
+  ASSERT_EQ(Definition->getLines().size(), 1u);
+  EXPECT_TRUE(Definition->getLines()[0]->getIsNewStatement());
+  EXPECT_EQ(Definition->getLines()[0]->getAddress(), 0x400u);
+
+  auto *Int = dyn_cast<Type>(CU->getChildren()[3]);
+  ASSERT_TRUE(Int);
+  EXPECT_TRUE(Int->getIsBaseType());
+  EXPECT_EQ(Int->getByteSize(), 4u);
+  EXPECT_EQ(Int->getName(), "int");
+}
+
+TEST(Snapshot, DifferentSettings) {
+  const std::string Path = getTestOutputFilePath("DifferentSettings.snap");
+  clearTestOutputFile("DifferentSettings.snap");
+  PrintSettings Settings;
+  saveTestSnapshot(Path, Settings);
+
+  // The names of the saved tree depend on how void types are shown.
+  Settings.ShowVoid = false;
+  LibScopeError::ScopedExitAsException ExitAsException;
+  EXPECT_THROW(SnapshotReader().loadFile(Path, Settings),
+               LibScopeError::ExitException);
+}
+
+TEST(Snapshot, NotASnapshot) {
+  EXPECT_FALSE(isFileFormatSnapshot(getTestInputFilePath("test.o")));
+  EXPECT_FALSE(isFileFormatSnapshot(getTestInputFilePath("3Bytes.o")));
+}
+
+TEST(Snapshot, SaveAndLoadCompileUnit) {
+  ScopeRoot Root;
+  auto *Other = new ScopeCompileUnit;
+  Other->setDieOffset(0x10);
+  Root.addChild(Other);
+  auto *Int = new Type;
+  Int->setIsBaseType();
+  Int->setName("int");
+  Int->setDieOffset(0x20);
+  Int->setIsGlobalReference();
+  Other->addChild(Int);
+
+  auto *CU = new ScopeCompileUnit;
+  CU->setName("test.cpp");
+  CU->setDieOffset(0x10b);
+  Root.addChild(CU);
+  auto *Variable = new Symbol;
+  Variable->setIsVariable();
+  Variable->setName("v");
+  Variable->setDieOffset(0x120);
+  Variable->setType(Int);
+  Variable->setIsGlobalReference();
+  CU->addChild(Variable);
+  auto *Ln = new Line;
+  Ln->setAddress(0x400);
+  Ln->setDieOffset(0x400);
+  CU->addChild(Ln);
+
+  // Save the compile unit as if its header was at 0x100, and load it at
+  // 0x200.
+  std::string Saved = saveCompileUnit(*CU, 0x100);
+  std::vector<std::pair<Object *, Dwarf_Off>> Types;
+  std::unique_ptr<ScopeCompileUnit> Loaded = loadCompileUnit(
+      Saved.data(), Saved.size(), 0x200,
+      [&](Object &Obj, bool IsType, Dwarf_Off Offset) {
+        EXPECT_TRUE(IsType);
+        Types.emplace_back(&Obj, Offset);
+      });
+  ASSERT_TRUE(Loaded);
+  EXPECT_EQ(Loaded->getName(), "test.cpp");
+  EXPECT_EQ(Loaded->getDieOffset(), 0x20bu);
+  ASSERT_EQ(Loaded->getChildren().size(), 1u);
+  ASSERT_EQ(Loaded->getLines().size(), 1u);
+  EXPECT_EQ(Loaded->getLines()[0]->getDieOffset(), 0x400u);
+
+  // The type in the other compile unit is given by its offset, and whether
+  // the variable is referred to from other compile units is not kept.
+  Object *LoadedVariable = Loaded->getChildren()[0];
+  EXPECT_EQ(LoadedVariable->getDieOffset(), 0x220u);
+  EXPECT_FALSE(LoadedVariable->getIsGlobalReference());
+  EXPECT_EQ(LoadedVariable->getType(), nullptr);
+  ASSERT_EQ(Types.size(), 1u);
+  EXPECT_EQ(Types[0].first, LoadedVariable);
+  EXPECT_EQ(Types[0].second, 0x20u);
+
+  // Damaged data is not loaded.
+  EXPECT_FALSE(loadCompileUnit(Saved.data(), Saved.size() - 1, 0x200,
+                               [](Object &, bool, Dwarf_Off) {}));
+}
+
+TEST(Snapshot, HashCompileUnit) {
+  // A compile unit with a variable of a type in another compile unit, and a
+  // line, all moved by Shift.
+  auto MakeRoot = [](Dwarf_Off Shift, const char *Name) {
+    auto Root = std::make_unique<ScopeRoot>();
+    auto *Other = new ScopeCompileUnit;
+    Other->setDieOffset(0x10);
+    Root->addChild(Other);
+    auto *Int = new Type;
+    Int->setIsBaseType();
+    Int->setName("int");
+    Int->setDieOffset(0x20);
+    Int->setIsGlobalReference();
+    Other->addChild(Int);
+
+    auto *CU = new ScopeCompileUnit;
+    CU->setName("test.cpp");
+    CU->setDieOffset(0x10b + Shift);
+    Root->addChild(CU);
+    auto *Variable = new Symbol;
+    Variable->setIsVariable();
+    Variable->setName(Name);
+    Variable->setDieOffset(0x120 + Shift);
+    Variable->setType(Int);
+    CU->addChild(Variable);
+    auto *Ln = new Line;
+    Ln->setAddress(0x400 + Shift);
+    Ln->setDieOffset(0x400 + Shift);
+    CU->addChild(Ln);
+    return Root;
+  };
+  auto GetCU = [](const ScopeRoot &Root) {
+    return static_cast<const ScopeCompileUnit *>(Root.getChildren()[1]);
+  };
+
+  auto Root = MakeRoot(0, "v");
+  auto Moved = MakeRoot(0x100, "v");
+  auto Renamed = MakeRoot(0, "w");
+  const ScopeCompileUnit::OutputHashes &Hashes = hashCompileUnit(*GetCU(*Root));
+  const ScopeCompileUnit::OutputHashes &MovedHashes =
+      hashCompileUnit(*GetCU(*Moved));
+  const ScopeCompileUnit::OutputHashes &RenamedHashes =
+      hashCompileUnit(*GetCU(*Renamed));
+
+  // Moving the compile unit changes only the hash of the offsets.
+  EXPECT_EQ(Hashes.Content, MovedHashes.Content);
+  EXPECT_NE(Hashes.Offsets, MovedHashes.Offsets);
+  EXPECT_NE(Hashes.Content, RenamedHashes.Content);
+  EXPECT_EQ(Hashes.Offsets, RenamedHashes.Offsets);
+
+  // The hashes are kept with the compile unit.
+  EXPECT_EQ(&hashCompileUnit(*GetCU(*Root)), &Hashes);
+}
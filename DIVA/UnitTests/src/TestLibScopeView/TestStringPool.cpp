@@ -51,3 +51,19 @@ TEST(StringPool, DeduplicateStrings) {
   EXPECT_EQ(BarRef, Pool.get(Bar));
   EXPECT_EQ(BazRef, Pool.get(Baz));
 }
+
+TEST(StringPool, ScopedStringPool) {
+  StringPool &Global = getGlobalStringPool();
+  StringPool Outer;
+  StringPool Inner;
+  {
+    ScopedStringPool UseOuter(Outer);
+    EXPECT_EQ(&getGlobalStringPool(), &Outer);
+    {
+      ScopedStringPool UseInner(Inner);
+      EXPECT_EQ(&getGlobalStringPool(), &Inner);
+    }
+    EXPECT_EQ(&getGlobalStringPool(), &Outer);
+  }
+  EXPECT_EQ(&getGlobalStringPool(), &Global);
+}
@@ -0,0 +1,119 @@
+//===-- UnitTests/TestLibScopeView/TestSummaryEstimate.cpp ------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::SummaryEstimate.
+///
+//===----------------------------------------------------------------------===//
+
+#include "SummaryEstimate.h"
+#include "SummaryTable.h"
+
+#include "gtest/gtest.h"
+
+#include <numeric>
+#include <sstream>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Create a table from the stats in the format of SummaryTable::writeCounts.
+SummaryTable makeTable(const std::string &Counts) {
+  SummaryTable Table(nullptr);
+  std::stringstream In(Counts);
+  EXPECT_TRUE(Table.addCounts(In));
+  return Table;
+}
+
+} // end anonymous namespace
+
+TEST(SummaryEstimate, DrawSampleParts) {
+  const std::vector<uint64_t> Sizes = {10, 0, 1000, 10};
+  std::vector<unsigned> Draws = drawSampleParts(Sizes, 100, 1);
+  ASSERT_EQ(Draws.size(), Sizes.size());
+  EXPECT_EQ(std::accumulate(Draws.begin(), Draws.end(), 0U), 100U);
+  EXPECT_EQ(Draws[1], 0U);
+  EXPECT_GT(Draws[2], 90U);
+
+  // The same seed draws the same parts.
+  EXPECT_EQ(drawSampleParts(Sizes, 100, 1), Draws);
+  EXPECT_NE(drawSampleParts(Sizes, 100, 2), Draws);
+
+  EXPECT_EQ(drawSampleParts({0, 0}, 10, 1), std::vector<unsigned>({0, 0}));
+}
+
+TEST(SummaryEstimate, PrintSummaryEstimate) {
+  // The functions are in proportion to the sizes of the parts, so each draw
+  // estimates them exactly, but the printed functions are not.
+  SummaryEstimate Estimate({100, 300, 400});
+  Estimate.addPart(0, 1, makeTable("Function 1 1\nTotals 1 1\n"));
+  Estimate.addPart(1, 1, makeTable("Function 3 2\nTotals 3 2\n"));
+
+  std::stringstream Result;
+  Estimate.printSummaryEstimate(Result);
+  const std::string Divider(
+      "     -----------------------------------------------------------\n");
+  const std::string ExpectedStart =
+      Divider +
+      "     Object                  Total       +/-   Printed       +/-\n" +
+      Divider +
+      "     Alias                       0         0         0         0\n";
+  const std::string ExpectedEnd =
+      "     Function                    8         0         7         3\n"
+      "     Member                      0         0         0         0\n";
+  const std::string ExpectedFooter =
+      Divider +
+      "     Totals                      8         0         7         3\n"
+      "\n"
+      "     Estimated from 2 draws of 3 groups of compile units.\n"
+      "     The 2 groups drawn hold 50.0% of the bytes.\n"
+      "     +/- is the 95% confidence interval of each estimate.\n"
+      "\n";
+  EXPECT_EQ(Result.str().substr(0, ExpectedStart.size()), ExpectedStart);
+  EXPECT_NE(Result.str().find(ExpectedEnd), std::string::npos);
+  ASSERT_GE(Result.str().size(), ExpectedFooter.size());
+  EXPECT_EQ(Result.str().substr(Result.str().size() - ExpectedFooter.size()),
+            ExpectedFooter);
+}
+
+TEST(SummaryEstimate, RepeatedDraws) {
+  // A part drawn twice counts as two draws of the same stats.
+  SummaryEstimate Once({100, 100});
+  Once.addPart(0, 1, makeTable("Block 2 1\nTotals 2 1\n"));
+  Once.addPart(0, 1, makeTable("Block 2 1\nTotals 2 1\n"));
+  SummaryEstimate Twice({100, 100});
+  Twice.addPart(0, 2, makeTable("Block 2 1\nTotals 2 1\n"));
+
+  std::stringstream OnceResult;
+  Once.printSummaryEstimate(OnceResult);
+  std::stringstream TwiceResult;
+  Twice.printSummaryEstimate(TwiceResult);
+  EXPECT_NE(TwiceResult.str().find("Block                       4         0"
+                                   "         2         0"),
+            std::string::npos);
+  EXPECT_NE(TwiceResult.str().find("The 1 groups drawn hold 50.0%"),
+            std::string::npos);
+  EXPECT_NE(OnceResult.str(), TwiceResult.str());
+}
@@ -315,3 +315,96 @@ TEST(SummaryTable, PrintSettingsSummaryTable) {
 
   EXPECT_EQ(Result.str(), Expected);
 }
+
+TEST(SummaryTable, AddObjectsSummaryTable) {
+  ScopeRoot Part1;
+  ScopeRoot Part2;
+  for (uint32_t Kind = 0; Kind != ObjectKindSize; ++Kind) {
+    generateTestObject(Part1, ObjectKind(Kind));
+    generateTestObject(Part2, ObjectKind(Kind));
+  }
+
+  // Adding the parts of a tree gives the same table as adding the whole tree.
+  SummaryTable PartsTable(nullptr);
+  PartsTable.addObjects(Part1);
+  PartsTable.addObjects(Part2);
+
+  for (uint32_t Kind = 0; Kind != ObjectKindSize; ++Kind)
+    generateTestObject(Part1, ObjectKind(Kind));
+  SummaryTable WholeTable(Part1, nullptr);
+
+  std::stringstream PartsResult;
+  PartsTable.printSummaryTable(PartsResult);
+  std::stringstream WholeResult;
+  WholeTable.printSummaryTable(WholeResult);
+
+  EXPECT_EQ(PartsResult.str(), WholeResult.str());
+  EXPECT_NE(PartsResult.str().find("Totals                    32       32"),
+            std::string::npos);
+}
+
+TEST(SummaryTable, AddTableSummaryTable) {
+  ScopeRoot Root1;
+  ScopeRoot Root2;
+  for (uint32_t Kind = 0; Kind != ObjectKindSize; ++Kind) {
+    generateTestObject(Root1, ObjectKind(Kind));
+    generateTestObject(Root2, ObjectKind(Kind));
+  }
+
+  // Adding the table of each tree gives the same table as adding each tree.
+  SummaryTable AddedTables(nullptr);
+  AddedTables.addTable(SummaryTable(Root1, nullptr));
+  AddedTables.addTable(SummaryTable(Root2, nullptr));
+
+  SummaryTable AddedObjects(nullptr);
+  AddedObjects.addObjects(Root1);
+  AddedObjects.addObjects(Root2);
+
+  std::stringstream TablesResult;
+  AddedTables.printSummaryTable(TablesResult);
+  std::stringstream ObjectsResult;
+  AddedObjects.printSummaryTable(ObjectsResult);
+
+  EXPECT_EQ(TablesResult.str(), ObjectsResult.str());
+  EXPECT_NE(TablesResult.str().find("Totals                    32       32"),
+            std::string::npos);
+}
+
+TEST(SummaryTable, AddCountsSummaryTable) {
+  ScopeRoot Root1;
+  ScopeRoot Root2;
+  for (uint32_t Kind = 0; Kind != ObjectKindSize; ++Kind) {
+    generateTestObject(Root1, ObjectKind(Kind));
+    generateTestObject(Root2, ObjectKind(Kind));
+  }
+  generateTestObject(Root2, ObjectKind::Block);
+
+  // Adding the counts written for each tree, one after another, gives the
+  // same table as adding each tree.
+  std::stringstream Counts;
+  SummaryTable(Root1, nullptr).writeCounts(Counts);
+  SummaryTable(Root2, nullptr).writeCounts(Counts);
+  SummaryTable AddedCounts(nullptr);
+  EXPECT_TRUE(AddedCounts.addCounts(Counts));
+  EXPECT_TRUE(AddedCounts.addCounts(Counts));
+  EXPECT_EQ(AddedCounts.getFound("Block"), 3u);
+  EXPECT_EQ(AddedCounts.getPrinted("Block"), 3u);
+
+  SummaryTable AddedObjects(nullptr);
+  AddedObjects.addObjects(Root1);
+  AddedObjects.addObjects(Root2);
+
+  std::stringstream CountsResult;
+  AddedCounts.printSummaryTable(CountsResult);
+  std::stringstream ObjectsResult;
+  AddedObjects.printSummaryTable(ObjectsResult);
+
+  EXPECT_EQ(CountsResult.str(), ObjectsResult.str());
+  EXPECT_NE(CountsResult.str().find("Totals                    33       33"),
+            std::string::npos);
+
+  std::stringstream Damaged("Block 1 x\n");
+  EXPECT_FALSE(SummaryTable(nullptr).addCounts(Damaged));
+  std::stringstream Truncated("Block 1 1\n");
+  EXPECT_FALSE(SummaryTable(nullptr).addCounts(Truncated));
+}
@@ -0,0 +1,152 @@
+//===-- UnitTests/TestLibScopeView/TestTypeSharing.cpp ----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::shareTypes.
+///
+//===----------------------------------------------------------------------===//
+
+#include "TypeSharing.h"
+#include "Scope.h"
+#include "Symbol.h"
+#include "Type.h"
+
+#include "gtest/gtest.h"
+
+using namespace LibScopeView;
+
+namespace {
+
+// A compile unit with a class "ns::C" holding a member of the given name and
+// a function declaration, and a definition of the function outside it.
+struct TestUnit {
+  TestUnit(ScopeRoot &Root, const std::string &Name,
+           const std::string &MemberName, Dwarf_Off FirstOffset) {
+    CU = new ScopeCompileUnit;
+    CU->setName(Name);
+    CU->setDieOffset(FirstOffset);
+    Root.addChild(CU);
+
+    auto *Namespace = new ScopeNamespace;
+    Namespace->setName("ns");
+    Namespace->setDieOffset(++FirstOffset);
+    CU->addChild(Namespace);
+
+    Class = new ScopeAggregate;
+    Class->setIsClassType();
+    Class->setName("C");
+    Class->setLineNumber(1);
+    Class->setDieOffset(++FirstOffset);
+    Namespace->addChild(Class);
+
+    Member = new Symbol;
+    Member->setIsMember();
+    Member->setName(MemberName);
+    Member->setLineNumber(2);
+    Member->setDieOffset(++FirstOffset);
+    Class->addChild(Member);
+
+    Declaration = new ScopeFunction;
+    Declaration->setName("f");
+    Declaration->setLineNumber(3);
+    Declaration->setIsDeclaration();
+    Declaration->setDieOffset(++FirstOffset);
+    Class->addChild(Declaration);
+
+    Definition = new ScopeFunction;
+    Definition->setName("f");
+    Definition->setLineNumber(3);
+    Definition->setReference(Declaration);
+    Definition->setDieOffset(++FirstOffset);
+    CU->addChild(Definition);
+
+    Variable = new Symbol;
+    Variable->setIsVariable();
+    Variable->setName("v");
+    Variable->setType(Member);
+    Variable->setDieOffset(++FirstOffset);
+    Definition->addChild(Variable);
+  }
+
+  ScopeCompileUnit *CU;
+  ScopeAggregate *Class;
+  Symbol *Member;
+  ScopeFunction *Declaration;
+  ScopeFunction *Definition;
+  Symbol *Variable;
+};
+
+} // namespace
+
+TEST(TypeSharing, ShareTypes) {
+  ScopeRoot Root;
+  TestUnit First(Root, "first.cpp", "m", 0);
+  TestUnit Same(Root, "same.cpp", "m", 100);
+  TestUnit Other(Root, "other.cpp", "n", 200);
+  for (TestUnit *Unit : {&First, &Same, &Other})
+    Unit->CU->getExtents().addObjectCount(7);
+  Root.getExtents().addObjectCount(21);
+
+  shareTypes(Root);
+
+  // The first copy keeps its members.
+  EXPECT_EQ(First.Class->getChildren(),
+            (std::vector<Object *>{First.Member, First.Declaration}));
+  EXPECT_EQ(First.Definition->getReference(), First.Declaration);
+  EXPECT_EQ(First.Variable->getType(), First.Member);
+
+  // The same type in another compile unit is left without its members, and
+  // the references to them are moved to the first copy's.
+  EXPECT_TRUE(Same.Class->getChildren().empty());
+  EXPECT_EQ(Same.CU->getChildren().front()->getKind(),
+            Object::SV_ScopeNamespace);
+  EXPECT_EQ(Same.Definition->getReference(), First.Declaration);
+  EXPECT_EQ(Same.Variable->getType(), First.Member);
+
+  // The freed members are no longer counted in the extents.
+  EXPECT_EQ(First.CU->getExtents().getObjectCount(), 7u);
+  EXPECT_EQ(Same.CU->getExtents().getObjectCount(), 5u);
+  EXPECT_EQ(Root.getExtents().getObjectCount(), 19u);
+
+  // A different type keeps its members.
+  EXPECT_EQ(Other.Class->getChildren().size(), 2u);
+  EXPECT_EQ(Other.Definition->getReference(), Other.Declaration);
+
+  EXPECT_EQ(Root.getSharedTypes(),
+            (std::unordered_map<const Scope *, const Scope *>{
+                {Same.Class, First.Class}}));
+}
+
+TEST(TypeSharing, NoSharedTypes) {
+  ScopeRoot Root;
+  TestUnit First(Root, "first.cpp", "m", 0);
+  TestUnit Other(Root, "other.cpp", "m", 100);
+  Other.Member->setLineNumber(5);
+
+  shareTypes(Root);
+
+  EXPECT_EQ(First.Class->getChildren().size(), 2u);
+  EXPECT_EQ(Other.Class->getChildren().size(), 2u);
+  EXPECT_TRUE(Root.getSharedTypes().empty());
+}
@@ -0,0 +1,104 @@
+//===-- UnitTests/TestLibScopeView/TestWorkerProcesses.cpp ------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for running items of work in LibScopeView worker processes.
+///
+//===----------------------------------------------------------------------===//
+
+#include "WorkerProcesses.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Get the output expected of item Index, of Size bytes.
+std::string getItemOutput(size_t Index, size_t Size) {
+  std::string Output = "item " + std::to_string(Index) + '\n';
+  while (Output.size() < Size)
+    Output += static_cast<char>('a' + (Output.size() + Index) % 26);
+  Output.resize(Size);
+  return Output;
+}
+
+} // namespace
+
+TEST(WorkerProcesses, OutputInItemOrder) {
+  if (!canRunWorkerProcesses())
+    return;
+  const size_t ItemCount = 50;
+  std::ostringstream Output;
+  ASSERT_TRUE(runInWorkerProcesses(
+      ItemCount, 4,
+      [](size_t Index, std::ostream &ItemOutput) {
+        ItemOutput << getItemOutput(Index, 100 + Index * 1000);
+      },
+      Output));
+
+  std::string Expected;
+  for (size_t Index = 0; Index < ItemCount; ++Index)
+    Expected += getItemOutput(Index, 100 + Index * 1000);
+  EXPECT_EQ(Output.str(), Expected);
+}
+
+TEST(WorkerProcesses, OutputLargerThanRing) {
+  if (!canRunWorkerProcesses())
+    return;
+  // The output of the first item is copied out while it is written, for the
+  // worker to finish it.
+  const size_t ItemSize = 5 * 1024 * 1024 + 7;
+  std::ostringstream Output;
+  ASSERT_TRUE(runInWorkerProcesses(
+      3, 2,
+      [&](size_t Index, std::ostream &ItemOutput) {
+        std::string Text = getItemOutput(Index, ItemSize);
+        for (size_t Pos = 0; Pos < Text.size(); Pos += 1000)
+          ItemOutput << Text.substr(Pos, 1000);
+      },
+      Output));
+  EXPECT_EQ(Output.str(), getItemOutput(0, ItemSize) +
+                              getItemOutput(1, ItemSize) +
+                              getItemOutput(2, ItemSize));
+}
+
+TEST(WorkerProcesses, EmptyItems) {
+  if (!canRunWorkerProcesses())
+    return;
+  std::ostringstream Output;
+  EXPECT_TRUE(runInWorkerProcesses(
+      10, 3,
+      [](size_t Index, std::ostream &ItemOutput) {
+        if (Index == 5)
+          ItemOutput << "five";
+      },
+      Output));
+  EXPECT_EQ(Output.str(), "five");
+  EXPECT_FALSE(runInWorkerProcesses(
+      0, 3, [](size_t, std::ostream &) {}, Output));
+}